@@ -33,6 +33,23 @@
  */
 ROCPROFILER_EXTERN_C_INIT
 
+/**
+ * @brief Header of the counter records of a sample requested with
+ * ::rocprofiler_sample_agent_profile_counting_service or
+ * ::rocprofiler_submit_agent_profile_counting_sample. It is written to the buffer
+ * (::ROCPROFILER_COUNTER_RECORD_AGENT_PROFILE_SAMPLE_HEADER) before the
+ * ::rocprofiler_record_counter_t records of the sample.
+ */
+typedef struct rocprofiler_agent_profile_sample_record_t
+{
+    uint64_t                size;           ///< Size of this struct
+    uint64_t                num_records;    ///< number of ::rocprofiler_record_counter_t records
+    rocprofiler_agent_id_t  agent_id;       ///< Agent of the sample
+    uint64_t                sample_id;      ///< Sequence number of the sample, starting at one
+    uint64_t                num_coalesced;  ///< Requests coalesced into the sample
+    rocprofiler_user_data_t user_data;      ///< User data of the request which submitted it
+} rocprofiler_agent_profile_sample_record_t;
+
 /**
  * @brief Callback to set the profile config for the agent.
  *
@@ -97,10 +114,12 @@ rocprofiler_configure_agent_profile_counting_service(rocprofiler_context_id_t co
 
 /**
  * @brief Trigger a read of the counter data for the agent profile. The counter data will be
- * written to the buffer specified in rocprofiler_configure_agent_profile_counting_service.
- * The data in rocprofiler_user_data_t will be written to the buffer along with the counter data.
- * flags can be used to specify if this call should be performed asynchronously (default is
- * synchronous).
+ * written to the buffer specified in rocprofiler_configure_agent_profile_counting_service,
+ * after a ::rocprofiler_agent_profile_sample_record_t header. The data in
+ * rocprofiler_user_data_t will be written to the buffer along with the counter data. flags can
+ * be used to specify if this call should be performed asynchronously (default is synchronous).
+ * An asynchronous call waits for the oldest sample if every sample slot is in flight (see
+ * ::rocprofiler_submit_agent_profile_counting_sample for a call which never waits).
  *
  * @param [in] context_id context id
  * @param [in] user_data User supplied data, included in records outputted to buffer.
@@ -118,6 +137,60 @@ rocprofiler_sample_agent_profile_counting_service(rocprofiler_context_id_t   con
                                                   rocprofiler_user_data_t    user_data,
                                                   rocprofiler_counter_flag_t flags) ROCPROFILER_API;
 
+/**
+ * @brief Submit a read of the counter data for the agent profile and return without waiting
+ * for the agent. The counter data is written to the buffer specified in
+ * rocprofiler_configure_agent_profile_counting_service, after a
+ * ::rocprofiler_agent_profile_sample_record_t header carrying the sample id, once the read
+ * completes. Samples are written in the order they were submitted. A bounded number of samples
+ * can be in flight per context, so one thread can keep samples in flight on many agents at
+ * once.
+ *
+ * @param [in] context_id context id
+ * @param [in] user_data User supplied data, included in the header of the sample.
+ * @param [in] flags ::ROCPROFILER_COUNTER_FLAG_ASYNC_COALESCE returns the sample id of the last
+ * sample if it has not been read by the agent yet (instead of submitting another sample).
+ * Other flags submit a sample.
+ * @param [out] sample_id Sequence number of the sample (optional)
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONTEXT_INVALID Returned if the context does not exist or
+ * the context is not configured for agent profiling.
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONTEXT_ERROR Returned if another operation is in progress (
+ * start/stop ctx or another read).
+ * @retval ::ROCPROFILER_STATUS_ERROR_OUT_OF_RESOURCES Returned if every sample slot is in flight
+ * @retval ::ROCPROFILER_STATUS_ERROR Returned if HSA has not been initialized yet.
+ * @retval ::ROCPROFILER_STATUS_SUCCESS Returned if the sample was submitted (or coalesced).
+ */
+rocprofiler_status_t
+rocprofiler_submit_agent_profile_counting_sample(rocprofiler_context_id_t   context_id,
+                                                 rocprofiler_user_data_t    user_data,
+                                                 rocprofiler_counter_flag_t flags,
+                                                 uint64_t* sample_id) ROCPROFILER_API;
+
+/**
+ * @brief Sample the counter data for the agent profile periodically while the context is
+ * started. The samples are submitted by a thread created by rocprofiler-sdk, every
+ * interval_ns nanoseconds, without waiting for the previous samples to complete (a bounded
+ * number of samples are in flight, ticks for which no sample can be submitted are dropped).
+ * The counter data of each sample is written to the buffer specified in
+ * rocprofiler_configure_agent_profile_counting_service with the timestamp (in nanoseconds)
+ * at which the sample was submitted as the user data. While periodic sampling is enabled,
+ * rocprofiler_sample_agent_profile_counting_service returns
+ * ::ROCPROFILER_STATUS_ERROR_CONTEXT_ERROR.
+ *
+ * @param [in] context_id context id
+ * @param [in] interval_ns Interval between two samples in nanoseconds. Zero disables periodic
+ * sampling (default).
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONTEXT_INVALID Returned if the context does not exist or
+ * the context is not configured for agent profiling.
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED Returned if the context is started.
+ * @retval ::ROCPROFILER_STATUS_SUCCESS Returned if succesfully configured
+ */
+rocprofiler_status_t
+rocprofiler_configure_agent_profile_sampling_interval(rocprofiler_context_id_t context_id,
+                                                      uint64_t interval_ns) ROCPROFILER_API;
+
 /** @} */
 
 ROCPROFILER_EXTERN_C_FINI
@@ -103,6 +103,10 @@ rocprofiler_configure_thread_trace_service(rocprofiler_context_id_t
  * @brief Callback for rocprofiler to parsed ATT data.
  * The caller must copy a desired instruction on isa_instruction and source_reference,
  * while obeying the max length passed by the caller.
+ * Unless the ROCPROFILER_ATT_PARSER_THREADS environment variable is set to one, the shader
+ * engines are decoded concurrently (by default, one thread per shader engine) and this callback
+ * may be invoked on a thread other than the one which called ::rocprofiler_att_parse_data. The
+ * invocations are never concurrent.
  * If the caller's length is insufficient, then this function writes the minimum sizes to isa_size
  * and source_size and returns ROCPROFILER_STATUS_ERROR_OUT_OF_RESOURCES.
  * If call returns ROCPROFILER_STATUS_SUCCESS, isa_size and source_size are written with bytes used.
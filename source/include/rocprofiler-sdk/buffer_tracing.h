@@ -137,6 +137,7 @@ typedef struct
     rocprofiler_timestamp_t           start_timestamp;  ///< start time in nanoseconds
     rocprofiler_timestamp_t           end_timestamp;    ///< end time in nanoseconds
     rocprofiler_thread_id_t           thread_id;        ///< id for thread generating this record
+    rocprofiler_marker_message_id_t   message_id;       ///< interned message or name argument
 
     /// @var kind
     /// @brief ::ROCPROFILER_CALLBACK_TRACING_MARKER_CORE_API,
@@ -145,6 +146,11 @@ typedef struct
     /// @brief Specification of the API function, e.g., ::rocprofiler_marker_core_api_id_t,
     /// ::rocprofiler_marker_control_api_id_t, or
     /// ::rocprofiler_marker_name_api_id_t
+    /// @var message_id
+    /// @brief Identifier for the message (e.g. roctxMarkA, roctxRangePushA) or name (e.g.
+    /// roctxNameOsThread) argument of the marker API. Zero if the function does not have a
+    /// message argument or the message was a nullptr. Resolve via
+    /// ::rocprofiler_query_marker_message
 } rocprofiler_buffer_tracing_marker_api_record_t;
 
 /**
@@ -334,6 +334,7 @@ save(ArchiveT& ar, rocprofiler_profile_counting_dispatch_data_t data)
     ROCP_SDK_SAVE_DATA_FIELD(size);
     ROCP_SDK_SAVE_DATA_FIELD(correlation_id);
     ROCP_SDK_SAVE_DATA_FIELD(dispatch_info);
+    ROCP_SDK_SAVE_DATA_FIELD(sample_weight);
 }
 
 template <typename ArchiveT>
@@ -344,6 +345,8 @@ save(ArchiveT& ar, rocprofiler_profile_counting_dispatch_record_t data)
     ROCP_SDK_SAVE_DATA_FIELD(num_records);
     ROCP_SDK_SAVE_DATA_FIELD(correlation_id);
     ROCP_SDK_SAVE_DATA_FIELD(dispatch_info);
+    ROCP_SDK_SAVE_DATA_FIELD(sample_weight);
+    ROCP_SDK_SAVE_DATA_VALUE("user_data", user_data.value);
 }
 
 template <typename ArchiveT>
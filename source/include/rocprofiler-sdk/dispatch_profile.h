@@ -46,12 +46,20 @@ typedef struct rocprofiler_profile_counting_dispatch_data_t
     uint64_t                           size;            ///< Size of this struct
     rocprofiler_correlation_id_t       correlation_id;  ///< Correlation ID for this dispatch
     rocprofiler_kernel_dispatch_info_t dispatch_info;   ///< Dispatch info
+    uint64_t sample_weight;  ///< Dispatches of the kernel represented by this dispatch
+                             ///< (one unless a sampling policy is configured)
 } rocprofiler_profile_counting_dispatch_data_t;
 
 /**
  * @brief ROCProfiler Profile Counting Counter Record Header Information
  *
  * This is buffer equivalent of ::rocprofiler_profile_counting_dispatch_data_t
+ *
+ * If the hardware counters of a profile do not fit in a single pass, successive dispatches of a
+ * kernel collect the passes of the profile round-robin. The dispatches of the first N-1 passes
+ * emit nothing. The dispatch completing the last pass emits one record with the counters of
+ * every pass, and the correlation_id, dispatch_info and user_data of that (last) dispatch. The
+ * values of passes that were not completed by the end of the profiling session are discarded.
  */
 typedef struct rocprofiler_profile_counting_dispatch_record_t
 {
@@ -59,6 +67,9 @@ typedef struct rocprofiler_profile_counting_dispatch_record_t
     uint64_t                     num_records;  ///< number of ::rocprofiler_record_counter_t records
     rocprofiler_correlation_id_t correlation_id;       ///< Correlation ID for this dispatch
     rocprofiler_kernel_dispatch_info_t dispatch_info;  ///< Contains the `dispatch_id`
+    uint64_t sample_weight;  ///< Dispatches of the kernel represented by this dispatch
+                             ///< (one unless a sampling policy is configured)
+    rocprofiler_user_data_t user_data;  ///< User data set by the dispatch callback
 } rocprofiler_profile_counting_dispatch_record_t;
 
 /**
@@ -84,6 +95,8 @@ typedef void (*rocprofiler_profile_counting_dispatch_callback_t)(
  *        execution is complete and contains the counter profile data requested in
  *        @ref rocprofiler_profile_counting_dispatch_callback_t. Only used with
  *        @ref rocprofiler_configure_callback_dispatch_profile_counting_service.
+ *        For a profile collected in several passes, only invoked by the dispatch completing
+ *        the last pass (see ::rocprofiler_profile_counting_dispatch_record_t).
  *
  * @param [in] dispatch_data      @see ::rocprofiler_profile_counting_dispatch_data_t
  * @param [in] record_data        Counter record data.
@@ -98,6 +111,70 @@ typedef void (*rocprofiler_profile_counting_record_callback_t)(
     rocprofiler_user_data_t                      user_data,
     void*                                        callback_data_args);
 
+/**
+ * @brief Kernel filter of the dispatch profile counting service. Invoked once for each kernel
+ *        symbol when its code object is loaded (and for the kernels which were already loaded
+ *        when the filter is configured) to decide whether the dispatches of the kernel are
+ *        profiled.
+ *
+ * @param [in] kernel_id   Kernel identifier
+ * @param [in] kernel_name Name of the kernel
+ * @param [in] filter_args Data supplied via ::rocprofiler_profile_counting_dispatch_filter_t
+ * @return int             Non-zero if the dispatches of the kernel are profiled
+ */
+typedef int (*rocprofiler_profile_counting_kernel_filter_t)(rocprofiler_kernel_id_t kernel_id,
+                                                            const char*             kernel_name,
+                                                            void*                   filter_args);
+
+/**
+ * @brief Dispatches targeted by the dispatch profile counting services of a context. A kernel is
+ *        targeted if its id is in @p kernel_ids or if @p kernel_filter returns non-zero for it.
+ *        When neither is provided, every kernel is targeted. Only the dispatches of targeted
+ *        kernels whose dispatch id is in [@p dispatch_id_begin, @p dispatch_id_end) invoke the
+ *        ::rocprofiler_profile_counting_dispatch_callback_t.
+ */
+typedef struct rocprofiler_profile_counting_dispatch_filter_t
+{
+    uint64_t                                     size;                ///< Size of this struct
+    const rocprofiler_kernel_id_t*               kernel_ids;          ///< Kernels to profile
+    size_t                                       kernel_ids_count;    ///< Number of kernel ids
+    rocprofiler_profile_counting_kernel_filter_t kernel_filter;       ///< Optional kernel filter
+    void*                                        kernel_filter_args;  ///< Kernel filter data
+    rocprofiler_dispatch_id_t                    dispatch_id_begin;   ///< First dispatch id
+    rocprofiler_dispatch_id_t dispatch_id_end;  ///< End of the dispatch ids, zero for no limit
+} rocprofiler_profile_counting_dispatch_filter_t;
+
+/**
+ * @brief Dispatch sampling policies of the dispatch profile counting service. The policy of a
+ *        kernel selects which of its dispatches are profiled. The other dispatches are not
+ *        instrumented, but still run serialized with the profiled dispatches.
+ */
+typedef enum  // NOLINT(performance-enum-size)
+{
+    ROCPROFILER_PROFILE_COUNTING_SAMPLING_NONE = 0,  ///< Every dispatch is profiled
+    ROCPROFILER_PROFILE_COUNTING_SAMPLING_STRIDE,    ///< Every Nth dispatch, starting at the first
+    ROCPROFILER_PROFILE_COUNTING_SAMPLING_FIRST,     ///< First N dispatches
+    ROCPROFILER_PROFILE_COUNTING_SAMPLING_INTERVAL,  ///< At most one dispatch per N nanoseconds
+    ROCPROFILER_PROFILE_COUNTING_SAMPLING_RANDOM,    ///< Each dispatch with a probability of 1/N
+    ROCPROFILER_PROFILE_COUNTING_SAMPLING_LAST,
+} rocprofiler_profile_counting_sampling_policy_t;
+
+/**
+ * @brief Dispatch sampling policy of a kernel, or of every kernel without a policy of its own
+ *        if @p kernel_id is zero. The sample weight of a profiled dispatch is N for the stride and
+ *        random policies, one for the first N dispatches, and the number of dispatches since the
+ *        previous profiled dispatch of the kernel for the interval policy. The random policy is
+ *        deterministic for a given @p seed, kernel, and dispatch count of the kernel.
+ */
+typedef struct rocprofiler_profile_counting_sampling_t
+{
+    uint64_t                                       size;       ///< Size of this struct
+    rocprofiler_kernel_id_t                        kernel_id;  ///< Kernel, zero for every kernel
+    rocprofiler_profile_counting_sampling_policy_t policy;     ///< Sampling policy
+    uint64_t                                       period;     ///< N of the policy
+    uint64_t                                       seed;       ///< Seed of the random policy
+} rocprofiler_profile_counting_sampling_t;
+
 /**
  * @brief Configure buffered dispatch profile Counting Service.
  *        Collects the counters in dispatch packets and stores them
@@ -151,6 +228,47 @@ rocprofiler_configure_callback_dispatch_profile_counting_service(
     void*                                            dispatch_callback_args,
     rocprofiler_profile_counting_record_callback_t   record_callback,
     void*                                            record_callback_args);
+
+/**
+ * @brief Restricts the dispatch profile counting services of a context to the dispatches
+ *        selected by @p filter. Whether a kernel is targeted is resolved once, when its code
+ *        object is loaded, so the dispatches of the other kernels neither invoke the
+ *        ::rocprofiler_profile_counting_dispatch_callback_t nor require a lookup by the tool.
+ *        May be invoked again, e.g. once the kernel ids of interest are known, to replace the
+ *        filter.
+ *
+ * @param [in] context_id context id with a configured dispatch profile counting service
+ * @param [in] filter     dispatches to profile
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_SUCCESS the filter was configured
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONTEXT_INVALID the context does not exist or has no
+ *         dispatch profile counting service
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT invalid kernel ids or dispatch id range
+ */
+rocprofiler_status_t ROCPROFILER_API
+rocprofiler_configure_dispatch_profile_counting_filter(
+    rocprofiler_context_id_t                       context_id,
+    rocprofiler_profile_counting_dispatch_filter_t filter);
+
+/**
+ * @brief Sets the dispatch sampling policy of a kernel (or the default policy of every kernel)
+ *        for the dispatch profile counting services of a context. Only the dispatches selected
+ *        by the policy invoke the ::rocprofiler_profile_counting_dispatch_callback_t, the other
+ *        dispatches are not instrumented but still run serialized with the profiled dispatches.
+ *        The dispatch counts of the policies restart when a policy is set.
+ *
+ * @param [in] context_id context id with a configured dispatch profile counting service
+ * @param [in] sampling   sampling policy
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_SUCCESS the sampling policy was set
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONTEXT_INVALID the context does not exist or has no
+ *         dispatch profile counting service
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT invalid policy or period of zero
+ */
+rocprofiler_status_t ROCPROFILER_API
+rocprofiler_configure_dispatch_profile_counting_sampling(
+    rocprofiler_context_id_t                context_id,
+    rocprofiler_profile_counting_sampling_t sampling);
 /** @} */
 
 ROCPROFILER_EXTERN_C_FINI
@@ -386,11 +386,15 @@ typedef enum
     ROCPROFILER_COUNTER_RECORD_NONE = 0,
     ROCPROFILER_COUNTER_RECORD_PROFILE_COUNTING_DISPATCH_HEADER,  ///< ::rocprofiler_profile_counting_dispatch_record_t
     ROCPROFILER_COUNTER_RECORD_VALUE,
+    ROCPROFILER_COUNTER_RECORD_AGENT_PROFILE_SAMPLE_HEADER,
     ROCPROFILER_COUNTER_RECORD_LAST,
 
     /// @var ROCPROFILER_COUNTER_RECORD_KIND_DISPATCH_PROFILE_HEADER
     /// @brief Indicates the payload type is of type
     /// ::rocprofiler_profile_counting_dispatch_record_t
+    /// @var ROCPROFILER_COUNTER_RECORD_AGENT_PROFILE_SAMPLE_HEADER
+    /// @brief Indicates the payload type is of type
+    /// ::rocprofiler_agent_profile_sample_record_t
 } rocprofiler_counter_record_kind_t;
 
 /**
@@ -399,7 +403,9 @@ typedef enum
 typedef enum
 {
     ROCPROFILER_COUNTER_FLAG_NONE = 0,
-    ROCPROFILER_COUNTER_FLAG_ASYNC,  ///< Do not wait for completion before returning.
+    ROCPROFILER_COUNTER_FLAG_ASYNC,           ///< Do not wait for completion before returning.
+    ROCPROFILER_COUNTER_FLAG_ASYNC_COALESCE,  ///< Do not wait for completion before returning,
+                                              ///< coalesce with the pending request (if any)
     ROCPROFILER_COUNTER_FLAG_LAST,
 } rocprofiler_counter_flag_t;
 
@@ -458,6 +464,12 @@ typedef uint64_t rocprofiler_kernel_id_t;
 //  */
 typedef uint64_t rocprofiler_dispatch_id_t;
 
+/**
+ * @brief Marker message identifier type. Identifies an interned ROCTx message string which can be
+ * resolved via ::rocprofiler_query_marker_message. A value of zero indicates no message.
+ */
+typedef uint64_t rocprofiler_marker_message_id_t;
+
 /**
  * @brief Unique record id encoding both the counter
  *        and dimensional values (positions) for the record.
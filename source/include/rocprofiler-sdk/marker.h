@@ -22,6 +22,36 @@
 
 #pragma once
 
+#include <rocprofiler-sdk/defines.h>
+#include <rocprofiler-sdk/fwd.h>
 #include <rocprofiler-sdk/marker/api_args.h>
 #include <rocprofiler-sdk/marker/api_id.h>
 #include <rocprofiler-sdk/marker/table_id.h>
+
+ROCPROFILER_EXTERN_C_INIT
+
+/**
+ * @defgroup MARKER_MESSAGES Marker Messages
+ * @brief Resolve the interned ROCTx message strings referenced by buffered marker records
+ *
+ * @{
+ */
+
+/**
+ * @brief Query the message string for the ::rocprofiler_marker_message_id_t value in a
+ * ::rocprofiler_buffer_tracing_marker_api_record_t. Each unique message is stored once, the
+ * returned string is valid until rocprofiler is finalized.
+ *
+ * @param [in] message_id Message identifier from a buffered marker record
+ * @param [out] message Pointer to the null-terminated message string
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_SUCCESS message was found
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT message identifier is not valid
+ */
+rocprofiler_status_t
+rocprofiler_query_marker_message(rocprofiler_marker_message_id_t message_id,
+                                 const char** message) ROCPROFILER_API ROCPROFILER_NONNULL(2);
+
+/** @} */
+
+ROCPROFILER_EXTERN_C_FINI
@@ -0,0 +1,455 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All Rights Reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/common/defines.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace common
+{
+namespace container
+{
+namespace detail
+{
+/**
+ * Per-thread hazard pointer slot. Slots are allocated once and recycled when the owning thread
+ * exits so the list only grows to the maximum number of concurrently live reader threads.
+ */
+struct alignas(64) hazard_slot
+{
+    std::atomic<const void*> pointer = nullptr;
+    std::atomic<bool>        in_use  = false;
+    hazard_slot*             next    = nullptr;
+};
+
+inline std::atomic<hazard_slot*>&
+get_hazard_slots()
+{
+    static auto _v = std::atomic<hazard_slot*>{nullptr};
+    return _v;
+}
+
+inline hazard_slot*
+acquire_hazard_slot()
+{
+    auto& _head = get_hazard_slots();
+    for(auto* itr = _head.load(std::memory_order_acquire); itr != nullptr; itr = itr->next)
+    {
+        auto _expected = false;
+        if(!itr->in_use.load(std::memory_order_relaxed) &&
+           itr->in_use.compare_exchange_strong(_expected, true, std::memory_order_acq_rel))
+            return itr;
+    }
+
+    // intentionally leaked: other threads may be scanning the list during static destruction
+    auto* _slot = new hazard_slot{};
+    _slot->in_use.store(true, std::memory_order_relaxed);
+    _slot->next = _head.load(std::memory_order_relaxed);
+    while(!_head.compare_exchange_weak(
+        _slot->next, _slot, std::memory_order_release, std::memory_order_relaxed))
+    {}
+    return _slot;
+}
+
+inline hazard_slot*
+get_hazard_slot()
+{
+    struct slot_owner
+    {
+        ~slot_owner()
+        {
+            slot->pointer.store(nullptr, std::memory_order_release);
+            slot->in_use.store(false, std::memory_order_release);
+        }
+
+        hazard_slot* slot = acquire_hazard_slot();
+    };
+
+    static thread_local auto _v = slot_owner{};
+    return _v.slot;
+}
+
+template <typename FuncT>
+void
+for_each_hazard(FuncT&& _func)
+{
+    for(auto* itr = get_hazard_slots().load(std::memory_order_acquire); itr != nullptr;
+        itr       = itr->next)
+    {
+        const auto* _ptr = itr->pointer.load(std::memory_order_seq_cst);
+        if(_ptr) _func(_ptr);
+    }
+}
+
+// generations are unique across all instances so a thread-local cache entry can never match
+// a map which was destroyed and re-created at the same address
+inline uint64_t
+get_next_generation()
+{
+    static auto _v = std::atomic<uint64_t>{0};
+    return ++_v;
+}
+
+inline uint64_t
+mix_hash(uint64_t _v)
+{
+    // finalizer from MurmurHash3: keys such as kernel objects are aligned addresses so the low
+    // bits carry very little entropy on their own
+    _v ^= (_v >> 33);
+    _v *= 0xff51afd7ed558ccdULL;
+    _v ^= (_v >> 33);
+    _v *= 0xc4ceb9fe1a85ec53ULL;
+    _v ^= (_v >> 33);
+    return _v;
+}
+}  // namespace detail
+
+/**
+ * read_mostly_map is an integral key -> integral value index intended for lookups on hot paths
+ * (e.g. every intercepted kernel dispatch) where modifications are rare (e.g. code object load
+ * and unload). Writers serialize on a mutex, apply their changes to an authoritative
+ * std::unordered_map, and then republish an immutable open-addressed snapshot. Readers never
+ * take a lock: they protect the snapshot with a per-thread hazard pointer and probe it. Retired
+ * snapshots are reclaimed by the next writer once no reader references them. A per-thread
+ * last-hit cache avoids probing altogether when the same key is looked up repeatedly between
+ * modifications.
+ *
+ * Example usage:
+ *
+ * read_mostly_map<uint64_t, uint64_t> x{};
+ * x.emplace(0x7f00, 1);
+ * x.modify([](auto& data) {
+ *  // batch updates -> only one snapshot is published
+ *  data.erase(0x7f00);
+ *  data.emplace(0x7f80, 2);
+ * });
+ * auto val = x.find(0x7f80);  // val == 2
+ * auto nil = x.find(0x7f00);  // nil == 0 (default value)
+ */
+template <typename KeyT, typename MappedT>
+class read_mostly_map
+{
+    static_assert(std::is_integral<KeyT>::value || std::is_pointer<KeyT>::value,
+                  "read_mostly_map requires an integral or pointer key type");
+    static_assert(std::is_trivially_copyable<MappedT>::value,
+                  "read_mostly_map requires a trivially copyable mapped type");
+
+public:
+    using key_type    = KeyT;
+    using mapped_type = MappedT;
+    using map_type    = std::unordered_map<key_type, mapped_type>;
+    using this_type   = read_mostly_map<key_type, mapped_type>;
+
+    read_mostly_map();
+    ~read_mostly_map();
+
+    read_mostly_map(const read_mostly_map&)     = delete;
+    read_mostly_map(read_mostly_map&&) noexcept = delete;
+    read_mostly_map& operator=(const read_mostly_map&) = delete;
+    read_mostly_map& operator=(read_mostly_map&&) noexcept = delete;
+
+    // lock-free lookup, returns _fallback if the key does not exist
+    mapped_type find(key_type _key, mapped_type _fallback = {}) const;
+    bool        contains(key_type _key) const;
+
+    // invokes the function with the authoritative map under the write lock and then publishes
+    // a new snapshot. Use this to batch multiple updates into one snapshot
+    template <typename FuncT, typename... Args>
+    decltype(auto) modify(FuncT&& _func, Args&&... _args);
+
+    void emplace(key_type _key, mapped_type _value);
+    void erase(key_type _key);
+    void clear();
+
+    size_t   size() const;
+    uint64_t generation() const { return m_generation.load(std::memory_order_acquire); }
+
+private:
+    struct entry
+    {
+        key_type    key   = {};
+        mapped_type value = {};
+        bool        used  = false;
+    };
+
+    struct snapshot
+    {
+        uint64_t                 generation = 0;
+        size_t                   mask       = 0;
+        size_t                   count      = 0;
+        std::unique_ptr<entry[]> entries    = {};
+    };
+
+    struct last_hit
+    {
+        const this_type* owner      = nullptr;
+        uint64_t         generation = 0;
+        key_type         key        = {};
+        mapped_type      value      = {};
+    };
+
+    static size_t bucket(key_type _key);
+
+    const snapshot* protect(detail::hazard_slot* _slot) const;
+    bool            lookup(const snapshot* _snap, key_type _key, mapped_type& _value) const;
+    void            publish();
+    void            reclaim();
+    snapshot*       build() const;
+
+    std::mutex             m_mutex      = {};
+    map_type               m_data       = {};
+    std::vector<snapshot*> m_retired    = {};
+    std::atomic<snapshot*> m_snapshot   = nullptr;
+    std::atomic<uint64_t>  m_generation = 0;
+};
+
+template <typename KeyT, typename MappedT>
+read_mostly_map<KeyT, MappedT>::read_mostly_map()
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    publish();
+}
+
+template <typename KeyT, typename MappedT>
+read_mostly_map<KeyT, MappedT>::~read_mostly_map()
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    for(auto* itr : m_retired)
+        delete itr;
+    m_retired.clear();
+    delete m_snapshot.exchange(nullptr);
+}
+
+template <typename KeyT, typename MappedT>
+size_t
+read_mostly_map<KeyT, MappedT>::bucket(key_type _key)
+{
+    if constexpr(std::is_pointer<key_type>::value)
+        return detail::mix_hash(reinterpret_cast<uintptr_t>(_key));
+    else
+        return detail::mix_hash(static_cast<uint64_t>(_key));
+}
+
+// acquires a hazard pointer to the current snapshot. The snapshot is only swapped when the map
+// is modified so this loop effectively never repeats
+template <typename KeyT, typename MappedT>
+const typename read_mostly_map<KeyT, MappedT>::snapshot*
+read_mostly_map<KeyT, MappedT>::protect(detail::hazard_slot* _slot) const
+{
+    const snapshot* _snap = m_snapshot.load(std::memory_order_acquire);
+    while(true)
+    {
+        _slot->pointer.store(_snap, std::memory_order_seq_cst);
+        const snapshot* _curr = m_snapshot.load(std::memory_order_seq_cst);
+        if(ROCPROFILER_LIKELY(_curr == _snap)) break;
+        _snap = _curr;
+    }
+    return _snap;
+}
+
+template <typename KeyT, typename MappedT>
+bool
+read_mostly_map<KeyT, MappedT>::lookup(const snapshot* _snap,
+                                       key_type        _key,
+                                       mapped_type&    _value) const
+{
+    if(!_snap || _snap->count == 0) return false;
+
+    // snapshot load factor is <= 0.5 so probing always terminates at an unused entry
+    for(auto idx = bucket(_key) & _snap->mask;; idx = (idx + 1) & _snap->mask)
+    {
+        const auto& itr = _snap->entries[idx];
+        if(!itr.used) return false;
+        if(itr.key == _key)
+        {
+            _value = itr.value;
+            return true;
+        }
+    }
+}
+
+template <typename KeyT, typename MappedT>
+MappedT
+read_mostly_map<KeyT, MappedT>::find(key_type _key, mapped_type _fallback) const
+{
+    static thread_local auto _cache = last_hit{};
+
+    auto _gen = m_generation.load(std::memory_order_acquire);
+    if(ROCPROFILER_LIKELY(_cache.owner == this && _cache.generation == _gen && _cache.key == _key))
+        return _cache.value;
+
+    auto*       _slot = detail::get_hazard_slot();
+    const auto* _snap = protect(_slot);
+
+    auto _value = _fallback;
+    if(lookup(_snap, _key, _value))
+        _cache = last_hit{this, _snap->generation, _key, _value};
+
+    _slot->pointer.store(nullptr, std::memory_order_release);
+    return _value;
+}
+
+template <typename KeyT, typename MappedT>
+bool
+read_mostly_map<KeyT, MappedT>::contains(key_type _key) const
+{
+    auto*       _slot = detail::get_hazard_slot();
+    const auto* _snap = protect(_slot);
+
+    auto _value = mapped_type{};
+    auto _found = lookup(_snap, _key, _value);
+
+    _slot->pointer.store(nullptr, std::memory_order_release);
+    return _found;
+}
+
+template <typename KeyT, typename MappedT>
+template <typename FuncT, typename... Args>
+decltype(auto)
+read_mostly_map<KeyT, MappedT>::modify(FuncT&& _func, Args&&... _args)
+{
+    static_assert(std::is_invocable<FuncT, map_type&, Args...>::value,
+                  "function must accept reference to map type");
+
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    if constexpr(std::is_void<std::invoke_result_t<FuncT, map_type&, Args...>>::value)
+    {
+        std::forward<FuncT>(_func)(m_data, std::forward<Args>(_args)...);
+        publish();
+    }
+    else
+    {
+        auto _ret = std::forward<FuncT>(_func)(m_data, std::forward<Args>(_args)...);
+        publish();
+        return _ret;
+    }
+}
+
+template <typename KeyT, typename MappedT>
+void
+read_mostly_map<KeyT, MappedT>::emplace(key_type _key, mapped_type _value)
+{
+    modify([_key, _value](map_type& _data) { _data[_key] = _value; });
+}
+
+template <typename KeyT, typename MappedT>
+void
+read_mostly_map<KeyT, MappedT>::erase(key_type _key)
+{
+    modify([_key](map_type& _data) { _data.erase(_key); });
+}
+
+template <typename KeyT, typename MappedT>
+void
+read_mostly_map<KeyT, MappedT>::clear()
+{
+    modify([](map_type& _data) { _data.clear(); });
+}
+
+template <typename KeyT, typename MappedT>
+size_t
+read_mostly_map<KeyT, MappedT>::size() const
+{
+    auto*       _slot = detail::get_hazard_slot();
+    const auto* _snap = protect(_slot);
+
+    auto _count = (_snap) ? _snap->count : 0;
+    _slot->pointer.store(nullptr, std::memory_order_release);
+    return _count;
+}
+
+template <typename KeyT, typename MappedT>
+typename read_mostly_map<KeyT, MappedT>::snapshot*
+read_mostly_map<KeyT, MappedT>::build() const
+{
+    constexpr size_t min_capacity = 16;
+
+    auto _capacity = min_capacity;
+    while(_capacity < 2 * m_data.size())
+        _capacity <<= 1;
+
+    auto* _snap       = new snapshot{};
+    _snap->generation = detail::get_next_generation();
+    _snap->mask       = _capacity - 1;
+    _snap->count      = m_data.size();
+    _snap->entries    = std::make_unique<entry[]>(_capacity);
+
+    for(const auto& itr : m_data)
+    {
+        auto idx = bucket(itr.first) & _snap->mask;
+        while(_snap->entries[idx].used)
+            idx = (idx + 1) & _snap->mask;
+        _snap->entries[idx] = entry{itr.first, itr.second, true};
+    }
+
+    return _snap;
+}
+
+// must be called while holding m_mutex
+template <typename KeyT, typename MappedT>
+void
+read_mostly_map<KeyT, MappedT>::publish()
+{
+    auto* _snap = build();
+    auto* _prev = m_snapshot.exchange(_snap, std::memory_order_seq_cst);
+    m_generation.store(_snap->generation, std::memory_order_release);
+
+    if(_prev) m_retired.emplace_back(_prev);
+    reclaim();
+}
+
+// must be called while holding m_mutex
+template <typename KeyT, typename MappedT>
+void
+read_mostly_map<KeyT, MappedT>::reclaim()
+{
+    if(m_retired.empty()) return;
+
+    auto _hazards = std::unordered_set<const void*>{};
+    detail::for_each_hazard([&_hazards](const void* _ptr) { _hazards.emplace(_ptr); });
+
+    auto _remaining = std::vector<snapshot*>{};
+    for(auto* itr : m_retired)
+    {
+        if(_hazards.count(itr) > 0)
+            _remaining.emplace_back(itr);
+        else
+            delete itr;
+    }
+    m_retired = std::move(_remaining);
+}
+}  // namespace container
+}  // namespace common
+}  // namespace rocprofiler
@@ -107,7 +107,10 @@ record_header_buffer::clear()
     {
         auto _sz = m_buffer.capacity();
         if(!m_buffer.clear(std::nothrow_t{})) return 0;
-        std::for_each(m_headers.begin(), m_headers.end(), [](auto& itr) {
+        // headers beyond the index were never written since the last clear so only the used
+        // headers need to be reset
+        auto _used = std::min<size_t>(_n, m_headers.size());
+        std::for_each(m_headers.begin(), m_headers.begin() + _used, [](auto& itr) {
             rocprofiler_record_header_t record = {};
             record.hash                        = 0;
             record.payload                     = nullptr;
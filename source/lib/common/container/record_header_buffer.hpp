@@ -26,10 +26,13 @@
 
 #include "lib/common/container/ring_buffer.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <limits>
 #include <mutex>
 #include <shared_mutex>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace rocprofiler
@@ -75,6 +78,12 @@ struct record_header_buffer
     template <typename Tp>
     bool emplace(uint32_t, uint32_t, Tp&);
 
+    /// reserve a contiguous region for up to the specified number of objects and invoke the
+    /// function with the address of the region and the number of objects which the function
+    /// must write in place. Returns the number of objects placed (may be less than requested)
+    template <typename Tp, typename FuncT>
+    size_t emplace_n(uint32_t, uint32_t, size_t, FuncT&&);
+
     /// this function will return a vector of pointers to the record headers
     /// at the time of invocation.
     record_ptr_vec_t get_record_headers(size_t _n = std::numeric_limits<size_t>::max());
@@ -313,6 +322,53 @@ record_header_buffer::emplace(uint32_t _category, uint32_t _kind, Tp& _v)
     return (_addr != nullptr);
 }
 
+template <typename Tp, typename FuncT>
+size_t
+record_header_buffer::emplace_n(uint32_t _category, uint32_t _kind, size_t _n, FuncT&& _func)
+{
+    static_assert(std::is_trivially_copyable<Tp>::value,
+                  "emplace_n requires objects which can be written in place");
+
+    if(m_headers.empty() || _n == 0) return 0;
+
+    // notify there was a request
+    m_requested.fetch_add(1);
+
+    // request as much of the region as is available. The request may fail even when there are
+    // enough free bytes if the region would wrap around the end of the buffer so shrink it until
+    // it fits
+    auto  _num  = std::min<size_t>(_n, m_buffer.free() / sizeof(Tp));
+    void* _addr = nullptr;
+    write_lock();
+    while(_num > 0 && (_addr = m_buffer.request(_num * sizeof(Tp), false)) == nullptr)
+        _num /= 2;
+    write_unlock();
+
+    read_lock();
+    if(_addr)
+    {
+        auto  idx   = m_index.fetch_add(_num, std::memory_order_release);
+        auto* _data = static_cast<Tp*>(_addr);
+
+        std::forward<FuncT>(_func)(_data, _num);
+
+        for(size_t i = 0; i < _num; ++i)
+        {
+            auto record           = rocprofiler_record_header_t{};
+            record.category       = _category;
+            record.kind           = _kind;
+            record.payload        = _data + i;
+            m_headers.at(idx + i) = record;
+        }
+    }
+    read_unlock();
+
+    // remove notification of request
+    m_requested.fetch_sub(1);
+
+    return (_addr != nullptr) ? _num : 0;
+}
+
 template <typename Tp>
 bool
 record_header_buffer::emplace(Tp& _v)
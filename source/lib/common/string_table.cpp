@@ -0,0 +1,278 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/string_table.hpp"
+#include "lib/common/defines.hpp"
+#include "lib/common/static_object.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace common
+{
+namespace
+{
+constexpr size_t arena_block_size  = 256 * 1024;
+constexpr size_t min_index_size    = 256;
+constexpr size_t shard_shift_width = 6;
+
+static_assert((size_t{1} << shard_shift_width) == string_table::num_shards,
+              "shard_shift_width must match the number of shards");
+
+size_t
+get_shard(size_t _hash)
+{
+    return (_hash >> ((sizeof(size_t) * 8) - shard_shift_width));
+}
+}  // namespace
+
+struct string_table::shard
+{
+    // entry header is placed directly in front of the null-terminated string data in the arena
+    struct entry
+    {
+        size_t   hash   = 0;
+        size_t   length = 0;
+        uint64_t id     = 0;
+
+        const char*      data() const { return reinterpret_cast<const char*>(this + 1); }
+        std::string_view view() const { return std::string_view{data(), length}; }
+    };
+
+    struct index
+    {
+        explicit index(size_t _capacity)
+        : mask{_capacity - 1}
+        , slots{std::make_unique<std::atomic<const entry*>[]>(_capacity)}
+        {}
+
+        size_t                                       mask  = 0;
+        std::unique_ptr<std::atomic<const entry*>[]> slots = {};
+    };
+
+    explicit shard(size_t _idx)
+    : shard_idx{_idx}
+    {}
+
+    const entry* find(size_t _hash, std::string_view _v) const;
+    const entry* emplace(size_t _hash, std::string_view _v);
+    const entry* lookup(uint64_t _pos);
+
+    size_t                               shard_idx    = 0;
+    std::mutex                           mutex        = {};
+    std::atomic<index*>                  active       = nullptr;
+    std::atomic<size_t>                  count        = 0;
+    std::vector<std::unique_ptr<index>>  indexes      = {};
+    std::vector<std::unique_ptr<char[]>> blocks       = {};
+    std::vector<const entry*>            entries      = {};  // in insertion order
+    char*                                block_cursor = nullptr;
+    size_t                               block_remain = 0;
+
+private:
+    static const entry* probe(const index* _idx, size_t _hash, std::string_view _v);
+    static void         insert(index* _idx, const entry* _v);
+
+    entry* allocate(std::string_view _v);
+};
+
+const string_table::shard::entry*
+string_table::shard::probe(const index* _idx, size_t _hash, std::string_view _v)
+{
+    for(auto i = _hash & _idx->mask;; i = (i + 1) & _idx->mask)
+    {
+        const auto* itr = _idx->slots[i].load(std::memory_order_acquire);
+        if(!itr) return nullptr;
+        if(itr->hash == _hash && itr->view() == _v) return itr;
+    }
+}
+
+void
+string_table::shard::insert(index* _idx, const entry* _v)
+{
+    auto i = _v->hash & _idx->mask;
+    while(_idx->slots[i].load(std::memory_order_relaxed) != nullptr)
+        i = (i + 1) & _idx->mask;
+    _idx->slots[i].store(_v, std::memory_order_release);
+}
+
+const string_table::shard::entry*
+string_table::shard::find(size_t _hash, std::string_view _v) const
+{
+    const auto* _idx = active.load(std::memory_order_acquire);
+    return (_idx) ? probe(_idx, _hash, _v) : nullptr;
+}
+
+const string_table::shard::entry*
+string_table::shard::emplace(size_t _hash, std::string_view _v)
+{
+    auto _lk = std::unique_lock<std::mutex>{mutex};
+
+    // another thread may have inserted the string after the lock-free lookup failed
+    auto* _idx = active.load(std::memory_order_relaxed);
+    if(_idx)
+    {
+        if(const auto* itr = probe(_idx, _hash, _v); itr) return itr;
+    }
+
+    auto _count = count.load(std::memory_order_relaxed) + 1;
+    if(!_idx || 2 * _count > (_idx->mask + 1))
+    {
+        // grow the index and republish. The old index remains valid for concurrent readers
+        // (it just does not contain newer strings so they will fall back to emplace)
+        auto _capacity = (_idx) ? 2 * (_idx->mask + 1) : min_index_size;
+        auto _next     = std::make_unique<index>(_capacity);
+        if(_idx)
+        {
+            for(size_t i = 0; i <= _idx->mask; ++i)
+            {
+                const auto* itr = _idx->slots[i].load(std::memory_order_relaxed);
+                if(itr) insert(_next.get(), itr);
+            }
+        }
+        _idx = indexes.emplace_back(std::move(_next)).get();
+        active.store(_idx, std::memory_order_release);
+    }
+
+    auto* _entry   = allocate(_v);
+    _entry->hash   = _hash;
+    _entry->length = _v.length();
+    _entry->id     = (static_cast<uint64_t>(_count) << shard_shift_width) | shard_idx;
+    entries.emplace_back(_entry);
+    insert(_idx, _entry);
+    count.store(_count, std::memory_order_relaxed);
+
+    return _entry;
+}
+
+const string_table::shard::entry*
+string_table::shard::lookup(uint64_t _pos)
+{
+    auto _lk = std::unique_lock<std::mutex>{mutex};
+    return (_pos > 0 && _pos <= entries.size()) ? entries.at(_pos - 1) : nullptr;
+}
+
+string_table::shard::entry*
+string_table::shard::allocate(std::string_view _v)
+{
+    constexpr auto align = alignof(entry);
+
+    auto _nbytes = sizeof(entry) + _v.length() + 1;
+    _nbytes      = ((_nbytes + align - 1) / align) * align;
+
+    if(_nbytes > block_remain)
+    {
+        auto _block_size = std::max(_nbytes, arena_block_size);
+        block_cursor     = blocks.emplace_back(std::make_unique<char[]>(_block_size)).get();
+        block_remain     = _block_size;
+    }
+
+    auto* _entry = new(block_cursor) entry{};
+    auto* _data  = block_cursor + sizeof(entry);
+    std::memcpy(_data, _v.data(), _v.length());
+    _data[_v.length()] = '\0';
+
+    block_cursor += _nbytes;
+    block_remain -= _nbytes;
+
+    return _entry;
+}
+
+string_table::string_table()
+{
+    for(size_t i = 0; i < m_shards.size(); ++i)
+        m_shards.at(i) = std::make_unique<shard>(i);
+}
+
+string_table::~string_table() = default;
+
+std::string_view
+string_table::intern(std::string_view _v)
+{
+    auto  _hash  = std::hash<std::string_view>{}(_v);
+    auto& _shard = m_shards.at(get_shard(_hash));
+
+    if(const auto* itr = _shard->find(_hash, _v); ROCPROFILER_LIKELY(itr != nullptr))
+        return itr->view();
+
+    return _shard->emplace(_hash, _v)->view();
+}
+
+uint64_t
+string_table::intern_id(std::string_view _v)
+{
+    auto  _hash  = std::hash<std::string_view>{}(_v);
+    auto& _shard = m_shards.at(get_shard(_hash));
+
+    if(const auto* itr = _shard->find(_hash, _v); ROCPROFILER_LIKELY(itr != nullptr))
+        return itr->id;
+
+    return _shard->emplace(_hash, _v)->id;
+}
+
+std::string_view
+string_table::lookup(uint64_t _id) const
+{
+    constexpr auto shard_mask = (uint64_t{1} << shard_shift_width) - 1;
+
+    const auto* _entry = m_shards.at(_id & shard_mask)->lookup(_id >> shard_shift_width);
+    return (_entry) ? _entry->view() : std::string_view{};
+}
+
+std::string_view
+string_table::find(std::string_view _v) const
+{
+    auto _hash = std::hash<std::string_view>{}(_v);
+    if(const auto* itr = m_shards.at(get_shard(_hash))->find(_hash, _v); itr) return itr->view();
+    return std::string_view{};
+}
+
+size_t
+string_table::size() const
+{
+    size_t _v = 0;
+    for(const auto& itr : m_shards)
+        _v += itr->count.load(std::memory_order_relaxed);
+    return _v;
+}
+
+string_table*
+get_string_table()
+{
+    static auto*& _v = static_object<string_table>::construct();
+    return _v;
+}
+
+std::string_view
+get_string_entry(std::string_view _v)
+{
+    auto* _table = get_string_table();
+    return (_table) ? _table->intern(_v) : std::string_view{};
+}
+}  // namespace common
+}  // namespace rocprofiler
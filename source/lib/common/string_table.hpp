@@ -0,0 +1,94 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace rocprofiler
+{
+namespace common
+{
+/**
+ * string_table interns strings (kernel names, code object URIs, agent names, etc.) so that each
+ * unique string is stored once and can be referenced via a stable, null-terminated
+ * std::string_view for the lifetime of the table.
+ *
+ * The table is split into shards selected by the high bits of the string hash. Each shard owns
+ * an arena for the string data and an open-addressed hash index. Lookups of existing strings
+ * never take a lock: they probe the currently published index of the shard. Inserting a new
+ * string takes the shard mutex, appends the string to the arena, and publishes it into the index
+ * (growing the index when it becomes half full). Strings are never removed, so indexes retired
+ * by growth are simply kept alive until the table is destroyed. Each string is also assigned an
+ * identifier encoding the shard and the insertion order within the shard.
+ */
+class string_table
+{
+public:
+    static constexpr size_t num_shards = 64;
+
+    string_table();
+    ~string_table();
+
+    string_table(const string_table&)     = delete;
+    string_table(string_table&&) noexcept = delete;
+    string_table& operator=(const string_table&) = delete;
+    string_table& operator=(string_table&&) noexcept = delete;
+
+    // returns the interned copy of the string, inserting it if it does not exist
+    std::string_view intern(std::string_view _v);
+
+    // returns the interned copy of the string or an empty string_view (with a nullptr data()) if
+    // it has not been interned
+    std::string_view find(std::string_view _v) const;
+
+    // returns the (non-zero) identifier of the interned string, inserting it if it does not exist.
+    // Identifiers are compact and stable so they can be stored in records instead of the string
+    uint64_t intern_id(std::string_view _v);
+
+    // returns the interned string for an identifier returned by intern_id or an empty string_view
+    // (with a nullptr data()) if the identifier is not valid. Acquires a lock
+    std::string_view lookup(uint64_t _id) const;
+
+    size_t size() const;
+
+    struct shard;
+
+private:
+    std::array<std::unique_ptr<shard>, num_shards> m_shards;
+};
+
+// process-wide string table. Returns nullptr after static objects have been destroyed
+string_table*
+get_string_table();
+
+// interns the string in the process-wide string table. Returns an empty string_view if the
+// string table has been destroyed
+std::string_view
+get_string_entry(std::string_view _v);
+}  // namespace common
+}  // namespace rocprofiler
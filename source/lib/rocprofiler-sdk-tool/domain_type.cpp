@@ -44,6 +44,7 @@ DEFINE_BUFFER_TYPE_NAME(COUNTER_COLLECTION, "COUNTER_COLLECTION", "counter_colle
 DEFINE_BUFFER_TYPE_NAME(KERNEL_DISPATCH, "KERNEL_DISPATCH", "kernel_dispatch")
 DEFINE_BUFFER_TYPE_NAME(MARKER, "MARKER", "marker_trace")
 DEFINE_BUFFER_TYPE_NAME(SCRATCH_MEMORY, "SCRATCH_MEMORY", "scratch_memory")
+DEFINE_BUFFER_TYPE_NAME(COUNTER_VALUES, "COUNTER_VALUES", "counter_values")
 
 #undef DEFINE_BUFFER_TYPE_NAME
 
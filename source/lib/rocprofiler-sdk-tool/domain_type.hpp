@@ -33,6 +33,7 @@ enum class domain_type
     KERNEL_DISPATCH,
     MARKER,
     SCRATCH_MEMORY,
+    COUNTER_VALUES,
     LAST,
 };
 
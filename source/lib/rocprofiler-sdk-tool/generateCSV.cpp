@@ -496,7 +496,7 @@ generate_csv(tool_table*                                                       t
             record.operation == ROCPROFILER_MARKER_CORE_API_ID_roctxRangePushA ||
             record.operation == ROCPROFILER_MARKER_CORE_API_ID_roctxRangeStartA))
         {
-            _name = tool_functions->tool_get_roctx_msg_fn(record.correlation_id.internal);
+            _name = tool_functions->tool_get_roctx_msg_fn(record.message_id);
         }
         else
         {
@@ -554,10 +554,9 @@ generate_csv(tool_table*                                                     too
     {
         auto kernel_id          = record.dispatch_data.dispatch_info.kernel_id;
         auto counter_name_value = std::map<std::string, uint64_t>{};
-        for(uint64_t i = 0; i < record.counter_count; i++)
+        for(const auto& count : record.records)
         {
-            const auto& count        = record.records.at(i);
-            auto        rec          = count.record_counter;
+            const auto& rec          = count.record_counter;
             std::string counter_name = tool_functions->tool_get_counter_info_name_fn(rec.id);
             auto        search       = counter_name_value.find(counter_name);
             if(search == counter_name_value.end())
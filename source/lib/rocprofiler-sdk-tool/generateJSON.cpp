@@ -82,7 +82,7 @@ write_json(tool_table*                                                      tool
             auto callback_name_info = get_callback_id_names();
             auto buffer_name_info   = get_buffer_id_names();
             auto counter_dims       = get_tool_counter_dimension_info();
-            auto marker_msg_data    = get_callback_roctx_msg();
+            auto marker_msg_data    = get_callback_roctx_msg(*marker_api_deque);
 
             json_ar.setNextName("strings");
             json_ar.startNode();
@@ -284,7 +284,7 @@ write_perfetto(
             auto& track = thread_tracks.at(itr.thread_id);
             auto  name  = (itr.kind == ROCPROFILER_BUFFER_TRACING_MARKER_CORE_API &&
                          itr.operation != ROCPROFILER_MARKER_CORE_API_ID_roctxGetThreadId)
-                              ? tool_functions->tool_get_roctx_msg_fn(itr.correlation_id.internal)
+                              ? tool_functions->tool_get_roctx_msg_fn(itr.message_id)
                               : buffer_names.at(itr.kind, itr.operation);
 
             TRACE_EVENT_BEGIN(sdk::perfetto_category<sdk::category::marker_api>::name,
@@ -36,6 +36,7 @@
 #include <rocprofiler-sdk/registration.h>
 #include <rocprofiler-sdk/rocprofiler.h>
 #include <cstdint>
+#include <deque>
 #include <rocprofiler-sdk/cxx/name_info.hpp>
 #include <rocprofiler-sdk/cxx/serialization.hpp>
 
@@ -91,7 +92,6 @@ using rocprofiler_tool_buffer_kind_operation_names_t =
     std::unordered_map<rocprofiler_buffer_tracing_kind_t,
                        std::unordered_map<uint32_t, std::string>>;
 
-using marker_message_map_t = std::unordered_map<uint64_t, std::string>;
 using rocprofiler_kernel_symbol_data_t =
     rocprofiler_callback_tracing_code_object_kernel_symbol_register_data_t;
 
@@ -161,8 +161,9 @@ get_buffer_id_names();
 ::rocprofiler::sdk::callback_name_info_t<std::string_view>
 get_callback_id_names();
 
+// maps the correlation ids of the marker records to their messages
 std::map<uint64_t, std::string>
-get_callback_roctx_msg();
+get_callback_roctx_msg(const std::deque<rocprofiler_buffer_tracing_marker_api_record_t>& data);
 
 std::vector<kernel_symbol_data>
 get_kernel_symbol_data();
@@ -269,24 +270,29 @@ struct rocprofiler_tool_record_counter_t
     }
 };
 
+// counter value of a dispatch in the temporary file, the counter values of a dispatch are joined
+// with the header record of the dispatch (and the kernel metadata) when the output is generated
+struct rocprofiler_tool_counter_value_t
+{
+    rocprofiler_counter_instance_id_t id          = 0;
+    double                            value       = 0.0;
+    rocprofiler_dispatch_id_t         dispatch_id = 0;
+};
+
 struct rocprofiler_tool_counter_collection_record_t
 {
-    rocprofiler_profile_counting_dispatch_data_t       dispatch_data    = {};
-    std::array<rocprofiler_tool_record_counter_t, 256> records          = {};
-    uint64_t                                           thread_id        = 0;
-    uint64_t                                           arch_vgpr_count  = 0;
-    uint64_t                                           sgpr_count       = 0;
-    uint64_t                                           lds_block_size_v = 0;
-    uint64_t                                           counter_count    = 0;
+    rocprofiler_profile_counting_dispatch_data_t   dispatch_data    = {};
+    std::vector<rocprofiler_tool_record_counter_t> records          = {};
+    uint64_t                                       thread_id        = 0;
+    uint64_t                                       arch_vgpr_count  = 0;
+    uint64_t                                       sgpr_count       = 0;
+    uint64_t                                       lds_block_size_v = 0;
 
     template <typename ArchiveT>
     void save(ArchiveT& ar) const
     {
         ar(cereal::make_nvp("dispatch_data", dispatch_data));
-        // should be removed when moving to buffered tracing
-        std::vector<rocprofiler_tool_record_counter_t> tmp{records.begin(),
-                                                           records.begin() + counter_count};
-        ar(cereal::make_nvp("records", tmp));
+        ar(cereal::make_nvp("records", records));
         ar(cereal::make_nvp("thread_id", thread_id));
         ar(cereal::make_nvp("arch_vgpr_count", arch_vgpr_count));
         ar(cereal::make_nvp("sgpr_count", sgpr_count));
@@ -325,8 +331,11 @@ using marker_buffered_output_t =
     ::rocprofiler::tool::buffered_output<rocprofiler_buffer_tracing_marker_api_record_t,
                                          domain_type::MARKER>;
 using counter_collection_buffered_output_t =
-    ::rocprofiler::tool::buffered_output<rocprofiler_tool_counter_collection_record_t,
+    ::rocprofiler::tool::buffered_output<rocprofiler_profile_counting_dispatch_record_t,
                                          domain_type::COUNTER_COLLECTION>;
+using counter_values_buffered_output_t =
+    ::rocprofiler::tool::buffered_output<rocprofiler_tool_counter_value_t,
+                                         domain_type::COUNTER_VALUES>;
 using scratch_memory_buffered_output_t =
     ::rocprofiler::tool::buffered_output<rocprofiler_buffer_tracing_scratch_memory_record_t,
                                          domain_type::SCRATCH_MEMORY>;
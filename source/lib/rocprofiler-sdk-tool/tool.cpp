@@ -34,6 +34,7 @@
 #include "lib/common/environment.hpp"
 #include "lib/common/filesystem.hpp"
 #include "lib/common/logging.hpp"
+#include "lib/common/string_table.hpp"
 #include "lib/common/synchronized.hpp"
 #include "lib/common/utility.hpp"
 
@@ -53,6 +54,7 @@
 #include <cassert>
 #include <fstream>
 #include <iomanip>
+#include <limits>
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
@@ -184,7 +186,7 @@ using agent_info_map_t = std::unordered_map<rocprofiler_agent_id_t, rocprofiler_
 
 auto  code_obj_data          = as_pointer<common::Synchronized<code_object_data_map_t, true>>();
 auto* kernel_data            = as_pointer<common::Synchronized<kernel_symbol_data_map_t, true>>();
-auto* marker_msg_data        = as_pointer<common::Synchronized<marker_message_map_t, true>>();
+auto* marker_msg_data        = as_pointer<common::string_table>();
 auto  counter_dimension_data = common::Synchronized<counter_dimension_info_map_t, true>{};
 auto  target_kernels         = common::Synchronized<targeted_kernels_set_t>{};
 auto* buffered_name_info     = as_pointer(get_buffer_id_names());
@@ -248,12 +250,9 @@ get_callback_op_name(rocprofiler_callback_tracing_kind_t kind, uint32_t op)
 }
 
 std::string_view
-get_roctx_msg(uint64_t cid)
+get_roctx_msg(uint64_t message_id)
 {
-    return CHECK_NOTNULL(marker_msg_data)
-        ->rlock(
-            [](const auto& _data, uint64_t _cid_v) -> std::string_view { return _data.at(_cid_v); },
-            cid);
+    return CHECK_NOTNULL(marker_msg_data)->lookup(message_id);
 }
 
 void
@@ -320,13 +319,8 @@ callback_tracing_callback(rocprofiler_callback_tracing_record_t record,
         {
             if(record.phase == ROCPROFILER_CALLBACK_PHASE_EXIT)
             {
-                CHECK_NOTNULL(marker_msg_data)
-                    ->wlock(
-                        [](auto& _data, uint64_t _cid_v, std::string&& _msg) {
-                            _data.emplace(_cid_v, std::move(_msg));
-                        },
-                        record.correlation_id.internal,
-                        std::string{marker_data->args.roctxMarkA.message});
+                auto msg_id =
+                    CHECK_NOTNULL(marker_msg_data)->intern_id(marker_data->args.roctxMarkA.message);
 
                 auto marker_record      = rocprofiler_buffer_tracing_marker_api_record_t{};
                 marker_record.size      = sizeof(rocprofiler_buffer_tracing_marker_api_record_t);
@@ -334,6 +328,7 @@ callback_tracing_callback(rocprofiler_callback_tracing_record_t record,
                 marker_record.operation = record.operation;
                 marker_record.thread_id = record.thread_id;
                 marker_record.correlation_id  = record.correlation_id;
+                marker_record.message_id      = msg_id;
                 marker_record.start_timestamp = ts;
                 marker_record.end_timestamp   = ts;
                 write_ring_buffer(marker_record, domain_type::MARKER);
@@ -345,13 +340,8 @@ callback_tracing_callback(rocprofiler_callback_tracing_record_t record,
             {
                 if(marker_data->args.roctxRangePushA.message)
                 {
-                    CHECK_NOTNULL(marker_msg_data)
-                        ->wlock(
-                            [](auto& _data, uint64_t _cid_v, std::string&& _msg) {
-                                _data.emplace(_cid_v, std::move(_msg));
-                            },
-                            record.correlation_id.internal,
-                            std::string{marker_data->args.roctxRangePushA.message});
+                    auto msg_id = CHECK_NOTNULL(marker_msg_data)
+                                      ->intern_id(marker_data->args.roctxRangePushA.message);
 
                     auto marker_record = rocprofiler_buffer_tracing_marker_api_record_t{};
                     marker_record.size = sizeof(rocprofiler_buffer_tracing_marker_api_record_t);
@@ -359,6 +349,7 @@ callback_tracing_callback(rocprofiler_callback_tracing_record_t record,
                     marker_record.operation       = record.operation;
                     marker_record.thread_id       = record.thread_id;
                     marker_record.correlation_id  = record.correlation_id;
+                    marker_record.message_id      = msg_id;
                     marker_record.start_timestamp = ts;
                     marker_record.end_timestamp   = 0;
 
@@ -386,13 +377,8 @@ callback_tracing_callback(rocprofiler_callback_tracing_record_t record,
             if(record.phase == ROCPROFILER_CALLBACK_PHASE_EXIT &&
                marker_data->args.roctxRangeStartA.message)
             {
-                CHECK_NOTNULL(marker_msg_data)
-                    ->wlock(
-                        [](auto& _data, uint64_t _cid_v, std::string&& _msg) {
-                            _data.emplace(_cid_v, std::move(_msg));
-                        },
-                        record.correlation_id.internal,
-                        std::string{marker_data->args.roctxRangeStartA.message});
+                auto msg_id = CHECK_NOTNULL(marker_msg_data)
+                                  ->intern_id(marker_data->args.roctxRangeStartA.message);
 
                 auto marker_record      = rocprofiler_buffer_tracing_marker_api_record_t{};
                 marker_record.size      = sizeof(rocprofiler_buffer_tracing_marker_api_record_t);
@@ -400,6 +386,7 @@ callback_tracing_callback(rocprofiler_callback_tracing_record_t record,
                 marker_record.operation = record.operation;
                 marker_record.thread_id = record.thread_id;
                 marker_record.correlation_id  = record.correlation_id;
+                marker_record.message_id      = msg_id;
                 marker_record.start_timestamp = ts;
                 marker_record.end_timestamp   = 0;
 
@@ -623,12 +610,37 @@ buffered_tracing_callback(rocprofiler_context_id_t /*context*/,
                     "unsupported category + kind: {} + {}", header->category, header->kind);
             }
         }
+        else if(header->category == ROCPROFILER_BUFFER_CATEGORY_COUNTERS)
+        {
+            // the counter values are stored separately from the dispatch header so the records
+            // are not limited in size. They are joined with their dispatch and kernel when the
+            // output is generated
+            if(header->kind == ROCPROFILER_COUNTER_RECORD_PROFILE_COUNTING_DISPATCH_HEADER)
+            {
+                auto* record =
+                    static_cast<rocprofiler_profile_counting_dispatch_record_t*>(header->payload);
+
+                write_ring_buffer(*record, domain_type::COUNTER_COLLECTION);
+            }
+            else if(header->kind == ROCPROFILER_COUNTER_RECORD_VALUE)
+            {
+                auto* record = static_cast<rocprofiler_record_counter_t*>(header->payload);
+
+                write_ring_buffer(rocprofiler_tool_counter_value_t{record->id,
+                                                                   record->counter_value,
+                                                                   record->dispatch_id},
+                                  domain_type::COUNTER_VALUES);
+            }
+            else
+            {
+                ROCP_FATAL << fmt::format(
+                    "unsupported category + kind: {} + {}", header->category, header->kind);
+            }
+        }
     }
 }
 
 using counter_vec_t = std::vector<rocprofiler_counter_id_t>;
-using agent_counter_map_t =
-    std::unordered_map<rocprofiler_agent_id_t, std::optional<rocprofiler_profile_config_id_t>>;
 
 rocprofiler_status_t
 dimensions_info_callback(rocprofiler_counter_id_t                   id,
@@ -770,107 +782,136 @@ get_agent_counter_info(const tool_agent_vec_t& _agents)
     return _data;
 }
 
-const tool_agent*
-get_tool_agent(rocprofiler_agent_id_t id, const tool_agent_vec_t& data)
+// counter requested by the user, optionally restricted to a GPU via the ':device=N' qualifier
+struct counter_request
 {
-    for(const auto& itr : data)
+    std::string_view       input     = {};
+    std::string_view       name      = {};
+    std::optional<int64_t> device_id = {};
+};
+
+auto
+get_counter_requests()
+{
+    constexpr auto device_qualifier = std::string_view{":device="};
+
+    auto _requests = std::vector<counter_request>{};
+    for(const auto& itr : tool::get_config().counters)
     {
-        if(id == itr.agent->id) return &itr;
+        auto _request = counter_request{itr, itr, std::nullopt};
+        if(auto pos = itr.find(device_qualifier); pos != std::string::npos)
+        {
+            auto dev_id_s = std::string_view{itr}.substr(pos + device_qualifier.length());
+
+            LOG_IF(FATAL,
+                   dev_id_s.empty() ||
+                       dev_id_s.find_first_not_of("0123456789") != std::string_view::npos)
+                << "invalid device qualifier format (':device=N) where N is the GPU id: " << itr;
+
+            _request.name      = std::string_view{itr}.substr(0, pos);
+            _request.device_id = std::stol(std::string{dev_id_s});
+        }
+        _requests.emplace_back(_request);
     }
+    return _requests;
+}
+
+// profile configs of the GPU agents indexed by the ordinal of the agent, i.e. its id relative
+// to the lowest GPU agent id. They are created in tool_init, before the context is started, so
+// dispatch_callback reads them without locking
+struct agent_profiles
+{
+    using profile_vec_t = std::vector<std::optional<rocprofiler_profile_config_id_t>>;
+
+    uint64_t      base     = 0;
+    profile_vec_t profiles = {};
+};
 
-    return nullptr;
+agent_profiles&
+get_agent_profiles()
+{
+    static auto _v = agent_profiles{};
+    return _v;
 }
 
-// this function creates a rocprofiler profile config on the first entry
-auto
-get_agent_profile(rocprofiler_agent_id_t agent_id)
+void
+create_agent_profiles()
 {
-    static auto       data                    = common::Synchronized<agent_counter_map_t>{};
-    static const auto gpu_agents              = get_gpu_agents();
-    static const auto gpu_agents_counter_info = get_agent_counter_info(gpu_agents);
-
-    auto profile = std::optional<rocprofiler_profile_config_id_t>{};
-    data.ulock(
-        [agent_id, &profile](const agent_counter_map_t& data_v) {
-            auto itr = data_v.find(agent_id);
-            if(itr != data_v.end())
-            {
-                profile = itr->second;
-                return true;
-            }
-            return false;
-        },
-        [agent_id, &profile](agent_counter_map_t& data_v) {
-            auto        counters_v   = counter_vec_t{};
-            auto        found_v      = std::vector<std::string_view>{};
-            const auto* tool_agent_v = get_tool_agent(agent_id, gpu_agents);
-            auto        expected_v   = tool::get_config().counters.size();
-
-            constexpr auto device_qualifier = std::string_view{":device="};
-            for(const auto& itr : tool::get_config().counters)
-            {
-                auto name_v = itr;
-                if(auto pos = std::string::npos;
-                   (pos = itr.find(device_qualifier)) != std::string::npos)
-                {
-                    name_v        = itr.substr(0, pos);
-                    auto dev_id_s = itr.substr(pos + device_qualifier.length());
-
-                    LOG_IF(FATAL,
-                           dev_id_s.empty() ||
-                               dev_id_s.find_first_not_of("0123456789") != std::string::npos)
-                        << "invalid device qualifier format (':device=N) where N is the GPU id: "
-                        << itr;
-
-                    auto dev_id_v = std::stol(dev_id_s);
-                    // skip this counter if the counter is for a specific device id (which doesn't
-                    // this agent's device id)
-                    if(dev_id_v != tool_agent_v->device_id)
-                    {
-                        --expected_v;  // is not expected
-                        continue;
-                    }
-                }
+    const auto gpu_agents              = get_gpu_agents();
+    const auto gpu_agents_counter_info = get_agent_counter_info(gpu_agents);
+    const auto requests                = get_counter_requests();
 
-                // search the gpu agent counter info for a counter with a matching name
-                for(const auto& citr : gpu_agents_counter_info.at(agent_id))
-                {
-                    if(name_v == std::string_view{citr.name})
-                    {
-                        counters_v.emplace_back(citr.id);
-                        found_v.emplace_back(itr);
-                    }
-                }
-            }
+    if(gpu_agents.empty()) return;
 
-            if(expected_v != counters_v.size())
+    auto& _data = get_agent_profiles();
+    auto  _last = uint64_t{0};
+    _data.base  = std::numeric_limits<uint64_t>::max();
+    for(const auto& itr : gpu_agents)
+    {
+        _data.base = std::min(_data.base, itr.agent->id.handle);
+        _last      = std::max(_last, itr.agent->id.handle);
+    }
+    _data.profiles.resize(_last - _data.base + 1);
+
+    for(const auto& itr : gpu_agents)
+    {
+        auto agent_id   = itr.agent->id;
+        auto counters_v = counter_vec_t{};
+        auto found_v    = std::vector<std::string_view>{};
+        auto expected_v = requests.size();
+
+        auto _counter_ids = std::unordered_map<std::string_view, rocprofiler_counter_id_t>{};
+        for(const auto& citr : gpu_agents_counter_info.at(agent_id))
+            _counter_ids.emplace(citr.name, citr.id);
+
+        for(const auto& ritr : requests)
+        {
+            // skip this counter if the counter is for a specific device id (which doesn't
+            // this agent's device id)
+            if(ritr.device_id && *ritr.device_id != itr.device_id)
             {
-                auto requested_counters = fmt::format("{}",
-                                                      fmt::join(tool::get_config().counters.begin(),
-                                                                tool::get_config().counters.end(),
-                                                                ", "));
-                auto found_counters =
-                    fmt::format("{}", fmt::join(found_v.begin(), found_v.end(), ", "));
-                LOG(FATAL) << "Unable to find all counters for agent "
-                           << tool_agent_v->agent->node_id << " (gpu-" << tool_agent_v->device_id
-                           << ", " << tool_agent_v->agent->name << ") in [" << requested_counters
-                           << "]. Found: [" << found_counters << "]";
+                --expected_v;  // is not expected
+                continue;
             }
 
-            if(!counters_v.empty())
+            if(const auto* counter_id = common::get_val(_counter_ids, ritr.name))
             {
-                auto profile_v = rocprofiler_profile_config_id_t{};
-                ROCPROFILER_CALL(rocprofiler_create_profile_config(
-                                     agent_id, counters_v.data(), counters_v.size(), &profile_v),
-                                 "Could not construct profile cfg");
-                profile = profile_v;
+                counters_v.emplace_back(*counter_id);
+                found_v.emplace_back(ritr.input);
             }
+        }
 
-            data_v.emplace(agent_id, profile);
-            return true;
-        });
+        if(expected_v != counters_v.size())
+        {
+            auto requested_counters = fmt::format("{}",
+                                                  fmt::join(tool::get_config().counters.begin(),
+                                                            tool::get_config().counters.end(),
+                                                            ", "));
+            auto found_counters =
+                fmt::format("{}", fmt::join(found_v.begin(), found_v.end(), ", "));
+            LOG(FATAL) << "Unable to find all counters for agent " << itr.agent->node_id
+                       << " (gpu-" << itr.device_id << ", " << itr.agent->name << ") in ["
+                       << requested_counters << "]. Found: [" << found_counters << "]";
+        }
 
-    return profile;
+        if(!counters_v.empty())
+        {
+            auto profile_v = rocprofiler_profile_config_id_t{};
+            ROCPROFILER_CALL(rocprofiler_create_profile_config(
+                                 agent_id, counters_v.data(), counters_v.size(), &profile_v),
+                             "Could not construct profile cfg");
+            _data.profiles.at(agent_id.handle - _data.base) = profile_v;
+        }
+    }
+}
+
+std::optional<rocprofiler_profile_config_id_t>
+get_agent_profile(rocprofiler_agent_id_t agent_id)
+{
+    const auto& _data = get_agent_profiles();
+    if(agent_id.handle < _data.base || agent_id.handle - _data.base >= _data.profiles.size())
+        return std::nullopt;
+    return _data.profiles[agent_id.handle - _data.base];
 }
 
 void
@@ -879,14 +920,8 @@ dispatch_callback(rocprofiler_profile_counting_dispatch_data_t dispatch_data,
                   rocprofiler_user_data_t*                     user_data,
                   void* /*callback_data_args*/)
 {
-    auto kernel_id = dispatch_data.dispatch_info.kernel_id;
-    auto agent_id  = dispatch_data.dispatch_info.agent_id;
-
-    if(!is_targeted_kernel(kernel_id))
-    {
-        return;
-    }
-    else if(auto profile = get_agent_profile(agent_id))
+    // the kernels which are not targeted are excluded by the dispatch filter of the context
+    if(auto profile = get_agent_profile(dispatch_data.dispatch_info.agent_id))
     {
         *config          = *profile;
         user_data->value = common::get_tid();
@@ -908,57 +943,6 @@ get_counter_info_name(uint64_t record_id)
     return counter_name;
 }
 
-void
-counter_record_callback(rocprofiler_profile_counting_dispatch_data_t dispatch_data,
-                        rocprofiler_record_counter_t*                record_data,
-                        size_t                                       record_count,
-                        rocprofiler_user_data_t                      user_data,
-                        void* /*callback_data_args*/)
-{
-    static const auto gpu_agents              = get_gpu_agents();
-    static const auto gpu_agents_counter_info = get_agent_counter_info(gpu_agents);
-
-    auto counter_record = rocprofiler_tool_counter_collection_record_t{};
-    auto kernel_id      = dispatch_data.dispatch_info.kernel_id;
-
-    counter_record.dispatch_data = dispatch_data;
-    counter_record.thread_id     = user_data.value;
-
-    const kernel_symbol_data* kernel_info =
-        kernel_data->rlock([kernel_id](const auto& _data) { return &_data.at(kernel_id); });
-
-    auto lds_block_size_v =
-        (kernel_info->group_segment_size + (lds_block_size - 1)) & ~(lds_block_size - 1);
-
-    counter_record.arch_vgpr_count  = kernel_info->arch_vgpr_count;
-    counter_record.sgpr_count       = kernel_info->sgpr_count;
-    counter_record.lds_block_size_v = lds_block_size_v;
-
-    ROCP_FATAL_IF(!kernel_info) << "missing kernel information for kernel_id=" << kernel_id;
-
-    ROCP_ERROR_IF(record_count == 0) << "zero record count for kernel_id=" << kernel_id
-                                     << " (name=" << kernel_info->kernel_name << ")";
-
-    for(size_t count = 0; count < record_count; count++)
-    {
-        // Unlikely to trigger, temporary until we move to buffered callbacks
-        if(count >= counter_record.records.size())
-        {
-            ROCP_WARNING << "Exceeded maximum counter capacity, skipping remaining";
-            break;
-        }
-
-        auto _counter_id = rocprofiler_counter_id_t{};
-        ROCPROFILER_CALL(rocprofiler_query_record_counter_id(record_data[count].id, &_counter_id),
-                         "query record counter id");
-        counter_record.records[count] =
-            rocprofiler_tool_record_counter_t{_counter_id, record_data[count]};
-        counter_record.counter_count++;
-    }
-
-    write_ring_buffer(counter_record, domain_type::COUNTER_COLLECTION);
-}
-
 rocprofiler_status_t
 list_metrics_iterate_agents(rocprofiler_agent_version_t,
                             const void** agents,
@@ -1319,10 +1303,38 @@ tool_init(rocprofiler_client_finalize_t fini_func, void* tool_data)
 
     if(tool::get_config().counter_collection)
     {
+        create_agent_profiles();
+
+        ROCPROFILER_CALL(rocprofiler_create_buffer(get_client_ctx(),
+                                                   buffer_size,
+                                                   buffer_watermark,
+                                                   ROCPROFILER_BUFFER_POLICY_LOSSLESS,
+                                                   buffered_tracing_callback,
+                                                   tool_data,
+                                                   &get_buffers().counter_collection),
+                         "buffer creation");
+
         ROCPROFILER_CALL(
-            rocprofiler_configure_callback_dispatch_profile_counting_service(
-                get_client_ctx(), dispatch_callback, nullptr, counter_record_callback, nullptr),
+            rocprofiler_configure_buffered_dispatch_profile_counting_service(
+                get_client_ctx(), get_buffers().counter_collection, dispatch_callback, nullptr),
             "Could not setup counting service");
+
+        // when kernels are selected by name, the SDK resolves the targeted kernels once at code
+        // object load (after code_object_tracing_callback) and the dispatches of the other
+        // kernels do not invoke dispatch_callback
+        if(!tool::get_config().kernel_names.empty())
+        {
+            auto dispatch_filter          = rocprofiler_profile_counting_dispatch_filter_t{};
+            dispatch_filter.size          = sizeof(rocprofiler_profile_counting_dispatch_filter_t);
+            dispatch_filter.kernel_filter =
+                [](rocprofiler_kernel_id_t kernel_id, const char*, void*) {
+                    return (is_targeted_kernel(kernel_id)) ? 1 : 0;
+                };
+            ROCPROFILER_CALL(
+                rocprofiler_configure_dispatch_profile_counting_filter(get_client_ctx(),
+                                                                       dispatch_filter),
+                "Could not setup counting service dispatch filter");
+        }
     }
 
     for(auto itr : get_buffers().as_array())
@@ -1380,6 +1392,69 @@ generate_output(rocprofiler::tool::buffered_output<Tp, DomainT>& output_v,
     }
 }
 
+// joins the dispatch header records with their counter values and the metadata of their kernel
+std::deque<rocprofiler_tool_counter_collection_record_t>
+get_counter_collection_records(
+    const std::deque<rocprofiler_profile_counting_dispatch_record_t>& headers,
+    const std::deque<rocprofiler_tool_counter_value_t>&               values)
+{
+    auto _data     = std::deque<rocprofiler_tool_counter_collection_record_t>{};
+    auto _dispatch = std::unordered_map<rocprofiler_dispatch_id_t, size_t>{};
+    auto _kernels  = get_kernel_symbol_data();
+
+    for(const auto& itr : headers)
+    {
+        auto kernel_id = itr.dispatch_info.kernel_id;
+        ROCP_FATAL_IF(kernel_id >= _kernels.size() || _kernels.at(kernel_id).kernel_id != kernel_id)
+            << "missing kernel information for kernel_id=" << kernel_id;
+
+        const auto& kernel_info = _kernels.at(kernel_id);
+        auto        _record     = rocprofiler_tool_counter_collection_record_t{};
+
+        _record.dispatch_data =
+            common::init_public_api_struct(rocprofiler_profile_counting_dispatch_data_t{});
+        _record.dispatch_data.correlation_id = itr.correlation_id;
+        _record.dispatch_data.dispatch_info  = itr.dispatch_info;
+        _record.dispatch_data.sample_weight  = itr.sample_weight;
+
+        _record.thread_id       = itr.user_data.value;
+        _record.arch_vgpr_count = kernel_info.arch_vgpr_count;
+        _record.sgpr_count      = kernel_info.sgpr_count;
+        _record.lds_block_size_v =
+            (kernel_info.group_segment_size + (lds_block_size - 1)) & ~(lds_block_size - 1);
+        _record.records.reserve(itr.num_records);
+
+        _dispatch.emplace(itr.dispatch_info.dispatch_id, _data.size());
+        _data.emplace_back(std::move(_record));
+    }
+
+    for(const auto& itr : values)
+    {
+        const auto* idx = common::get_val(_dispatch, itr.dispatch_id);
+        if(!idx)
+        {
+            ROCP_WARNING << "missing dispatch header for counter record of dispatch_id="
+                         << itr.dispatch_id;
+            continue;
+        }
+
+        auto _counter_id = rocprofiler_counter_id_t{};
+        ROCPROFILER_CALL(rocprofiler_query_record_counter_id(itr.id, &_counter_id),
+                         "query record counter id");
+
+        auto& _record = _data.at(*idx);
+        auto  _value  = rocprofiler_record_counter_t{};
+
+        _value.id              = itr.id;
+        _value.counter_value   = itr.value;
+        _value.dispatch_id     = itr.dispatch_id;
+        _value.user_data.value = _record.thread_id;
+        _record.records.emplace_back(rocprofiler_tool_record_counter_t{_counter_id, _value});
+    }
+
+    return _data;
+}
+
 void
 tool_fini(void* /*tool_data*/)
 {
@@ -1403,6 +1478,8 @@ tool_fini(void* /*tool_data*/)
     auto marker_output      = marker_buffered_output_t{tool::get_config().marker_api_trace};
     auto counters_output =
         counter_collection_buffered_output_t{tool::get_config().counter_collection};
+    auto counter_values_output =
+        counter_values_buffered_output_t{tool::get_config().counter_collection};
     auto scratch_memory_output =
         scratch_memory_buffered_output_t{tool::get_config().scratch_memory};
 
@@ -1429,9 +1506,22 @@ tool_fini(void* /*tool_data*/)
     generate_output(hip_output, contributions);
     generate_output(memory_copy_output, contributions);
     generate_output(marker_output, contributions);
-    generate_output(counters_output, contributions);
     generate_output(scratch_memory_output, contributions);
 
+    counters_output.read();
+    counter_values_output.read();
+    auto counter_collection_data = get_counter_collection_records(
+        counters_output.element_data, counter_values_output.element_data);
+    counters_output.clear();
+    counter_values_output.clear();
+
+    if(counters_output && tool::get_config().csv_output)
+    {
+        counters_output.stats =
+            rocprofiler::tool::generate_csv(tool_functions, counter_collection_data);
+        contributions.emplace(counters_output.buffer_type_v, counters_output.stats);
+    }
+
     if(tool::get_config().stats && tool::get_config().csv_output)
     {
         rocprofiler::tool::generate_csv(tool_functions, contributions);
@@ -1447,7 +1537,7 @@ tool_fini(void* /*tool_data*/)
                                       &hsa_output.element_data,
                                       &kernel_dispatch_output.element_data,
                                       &memory_copy_output.element_data,
-                                      &counters_output.element_data,
+                                      &counter_collection_data,
                                       &marker_output.element_data,
                                       &scratch_memory_output.element_data);
     }
@@ -1473,6 +1563,7 @@ tool_fini(void* /*tool_data*/)
     destroy_output(memory_copy_output);
     destroy_output(marker_output);
     destroy_output(counters_output);
+    destroy_output(counter_values_output);
     destroy_output(scratch_memory_output);
 
     fini_tool_table();
@@ -1491,12 +1582,15 @@ tool_fini(void* /*tool_data*/)
 }  // namespace
 
 std::map<uint64_t, std::string>
-get_callback_roctx_msg()
+get_callback_roctx_msg(const std::deque<rocprofiler_buffer_tracing_marker_api_record_t>& data)
 {
-    auto _data = marker_msg_data->rlock([](const auto& _data_v) { return _data_v; });
-    auto _ret  = std::map<uint64_t, std::string>{};
-    for(const auto& itr : _data)
-        _ret.emplace(itr.first, itr.second);
+    auto _ret = std::map<uint64_t, std::string>{};
+    for(const auto& itr : data)
+    {
+        if(itr.message_id == 0) continue;
+        _ret.emplace(itr.correlation_id.internal,
+                     std::string{CHECK_NOTNULL(marker_msg_data)->lookup(itr.message_id)});
+    }
     return _ret;
 }
 
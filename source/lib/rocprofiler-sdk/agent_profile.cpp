@@ -47,4 +47,27 @@ rocprofiler_sample_agent_profile_counting_service(rocprofiler_context_id_t   con
     return rocprofiler::counters::read_agent_ctx(
         rocprofiler::context::get_registered_context(context_id), user_data, flags);
 }
+
+rocprofiler_status_t ROCPROFILER_API
+rocprofiler_submit_agent_profile_counting_sample(rocprofiler_context_id_t   context_id,
+                                                 rocprofiler_user_data_t    user_data,
+                                                 rocprofiler_counter_flag_t flags,
+                                                 uint64_t*                  sample_id)
+{
+    if(flags != ROCPROFILER_COUNTER_FLAG_ASYNC_COALESCE) flags = ROCPROFILER_COUNTER_FLAG_ASYNC;
+    // never waits for a read slot: OUT_OF_RESOURCES is returned when every slot is in flight
+    return rocprofiler::counters::read_agent_ctx(
+        rocprofiler::context::get_registered_context(context_id),
+        user_data,
+        flags,
+        sample_id,
+        false);
+}
+
+rocprofiler_status_t ROCPROFILER_API
+rocprofiler_configure_agent_profile_sampling_interval(rocprofiler_context_id_t context_id,
+                                                      uint64_t                 interval_ns)
+{
+    return rocprofiler::counters::configure_agent_sampling(context_id, interval_ns);
+}
 }
\ No newline at end of file
@@ -22,12 +22,17 @@
 
 #include "lib/rocprofiler-sdk/aql/packet_construct.hpp"
 #include "lib/common/logging.hpp"
+#include "lib/rocprofiler-sdk/counters/id_decode.hpp"
 #include "lib/rocprofiler-sdk/hsa/details/fmt.hpp"
 
 #include <fmt/core.h>
 #include <hsa/hsa_ext_amd.h>
+#include <rocprofiler-sdk/rocprofiler.h>
 #include "glog/logging.h"
 
+#include <algorithm>
+#include <numeric>
+
 #define CHECK_HSA(fn, message)                                                                     \
     {                                                                                              \
         auto status = (fn);                                                                        \
@@ -95,18 +100,34 @@ CounterPacketConstruct::CounterPacketConstruct(rocprofiler_agent_id_t
     // with a single AQL packet
     can_collect();
     _events = get_all_events();
+
+    auto counter_events = counters::SampleDecoder::counter_events_t{};
+    for(const auto& metric : _metrics)
+        counter_events.emplace_back(metric.metric.id(), metric.instances);
+
+    // Only used to compute the layout of the output, i.e. once per sample of the first packet
+    auto instance_id = [agent](uint64_t                              counter_id,
+                               const hsa_ven_amd_aqlprofile_event_t& event,
+                               uint32_t                              sample_id) {
+        const auto* agent_cache = CHECK_NOTNULL(rocprofiler::agent::get_agent_cache(
+            CHECK_NOTNULL(rocprofiler::agent::get_agent(agent))));
+
+        rocprofiler_counter_instance_id_t id = 0;
+        counters::set_counter_in_rec(id, {.handle = counter_id});
+        auto status = set_dim_id_from_sample(id, agent_cache->get_hsa_agent(), event, sample_id);
+        ROCP_FATAL_IF(status != ROCPROFILER_STATUS_SUCCESS)
+            << "Could not get the dimensions of sample " << sample_id << " of counter "
+            << counter_id << ": " << rocprofiler_get_status_string(status);
+        return id;
+    };
+
+    _decoder = std::make_unique<counters::SampleDecoder>(
+        counter_events, hsa_ven_amd_aqlprofile_iterate_data, std::move(instance_id));
 }
 
-std::unique_ptr<hsa::CounterAQLPacket>
-CounterPacketConstruct::construct_packet(const AmdExtTable& ext)
+const hsa::AgentCache&
+CounterPacketConstruct::init_profile(const AmdExtTable& ext, hsa::CounterAQLPacket& pkt) const
 {
-    auto  pkt_ptr = std::make_unique<hsa::CounterAQLPacket>(ext.hsa_amd_memory_pool_free_fn);
-    auto& pkt     = *pkt_ptr;
-    if(_events.empty())
-    {
-        ROCP_TRACE << "No events for pkt";
-        return pkt_ptr;
-    }
     pkt.empty = false;
 
     const auto* agent_cache =
@@ -151,6 +172,44 @@ CounterPacketConstruct::construct_packet(const AmdExtTable& ext)
                         profile.output_buffer.size));
     }
 
+    return *agent_cache;
+}
+
+void
+CounterPacketConstruct::arm_packet(hsa::CounterAQLPacket& pkt) const
+{
+    auto& profile = pkt.profile;
+    memset(profile.output_buffer.ptr, 0x0, profile.output_buffer.size);
+
+    CHECK_HSA(hsa_ven_amd_aqlprofile_start(&profile, &pkt.start), "failed to create start packet");
+    CHECK_HSA(hsa_ven_amd_aqlprofile_stop(&profile, &pkt.stop), "failed to create stop packet");
+    CHECK_HSA(hsa_ven_amd_aqlprofile_read(&profile, &pkt.read), "failed to create read packet");
+    pkt.start.header = HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE;
+    pkt.stop.header  = HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE;
+    pkt.read.header  = HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE;
+    ROCP_TRACE << fmt::format("Following Packets Generated (output_buffer={}, output_size={}). "
+                              "Start Pkt: {}, Read Pkt: {}, Stop Pkt: {}",
+                              profile.output_buffer.ptr,
+                              profile.output_buffer.size,
+                              pkt.start,
+                              pkt.read,
+                              pkt.stop);
+}
+
+std::unique_ptr<hsa::CounterAQLPacket>
+CounterPacketConstruct::construct_packet(const AmdExtTable& ext)
+{
+    auto  pkt_ptr = std::make_unique<hsa::CounterAQLPacket>(ext.hsa_amd_memory_pool_free_fn);
+    auto& pkt     = *pkt_ptr;
+    if(_events.empty())
+    {
+        ROCP_TRACE << "No events for pkt";
+        return pkt_ptr;
+    }
+
+    const auto* agent_cache = &init_profile(ext, pkt);
+    auto&       profile     = pkt.profile;
+
     // Allocate buffers and check the results
     auto alloc_and_check = [&](auto& pool, auto** mem_loc, auto size) -> bool {
         bool   malloced     = false;
@@ -180,24 +239,53 @@ CounterPacketConstruct::construct_packet(const AmdExtTable& ext)
         agent_cache->cpu_pool(), &profile.command_buffer.ptr, profile.command_buffer.size);
     pkt.output_buffer_malloced = alloc_and_check(
         agent_cache->kernarg_pool(), &profile.output_buffer.ptr, profile.output_buffer.size);
-    memset(profile.output_buffer.ptr, 0x0, profile.output_buffer.size);
 
-    CHECK_HSA(hsa_ven_amd_aqlprofile_start(&profile, &pkt.start), "failed to create start packet");
-    CHECK_HSA(hsa_ven_amd_aqlprofile_stop(&profile, &pkt.stop), "failed to create stop packet");
-    CHECK_HSA(hsa_ven_amd_aqlprofile_read(&profile, &pkt.read), "failed to create read packet");
-    pkt.start.header = HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE;
-    pkt.stop.header  = HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE;
-    pkt.read.header  = HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE;
-    ROCP_TRACE << fmt::format("Following Packets Generated (output_buffer={}, output_size={}). "
-                              "Start Pkt: {}, Read Pkt: {}, Stop Pkt: {}",
-                              profile.output_buffer.ptr,
-                              profile.output_buffer.size,
-                              pkt.start,
-                              pkt.read,
-                              pkt.stop);
+    arm_packet(pkt);
     return pkt_ptr;
 }
 
+std::vector<std::unique_ptr<hsa::CounterAQLPacket>>
+CounterPacketConstruct::construct_packets(const AmdExtTable& ext, size_t count)
+{
+    auto ret = std::vector<std::unique_ptr<hsa::CounterAQLPacket>>{};
+    if(count == 0) return ret;
+
+    ret.reserve(count);
+    if(_events.empty())
+    {
+        ROCP_TRACE << "No events for pkt";
+        for(size_t i = 0; i < count; ++i)
+            ret.emplace_back(std::make_unique<hsa::CounterAQLPacket>(nullptr));
+        return ret;
+    }
+
+    // The profile (and buffer sizes) are identical for every packet of the block
+    auto        proto       = hsa::CounterAQLPacket{nullptr};
+    const auto& agent_cache = init_profile(ext, proto);
+
+    auto block = std::make_shared<hsa::CounterBufferBlock>(ext,
+                                                           agent_cache.get_hsa_agent(),
+                                                           agent_cache.cpu_pool(),
+                                                           agent_cache.kernarg_pool(),
+                                                           proto.profile.command_buffer.size,
+                                                           proto.profile.output_buffer.size,
+                                                           count);
+    for(size_t i = 0; i < count; ++i)
+    {
+        auto& pkt            = ret.emplace_back(std::make_unique<hsa::CounterAQLPacket>(block, i));
+        auto  command_buffer = pkt->profile.command_buffer;
+        auto  output_buffer  = pkt->profile.output_buffer;
+
+        pkt->profile                = proto.profile;
+        pkt->profile.command_buffer = command_buffer;
+        pkt->profile.output_buffer  = output_buffer;
+        pkt->empty                  = false;
+        arm_packet(*pkt);
+    }
+
+    return ret;
+}
+
 ThreadTraceAQLPacketFactory::ThreadTraceAQLPacketFactory(const hsa::AgentCache&             agent,
                                                          const thread_trace_parameter_pack& params,
                                                          const CoreApiTable&                coreapi,
@@ -282,6 +370,112 @@ CounterPacketConstruct::get_counter_events(const counters::Metric& metric) const
     throw std::runtime_error(fmt::format("Cannot Find Events for {}", metric));
 }
 
+std::vector<std::vector<counters::Metric>>
+CounterPacketConstruct::partition(rocprofiler_agent_id_t               agent,
+                                  const std::vector<counters::Metric>& metrics)
+{
+    auto counter_events = std::vector<std::vector<aqlprofile_pmc_event_t>>{};
+    for(const auto& x : metrics)
+    {
+        auto     query_info = get_query_info(agent, x);
+        uint32_t event_id   = std::atoi(x.event().c_str());
+        auto&    events     = counter_events.emplace_back();
+        for(unsigned block_index = 0; block_index < query_info.instance_count; ++block_index)
+        {
+            events.push_back(
+                {.block_index = block_index,
+                 .event_id    = event_id,
+                 .flags       = aqlprofile_pmc_event_flags_t{0},
+                 .block_name  = static_cast<hsa_ven_amd_aqlprofile_block_name_t>(query_info.id)});
+        }
+    }
+
+    auto passes = partition_counter_events(counter_events, [agent](const auto& event) {
+        return get_block_counters(agent, event);
+    });
+
+    auto ret = std::vector<std::vector<counters::Metric>>{};
+    for(const auto& pass : passes)
+    {
+        auto& group = ret.emplace_back();
+        for(auto idx : pass)
+            group.emplace_back(metrics.at(idx));
+    }
+    return ret;
+}
+
+std::vector<std::vector<size_t>>
+partition_counter_events(const std::vector<std::vector<aqlprofile_pmc_event_t>>& counter_events,
+                         const block_counters_func_t&                            block_counters)
+{
+    using block_instance_t = std::pair<hsa_ven_amd_aqlprofile_block_name_t, uint32_t>;
+    using block_count_t    = std::map<block_instance_t, int64_t>;
+
+    block_count_t                    max_allowed;
+    std::vector<block_count_t>       pass_counts;
+    std::vector<std::vector<size_t>> passes;
+
+    // Place the counters using the most block instances first
+    auto order = std::vector<size_t>(counter_events.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return counter_events.at(lhs).size() > counter_events.at(rhs).size();
+    });
+
+    for(auto idx : order)
+    {
+        block_count_t counter_count;
+        for(const auto& event : counter_events.at(idx))
+        {
+            auto block_pair = std::make_pair(event.block_name, event.block_index);
+            counter_count[block_pair]++;
+            if(max_allowed.count(block_pair) == 0)
+                max_allowed.emplace(block_pair, block_counters(event));
+        }
+
+        for(const auto& [block_pair, count] : counter_count)
+        {
+            if(count > max_allowed.at(block_pair))
+            {
+                throw std::runtime_error(
+                    fmt::format("Block {} exceeds max number of hardware counters ({} > {})",
+                                static_cast<int64_t>(block_pair.first),
+                                count,
+                                max_allowed.at(block_pair)));
+            }
+        }
+
+        auto fits = [&](const block_count_t& pass_count) {
+            for(const auto& [block_pair, count] : counter_count)
+            {
+                const auto* used = common::get_val(pass_count, block_pair);
+                if((used ? *used : 0) + count > max_allowed.at(block_pair)) return false;
+            }
+            return true;
+        };
+
+        size_t pass = 0;
+        while(pass < passes.size() && !fits(pass_counts.at(pass)))
+            ++pass;
+
+        if(pass == passes.size())
+        {
+            passes.emplace_back();
+            pass_counts.emplace_back();
+        }
+
+        passes.at(pass).emplace_back(idx);
+        for(const auto& [block_pair, count] : counter_count)
+            pass_counts.at(pass)[block_pair] += count;
+    }
+
+    // Keep the order of the counters within a pass
+    for(auto& itr : passes)
+        std::sort(itr.begin(), itr.end());
+
+    return passes;
+}
+
 void
 CounterPacketConstruct::can_collect()
 {
@@ -24,6 +24,7 @@
 
 #include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include <hsa/hsa.h>
@@ -33,6 +34,7 @@
 #include "lib/rocprofiler-sdk/aql/aql_profile_v2.h"
 #include "lib/rocprofiler-sdk/aql/helpers.hpp"
 #include "lib/rocprofiler-sdk/counters/metrics.hpp"
+#include "lib/rocprofiler-sdk/counters/sample_decode.hpp"
 #include "lib/rocprofiler-sdk/hsa/agent_cache.hpp"
 #include "lib/rocprofiler-sdk/hsa/queue.hpp"
 #include "lib/rocprofiler-sdk/thread_trace/att_core.hpp"
@@ -55,6 +57,10 @@ public:
     CounterPacketConstruct(rocprofiler_agent_id_t               agent,
                            const std::vector<counters::Metric>& metrics);
     std::unique_ptr<hsa::CounterAQLPacket> construct_packet(const AmdExtTable&);
+    // Constructs count packets whose command and output buffers are the slots of a single
+    // hsa::CounterBufferBlock, i.e. two allocations (and access grants) for all the packets
+    std::vector<std::unique_ptr<hsa::CounterAQLPacket>> construct_packets(const AmdExtTable&,
+                                                                          size_t count);
 
     const counters::Metric* event_to_metric(const hsa_ven_amd_aqlprofile_event_t& event) const;
     std::vector<hsa_ven_amd_aqlprofile_event_t> get_all_events() const;
@@ -62,12 +68,27 @@ public:
 
     rocprofiler_agent_id_t agent() const { return _agent; }
 
+    // Decoder of the output of the packets, shared by every packet constructed
+    const counters::SampleDecoder& decoder() const { return *_decoder; }
+
+    // Splits the metrics into the groups of metrics collected by a single packet (see
+    // partition_counter_events). Each group can be used to construct a CounterPacketConstruct
+    static std::vector<std::vector<counters::Metric>> partition(
+        rocprofiler_agent_id_t               agent,
+        const std::vector<counters::Metric>& metrics);
+
 private:
     static constexpr size_t MEM_PAGE_ALIGN = 0x1000;
     static constexpr size_t MEM_PAGE_MASK  = MEM_PAGE_ALIGN - 1;
     static size_t getPageAligned(size_t p) { return (p + MEM_PAGE_MASK) & ~MEM_PAGE_MASK; }
 
 protected:
+    // Sets the profile of the packet and its buffer sizes. Returns the cache of the agent
+    const hsa::AgentCache& init_profile(const AmdExtTable&, hsa::CounterAQLPacket&) const;
+    // Zeroes the output buffer and generates the start/stop/read packets for the buffers of
+    // the profile
+    void arm_packet(hsa::CounterAQLPacket&) const;
+
     struct AQLProfileMetric
     {
         counters::Metric                            metric;
@@ -82,8 +103,26 @@ protected:
     std::vector<hsa_ven_amd_aqlprofile_event_t> _events;
     std::map<std::tuple<hsa_ven_amd_aqlprofile_block_name_t, uint32_t, uint32_t>, counters::Metric>
         _event_to_metric;
+    std::unique_ptr<counters::SampleDecoder> _decoder;
 };
 
+using block_counters_func_t = std::function<uint32_t(const aqlprofile_pmc_event_t&)>;
+
+/**
+ * Partitions counters whose events exceed the hardware counters of a block into passes, i.e.
+ * groups of counters which can be collected at the same time. The events of a counter are never
+ * split across passes. Counters are assigned first-fit, in decreasing order of their number of
+ * events, to the first pass where every block instance they use has a free hardware counter.
+ *
+ * @param [in] counter_events Events (one per block instance) of every counter
+ * @param [in] block_counters Returns the number of hardware counters of the block of an event
+ * @return Indices in counter_events of the counters of every pass
+ * @throws std::runtime_error if a counter does not fit in a pass on its own
+ */
+std::vector<std::vector<size_t>>
+partition_counter_events(const std::vector<std::vector<aqlprofile_pmc_event_t>>& counter_events,
+                         const block_counters_func_t&                            block_counters);
+
 class ThreadTraceAQLPacketFactory
 {
 public:
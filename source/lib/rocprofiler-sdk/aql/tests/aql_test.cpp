@@ -22,8 +22,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <functional>
 #include <map>
+#include <random>
 #include <unordered_set>
 
 #include <hsa/hsa.h>
@@ -225,3 +227,151 @@ TEST(aql_profile, test_aql_packet)
     // Why is this valid?
     TestAqlPacket test_pkt2(false);
 }
+
+namespace
+{
+using counter_events_t = std::vector<std::vector<aqlprofile_pmc_event_t>>;
+
+// Mocked number of hardware counters per block
+const std::map<hsa_ven_amd_aqlprofile_block_name_t, uint32_t> mock_block_counters = {
+    {HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_SQ, 8},
+    {HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_TA, 2},
+    {HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_TCC, 4},
+    {HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_GRBM, 0}};
+
+uint32_t
+get_mock_block_counters(const aqlprofile_pmc_event_t& event)
+{
+    return mock_block_counters.at(event.block_name);
+}
+
+// Events of a counter on the given number of instances of the block
+std::vector<aqlprofile_pmc_event_t>
+make_counter(hsa_ven_amd_aqlprofile_block_name_t block, uint32_t event_id, uint32_t instances)
+{
+    auto ret = std::vector<aqlprofile_pmc_event_t>{};
+    for(uint32_t i = 0; i < instances; ++i)
+    {
+        ret.push_back({.block_index = i,
+                       .event_id    = event_id,
+                       .flags       = aqlprofile_pmc_event_flags_t{0},
+                       .block_name  = block});
+    }
+    return ret;
+}
+
+// Checks that every counter is in exactly one pass and that no pass exceeds the block limits
+void
+check_passes(const counter_events_t& counters, const std::vector<std::vector<size_t>>& passes)
+{
+    auto seen = std::vector<size_t>(counters.size(), 0);
+    for(const auto& pass : passes)
+    {
+        EXPECT_FALSE(pass.empty());
+        auto counts =
+            std::map<std::pair<hsa_ven_amd_aqlprofile_block_name_t, uint32_t>, uint32_t>{};
+        for(auto idx : pass)
+        {
+            ASSERT_LT(idx, counters.size());
+            ++seen.at(idx);
+            for(const auto& event : counters.at(idx))
+                ++counts[{event.block_name, event.block_index}];
+        }
+        for(const auto& [block, count] : counts)
+            EXPECT_LE(count, mock_block_counters.at(block.first));
+    }
+    for(size_t i = 0; i < seen.size(); ++i)
+        EXPECT_EQ(seen.at(i), 1) << "counter " << i;
+}
+}  // namespace
+
+TEST(aql_profile, partition_single_pass)
+{
+    auto counters = counter_events_t{};
+    for(uint32_t i = 0; i < 8; ++i)
+        counters.emplace_back(make_counter(HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_SQ, i, 4));
+    counters.emplace_back(make_counter(HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_TA, 0, 16));
+
+    auto passes = partition_counter_events(counters, get_mock_block_counters);
+    ASSERT_EQ(passes.size(), 1);
+    check_passes(counters, passes);
+
+    EXPECT_TRUE(partition_counter_events({}, get_mock_block_counters).empty());
+}
+
+TEST(aql_profile, partition_oversubscribed)
+{
+    // 20 SQ counters with 8 hardware counters and 5 TA counters with 2 hardware counters: the
+    // TA block needs the most passes
+    auto counters = counter_events_t{};
+    for(uint32_t i = 0; i < 20; ++i)
+        counters.emplace_back(make_counter(HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_SQ, i, 4));
+    for(uint32_t i = 0; i < 5; ++i)
+        counters.emplace_back(make_counter(HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_TA, i, 16));
+
+    auto passes = partition_counter_events(counters, get_mock_block_counters);
+    EXPECT_EQ(passes.size(), 3);
+    check_passes(counters, passes);
+
+    // the counters of a pass are in the order they were provided
+    for(const auto& pass : passes)
+        EXPECT_TRUE(std::is_sorted(pass.begin(), pass.end()));
+}
+
+TEST(aql_profile, partition_block_instances)
+{
+    // counters only use the block instances they are collected on: 4 counters on the first
+    // instance of TCC and 4 counters on every instance fit in 2 passes
+    auto counters = counter_events_t{};
+    for(uint32_t i = 0; i < 4; ++i)
+        counters.emplace_back(make_counter(HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_TCC, i, 1));
+    for(uint32_t i = 4; i < 8; ++i)
+        counters.emplace_back(make_counter(HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_TCC, i, 16));
+
+    auto passes = partition_counter_events(counters, get_mock_block_counters);
+    EXPECT_EQ(passes.size(), 2);
+    check_passes(counters, passes);
+}
+
+TEST(aql_profile, partition_lower_bound)
+{
+    // with counters on a single block each, the number of passes is the number of passes
+    // needed by the most oversubscribed block
+    auto rng    = std::default_random_engine{};
+    auto blocks = std::vector<hsa_ven_amd_aqlprofile_block_name_t>{
+        HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_SQ,
+        HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_TA,
+        HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_TCC};
+
+    for(size_t iter = 0; iter < 100; ++iter)
+    {
+        auto counters   = counter_events_t{};
+        auto num_blocks = std::map<hsa_ven_amd_aqlprofile_block_name_t, size_t>{};
+        auto num        = std::uniform_int_distribution<size_t>{1, 64}(rng);
+        for(size_t i = 0; i < num; ++i)
+        {
+            auto block     = blocks.at(std::uniform_int_distribution<size_t>{0, 2}(rng));
+            auto instances = std::uniform_int_distribution<uint32_t>{1, 16}(rng);
+            counters.emplace_back(make_counter(block, i, instances));
+            ++num_blocks[block];
+        }
+
+        size_t min_passes = 0;
+        for(const auto& [block, count] : num_blocks)
+        {
+            auto max   = mock_block_counters.at(block);
+            min_passes = std::max<size_t>(min_passes, (count + max - 1) / max);
+        }
+
+        auto passes = partition_counter_events(counters, get_mock_block_counters);
+        EXPECT_EQ(passes.size(), min_passes);
+        check_passes(counters, passes);
+    }
+}
+
+TEST(aql_profile, partition_counter_too_large)
+{
+    // a counter which does not fit in a pass on its own cannot be collected
+    auto counters = counter_events_t{make_counter(HSA_VEN_AMD_AQLPROFILE_BLOCK_NAME_GRBM, 0, 1)};
+    EXPECT_THROW(partition_counter_events(counters, get_mock_block_counters), std::runtime_error);
+}
@@ -23,6 +23,7 @@
 #include "lib/rocprofiler-sdk/buffer.hpp"
 
 #include "lib/common/container/stable_vector.hpp"
+#include "lib/common/environment.hpp"
 #include "lib/common/static_object.hpp"
 #include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
@@ -35,10 +36,16 @@
 #include <rocprofiler-sdk/fwd.h>
 #include <rocprofiler-sdk/rocprofiler.h>
 
+#include <pthread.h>
+
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <exception>
 #include <mutex>
 #include <random>
+#include <thread>
 #include <vector>
 
 namespace rocprofiler
@@ -56,6 +63,148 @@ get_buffers_mutex()
     return _v;
 }
 
+/**
+ * Background thread which requests a flush of the buffers whose records have been waiting longer
+ * than the max latency of their flush policy. Low-rate buffers would otherwise hold records
+ * below the watermark indefinitely.
+ */
+struct flush_timer
+{
+    explicit flush_timer(uint64_t _interval);
+    ~flush_timer() = default;
+
+    void start();
+    void stop();
+    void run();
+    void update_interval(uint64_t _interval);
+
+    std::mutex              mutex    = {};
+    std::condition_variable cv       = {};
+    bool                    stopped  = false;
+    uint64_t                interval = 0;
+    std::thread             thread   = {};
+};
+
+flush_timer*&
+get_flush_timer()
+{
+    static flush_timer* _v = nullptr;
+    return _v;
+}
+
+// serializes the start of the flush timer with its destruction at finalization
+auto&
+get_flush_timer_mutex()
+{
+    static auto _v = std::mutex{};
+    return _v;
+}
+
+flush_timer::flush_timer(uint64_t _interval)
+: interval{_interval}
+{}
+
+void
+flush_timer::start()
+{
+    internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+    thread = std::thread{&flush_timer::run, this};
+    internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+}
+
+void
+flush_timer::stop()
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{mutex};
+        stopped  = true;
+    }
+    cv.notify_all();
+    if(thread.joinable()) thread.join();
+}
+
+void
+flush_timer::update_interval(uint64_t _interval)
+{
+    auto _lk = std::unique_lock<std::mutex>{mutex};
+    interval = std::min(interval, _interval);
+}
+
+void
+flush_timer::run()
+{
+    auto _due = std::vector<uint64_t>{};
+    auto _lk  = std::unique_lock<std::mutex>{mutex};
+    while(!stopped)
+    {
+        cv.wait_for(_lk, std::chrono::nanoseconds{interval}, [this]() { return stopped; });
+        if(stopped) break;
+
+        // finalization flushes all the buffers
+        if(registration::get_fini_status() != 0) continue;
+
+        _lk.unlock();
+        {
+            // hold the buffers mutex so that buffers are not destroyed while being inspected
+            auto _buffers_lk = std::unique_lock<std::mutex>{get_buffers_mutex()};
+            auto _now        = common::timestamp_ns();
+            for(auto& itr : *CHECK_NOTNULL(get_buffers()))
+            {
+                if(!itr || itr->flush_config.max_latency == 0) continue;
+                // records may arrive just after the last flush so check at half the max latency
+                auto _elapsed = _now - std::min(_now, itr->last_flush_ns.load());
+                if(2 * _elapsed < itr->flush_config.max_latency) continue;
+                if(itr->get_internal_buffer().is_empty()) continue;
+                _due.emplace_back(itr->buffer_id);
+            }
+        }
+
+        // submitting a flush blocks while the flush queue is full so the flushes are requested
+        // without holding the buffers mutex. A buffer destroyed meanwhile is not found
+        for(auto itr : _due)
+        {
+            if(auto* _buffer = get_buffer(itr)) _buffer->request_flush();
+        }
+        _due.clear();
+        _lk.lock();
+    }
+}
+
+void
+create_forked_flush_timer()
+{
+    // the timer thread does not exist in the forked process so the timer from the parent process
+    // is intentionally leaked
+    if(get_flush_timer())
+    {
+        get_flush_timer() = new flush_timer{get_flush_timer()->interval};
+        get_flush_timer()->start();
+    }
+}
+
+void
+start_flush_timer(uint64_t _max_latency)
+{
+    // the timer wakes up at half the smallest max latency of all the buffers
+    auto _interval = std::max<uint64_t>(_max_latency / 2, 1);
+
+    static auto _once = std::once_flag{};
+    std::call_once(_once, []() { ::pthread_atfork(nullptr, nullptr, create_forked_flush_timer); });
+
+    // the timer is started by the first buffer with a max latency, or the first one after the
+    // timer was stopped by finalize
+    auto _lk = std::unique_lock<std::mutex>{get_flush_timer_mutex()};
+    if(!get_flush_timer())
+    {
+        get_flush_timer() = new flush_timer{_interval};
+        get_flush_timer()->start();
+    }
+    else
+    {
+        get_flush_timer()->update_interval(_interval);
+    }
+}
+
 uint64_t
 get_buffer_offset()
 {
@@ -69,6 +218,64 @@ get_buffer_offset()
 }
 }  // namespace
 
+flush_policy
+get_default_flush_policy()
+{
+    static auto _v = []() {
+        constexpr uint64_t msec = 1000000;
+
+        auto _max_latency = common::get_env<uint64_t>("ROCPROFILER_BUFFER_MAX_LATENCY", 0);
+        auto _adaptive    = common::get_env("ROCPROFILER_BUFFER_ADAPTIVE_WATERMARK", false);
+        return flush_policy{.max_latency = _max_latency * msec, .adaptive_watermark = _adaptive};
+    }();
+    return _v;
+}
+
+void
+instance::update_watermark(uint64_t nbytes, uint64_t beg_ns, uint64_t end_ns)
+{
+    // exponentially weighted moving average of the rate at which producers fill the buffer and
+    // the rate at which the callback drains it
+    constexpr double weight = 0.25;
+
+    auto _prev_ns = last_flush_ns.load();
+    auto _fill_ns = (beg_ns > _prev_ns) ? (beg_ns - _prev_ns) : 0;
+    if(nbytes == 0 || _fill_ns == 0) return;
+
+    auto _fill_rate  = static_cast<double>(nbytes) / static_cast<double>(_fill_ns);
+    auto _drain_rate = static_cast<double>(end_ns - beg_ns) / static_cast<double>(nbytes);
+    if(fill_bytes_per_ns == 0.0)
+    {
+        fill_bytes_per_ns = _fill_rate;
+        drain_ns_per_byte = _drain_rate;
+    }
+    else
+    {
+        fill_bytes_per_ns += weight * (_fill_rate - fill_bytes_per_ns);
+        drain_ns_per_byte += weight * (_drain_rate - drain_ns_per_byte);
+    }
+
+    if(!flush_config.adaptive_watermark || flush_config.max_latency == 0) return;
+
+    // a record waits for the buffer to fill up to the watermark (W / fill rate) and then for the
+    // callback to drain the records before it (W * drain rate). Solving for a total wait of the
+    // max latency: W = fill_rate * max_latency / (1 + fill_rate * drain_rate)
+    auto _target = fill_bytes_per_ns * static_cast<double>(flush_config.max_latency) /
+                   (1.0 + (fill_bytes_per_ns * drain_ns_per_byte));
+    auto _value  = std::min<uint64_t>(watermark, static_cast<uint64_t>(_target));
+    effective_watermark.store(std::max<uint64_t>(_value, 1), std::memory_order_relaxed);
+}
+
+void
+set_flush_policy(instance* buff, flush_policy policy)
+{
+    buff->flush_config        = policy;
+    buff->effective_watermark = buff->watermark;
+    buff->last_flush_ns       = common::timestamp_ns();
+
+    if(policy.max_latency > 0) start_flush_timer(policy.max_latency);
+}
+
 bool
 is_valid_buffer_id(rocprofiler_buffer_id_t id)
 {
@@ -133,6 +340,68 @@ allocate_buffer()
     return rocprofiler_buffer_id_t{_idx};
 }
 
+void
+execute_flush(uint64_t buffer_id, uint64_t idx)
+{
+    ROCP_ERROR_IF(registration::get_fini_status() > 0)
+        << "executing buffer (" << buffer_id << ") flush task finalization!";
+
+    auto& buff_v          = CHECK_NOTNULL(get_buffers())->at(buffer_id - get_buffer_offset());
+    auto& buff_internal_v = buff_v->get_internal_buffer(idx);
+
+    if(!buff_internal_v.is_empty())
+    {
+        auto _nbytes = buff_internal_v.count();
+        auto _beg_ns = common::timestamp_ns();
+
+        // get the array of record headers
+        auto buff_data = buff_internal_v.get_record_headers();
+
+        // invoke buffer callback
+        try
+        {
+            if(buff_v->callback)
+            {
+                buff_v->callback(rocprofiler_context_id_t{buff_v->context_id},
+                                 rocprofiler_buffer_id_t{buff_v->buffer_id},
+                                 buff_data.data(),
+                                 buff_data.size(),
+                                 buff_v->callback_data,
+                                 buff_v->drop_count);
+            }
+        } catch(std::exception& e)
+        {
+            ROCP_ERROR << "buffer callback threw an exception: " << e.what();
+        }
+        // clear the buffer
+        buff_internal_v.clear();
+
+        buff_v->update_watermark(_nbytes, _beg_ns, common::timestamp_ns());
+        buff_v->last_flush_ns.store(_beg_ns);
+    }
+    else
+    {
+        ROCP_INFO << "buffer at " << buffer_id << " is empty...";
+    }
+
+    // allow producers to request the flush of the next fill cycle
+    buff_v->flush_requested.store(false, std::memory_order_release);
+    ++buff_v->flush_count;
+    buff_v->syncer.clear();
+}
+
+void
+finalize()
+{
+    auto _lk = std::unique_lock<std::mutex>{get_flush_timer_mutex()};
+    if(get_flush_timer())
+    {
+        get_flush_timer()->stop();
+        delete get_flush_timer();
+        get_flush_timer() = nullptr;
+    }
+}
+
 rocprofiler_status_t
 flush(rocprofiler_buffer_id_t buffer_id, bool wait)
 {
@@ -145,80 +414,34 @@ flush(rocprofiler_buffer_id_t buffer_id, bool wait)
 
     if(registration::get_fini_status() < 0 && !wait) wait = true;
 
-    auto offset = get_buffer_offset();
-
     if(!is_valid_buffer_id(buffer_id)) return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
 
     auto* buff = get_buffer(buffer_id);
 
     if(!buff) return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
 
-    auto* task_group =
-        internal_threading::get_task_group(rocprofiler_callback_thread_t{buff->task_group_id});
+    auto* executor =
+        internal_threading::get_flush_executor(rocprofiler_callback_thread_t{buff->task_group_id});
 
-    ROCP_FATAL_IF(!task_group)
+    ROCP_FATAL_IF(!executor)
         << "buffer (" << buffer_id.handle
-        << ") flush request received after the task group for handling request was destroyed";
+        << ") flush request received after the executor for handling request was destroyed";
 
-    if(wait) task_group->wait();
+    if(wait) executor->wait_until([buff]() { return buff->is_flushed(buff->buffer_idx - 1); });
 
     // buffer is currently being flushed or destroyed
     if(buff->syncer.test_and_set())
     {
         if(!wait) return ROCPROFILER_STATUS_ERROR_BUFFER_BUSY;
-        while(buff->syncer.test_and_set())
-        {
-            std::this_thread::yield();
-            std::this_thread::sleep_for(std::chrono::milliseconds{10});
-        }
+        // the syncer is released by a flush task so re-check it when tasks complete. When called
+        // from a worker thread, this also executes the queued tasks
+        executor->wait_until([buff]() { return !buff->syncer.test_and_set(); });
     }
 
     auto idx = buff->buffer_idx++;
 
-    auto _task = [buffer_id, idx, offset]() {
-        ROCP_ERROR_IF(registration::get_fini_status() > 0)
-            << "executing buffer (" << buffer_id.handle << ") flush task finalization!";
-
-        auto& buff_v          = CHECK_NOTNULL(get_buffers())->at(buffer_id.handle - offset);
-        auto& buff_internal_v = buff_v->get_internal_buffer(idx);
-
-        if(!buff_internal_v.is_empty())
-        {
-            // get the array of record headers
-            auto buff_data = buff_internal_v.get_record_headers();
-
-            // invoke buffer callback
-            try
-            {
-                if(buff_v->callback)
-                {
-                    buff_v->callback(rocprofiler_context_id_t{buff_v->context_id},
-                                     rocprofiler_buffer_id_t{buff_v->buffer_id},
-                                     buff_data.data(),
-                                     buff_data.size(),
-                                     buff_v->callback_data,
-                                     buff_v->drop_count);
-                }
-            } catch(std::exception& e)
-            {
-                ROCP_ERROR << "buffer callback threw an exception: " << e.what();
-            }
-            // clear the buffer
-            buff_internal_v.clear();
-        }
-        else
-        {
-            ROCP_INFO << "buffer at " << buffer_id.handle << " is empty...";
-        }
-
-        buff_v->syncer.clear();
-    };
-
-    task_group->exec(std::move(_task));
-    if(wait)
-    {
-        task_group->join();
-    }
+    executor->submit({&execute_flush, buffer_id.handle, idx});
+    if(wait) executor->wait_until([buff, idx]() { return buff->is_flushed(idx); });
 
     return ROCPROFILER_STATUS_SUCCESS;
 }
@@ -266,6 +489,9 @@ rocprofiler_create_buffer(rocprofiler_context_id_t        context,
     buff->buffer_id     = buffer_id->handle;
     buff->buffer_idx    = 0;
 
+    rocprofiler::buffer::set_flush_policy(buff.get(),
+                                          rocprofiler::buffer::get_default_flush_policy());
+
     return ROCPROFILER_STATUS_SUCCESS;
 }
 
@@ -293,6 +519,9 @@ rocprofiler_destroy_buffer(rocprofiler_buffer_id_t buffer_id)
 
     if(!buff) return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
 
+    // the flush timer inspects the buffers while holding this mutex
+    auto _lk = std::unique_lock<std::mutex>{rocprofiler::buffer::get_buffers_mutex()};
+
     // buffer is currently being flushed or destroyed
     if(buff->syncer.test_and_set()) return ROCPROFILER_STATUS_ERROR_BUFFER_BUSY;
 
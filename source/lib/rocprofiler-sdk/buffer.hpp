@@ -38,27 +38,69 @@ namespace rocprofiler
 {
 namespace buffer
 {
+// when the buffer is flushed in addition to reaching the watermark
+struct flush_policy
+{
+    // maximum time (in nanoseconds) records may sit in the buffer before the background timer
+    // requests a flush. Zero disables the timer
+    uint64_t max_latency = 0;
+    // reduce the watermark when the callback cannot drain a full watermark worth of records
+    // within the max latency. Requires a non-zero max latency
+    bool adaptive_watermark = false;
+};
+
+// flush policy applied to new buffers: ROCPROFILER_BUFFER_MAX_LATENCY (milliseconds) and
+// ROCPROFILER_BUFFER_ADAPTIVE_WATERMARK
+flush_policy
+get_default_flush_policy();
+
 struct instance
 {
     using buffer_t = common::container::record_header_buffer;
 
-    mutable std::array<buffer_t, 2> buffers       = {};
-    mutable std::atomic_flag        syncer        = ATOMIC_FLAG_INIT;
-    mutable std::atomic<uint32_t>   buffer_idx    = {};  // array index
-    mutable std::atomic<uint64_t>   drop_count    = {};
-    uint64_t                        watermark     = 0;
-    uint64_t                        context_id    = 0;  // rocprofiler_context_id_t value
-    uint64_t                        buffer_id     = 0;  // rocprofiler_buffer_id_t value
-    uint64_t                        task_group_id = 0;  // thread-pool assignment
-    rocprofiler_buffer_tracing_cb_t callback      = nullptr;
-    void*                           callback_data = nullptr;
-    rocprofiler_buffer_policy_t     policy        = ROCPROFILER_BUFFER_POLICY_NONE;
+    mutable std::array<buffer_t, 2> buffers             = {};
+    mutable std::atomic_flag        syncer              = ATOMIC_FLAG_INIT;
+    mutable std::atomic<uint32_t>   buffer_idx          = {};  // array index
+    mutable std::atomic<uint32_t>   flush_count         = {};  // number of completed flushes
+    mutable std::atomic<uint64_t>   drop_count          = {};
+    mutable std::atomic<bool>       flush_requested     = {};  // flush pending for fill cycle
+    mutable std::atomic<uint64_t>   effective_watermark = {};  // adapted watermark
+    mutable std::atomic<uint64_t>   last_flush_ns       = {};  // timestamp of last flush
+    uint64_t                        watermark           = 0;
+    uint64_t                        context_id          = 0;  // rocprofiler_context_id_t value
+    uint64_t                        buffer_id           = 0;  // rocprofiler_buffer_id_t value
+    uint64_t                        task_group_id       = 0;  // thread-pool assignment
+    rocprofiler_buffer_tracing_cb_t callback            = nullptr;
+    void*                           callback_data       = nullptr;
+    rocprofiler_buffer_policy_t     policy              = ROCPROFILER_BUFFER_POLICY_NONE;
+    flush_policy                    flush_config        = {};
+
+    // drain statistics only accessed by the flush task (at most one in flight per buffer)
+    double fill_bytes_per_ns = 0.0;
+    double drain_ns_per_byte = 0.0;
 
     template <typename Tp>
     bool emplace(uint32_t, uint32_t, Tp&);
 
+    // writes the given number of records in place via func(Tp* records, size_t n), which may be
+    // invoked multiple times for consecutive sub-ranges. Returns the number of records written
+    template <typename Tp, typename FuncT>
+    size_t emplace_n(uint32_t, uint32_t, size_t, FuncT&&);
+
     buffer_t& get_internal_buffer();
     buffer_t& get_internal_buffer(size_t);
+
+    // true if the flush of the internal buffer at the given index has completed
+    bool is_flushed(uint32_t idx) const;
+
+    // the watermark adapted by the flush policy
+    uint64_t get_watermark() const;
+
+    // requests a non-blocking flush unless one has already been requested in this fill cycle
+    void request_flush() const;
+
+    // updates the drain statistics and the effective watermark after a flush
+    void update_watermark(uint64_t nbytes, uint64_t beg_ns, uint64_t end_ns);
 };
 
 using unique_buffer_vec_t = common::container::stable_vector<std::unique_ptr<instance>, 4>;
@@ -81,8 +123,22 @@ get_buffer(uint64_t buffer_idx);
 rocprofiler_status_t
 flush(rocprofiler_buffer_id_t buffer_id, bool wait);
 
+// applies the flush policy to the buffer and starts the flush timer if the policy has a max
+// latency. Must be invoked after the watermark is set
+void
+set_flush_policy(instance* buff, flush_policy policy);
+
+// delivers the records in the internal buffer at the given index to the buffer callback. This is
+// the task executed by the flush executor (or the dedicated callback thread)
+void
+execute_flush(uint64_t buffer_id, uint64_t idx);
+
 rocprofiler_status_t
 flush(uint64_t buffer_idx, bool wait);
+
+// stops the background flush timer
+void
+finalize();
 }  // namespace buffer
 }  // namespace rocprofiler
 
@@ -99,6 +155,34 @@ rocprofiler::buffer::instance::get_internal_buffer(size_t idx)
     return buffers.at(idx % buffers.size());
 }
 
+inline bool
+rocprofiler::buffer::instance::is_flushed(uint32_t idx) const
+{
+    // signed distance is robust to the counters wrapping
+    return static_cast<int32_t>(flush_count.load(std::memory_order_acquire) - idx) > 0;
+}
+
+inline uint64_t
+rocprofiler::buffer::instance::get_watermark() const
+{
+    return (flush_config.adaptive_watermark) ? effective_watermark.load(std::memory_order_relaxed)
+                                             : watermark;
+}
+
+inline void
+rocprofiler::buffer::instance::request_flush() const
+{
+    // the relaxed load keeps the cache line shared while the flag is already set
+    if(flush_requested.load(std::memory_order_relaxed) ||
+       flush_requested.exchange(true, std::memory_order_acq_rel))
+        return;
+
+    // the flag is cleared when the flush completes. If the flush could not be issued (e.g. the
+    // buffer is busy with a blocking flush), clear it so the next record tries again
+    if(buffer::flush(buffer_id, false) != ROCPROFILER_STATUS_SUCCESS)
+        flush_requested.store(false, std::memory_order_release);
+}
+
 inline rocprofiler::buffer::instance*
 rocprofiler::buffer::get_buffer(uint64_t buffer_idx)
 {
@@ -147,11 +231,58 @@ rocprofiler::buffer::instance::emplace(uint32_t category, uint32_t kind, Tp& val
         }
     }
 
-    if(buffers.at(idx).count() >= watermark)
+    if(buffers.at(idx).count() >= get_watermark())
     {
         // flush without syncing
-        buffer::flush(buffer_id, false);
+        request_flush();
     }
 
     return success;
 }
+
+template <typename Tp, typename FuncT>
+inline size_t
+rocprofiler::buffer::instance::emplace_n(uint32_t category, uint32_t kind, size_t n, FuncT&& func)
+{
+    // get the index of the current buffer
+    auto get_idx = [this]() { return buffer_idx.load(std::memory_order_acquire) % buffers.size(); };
+
+    size_t num_written = 0;
+    auto   idx         = get_idx();
+    while(num_written < n)
+    {
+        auto num = buffers.at(idx).template emplace_n<Tp>(category, kind, n - num_written, func);
+        if(num > 0)
+        {
+            num_written += num;
+            continue;
+        }
+
+        if(buffers.at(idx).capacity() < sizeof(Tp))
+        {
+            auto msg = std::stringstream{};
+            msg << "buffer " << buffer_id << " to small (size=" << buffers.at(idx).capacity()
+                << ") to hold an object of type " << common::cxx_demangle(typeid(Tp).name())
+                << " with size " << sizeof(Tp);
+            throw std::runtime_error(msg.str());
+        }
+
+        if(policy != ROCPROFILER_BUFFER_POLICY_LOSSLESS)
+        {
+            drop_count += (n - num_written);
+            break;
+        }
+
+        // blocks until buffer is flushed
+        buffer::flush(buffer_id, true);
+        idx = get_idx();
+    }
+
+    if(buffers.at(idx).count() >= get_watermark())
+    {
+        // flush without syncing
+        request_flush();
+    }
+
+    return num_written;
+}
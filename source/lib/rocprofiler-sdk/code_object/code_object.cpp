@@ -21,8 +21,9 @@
 // THE SOFTWARE.
 
 #include "lib/rocprofiler-sdk/code_object/code_object.hpp"
-#include "lib/common/scope_destructor.hpp"
+#include "lib/common/container/read_mostly_map.hpp"
 #include "lib/common/static_object.hpp"
+#include "lib/common/string_table.hpp"
 #include "lib/common/synchronized.hpp"
 #include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/agent.hpp"
@@ -158,7 +159,6 @@ using context_t                      = context::context;
 using user_data_t                    = rocprofiler_user_data_t;
 using context_array_t                = context::context_array_t;
 using context_user_data_map_t        = std::unordered_map<const context_t*, user_data_t>;
-using name_array_t                   = std::vector<std::pair<size_t, std::unique_ptr<std::string>>>;
 using amd_compute_pgm_rsrc_three32_t = uint32_t;
 
 struct kernel_descriptor_t
@@ -296,34 +296,6 @@ sgpr_count(std::string_view name, kernel_descriptor_t kernel_code)
     return 0;
 }
 
-name_array_t*
-get_string_array()
-{
-    static auto*& _v = common::static_object<name_array_t>::construct();
-    return _v;
-}
-
-std::string*
-get_string_entry(std::string_view name)
-{
-    auto        _hash_v = std::hash<std::string_view>{}(name);
-    static auto _sync   = std::shared_mutex{};
-    if(!get_string_array()) return nullptr;
-
-    {
-        auto _unlock = common::scope_destructor{[]() { _sync.unlock_shared(); }};
-        _sync.lock_shared();
-        for(const auto& itr : *get_string_array())
-            if(itr.first == _hash_v) return itr.second.get();
-    }
-
-    auto _unlock = common::scope_destructor{[]() { _sync.unlock(); }};
-    _sync.lock();
-    return get_string_array()
-        ->emplace_back(std::make_pair(_hash_v, std::make_unique<std::string>(name)))
-        .second.get();
-}
-
 hsa_loader_table_t&
 get_loader_table()
 {
@@ -384,9 +356,12 @@ get_kernel_symbol_id()
     return _v;
 }
 
-using kernel_object_map_t        = std::unordered_map<uint64_t, uint64_t>;
+// kernel object -> kernel id: looked up for every intercepted kernel dispatch and only modified
+// when executables are frozen or destroyed
+using kernel_object_map_t        = common::container::read_mostly_map<uint64_t, uint64_t>;
 using executable_array_t         = std::vector<hsa_executable_t>;
 using code_object_unload_array_t = std::vector<hsa::code_object_unload>;
+using code_object_load_array_t   = std::vector<code_object_iterator_t>;
 
 std::vector<hsa::code_object_unload>
 shutdown(hsa_executable_t executable);
@@ -410,9 +385,16 @@ get_code_objects()
 
 auto*
 get_kernel_object_map()
+{
+    static auto*& _v = common::static_object<kernel_object_map_t>::construct();
+    return _v;
+}
+
+auto*
+get_code_object_load_callbacks()
 {
     static auto*& _v =
-        common::static_object<common::Synchronized<kernel_object_map_t>>::construct();
+        common::static_object<common::Synchronized<code_object_load_array_t>>::construct();
     return _v;
 }
 
@@ -472,9 +454,9 @@ executable_iterate_agent_symbols_load_callback(hsa_executable_t        executabl
         auto _name = std::string(_name_length + 1, '\0');
         ROCP_HSA_CORE_GET_EXE_SYMBOL_INFO(HSA_EXECUTABLE_SYMBOL_INFO_NAME, _name.data());
 
-        symbol_v.name = get_string_entry(_name.substr(0, _name.find_first_of('\0')));
+        symbol_v.name = common::get_string_entry(_name.substr(0, _name.find_first_of('\0')));
     }
-    data.kernel_name = (symbol_v.name) ? symbol_v.name->c_str() : nullptr;
+    data.kernel_name = symbol_v.name.data();
 
     // these should all be self-explanatory
     ROCP_HSA_CORE_GET_EXE_SYMBOL_INFO(HSA_EXECUTABLE_SYMBOL_INFO_KERNEL_OBJECT,
@@ -505,14 +487,6 @@ executable_iterate_agent_symbols_load_callback(hsa_executable_t        executabl
     // generate a unique kernel symbol id
     data.kernel_id = ++get_kernel_symbol_id();
 
-    CHECK_NOTNULL(get_kernel_object_map())
-        ->wlock(
-            [](kernel_object_map_t& object_map, uint64_t _kern_obj, uint64_t _kern_id) {
-                object_map[_kern_obj] = _kern_id;
-            },
-            data.kernel_object,
-            data.kernel_id);
-
     code_obj_v->symbols.emplace_back(std::make_unique<hsa::kernel_symbol>(std::move(symbol_v)));
 
     return HSA_STATUS_SUCCESS;
@@ -648,9 +622,9 @@ code_object_load_callback(hsa_executable_t         executable,
         ROCP_HSA_VEN_LOADER_GET_CODE_OBJECT_INFO(HSA_VEN_AMD_LOADER_LOADED_CODE_OBJECT_INFO_URI,
                                                  _uri.data());
 
-        code_obj_v.uri = get_string_entry(_uri);
+        code_obj_v.uri = common::get_string_entry(_uri.substr(0, _uri.find_first_of('\0')));
     }
-    data.uri = (code_obj_v.uri) ? code_obj_v.uri->data() : nullptr;
+    data.uri = code_obj_v.uri.data();
 
     auto _hsa_agent = hsa_agent_t{};
     ROCP_HSA_VEN_LOADER_GET_CODE_OBJECT_INFO(HSA_VEN_AMD_LOADER_LOADED_CODE_OBJECT_INFO_AGENT,
@@ -769,6 +743,23 @@ executable_freeze(hsa_executable_t executable, const char* options)
             executable, code_object_load_callback, &_vec);
     });
 
+    // publish the kernel object -> kernel id mappings for all the symbols in the executable at
+    // once so that readers on the dispatch path only see a single update per executable
+    code_obj_vec->rlock([executable](const code_object_array_t& _vec) {
+        CHECK_NOTNULL(get_kernel_object_map())
+            ->modify([&_vec, executable](kernel_object_map_t::map_type& object_map) {
+                for(const auto& itr : _vec)
+                {
+                    if(!itr || itr->hsa_executable.handle != executable.handle) continue;
+                    for(const auto& sitr : itr->symbols)
+                    {
+                        if(sitr)
+                            object_map[sitr->rocp_data.kernel_object] = sitr->rocp_data.kernel_id;
+                    }
+                }
+            });
+    });
+
     constexpr auto CODE_OBJECT_KIND = ROCPROFILER_CALLBACK_TRACING_CODE_OBJECT;
     constexpr auto CODE_OBJECT_LOAD = ROCPROFILER_CODE_OBJECT_LOAD;
     constexpr auto CODE_OBJECT_KERNEL_SYMBOL =
@@ -854,6 +845,21 @@ executable_freeze(hsa_executable_t executable, const char* options)
         });
     }
 
+    // internal consumers are notified after the tools, e.g. so a kernel filter can rely on the
+    // state a tool built from its kernel symbol callbacks
+    CHECK_NOTNULL(get_code_object_load_callbacks())
+        ->rlock([code_obj_vec, executable](const code_object_load_array_t& callbacks) {
+            if(callbacks.empty()) return;
+            code_obj_vec->rlock([&callbacks, executable](const code_object_array_t& _vec) {
+                for(const auto& itr : _vec)
+                {
+                    if(!itr || itr->hsa_executable.handle != executable.handle) continue;
+                    for(const auto& cb : callbacks)
+                        cb(*itr);
+                }
+            });
+        });
+
     return HSA_STATUS_SUCCESS;
 }
 
@@ -866,15 +872,16 @@ executable_destroy(hsa_executable_t executable)
 
     if(get_kernel_object_map())
     {
-        CHECK_NOTNULL(get_kernel_object_map())->wlock([_unloaded](kernel_object_map_t& data) {
-            for(const auto& uitr : _unloaded)
-            {
-                for(const auto& sitr : uitr.symbols)
+        CHECK_NOTNULL(get_kernel_object_map())
+            ->modify([&_unloaded](kernel_object_map_t::map_type& data) {
+                for(const auto& uitr : _unloaded)
                 {
-                    data.erase(sitr->rocp_data.kernel_id);
+                    for(const auto& sitr : uitr.symbols)
+                    {
+                        data.erase(sitr->rocp_data.kernel_object);
+                    }
                 }
-            }
-        });
+            });
     }
 
     if(get_code_objects())
@@ -1011,13 +1018,7 @@ initialize(HsaApiTable* table)
 uint64_t
 get_kernel_id(uint64_t kernel_object)
 {
-    return CHECK_NOTNULL(get_kernel_object_map())
-        ->rlock(
-            [](const kernel_object_map_t& object_map, uint64_t _kern_obj) -> uint64_t {
-                auto itr = object_map.find(_kern_obj);
-                return (itr == object_map.end()) ? 0 : itr->second;
-            },
-            kernel_object);
+    return CHECK_NOTNULL(get_kernel_object_map())->find(kernel_object, 0);
 }
 
 void
@@ -1037,6 +1038,15 @@ finalize()
     is_shutdown = true;
 }
 
+void
+add_code_object_load_callback(code_object_iterator_t&& func)
+{
+    CHECK_NOTNULL(get_code_object_load_callbacks())
+        ->wlock([](code_object_load_array_t& data,
+                   code_object_iterator_t&&  func_v) { data.emplace_back(std::move(func_v)); },
+                std::move(func));
+}
+
 void
 iterate_loaded_code_objects(code_object_iterator_t&& func)
 {
@@ -56,6 +56,11 @@ get_kernel_id(uint64_t kernel_object);
 void
 iterate_loaded_code_objects(code_object_iterator_t&& func);
 
+// invoked for each code object of an executable when it is frozen, i.e. before any of its
+// kernels can be dispatched
+void
+add_code_object_load_callback(code_object_iterator_t&& func);
+
 void
 initialize(HsaApiTable* table);
 
@@ -57,7 +57,7 @@ code_object::operator=(code_object&& rhs) noexcept
         hsa_code_object = rhs.hsa_code_object;
         rocp_data       = rhs.rocp_data;
         user_data       = std::move(rhs.user_data);
-        rocp_data.uri   = (uri) ? uri->c_str() : nullptr;
+        rocp_data.uri   = uri.data();
         symbols         = std::move(rhs.symbols);
     }
 
@@ -30,6 +30,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -61,7 +62,7 @@ struct code_object
 
     bool                     beg_notified    = false;
     bool                     end_notified    = false;
-    std::string*             uri             = {};
+    std::string_view         uri             = {};
     hsa_executable_t         hsa_executable  = {};
     hsa_loaded_code_object_t hsa_code_object = {};
     code_object_data_t       rocp_data       = common::init_public_api_struct(code_object_data_t{});
@@ -58,7 +58,7 @@ kernel_symbol::operator=(kernel_symbol&& rhs) noexcept
         hsa_symbol            = rhs.hsa_symbol;
         rocp_data             = rhs.rocp_data;
         user_data             = std::move(rhs.user_data);
-        rocp_data.kernel_name = (name) ? name->c_str() : nullptr;
+        rocp_data.kernel_name = name.data();
     }
 
     return *this;
@@ -29,6 +29,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -60,7 +61,7 @@ struct kernel_symbol
 
     bool                    beg_notified   = false;
     bool                    end_notified   = false;
-    std::string*            name           = {};
+    std::string_view        name           = {};
     hsa_executable_t        hsa_executable = {};
     hsa_agent_t             hsa_agent      = {};
     hsa_executable_symbol_t hsa_symbol     = {};
@@ -32,6 +32,7 @@
 #include "lib/rocprofiler-sdk/context/domain.hpp"
 #include "lib/rocprofiler-sdk/counters/agent_profiling.hpp"
 #include "lib/rocprofiler-sdk/counters/core.hpp"
+#include "lib/rocprofiler-sdk/counters/dispatch_filter.hpp"
 #include "lib/rocprofiler-sdk/external_correlation.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/types.hpp"
 #include "lib/rocprofiler-sdk/thread_trace/att_core.hpp"
@@ -87,6 +88,9 @@ struct dispatch_counter_collection_service
     // to protect against multithreaded calls to enable a context (and enabling already enabled
     // counters).
     common::Synchronized<bool> enabled{false};
+    // Dispatches profiled by the instances (kernel filter and sampling policies). The other
+    // dispatches do not invoke the callbacks of the instances.
+    counters::dispatch_filter filter{};
 };
 
 struct agent_counter_collection_service
@@ -115,6 +119,8 @@ struct agent_counter_collection_service
     common::Synchronized<bool> enabled{false};
 };
 
+struct context;
+
 struct pc_sampling_service
 {
     // Contains a map with pairs (rocprofiler_agent_id_t, PCSAgentSession*).
@@ -123,6 +129,12 @@ struct pc_sampling_service
     std::unordered_map<rocprofiler_agent_id_t,
                        std::unique_ptr<rocprofiler::pc_sampling::PCSAgentSession>>
         agent_sessions;
+    // The registered context enclosing the service. Cached when the service is configured
+    // so that the context is not searched for on every kernel dispatch.
+    const context* ctx = nullptr;
+    // If true, the marker packets correlating PC samples with kernel dispatches are injected
+    // only while the service is active (ROCPROFILER_PC_SAMPLING_MARKERS_WHILE_ACTIVE).
+    bool markers_while_active = false;
 };
 
 struct context
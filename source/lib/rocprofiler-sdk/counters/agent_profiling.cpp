@@ -23,7 +23,9 @@
 #include "lib/rocprofiler-sdk/counters/agent_profiling.hpp"
 #include <cstdint>
 
+#include "lib/common/container/small_vector.hpp"
 #include "lib/common/logging.hpp"
+#include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/buffer.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
 #include "lib/rocprofiler-sdk/counters/controller.hpp"
@@ -32,6 +34,7 @@
 #include "lib/rocprofiler-sdk/hsa/queue_controller.hpp"
 #include "lib/rocprofiler-sdk/hsa/rocprofiler_packet.hpp"
 #include "rocprofiler-sdk/fwd.h"
+#include "rocprofiler-sdk/rocprofiler.h"
 
 namespace rocprofiler
 {
@@ -98,7 +101,17 @@ construct_aql_pkt(const hsa::AgentCache& agent, std::shared_ptr<profile_config>&
         return nullptr;
     }
 
-    auto pkts = profile->pkt_generator->construct_packet(
+    // Agent profiles are sampled by a single packet, the counters cannot be split in passes
+    if(profile->pkt_generators.size() != 1)
+    {
+        ROCP_ERROR << fmt::format("Hardware counters of profile {} do not fit in a single pass "
+                                  "({} passes), they cannot be collected by agent profiling",
+                                  profile->id.handle,
+                                  profile->pkt_generators.size());
+        return nullptr;
+    }
+
+    auto pkts = profile->pkt_generators.front()->construct_packet(
         CHECK_NOTNULL(hsa::get_queue_controller())->get_ext_table());
 
     pkts->start.header                   = header_pkt(HSA_PACKET_TYPE_VENDOR_SPECIFIC);
@@ -108,18 +121,20 @@ construct_aql_pkt(const hsa::AgentCache& agent, std::shared_ptr<profile_config>&
     return pkts;
 }
 
+// Decode the AQL packet data into decoded_pkt and write out the evaluated counters
+// to the buffer of the agent context, after the header of the sample (if any)
 bool
-agent_async_handler(hsa_signal_value_t /*signal_v*/, void* data)
+write_agent_records(
+    const context::agent_counter_collection_service&                         agent_ctx,
+    hsa::CounterAQLPacket&                                                   pkt,
+    rocprofiler_user_data_t                                                  user_data,
+    std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>>& decoded_pkt,
+    std::vector<std::unique_ptr<std::vector<rocprofiler_record_counter_t>>>& cache,
+    rocprofiler_agent_profile_sample_record_t*                               header = nullptr)
 {
-    const auto* ctx = context::get_registered_context({.handle = (uint64_t) data});
-    if(!ctx) return false;
-
-    const auto& agent_ctx   = *ctx->agent_counter_collection;
     const auto& prof_config = agent_ctx.profile;
 
-    // Decode the AQL packet data
-    auto decoded_pkt =
-        EvaluateAST::read_pkt(prof_config->pkt_generator.get(), *agent_ctx.callback_data.packet);
+    EvaluateAST::read_pkt(prof_config->pkt_generators.front().get(), pkt, decoded_pkt);
     EvaluateAST::read_special_counters(
         *prof_config->agent, prof_config->required_special_counters, decoded_pkt);
 
@@ -131,23 +146,31 @@ agent_async_handler(hsa_signal_value_t /*signal_v*/, void* data)
         return false;
     }
 
-    // Write out the AQL data to the buffer
+    // Evaluate the counters, the header of the sample holds the number of records
+    common::container::small_vector<rocprofiler_record_counter_t, 128> out;
     for(auto& ast : prof_config->asts)
     {
-        std::vector<std::unique_ptr<std::vector<rocprofiler_record_counter_t>>> cache;
+        cache.clear();
         auto* ret = CHECK_NOTNULL(ast.evaluate(decoded_pkt, cache));
         ast.set_out_id(*ret);
         for(auto& val : *ret)
         {
-            val.user_data = agent_ctx.callback_data.user_data;
-            buf->emplace(
-                ROCPROFILER_BUFFER_CATEGORY_COUNTERS, ROCPROFILER_COUNTER_RECORD_VALUE, val);
+            val.user_data = user_data;
+            out.emplace_back(val);
         }
     }
 
-    // reset the signal to allow another sample to start
-    agent_ctx.callback_data.table.hsa_signal_store_relaxed_fn(agent_ctx.callback_data.completion,
-                                                              1);
+    // Write out the AQL data to the buffer
+    if(header)
+    {
+        header->num_records = out.size();
+        buf->emplace(ROCPROFILER_BUFFER_CATEGORY_COUNTERS,
+                     ROCPROFILER_COUNTER_RECORD_AGENT_PROFILE_SAMPLE_HEADER,
+                     *header);
+    }
+
+    for(auto& val : out)
+        buf->emplace(ROCPROFILER_BUFFER_CATEGORY_COUNTERS, ROCPROFILER_COUNTER_RECORD_VALUE, val);
     return true;
 }
 
@@ -170,10 +193,9 @@ init_callback_data(const rocprofiler::context::context& ctx, const hsa::AgentCac
 
     agent_ctx.callback_data.table = CHECK_NOTNULL(hsa::get_queue_controller())->get_core_table();
 
-    // Tri-state signal
-    //   1: allow next sample to start
-    //   0: sample in progress
-    //  -1: sample complete
+    // Signal of the packets waited for on submission
+    //   1: no packet in progress
+    //   0: packet complete
     CHECK_EQ(agent_ctx.callback_data.table.hsa_signal_create_fn(
                  1, 0, nullptr, &agent_ctx.callback_data.completion),
              HSA_STATUS_SUCCESS);
@@ -184,18 +206,6 @@ init_callback_data(const rocprofiler::context::context& ctx, const hsa::AgentCac
         agent_ctx.callback_data.table.hsa_signal_create_fn(1, 0, nullptr, &agent_ctx.start_signal),
         HSA_STATUS_SUCCESS);
 
-    // Setup callback
-    // NOLINTBEGIN(performance-no-int-to-ptr)
-    CHECK_EQ(CHECK_NOTNULL(hsa::get_queue_controller())
-                 ->get_ext_table()
-                 .hsa_amd_signal_async_handler_fn(agent_ctx.callback_data.completion,
-                                                  HSA_SIGNAL_CONDITION_LT,
-                                                  0,
-                                                  agent_async_handler,
-                                                  (void*) ctx.context_idx),
-             HSA_STATUS_SUCCESS);
-    // NOLINTEND(performance-no-int-to-ptr)
-
     // Set state of the queue to allow profiling (may not be needed since AQL
     // may do this in the future).
     aql::set_profiler_active_on_queue(
@@ -219,13 +229,137 @@ init_callback_data(const rocprofiler::context::context& ctx, const hsa::AgentCac
                 agent_ctx.callback_data.completion, 1);
         });
 }
+// Slots of the periodic sampler, i.e. number of samples in flight
+constexpr size_t agent_sampling_depth = 4;
+// Slots of the reads requested by the tool, i.e. number of reads in flight
+constexpr size_t agent_read_depth = 16;
+
+// Submits a read of the counters into the output buffer of the AQL packet of a slot. The barrier
+// flushes the hardware caches, without it the read packet may not have the correct data.
+void
+submit_agent_read(const context::agent_counter_collection_service& agent_ctx,
+                  hsa_queue_t*                                     queue,
+                  const hsa::CounterAQLPacket&                     pkt,
+                  hsa_signal_t                                     completion)
+{
+    const auto& table = agent_ctx.callback_data.table;
+
+    // Remove when AQL is updated to not require stop to be called first
+    submitPacket(table, queue, (void*) &agent_ctx.callback_data.packet->stop);
+    submitPacket(table, queue, (void*) &pkt.read);
+
+    rocprofiler::hsa::rocprofiler_packet barrier{};
+    barrier.barrier_and.header            = header_pkt(HSA_PACKET_TYPE_BARRIER_AND);
+    barrier.barrier_and.completion_signal = completion;
+    submitPacket(table, queue, (void*) &barrier.barrier_and);
+}
+
+rocprofiler_status_t
+start_agent_reads(const context::context& ctx, const hsa::AgentCache& agent)
+{
+    auto& agent_ctx = *ctx.agent_counter_collection;
+    auto& reads     = agent_ctx.callback_data.reads;
+
+    if(reads.queue) return ROCPROFILER_STATUS_SUCCESS;
+
+    // The read buffers of every slot are allocated at once
+    const auto& ext = CHECK_NOTNULL(hsa::get_queue_controller())->get_ext_table();
+    auto&       gen = *agent_ctx.profile->pkt_generators.front();
+
+    reads.packets = gen.construct_packets(ext, agent_read_depth);
+    if(reads.packets.size() != agent_read_depth)
+    {
+        reads.packets.clear();
+        return ROCPROFILER_STATUS_ERROR_AST_GENERATION_FAILED;
+    }
+
+    for(auto& itr : reads.packets)
+        itr->read.header = header_pkt(HSA_PACKET_TYPE_VENDOR_SPECIFIC);
+
+    auto* queue = agent.profile_queue();
+    reads.queue = std::make_unique<agent_read_queue>(
+        agent_ctx.callback_data.table,
+        ext,
+        agent_read_depth,
+        [&agent_ctx, &reads, queue](size_t slot, hsa_signal_t completion) {
+            submit_agent_read(agent_ctx, queue, *reads.packets.at(slot), completion);
+        },
+        [&agent_ctx, &reads](size_t slot, const agent_read_queue::read_info& info) {
+            auto header =
+                common::init_public_api_struct(rocprofiler_agent_profile_sample_record_t{});
+            header.agent_id      = agent_ctx.agent_id;
+            header.sample_id     = info.sample_id;
+            header.num_coalesced = info.num_coalesced;
+            header.user_data     = info.user_data;
+            write_agent_records(agent_ctx,
+                                *reads.packets.at(slot),
+                                info.user_data,
+                                reads.decoded,
+                                reads.cache,
+                                &header);
+        });
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
+rocprofiler_status_t
+start_agent_sampler(const context::context& ctx, const hsa::AgentCache& agent)
+{
+    auto& agent_ctx = *ctx.agent_counter_collection;
+    auto& sampling  = agent_ctx.callback_data.sampling;
+
+    if(sampling.interval == 0) return ROCPROFILER_STATUS_SUCCESS;
+
+    while(sampling.packets.size() < agent_sampling_depth)
+    {
+        auto pkt = construct_aql_pkt(agent, agent_ctx.profile);
+        if(!pkt) return ROCPROFILER_STATUS_ERROR_AST_GENERATION_FAILED;
+        sampling.packets.emplace_back(std::move(pkt));
+    }
+
+    auto* queue = agent.profile_queue();
+    // the timestamp of the sample is passed as the user data of its records
+    sampling.sampler = std::make_unique<agent_sampler>(
+        agent_ctx.callback_data.table,
+        std::chrono::nanoseconds{sampling.interval},
+        agent_sampling_depth,
+        [&agent_ctx, &sampling, queue](size_t slot, hsa_signal_t completion) {
+            submit_agent_read(agent_ctx, queue, *sampling.packets.at(slot), completion);
+        },
+        [&agent_ctx, &sampling](size_t slot, uint64_t timestamp) {
+            write_agent_records(agent_ctx,
+                                *sampling.packets.at(slot),
+                                {.value = timestamp},
+                                sampling.decoded,
+                                sampling.cache);
+        });
+    sampling.sampler->start();
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
+void
+stop_agent_sampler(const context::context& ctx)
+{
+    auto& sampling = ctx.agent_counter_collection->callback_data.sampling;
+    if(!sampling.sampler) return;
+
+    sampling.sampler->stop();
+    ROCP_INFO << fmt::format("Context {} collected {} periodic agent samples ({} dropped)",
+                             ctx.context_idx,
+                             sampling.sampler->get_num_samples(),
+                             sampling.sampler->get_num_dropped());
+    sampling.sampler.reset();
+}
 }  // namespace
 
 rocprofiler_status_t
 read_agent_ctx(const context::context*    ctx,
                rocprofiler_user_data_t    user_data,
-               rocprofiler_counter_flag_t flags)
+               rocprofiler_counter_flag_t flags,
+               uint64_t*                  sample_id,
+               bool                       wait_for_slot)
 {
+    if(!ctx) return ROCPROFILER_STATUS_ERROR_CONTEXT_INVALID;
+
     if(!ctx->agent_counter_collection || !ctx->agent_counter_collection->profile)
     {
         if(!ctx->agent_counter_collection)
@@ -260,8 +394,24 @@ read_agent_ctx(const context::context*    ctx,
         return ROCPROFILER_STATUS_ERROR_CONTEXT_ERROR;
     }
 
+    // The periodic sampler owns the profile queue while the context is started
+    if(agent_ctx.callback_data.sampling.sampler)
+    {
+        agent_ctx.status.exchange(
+            rocprofiler::context::agent_counter_collection_service::state::ENABLED);
+        return ROCPROFILER_STATUS_ERROR_CONTEXT_ERROR;
+    }
+
     CHECK(agent_ctx.callback_data.packet);
 
+    // The read queue is created when the context is started
+    if(!agent_ctx.callback_data.reads.queue)
+    {
+        agent_ctx.status.exchange(
+            rocprofiler::context::agent_counter_collection_service::state::ENABLED);
+        return ROCPROFILER_STATUS_ERROR_CONTEXT_ERROR;
+    }
+
     ROCP_TRACE << fmt::format("Agent Infor for Running Counter: Name = {}, XCC = {}, "
                               "SE = {}, CU = {}, SIMD = {}",
                               agent->get_rocp_agent()->name,
@@ -270,40 +420,25 @@ read_agent_ctx(const context::context*    ctx,
                               agent->get_rocp_agent()->cu_count,
                               agent->get_rocp_agent()->simd_arrays_per_engine);
 
-    // Remove when AQL is updated to not require stop to be called first
-    submitPacket(agent_ctx.callback_data.table,
-                 agent->profile_queue(),
-                 (void*) &agent_ctx.callback_data.packet->stop);
+    // Submit the read into the next slot (or coalesce it into the pending read), the records
+    // are written to the buffer by the completion handler of the slot
+    auto& reads    = *agent_ctx.callback_data.reads.queue;
+    bool  coalesce = (flags == ROCPROFILER_COUNTER_FLAG_ASYNC_COALESCE);
+    auto  id       = reads.submit(user_data, coalesce, wait_for_slot);
 
-    // Submit the read packet to the queue
-    submitPacket(agent_ctx.callback_data.table,
-                 agent->profile_queue(),
-                 (void*) &agent_ctx.callback_data.packet->read);
+    // Wait for the read to be written to the buffer
+    if(id != 0 && flags != ROCPROFILER_COUNTER_FLAG_ASYNC && !coalesce) reads.wait(id);
 
-    // Submit a barrier packet. This is needed to flush hardware caches. Without this
-    // the read packet may not have the correct data.
-    rocprofiler::hsa::rocprofiler_packet barrier{};
-    barrier.barrier_and.header            = header_pkt(HSA_PACKET_TYPE_BARRIER_AND);
-    barrier.barrier_and.completion_signal = agent_ctx.callback_data.completion;
-    agent_ctx.callback_data.table.hsa_signal_store_relaxed_fn(agent_ctx.callback_data.completion,
-                                                              0);
-    agent_ctx.callback_data.user_data = user_data;
-    submitPacket(
-        agent_ctx.callback_data.table, agent->profile_queue(), (void*) &barrier.barrier_and);
-
-    // Wait for the barrier/read packet to complete
-    if(flags != ROCPROFILER_COUNTER_FLAG_ASYNC)
+    agent_ctx.status.exchange(
+        rocprofiler::context::agent_counter_collection_service::state::ENABLED);
+
+    if(id == 0)
     {
-        // Wait for any inprogress samples to complete before returning
-        agent_ctx.callback_data.table.hsa_signal_wait_relaxed_fn(agent_ctx.callback_data.completion,
-                                                                 HSA_SIGNAL_CONDITION_EQ,
-                                                                 1,
-                                                                 UINT64_MAX,
-                                                                 HSA_WAIT_STATE_ACTIVE);
+        return (wait_for_slot) ? ROCPROFILER_STATUS_ERROR
+                               : ROCPROFILER_STATUS_ERROR_OUT_OF_RESOURCES;
     }
 
-    agent_ctx.status.exchange(
-        rocprofiler::context::agent_counter_collection_service::state::ENABLED);
+    if(sample_id) *sample_id = id;
     return ROCPROFILER_STATUS_SUCCESS;
 }
 
@@ -377,6 +512,9 @@ start_agent_ctx(const context::context* ctx)
 
                 cb_ctx->agent_counter_collection->profile = config;
                 cb_ctx->agent_counter_collection->callback_data.packet.reset();
+                cb_ctx->agent_counter_collection->callback_data.reads.queue.reset();
+                cb_ctx->agent_counter_collection->callback_data.reads.packets.clear();
+                cb_ctx->agent_counter_collection->callback_data.sampling.packets.clear();
             }
             return ROCPROFILER_STATUS_SUCCESS;
         },
@@ -420,9 +558,29 @@ start_agent_ctx(const context::context* ctx)
     agent_ctx.callback_data.table.hsa_signal_wait_relaxed_fn(
         agent_ctx.start_signal, HSA_SIGNAL_CONDITION_EQ, 0, UINT64_MAX, HSA_WAIT_STATE_ACTIVE);
 
+    status = start_agent_reads(*ctx, *agent);
+    if(status == ROCPROFILER_STATUS_SUCCESS) status = start_agent_sampler(*ctx, *agent);
+
+    // Undo the start so that the counters are not left running without a way to read them
+    if(status != ROCPROFILER_STATUS_SUCCESS)
+    {
+        ROCP_ERROR << fmt::format("Context {} could not start the agent counter collection: {}",
+                                  ctx->context_idx,
+                                  rocprofiler_get_status_string(status));
+
+        stop_agent_sampler(*ctx);
+        submitPacket(agent_ctx.callback_data.table,
+                     agent->profile_queue(),
+                     (void*) &agent_ctx.callback_data.packet->stop);
+
+        agent_ctx.status.exchange(
+            rocprofiler::context::agent_counter_collection_service::state::DISABLED);
+        return status;
+    }
+
     agent_ctx.status.exchange(
         rocprofiler::context::agent_counter_collection_service::state::ENABLED);
-    return ROCPROFILER_STATUS_SUCCESS;
+    return status;
 }
 
 rocprofiler_status_t
@@ -454,20 +612,42 @@ stop_agent_ctx(const context::context* ctx)
 
     CHECK(agent_ctx.callback_data.packet);
 
+    // Decodes the periodic samples in flight
+    stop_agent_sampler(*ctx);
+
     submitPacket(agent_ctx.callback_data.table,
                  agent->profile_queue(),
                  (void*) &agent_ctx.callback_data.packet->stop);
 
-    // Wait for any inprogress samples to complete before returning
-    agent_ctx.callback_data.table.hsa_signal_wait_relaxed_fn(agent_ctx.callback_data.completion,
-                                                             HSA_SIGNAL_CONDITION_EQ,
-                                                             1,
-                                                             UINT64_MAX,
-                                                             HSA_WAIT_STATE_ACTIVE);
+    // Wait for any inprogress reads to complete before returning
+    if(agent_ctx.callback_data.reads.queue) agent_ctx.callback_data.reads.queue->sync();
 
     return status;
 }
 
+rocprofiler_status_t
+configure_agent_sampling(rocprofiler_context_id_t context_id, uint64_t interval_ns)
+{
+    auto* ctx = rocprofiler::context::get_mutable_registered_context(context_id);
+    if(!ctx || !ctx->agent_counter_collection) return ROCPROFILER_STATUS_ERROR_CONTEXT_INVALID;
+
+    auto& agent_ctx = *ctx->agent_counter_collection;
+
+    // The interval can only be changed while the context is stopped
+    auto expected = rocprofiler::context::agent_counter_collection_service::state::DISABLED;
+    if(!agent_ctx.status.compare_exchange_strong(
+           expected, rocprofiler::context::agent_counter_collection_service::state::LOCKED))
+    {
+        return ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED;
+    }
+
+    agent_ctx.callback_data.sampling.interval = interval_ns;
+
+    agent_ctx.status.exchange(
+        rocprofiler::context::agent_counter_collection_service::state::DISABLED);
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
 // If we have ctx's that were started before HSA was initialized, we need to
 // actually start those contexts now.
 rocprofiler_status_t
@@ -25,8 +25,15 @@
 #include <rocprofiler-sdk/hsa.h>
 #include <rocprofiler-sdk/rocprofiler.h>
 
+#include "lib/rocprofiler-sdk/counters/agent_read_queue.hpp"
+#include "lib/rocprofiler-sdk/counters/agent_sampler.hpp"
 #include "lib/rocprofiler-sdk/hsa/aql_packet.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 namespace rocprofiler
 {
 namespace context
@@ -36,19 +43,43 @@ struct context;
 
 namespace counters
 {
+// Periodic sampling of an agent context (see
+// rocprofiler_configure_agent_profile_sampling_interval). Every slot of the sampler has
+// its own AQL packet so that the read buffers of the samples in flight are distinct. The
+// decode buffers are reused by every sample.
+struct agent_sampling_data
+{
+    uint64_t                                                                interval = 0;
+    std::vector<std::unique_ptr<hsa::CounterAQLPacket>>                     packets  = {};
+    std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>> decoded  = {};
+    std::vector<std::unique_ptr<std::vector<rocprofiler_record_counter_t>>> cache    = {};
+    std::unique_ptr<agent_sampler>                                          sampler  = {};
+};
+
+// Reads requested by the tool (see rocprofiler_sample_agent_profile_counting_service). Every
+// slot of the read queue has its own AQL packet so that the read buffers of the reads in flight
+// are distinct. The decode buffers are reused by every read.
+struct agent_read_data
+{
+    std::vector<std::unique_ptr<hsa::CounterAQLPacket>>                     packets = {};
+    std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>> decoded = {};
+    std::vector<std::unique_ptr<std::vector<rocprofiler_record_counter_t>>> cache   = {};
+    std::unique_ptr<agent_read_queue>                                       queue   = {};
+};
+
 struct agent_callback_data
 {
     CoreApiTable                           table;
     hsa_queue_t*                           queue{nullptr};
     std::unique_ptr<hsa::CounterAQLPacket> packet;
 
-    // Tri-state signal used to know what the current state of processing
-    // a sample is. The states are:
-    //   1: allow next sample to start (i.e. no in progress work)
-    //   0: sample in progress
-    //  -1: sample complete  (i.e. signal for caller that sample is ready)
-    hsa_signal_t            completion{.handle = 0};
-    rocprofiler_user_data_t user_data{.value = 0};
+    // Signal of the packets which are waited for on submission (i.e. setting the profiler
+    // active on the queue). The states are:
+    //   1: no packet in progress
+    //   0: packet complete
+    hsa_signal_t        completion{.handle = 0};
+    agent_read_data     reads    = {};
+    agent_sampling_data sampling = {};
     ~agent_callback_data();
 };
 
@@ -73,14 +104,23 @@ rocprofiler_status_t
 stop_agent_ctx(const context::context* ctx);
 
 // Read the counter data from the agent. This function is synchronous
-// if flags is not set to ASYNC. If ASYNC is set, the function will
-// return before data has been written to the buffer. Overlapping
-// read calls are not allowed in ASYNC mode and will result in
-// this call waiting for the previous sample to complete.
+// if flags is not set to ASYNC or ASYNC_COALESCE, otherwise it returns
+// before data has been written to the buffer. If every read slot is in
+// flight, the call waits for the oldest read when wait_for_slot is set
+// and returns ROCPROFILER_STATUS_ERROR_OUT_OF_RESOURCES otherwise. The
+// sequence number of the read is returned in sample_id (if not null).
 rocprofiler_status_t
 read_agent_ctx(const context::context*    ctx,
                rocprofiler_user_data_t    user_data,
-               rocprofiler_counter_flag_t flags);
+               rocprofiler_counter_flag_t flags,
+               uint64_t*                  sample_id     = nullptr,
+               bool                       wait_for_slot = true);
+
+// Sample the counter data of the agent every interval_ns nanoseconds while the
+// context is started (zero disables periodic sampling). Must be called while the
+// context is stopped.
+rocprofiler_status_t
+configure_agent_sampling(rocprofiler_context_id_t context_id, uint64_t interval_ns);
 
 }  // namespace counters
 }  // namespace rocprofiler
\ No newline at end of file
@@ -0,0 +1,170 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/agent_read_queue.hpp"
+#include "lib/common/logging.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace rocprofiler
+{
+namespace counters
+{
+agent_read_queue::agent_read_queue(const CoreApiTable& core_table,
+                                   const AmdExtTable&  ext_table,
+                                   size_t              depth,
+                                   submit_func_t       submit_func,
+                                   complete_func_t     complete_func)
+: m_table{core_table}
+, m_async_handler_fn{ext_table.hsa_amd_signal_async_handler_fn}
+, m_submit_func{std::move(submit_func)}
+, m_complete_func{std::move(complete_func)}
+, m_slots(std::max<size_t>(depth, 1))
+{
+    for(auto& itr : m_slots)
+    {
+        itr.queue = this;
+        CHECK_EQ(m_table.hsa_signal_create_fn(1, 0, nullptr, &itr.completion),
+                 HSA_STATUS_SUCCESS);
+    }
+}
+
+agent_read_queue::~agent_read_queue()
+{
+    // the reads in flight cannot complete if the runtime has been shut down
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        if(!m_cv.wait_for(_lk, std::chrono::seconds{1}, [this]() { return m_in_flight == 0; }))
+        {
+            ROCP_WARNING << fmt::format("{} agent profile reads did not complete", m_in_flight);
+        }
+    }
+
+    for(auto& itr : m_slots)
+        m_table.hsa_signal_destroy_fn(itr.completion);
+}
+
+uint64_t
+agent_read_queue::submit(rocprofiler_user_data_t user_data, bool coalesce, bool wait_for_slot)
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+
+    if(coalesce && m_in_flight > 0)
+    {
+        // the counter data of the last read has not been read by the agent yet
+        auto& _last = m_slots.at((m_head + m_in_flight - 1) % m_slots.size());
+        if(!_last.completed)
+        {
+            ++_last.info.num_coalesced;
+            ++m_num_coalesced;
+            return _last.info.sample_id;
+        }
+    }
+
+    if(m_in_flight == m_slots.size())
+    {
+        if(!wait_for_slot) return 0;
+        m_cv.wait(_lk, [this]() { return m_in_flight < m_slots.size(); });
+    }
+
+    auto  _idx       = (m_head + m_in_flight) % m_slots.size();
+    auto  _sample_id = m_next_sample_id;
+    auto& _slot      = m_slots.at(_idx);
+
+    _slot.info      = read_info{_sample_id, user_data, 0};
+    _slot.completed = false;
+    m_table.hsa_signal_store_relaxed_fn(_slot.completion, 1);
+
+    // the handler is registered before the read is submitted and is invoked once
+    if(m_async_handler_fn(
+           _slot.completion, HSA_SIGNAL_CONDITION_LT, 1, completion_handler, &_slot) !=
+       HSA_STATUS_SUCCESS)
+    {
+        ROCP_ERROR << "hsa_amd_signal_async_handler failed for the read of an agent profile";
+        return 0;
+    }
+
+    ++m_in_flight;
+    ++m_next_sample_id;
+    ++m_num_reads;
+    _lk.unlock();
+
+    // the slot is not reused before it has been decoded, i.e. after this read completes
+    m_submit_func(_idx, _slot.completion);
+    return _sample_id;
+}
+
+void
+agent_read_queue::wait(uint64_t sample_id)
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    m_cv.wait(_lk, [this, sample_id]() { return m_decoded_id >= sample_id; });
+}
+
+void
+agent_read_queue::sync()
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    m_cv.wait(_lk, [this]() { return m_in_flight == 0; });
+}
+
+bool
+agent_read_queue::completion_handler(hsa_signal_value_t, void* arg)
+{
+    auto* _slot = static_cast<slot_t*>(arg);
+    _slot->queue->complete(*_slot);
+    return false;
+}
+
+void
+agent_read_queue::complete(slot_t& slot)
+{
+    auto _lk       = std::unique_lock<std::mutex>{m_mutex};
+    slot.completed = true;
+
+    // the reads complete in order on the queue of the agent but their handlers may not be
+    // invoked in order: the first handler which finds the oldest read completed decodes every
+    // completed read from there
+    if(m_decoding) return;
+
+    m_decoding = true;
+    while(m_in_flight > 0 && m_slots.at(m_head).completed)
+    {
+        auto _idx  = m_head;
+        auto _info = m_slots.at(_idx).info;
+        _lk.unlock();
+
+        m_complete_func(_idx, _info);
+
+        _lk.lock();
+        m_head       = (m_head + 1) % m_slots.size();
+        m_decoded_id = _info.sample_id;
+        --m_in_flight;
+        m_cv.notify_all();
+    }
+    m_decoding = false;
+}
+}  // namespace counters
+}  // namespace rocprofiler
@@ -0,0 +1,121 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <rocprofiler-sdk/fwd.h>
+
+#include <hsa/hsa.h>
+#include <hsa/hsa_api_trace.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace counters
+{
+// Reads of the counters of an agent requested by the tool (see
+// rocprofiler_submit_agent_profile_counting_sample). Each read is submitted into one of a
+// fixed number of slots, each with its own completion signal and read buffer, and the caller
+// returns right after the submission: the completion is detected by an HSA async handler and
+// the slots are decoded in the order the reads were submitted. Every read is identified by a
+// sequence number (sample id). A coalescing request made while the last read is still pending
+// on the agent returns the sample id of that read rather than submitting another one.
+class agent_read_queue
+{
+public:
+    struct read_info
+    {
+        uint64_t                sample_id     = 0;
+        rocprofiler_user_data_t user_data     = {.value = 0};  // of the first request
+        uint64_t                num_coalesced = 0;             // requests coalesced into the read
+    };
+
+    // Submits the read of the slot. The completion signal (value of one) must be
+    // decremented to zero once the counter data of the slot is available.
+    using submit_func_t = std::function<void(size_t slot, hsa_signal_t completion)>;
+    // Decodes the counter data of the slot. Invoked once per read, in the order the reads
+    // were submitted.
+    using complete_func_t = std::function<void(size_t slot, const read_info& info)>;
+
+    agent_read_queue(const CoreApiTable& core_table,
+                     const AmdExtTable&  ext_table,
+                     size_t              depth,
+                     submit_func_t       submit_func,
+                     complete_func_t     complete_func);
+    ~agent_read_queue();
+
+    agent_read_queue(const agent_read_queue&) = delete;
+    agent_read_queue& operator=(const agent_read_queue&) = delete;
+
+    // Submits a read (or coalesces the request into the pending read) and returns its sample
+    // id. If every slot is in flight, waits for the oldest read to be decoded when wait_for_slot
+    // is set and returns zero otherwise. Zero is also returned if the read could not be
+    // submitted. Must not be called concurrently from several threads.
+    uint64_t submit(rocprofiler_user_data_t user_data, bool coalesce, bool wait_for_slot);
+
+    // Blocks until the read of the sample has been decoded
+    void wait(uint64_t sample_id);
+
+    // Blocks until every read in flight has been decoded
+    void sync();
+
+    size_t   depth() const { return m_slots.size(); }
+    uint64_t get_num_reads() const { return m_num_reads; }
+    uint64_t get_num_coalesced() const { return m_num_coalesced; }
+
+private:
+    struct slot_t
+    {
+        hsa_signal_t      completion = {.handle = 0};
+        read_info         info       = {};
+        bool              completed  = false;  // counter data is available
+        agent_read_queue* queue      = nullptr;
+    };
+
+    static bool completion_handler(hsa_signal_value_t signal_value, void* arg);
+
+    void complete(slot_t& slot);
+
+    CoreApiTable                            m_table            = {};
+    decltype(hsa_amd_signal_async_handler)* m_async_handler_fn = nullptr;
+    submit_func_t                           m_submit_func      = {};
+    complete_func_t                         m_complete_func    = {};
+    std::vector<slot_t>                     m_slots            = {};
+    size_t                                  m_head             = 0;  // oldest read in flight
+    size_t                                  m_in_flight        = 0;
+    uint64_t                                m_next_sample_id   = 1;
+    uint64_t                                m_decoded_id       = 0;  // last decoded read
+    bool                                    m_decoding         = false;
+    std::atomic<uint64_t>                   m_num_reads        = {0};
+    std::atomic<uint64_t>                   m_num_coalesced    = {0};
+    mutable std::mutex                      m_mutex            = {};
+    std::condition_variable                 m_cv               = {};
+};
+}  // namespace counters
+}  // namespace rocprofiler
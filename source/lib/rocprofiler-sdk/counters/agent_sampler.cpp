@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/agent_sampler.hpp"
+#include "lib/common/logging.hpp"
+#include "lib/common/utility.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+
+namespace rocprofiler
+{
+namespace counters
+{
+agent_sampler::agent_sampler(const CoreApiTable&      table,
+                             std::chrono::nanoseconds interval,
+                             size_t                   depth,
+                             submit_func_t            submit_func,
+                             complete_func_t          complete_func)
+: m_table{table}
+, m_interval{interval}
+, m_submit_func{std::move(submit_func)}
+, m_complete_func{std::move(complete_func)}
+, m_slots(std::max<size_t>(depth, 1))
+{
+    for(auto& itr : m_slots)
+    {
+        CHECK_EQ(m_table.hsa_signal_create_fn(1, 0, nullptr, &itr.completion),
+                 HSA_STATUS_SUCCESS);
+    }
+}
+
+agent_sampler::~agent_sampler()
+{
+    stop();
+    reap();
+
+    // the signals of the samples which never completed are leaked, the agent may still
+    // decrement them
+    for(size_t i = m_in_flight; i < m_slots.size(); ++i)
+        m_table.hsa_signal_destroy_fn(m_slots.at((m_head + i) % m_slots.size()).completion);
+}
+
+void
+agent_sampler::start()
+{
+    if(m_thread.joinable()) return;
+
+    m_stop = false;
+    internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+    m_thread = std::thread{&agent_sampler::run, this};
+    internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+}
+
+void
+agent_sampler::stop()
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        m_stop   = true;
+    }
+    m_cv.notify_all();
+
+    if(m_thread.joinable()) m_thread.join();
+}
+
+void
+agent_sampler::run()
+{
+    using clock_t = std::chrono::steady_clock;
+
+    auto _next = clock_t::now();
+    auto _lk   = std::unique_lock<std::mutex>{m_mutex};
+    while(!m_stop)
+    {
+        _lk.unlock();
+        reap();
+        submit();
+        _lk.lock();
+
+        // ticks missed because a sample (or a decode) took longer than the interval
+        // are dropped rather than submitted back-to-back
+        _next += m_interval;
+        auto _now = clock_t::now();
+        if(_next < _now)
+        {
+            auto _missed = (_now - _next) / m_interval;
+            m_num_dropped += _missed;
+            _next += (_missed + 1) * m_interval;
+        }
+
+        m_cv.wait_until(_lk, _next, [this]() { return m_stop; });
+    }
+    _lk.unlock();
+
+    // decode the samples in flight. The reads cannot complete if the agent hangs or its queue
+    // has been destroyed
+    const auto _deadline = clock_t::now() + drain_timeout;
+    while(true)
+    {
+        reap();
+        if(m_in_flight == m_abandoned) break;
+
+        auto _now = clock_t::now();
+        if(_now >= _deadline)
+        {
+            // the slots stay in flight, i.e. out of use, since the agent may still write their
+            // read buffers and decrement their signals
+            auto _num_incomplete = m_in_flight - m_abandoned;
+            ROCP_WARNING << fmt::format("{} agent counter samples did not complete",
+                                        _num_incomplete);
+            m_num_dropped += _num_incomplete;
+            m_abandoned = m_in_flight;
+            break;
+        }
+
+        // block until the oldest sample completes
+        auto _timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(_deadline - _now);
+        m_table.hsa_signal_wait_scacquire_fn(m_slots.at(m_head).completion,
+                                             HSA_SIGNAL_CONDITION_LT,
+                                             1,
+                                             _timeout.count(),
+                                             HSA_WAIT_STATE_BLOCKED);
+    }
+}
+
+void
+agent_sampler::submit()
+{
+    if(m_in_flight == m_slots.size())
+    {
+        ++m_num_dropped;
+        return;
+    }
+
+    auto  _idx  = (m_head + m_in_flight) % m_slots.size();
+    auto& _slot = m_slots.at(_idx);
+    m_table.hsa_signal_store_relaxed_fn(_slot.completion, 1);
+    _slot.timestamp = common::timestamp_ns();
+    m_submit_func(_idx, _slot.completion);
+    ++m_in_flight;
+}
+
+void
+agent_sampler::reap()
+{
+    // samples complete in the order they were submitted to the queue
+    while(m_in_flight > 0)
+    {
+        // acquire: the counter data of the slot is read after the signal
+        auto& _slot = m_slots.at(m_head);
+        if(m_table.hsa_signal_load_scacquire_fn(_slot.completion) > 0) break;
+
+        if(m_abandoned > 0)
+        {
+            // dropped when the sampler stopped, the agent is done with the slot
+            --m_abandoned;
+        }
+        else
+        {
+            m_complete_func(m_head, _slot.timestamp);
+            ++m_num_samples;
+        }
+        m_head = (m_head + 1) % m_slots.size();
+        --m_in_flight;
+    }
+}
+}  // namespace counters
+}  // namespace rocprofiler
@@ -0,0 +1,108 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <hsa/hsa.h>
+#include <hsa/hsa_api_trace.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace counters
+{
+// Periodically samples the counters of an agent on a dedicated thread. Each sample is
+// submitted into one of a fixed number of slots, each with its own completion signal
+// and read buffer, so up to depth samples are in flight at a time. The sampler thread
+// never blocks on the agent: completed samples are detected by polling the signals of
+// the oldest slots at each tick. Ticks for which every slot is still in flight are
+// dropped.
+class agent_sampler
+{
+public:
+    // Submits the read of the slot. The completion signal (value of one) must be
+    // decremented to zero once the counter data of the slot is available.
+    using submit_func_t = std::function<void(size_t slot, hsa_signal_t completion)>;
+    // Decodes the counter data of the slot. Invoked on the sampler thread in the order
+    // the samples were submitted, timestamp is the time the sample was submitted.
+    using complete_func_t = std::function<void(size_t slot, uint64_t timestamp)>;
+
+    agent_sampler(const CoreApiTable&      table,
+                  std::chrono::nanoseconds interval,
+                  size_t                   depth,
+                  submit_func_t            submit_func,
+                  complete_func_t          complete_func);
+    ~agent_sampler();
+
+    agent_sampler(const agent_sampler&) = delete;
+    agent_sampler& operator=(const agent_sampler&) = delete;
+
+    // Starts the sampler thread
+    void start();
+
+    // Stops the sampler thread after the samples in flight have been decoded. Samples which
+    // do not complete within drain_timeout are counted as dropped, their slots are not reused
+    // until the agent completes them
+    void stop();
+
+    uint64_t get_num_samples() const { return m_num_samples; }
+    uint64_t get_num_dropped() const { return m_num_dropped; }
+
+    static constexpr auto drain_timeout = std::chrono::seconds{1};
+
+private:
+    struct slot_t
+    {
+        hsa_signal_t completion = {.handle = 0};
+        uint64_t     timestamp  = 0;
+    };
+
+    void run();
+    void submit();
+    void reap();
+
+    CoreApiTable             m_table         = {};
+    std::chrono::nanoseconds m_interval      = {};
+    submit_func_t            m_submit_func   = {};
+    complete_func_t          m_complete_func = {};
+    std::vector<slot_t>      m_slots         = {};
+    size_t                   m_head          = 0;  // oldest slot in flight
+    size_t                   m_in_flight     = 0;
+    size_t                   m_abandoned     = 0;  // oldest slots in flight already dropped
+    std::atomic<uint64_t>    m_num_samples   = {0};
+    std::atomic<uint64_t>    m_num_dropped   = {0};
+    std::mutex               m_mutex         = {};
+    std::condition_variable  m_cv            = {};
+    bool                     m_stop          = false;
+    std::thread              m_thread        = {};
+};
+}  // namespace counters
+}  // namespace rocprofiler
@@ -27,15 +27,33 @@
 #include <rocprofiler-sdk/fwd.h>
 #include <rocprofiler-sdk/rocprofiler.h>
 
+#include "lib/common/logging.hpp"
 #include "lib/rocprofiler-sdk/buffer.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
 
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+
 namespace rocprofiler
 {
 namespace counters
 {
+namespace
+{
+// Set once the controller is constructed, i.e. the counter services were used
+std::atomic<bool>&
+controller_constructed()
+{
+    static auto _v = std::atomic<bool>{false};
+    return _v;
+}
+}  // namespace
+
 CounterController::CounterController()
 {
+    controller_constructed() = true;
     // Pre-read metrics map file to catch faliures during initial setup.
     rocprofiler::counters::getMetricIdMap();
 }
@@ -138,6 +156,28 @@ CounterController::configure_dispatch(
     return ROCPROFILER_STATUS_SUCCESS;
 }
 
+rocprofiler_status_t
+CounterController::configure_dispatch_filter(
+    rocprofiler_context_id_t                              context_id,
+    const rocprofiler_profile_counting_dispatch_filter_t& filter)
+{
+    auto* ctx_p = rocprofiler::context::get_mutable_registered_context(context_id);
+    if(!ctx_p || !ctx_p->counter_collection) return ROCPROFILER_STATUS_ERROR_CONTEXT_INVALID;
+
+    return ctx_p->counter_collection->filter.configure(filter);
+}
+
+rocprofiler_status_t
+CounterController::configure_dispatch_sampling(
+    rocprofiler_context_id_t                       context_id,
+    const rocprofiler_profile_counting_sampling_t& sampling)
+{
+    auto* ctx_p = rocprofiler::context::get_mutable_registered_context(context_id);
+    if(!ctx_p || !ctx_p->counter_collection) return ROCPROFILER_STATUS_ERROR_CONTEXT_INVALID;
+
+    return ctx_p->counter_collection->filter.configure(sampling);
+}
+
 std::shared_ptr<profile_config>
 CounterController::get_profile_cfg(rocprofiler_profile_config_id_t id)
 {
@@ -146,6 +186,90 @@ CounterController::get_profile_cfg(rocprofiler_profile_config_id_t id)
     return cfg;
 }
 
+void
+CounterController::remove_queue(uint64_t queue_id)
+{
+    _configs.rlock([&](const auto& map) {
+        for(const auto& [_, cfg] : map)
+            cfg->packets.wlock([&](auto& queue_rings) { queue_rings.erase(queue_id); });
+    });
+}
+
+void
+CounterController::finalize()
+{
+    _configs.rlock([](const auto& map) {
+        for(const auto& [id, cfg] : map)
+        {
+            if(auto num_kernels = drop_partial_kernel_passes(*cfg); num_kernels > 0)
+            {
+                ROCP_WARNING << fmt::format(
+                    "{} kernel(s) did not complete the {} passes of counter profile {}, their "
+                    "counters are not reported",
+                    num_kernels,
+                    cfg->pkt_generators.size(),
+                    id);
+            }
+        }
+    });
+}
+
+size_t
+next_kernel_pass(profile_config& config, rocprofiler_kernel_id_t kernel_id)
+{
+    return config.kernel_passes.wlock([&](auto& kernels) {
+        auto& state     = kernels[kernel_id];
+        auto  pass      = state.next_pass;
+        state.next_pass = (pass + 1) % config.pkt_generators.size();
+        return pass;
+    });
+}
+
+bool
+merge_kernel_pass(profile_config&         config,
+                  rocprofiler_kernel_id_t kernel_id,
+                  size_t                  pass,
+                  decoded_pkt_t&          decoded)
+{
+    auto num_passes = config.pkt_generators.size();
+    return config.kernel_passes.wlock([&](auto& kernels) {
+        auto& state = kernels[kernel_id];
+        state.collected.resize(num_passes, false);
+        state.collected.at(pass) = true;
+        for(auto& [id, records] : decoded)
+            state.decoded[id] = std::move(records);
+
+        if(std::find(state.collected.begin(), state.collected.end(), false) !=
+           state.collected.end())
+        {
+            return false;
+        }
+
+        decoded = std::move(state.decoded);
+        state.decoded.clear();
+        state.collected.assign(num_passes, false);
+        return true;
+    });
+}
+
+size_t
+drop_partial_kernel_passes(profile_config& config)
+{
+    return config.kernel_passes.wlock([](auto& kernels) {
+        size_t num_kernels = 0;
+        for(auto& [_, state] : kernels)
+        {
+            if(std::find(state.collected.begin(), state.collected.end(), true) !=
+               state.collected.end())
+            {
+                ++num_kernels;
+            }
+            state = kernel_pass_state{};
+        }
+        return num_kernels;
+    });
+}
+
 CounterController&
 get_controller()
 {
@@ -165,6 +289,12 @@ destroy_counter_profile(uint64_t id)
     get_controller().destroy_profile(id);
 }
 
+void
+finalize()
+{
+    if(controller_constructed()) get_controller().finalize();
+}
+
 std::shared_ptr<profile_config>
 get_profile_config(rocprofiler_profile_config_id_t id)
 {
@@ -176,5 +306,11 @@ get_profile_config(rocprofiler_profile_config_id_t id)
         return nullptr;
     }
 }
+
+void
+remove_queue(uint64_t queue_id)
+{
+    get_controller().remove_queue(queue_id);
+}
 }  // namespace counters
 }  // namespace rocprofiler
\ No newline at end of file
@@ -27,16 +27,36 @@
 #include "lib/rocprofiler-sdk/aql/packet_construct.hpp"
 #include "lib/rocprofiler-sdk/counters/evaluate_ast.hpp"
 #include "lib/rocprofiler-sdk/counters/metrics.hpp"
+#include "lib/rocprofiler-sdk/counters/packet_ring.hpp"
 
 #include <rocprofiler-sdk/agent.h>
 #include <rocprofiler-sdk/dispatch_profile.h>
 #include <rocprofiler-sdk/fwd.h>
 #include <rocprofiler-sdk/rocprofiler.h>
 
+#include <unordered_map>
+#include <vector>
+
 namespace rocprofiler
 {
 namespace counters
 {
+// Counter id -> values read from the counters
+using decoded_pkt_t = std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>>;
+
+// Hardware counter values of a kernel collected by the passes of a profile
+// so far. Only used if the hardware counters of the profile do not fit in a
+// single pass.
+struct kernel_pass_state
+{
+    // Pass applied to the next dispatch of the kernel
+    size_t next_pass = 0;
+    // Passes whose values were read since the last complete set
+    std::vector<bool> collected = {};
+    // Values of the hardware counters read so far
+    decoded_pkt_t decoded = {};
+};
+
 // Stores counter profiling information such as the agent
 // to collect counters on, the metrics to collect, the hw
 // counters needed to evaluate the metrics, and the ASTs.
@@ -55,14 +75,40 @@ struct profile_config
     // ASTs to evaluate
     std::vector<counters::EvaluateAST> asts{};
     rocprofiler_profile_config_id_t    id{.handle = 0};
-    // Packet generator to create AQL packets for insertion
-    std::unique_ptr<rocprofiler::aql::CounterPacketConstruct> pkt_generator{nullptr};
-    // A packet cache of AQL packets. This allows reuse of AQL packets (preventing costly
-    // allocation of new packets/destruction).
-    rocprofiler::common::Synchronized<std::vector<std::unique_ptr<rocprofiler::hsa::AQLPacket>>>
+    // Packet generators to create AQL packets for insertion, one per pass. When the hw
+    // counters exceed the hardware counters of a block, they are split into several
+    // passes which are applied round-robin to successive dispatches of a kernel.
+    std::vector<std::unique_ptr<rocprofiler::aql::CounterPacketConstruct>> pkt_generators{};
+    // Queue id -> ring of AQL packets of every pass. The buffers of the packets are allocated
+    // once per block of slots and re-armed in place by the dispatches on the queue (no
+    // allocation or access grants on the dispatch path). The rings of a queue are released
+    // when the queue is destroyed.
+    rocprofiler::common::Synchronized<
+        std::unordered_map<uint64_t, std::vector<std::unique_ptr<packet_ring>>>>
         packets{};
+    // Kernel id -> values collected by the passes of the kernel (multi-pass profiles only)
+    rocprofiler::common::Synchronized<std::unordered_map<uint64_t, kernel_pass_state>>
+        kernel_passes{};
 };
 
+// Pass of a multi-pass profile applied to the next dispatch of the kernel. Successive
+// dispatches of a kernel take the passes round-robin.
+size_t
+next_kernel_pass(profile_config& config, rocprofiler_kernel_id_t kernel_id);
+
+// Adds the values read by a pass of a multi-pass profile to the values of the kernel. Returns
+// true, with the values of every pass in decoded, once all the passes of the kernel were read.
+bool
+merge_kernel_pass(profile_config&         config,
+                  rocprofiler_kernel_id_t kernel_id,
+                  size_t                  pass,
+                  decoded_pkt_t&          decoded);
+
+// Discards the values of the kernels of a multi-pass profile whose passes were not all read
+// and returns the number of those kernels.
+size_t
+drop_partial_kernel_passes(profile_config& config);
+
 class CounterController
 {
 public:
@@ -85,8 +131,27 @@ public:
         void*                                            callback_args,
         rocprofiler_profile_counting_record_callback_t   record_callback,
         void*                                            record_callback_args);
+
+    // Restricts the dispatch counting services of the context to the dispatches selected by
+    // the filter. Requires a configured dispatch counting service.
+    static rocprofiler_status_t configure_dispatch_filter(
+        rocprofiler_context_id_t                              context_id,
+        const rocprofiler_profile_counting_dispatch_filter_t& filter);
+
+    // Sets a dispatch sampling policy of the dispatch counting services of the context.
+    // Requires a configured dispatch counting service.
+    static rocprofiler_status_t configure_dispatch_sampling(
+        rocprofiler_context_id_t                       context_id,
+        const rocprofiler_profile_counting_sampling_t& sampling);
     std::shared_ptr<profile_config> get_profile_cfg(rocprofiler_profile_config_id_t id);
 
+    // Releases the packet rings of the queue held by every profile
+    void remove_queue(uint64_t queue_id);
+
+    // Warns about (and discards) the values of the kernels whose passes were not all read when
+    // the dispatches of the multi-pass profiles can no longer complete
+    void finalize();
+
     static rocprofiler_status_t configure_agent_collection(rocprofiler_context_id_t context_id,
                                                            rocprofiler_buffer_id_t  buffer_id,
                                                            rocprofiler_agent_id_t   agent_id,
@@ -107,8 +172,15 @@ create_counter_profile(std::shared_ptr<profile_config>&& config);
 void
 destroy_counter_profile(uint64_t id);
 
+void
+finalize();
+
 std::shared_ptr<profile_config>
 get_profile_config(rocprofiler_profile_config_id_t id);
 
+// Called when a queue is destroyed, once every dispatch on the queue has completed
+void
+remove_queue(uint64_t queue_id);
+
 }  // namespace counters
 }  // namespace rocprofiler
@@ -41,7 +41,7 @@ rocprofiler_status_t
 counter_callback_info::setup_profile_config(const hsa::AgentCache&           agent,
                                             std::shared_ptr<profile_config>& profile)
 {
-    if(profile->pkt_generator || !profile->reqired_hw_counters.empty())
+    if(!profile->pkt_generators.empty() || !profile->reqired_hw_counters.empty())
     {
         return ROCPROFILER_STATUS_SUCCESS;
     }
@@ -103,40 +103,83 @@ counter_callback_info::setup_profile_config(const hsa::AgentCache&           age
         }
     }
 
-    profile->pkt_generator = std::make_unique<rocprofiler::aql::CounterPacketConstruct>(
+    // Hardware counters which do not fit in the hardware counters of a block at the same time
+    // are collected over several passes (i.e. dispatches)
+    auto passes = rocprofiler::aql::CounterPacketConstruct::partition(
         agent.get_rocp_agent()->id,
         std::vector<counters::Metric>{profile->reqired_hw_counters.begin(),
                                       profile->reqired_hw_counters.end()});
+    if(passes.empty()) passes.emplace_back();
+
+    if(passes.size() > 1)
+    {
+        ROCP_INFO << fmt::format("Hardware counters of profile {} are collected in {} passes",
+                                 profile->id.handle,
+                                 passes.size());
+    }
+
+    for(const auto& pass : passes)
+    {
+        profile->pkt_generators.emplace_back(
+            std::make_unique<rocprofiler::aql::CounterPacketConstruct>(agent.get_rocp_agent()->id,
+                                                                       pass));
+    }
     return ROCPROFILER_STATUS_SUCCESS;
 }
 
 rocprofiler_status_t
 counter_callback_info::get_packet(std::unique_ptr<rocprofiler::hsa::AQLPacket>& ret_pkt,
                                   const hsa::AgentCache&                        agent,
-                                  std::shared_ptr<profile_config>&              profile)
+                                  std::shared_ptr<profile_config>&              profile,
+                                  rocprofiler_kernel_id_t                       kernel_id,
+                                  uint64_t                                      sample_weight,
+                                  const hsa::Queue*                             queue)
 {
     rocprofiler_status_t status;
-    // Check packet cache
-    profile->packets.wlock([&](auto& pkt_vector) {
+    size_t               pass     = 0;
+    packet_ring*         ring     = nullptr;
+    const auto&          ext      = CHECK_NOTNULL(hsa::get_queue_controller())->get_ext_table();
+    auto                 queue_id = (queue) ? queue->get_id().handle : 0;
+    // Take a packet from the ring of the queue
+    profile->packets.wlock([&](auto& queue_rings) {
         status = counter_callback_info::setup_profile_config(agent, profile);
-        if(!pkt_vector.empty() && status == ROCPROFILER_STATUS_SUCCESS)
+        if(status != ROCPROFILER_STATUS_SUCCESS) return;
+
+        // Successive dispatches of a kernel collect the passes round-robin
+        if(profile->pkt_generators.size() > 1) pass = next_kernel_pass(*profile, kernel_id);
+
+        auto& rings = queue_rings[queue_id];
+        if(rings.empty())
         {
-            ret_pkt = std::move(pkt_vector.back());
-            pkt_vector.pop_back();
+            auto capacity = (queue) ? packet_ring::queue_capacity(queue->intercept_queue()->size)
+                                    : packet_ring::default_block_slots;
+            for(auto& itr : profile->pkt_generators)
+            {
+                auto* gen = itr.get();
+                rings.emplace_back(std::make_unique<packet_ring>(
+                    capacity,
+                    [gen, &ext](size_t count) { return gen->construct_packets(ext, count); }));
+            }
         }
+
+        ring    = rings.at(pass).get();
+        ret_pkt = ring->acquire();
+        if(!ret_pkt) ring = nullptr;
     });
 
     if(status != ROCPROFILER_STATUS_SUCCESS) return status;
     if(!ret_pkt)
     {
-        // If we do not have a packet in the cache, create one.
-        ret_pkt = profile->pkt_generator->construct_packet(
-            CHECK_NOTNULL(hsa::get_queue_controller())->get_ext_table());
+        // Every slot of the ring is in flight: construct a packet which is destroyed when the
+        // dispatch completes instead of waiting for a slot on the dispatch path
+        ret_pkt = profile->pkt_generators.at(pass)->construct_packet(ext);
     }
 
     ret_pkt->before_krn_pkt.clear();
     ret_pkt->after_krn_pkt.clear();
-    packet_return_map.wlock([&](auto& data) { data.emplace(ret_pkt.get(), profile); });
+    packet_return_map.wlock([&](auto& data) {
+        data.emplace(ret_pkt.get(), packet_profile{profile, pass, sample_weight, ring});
+    });
 
     return ROCPROFILER_STATUS_SUCCESS;
 }
@@ -243,5 +286,19 @@ configure_callback_dispatch(rocprofiler_context_id_t                         con
                                                record_callback_args);
 }
 
+rocprofiler_status_t
+configure_dispatch_filter(rocprofiler_context_id_t                              context_id,
+                          const rocprofiler_profile_counting_dispatch_filter_t& filter)
+{
+    return get_controller().configure_dispatch_filter(context_id, filter);
+}
+
+rocprofiler_status_t
+configure_dispatch_sampling(rocprofiler_context_id_t                       context_id,
+                            const rocprofiler_profile_counting_sampling_t& sampling)
+{
+    return get_controller().configure_dispatch_sampling(context_id, sampling);
+}
+
 }  // namespace counters
 }  // namespace rocprofiler
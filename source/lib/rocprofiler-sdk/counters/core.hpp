@@ -40,6 +40,17 @@ struct context;
 }
 namespace counters
 {
+// Profile and pass that constructed an AQL packet, sample weight of the dispatch, and the ring
+// the packet returns to (nullptr if the packet was constructed because the ring was exhausted, it
+// is destroyed on completion)
+struct packet_profile
+{
+    std::shared_ptr<profile_config> profile       = {};
+    size_t                          pass          = 0;
+    uint64_t                        sample_weight = 1;
+    packet_ring*                    ring          = nullptr;
+};
+
 // Internal counter struct that stores the state needed to handle an intercepted
 // HSA kernel packet.
 struct counter_callback_info
@@ -63,15 +74,20 @@ struct counter_callback_info
 
     // Facilitates the return of an AQL Packet to the profile config that constructed it.
     rocprofiler::common::Synchronized<
-        std::unordered_map<rocprofiler::hsa::AQLPacket*, std::shared_ptr<profile_config>>>
+        std::unordered_map<rocprofiler::hsa::AQLPacket*, packet_profile>>
         packet_return_map{};
 
     static rocprofiler_status_t setup_profile_config(const hsa::AgentCache&,
                                                      std::shared_ptr<profile_config>&);
 
+    // Packet for a dispatch of the kernel on the queue, taken from the packet ring of the queue.
+    // If the profile has several passes, the packet collects the next pass of the kernel
     rocprofiler_status_t get_packet(std::unique_ptr<rocprofiler::hsa::AQLPacket>&,
                                     const hsa::AgentCache&,
-                                    std::shared_ptr<profile_config>&);
+                                    std::shared_ptr<profile_config>&,
+                                    rocprofiler_kernel_id_t kernel_id     = 0,
+                                    uint64_t                sample_weight = 1,
+                                    const hsa::Queue*       queue         = nullptr);
 };
 
 uint64_t
@@ -93,6 +109,14 @@ configure_callback_dispatch(rocprofiler_context_id_t                         con
                             rocprofiler_profile_counting_record_callback_t   record_callback,
                             void*                                            record_callback_args);
 
+rocprofiler_status_t
+configure_dispatch_filter(rocprofiler_context_id_t                              context_id,
+                          const rocprofiler_profile_counting_dispatch_filter_t& filter);
+
+rocprofiler_status_t
+configure_dispatch_sampling(rocprofiler_context_id_t                       context_id,
+                            const rocprofiler_profile_counting_sampling_t& sampling);
+
 rocprofiler_status_t
 configure_agent_collection(rocprofiler_context_id_t             context_id,
                            rocprofiler_buffer_id_t              buffer_id,
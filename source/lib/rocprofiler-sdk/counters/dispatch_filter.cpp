@@ -0,0 +1,249 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/dispatch_filter.hpp"
+#include "lib/common/utility.hpp"
+#include "lib/rocprofiler-sdk/code_object/code_object.hpp"
+
+#include <algorithm>
+
+namespace rocprofiler
+{
+namespace counters
+{
+namespace
+{
+// splitmix64 finalizer: the random policy hashes the seed, the kernel, and the dispatch count
+// of the kernel so the selection does not depend on the order the dispatches are processed in
+uint64_t
+mix(uint64_t val)
+{
+    val += 0x9e3779b97f4a7c15ULL;
+    val = (val ^ (val >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    val = (val ^ (val >> 27)) * 0x94d049bb133111ebULL;
+    return val ^ (val >> 31);
+}
+}  // namespace
+
+uint64_t
+dispatch_filter::kernel_state::sample(rocprofiler_kernel_id_t kernel_id)
+{
+    auto count   = dispatches.fetch_add(1, std::memory_order_relaxed) + 1;
+    auto _period = std::max<uint64_t>(period.load(std::memory_order_relaxed), 1);
+
+    switch(policy.load(std::memory_order_relaxed))
+    {
+        case ROCPROFILER_PROFILE_COUNTING_SAMPLING_NONE: return 1;
+        case ROCPROFILER_PROFILE_COUNTING_SAMPLING_STRIDE:
+            return ((count - 1) % _period == 0) ? _period : 0;
+        case ROCPROFILER_PROFILE_COUNTING_SAMPLING_FIRST: return (count <= _period) ? 1 : 0;
+        case ROCPROFILER_PROFILE_COUNTING_SAMPLING_INTERVAL:
+        {
+            auto now  = common::timestamp_ns();
+            auto next = next_sample_ns.load(std::memory_order_relaxed);
+            if(now < next || !next_sample_ns.compare_exchange_strong(next, now + _period))
+                return 0;
+
+            auto prev = last_sample.exchange(count, std::memory_order_relaxed);
+            return (count > prev) ? (count - prev) : 1;
+        }
+        case ROCPROFILER_PROFILE_COUNTING_SAMPLING_RANDOM:
+        {
+            auto _seed = seed.load(std::memory_order_relaxed);
+            return (mix(mix(_seed ^ kernel_id) + count) % _period == 0) ? _period : 0;
+        }
+        case ROCPROFILER_PROFILE_COUNTING_SAMPLING_LAST: break;
+    }
+    return 0;
+}
+
+void
+dispatch_filter::kernel_state::reset(const rocprofiler_profile_counting_sampling_t& sampling)
+{
+    policy.store(sampling.policy, std::memory_order_relaxed);
+    period.store(sampling.period, std::memory_order_relaxed);
+    seed.store(sampling.seed, std::memory_order_relaxed);
+    dispatches.store(0, std::memory_order_relaxed);
+    last_sample.store(0, std::memory_order_relaxed);
+    next_sample_ns.store(0, std::memory_order_relaxed);
+}
+
+rocprofiler_status_t
+dispatch_filter::configure(const rocprofiler_profile_counting_dispatch_filter_t& filter)
+{
+    if(filter.kernel_ids_count > 0 && !filter.kernel_ids)
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    auto _dispatch_end = (filter.dispatch_id_end == 0) ? max_dispatch_id : filter.dispatch_id_end;
+    if(filter.dispatch_id_begin >= _dispatch_end) return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    register_load_callback();
+
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+
+    m_kernel_ids.clear();
+    m_kernel_ids.insert(filter.kernel_ids, filter.kernel_ids + filter.kernel_ids_count);
+    m_kernel_filter      = filter.kernel_filter;
+    m_kernel_filter_args = filter.kernel_filter_args;
+    m_all_kernels        = (m_kernel_ids.empty() && !m_kernel_filter);
+    rebuild();
+
+    m_dispatch_begin.store(filter.dispatch_id_begin, std::memory_order_relaxed);
+    m_dispatch_end.store(_dispatch_end, std::memory_order_relaxed);
+    m_enabled.store(true, std::memory_order_release);
+
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
+rocprofiler_status_t
+dispatch_filter::configure(const rocprofiler_profile_counting_sampling_t& sampling)
+{
+    if(sampling.policy >= ROCPROFILER_PROFILE_COUNTING_SAMPLING_LAST)
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+    if(sampling.policy != ROCPROFILER_PROFILE_COUNTING_SAMPLING_NONE && sampling.period == 0)
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    register_load_callback();
+
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+
+    m_sampling[sampling.kernel_id] = sampling;
+    if(m_every_dispatch.load(std::memory_order_relaxed))
+    {
+        // the states of the targeted kernels are published with the first policy
+        rebuild();
+    }
+    else if(sampling.kernel_id != 0)
+    {
+        // only the kernel of the policy, if it has been loaded
+        if(auto* itr = common::get_val(m_states, sampling.kernel_id)) (*itr)->reset(sampling);
+    }
+    else
+    {
+        // the kernels without a policy of their own use the default policy
+        for(auto& [kernel_id, state] : m_states)
+        {
+            if(m_sampling.count(kernel_id) == 0) state->reset(sampling);
+        }
+    }
+
+    m_enabled.store(true, std::memory_order_release);
+
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
+void
+dispatch_filter::add_kernels(const std::vector<kernel_t>& kernels)
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+
+    auto _added = std::vector<const std::pair<const rocprofiler_kernel_id_t, std::string>*>{};
+    for(const auto& itr : kernels)
+    {
+        auto ret = m_kernel_names.emplace(itr.id, std::string{itr.name});
+        if(ret.second) _added.emplace_back(&*ret.first);
+    }
+
+    if(_added.empty() || m_every_dispatch.load(std::memory_order_relaxed)) return;
+
+    // publish the states of all the kernels at once
+    m_kernels.modify([this, &_added](kernel_state_map_t::map_type& states) {
+        for(const auto* itr : _added)
+        {
+            if(m_all_kernels || resolve(itr->first, itr->second))
+                states[itr->first] = get_state(itr->first, true);
+        }
+    });
+}
+
+void
+dispatch_filter::register_load_callback()
+{
+    // record the kernels which are already loaded and the ones loaded from now on
+    std::call_once(m_load_callback, [this]() {
+        auto&& _add_kernels = [this](const code_object::hsa::code_object& obj) {
+            auto _kernels = std::vector<kernel_t>{};
+            _kernels.reserve(obj.symbols.size());
+            for(const auto& itr : obj.symbols)
+            {
+                if(itr) _kernels.emplace_back(kernel_t{itr->rocp_data.kernel_id, itr->name});
+            }
+            add_kernels(_kernels);
+        };
+
+        code_object::add_code_object_load_callback(_add_kernels);
+        code_object::iterate_loaded_code_objects(_add_kernels);
+    });
+}
+
+void
+dispatch_filter::rebuild()
+{
+    // the dispatches only look up the states once they are published
+    auto _every_dispatch = (m_all_kernels && m_sampling.empty());
+    if(_every_dispatch) m_every_dispatch.store(true, std::memory_order_relaxed);
+
+    m_kernels.modify([this, _every_dispatch](kernel_state_map_t::map_type& states) {
+        auto _previous = kernel_state_map_t::map_type{};
+        std::swap(_previous, states);
+        if(_every_dispatch) return;
+        for(const auto& [kernel_id, kernel_name] : m_kernel_names)
+        {
+            // the kernels which remain targeted keep counting their dispatches
+            if(m_all_kernels || resolve(kernel_id, kernel_name))
+                states[kernel_id] = get_state(kernel_id, _previous.count(kernel_id) == 0);
+        }
+    });
+
+    if(!_every_dispatch) m_every_dispatch.store(false, std::memory_order_release);
+}
+
+bool
+dispatch_filter::resolve(rocprofiler_kernel_id_t kernel_id, const std::string& kernel_name) const
+{
+    if(m_kernel_ids.count(kernel_id) > 0) return true;
+    return (m_kernel_filter &&
+            m_kernel_filter(kernel_id, kernel_name.c_str(), m_kernel_filter_args) != 0);
+}
+
+rocprofiler_profile_counting_sampling_t
+dispatch_filter::get_sampling(rocprofiler_kernel_id_t kernel_id) const
+{
+    if(const auto* itr = common::get_val(m_sampling, kernel_id)) return *itr;
+    if(const auto* itr = common::get_val(m_sampling, rocprofiler_kernel_id_t{0})) return *itr;
+    return common::init_public_api_struct(rocprofiler_profile_counting_sampling_t{});
+}
+
+dispatch_filter::kernel_state*
+dispatch_filter::get_state(rocprofiler_kernel_id_t kernel_id, bool restart)
+{
+    auto& state = m_states[kernel_id];
+    if(!state)
+    {
+        state   = std::make_unique<kernel_state>();
+        restart = true;
+    }
+    if(restart) state->reset(get_sampling(kernel_id));
+    return state.get();
+}
+}  // namespace counters
+}  // namespace rocprofiler
@@ -0,0 +1,147 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/common/container/read_mostly_map.hpp"
+
+#include <rocprofiler-sdk/dispatch_profile.h>
+#include <rocprofiler-sdk/fwd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace counters
+{
+// Selects the dispatches of a context which are profiled by its dispatch counting services.
+// Whether a kernel is targeted, and its sampling policy, are resolved when its code object is
+// loaded (or when the filter or a policy is configured) so the dispatch path only performs a
+// lock-free lookup. Until a filter or a policy is configured, every dispatch is profiled.
+class dispatch_filter
+{
+public:
+    struct kernel_t
+    {
+        rocprofiler_kernel_id_t id   = 0;
+        std::string_view        name = {};
+    };
+
+    dispatch_filter()  = default;
+    ~dispatch_filter() = default;
+
+    dispatch_filter(const dispatch_filter&) = delete;
+    dispatch_filter& operator=(const dispatch_filter&) = delete;
+
+    // Replaces the filter and re-resolves the kernels which were already loaded
+    rocprofiler_status_t configure(const rocprofiler_profile_counting_dispatch_filter_t& filter);
+
+    // Sets the sampling policy of a kernel (or the default policy) and restarts the dispatch
+    // counts of the kernels which use the policy
+    rocprofiler_status_t configure(const rocprofiler_profile_counting_sampling_t& sampling);
+
+    // Resolves the targeting and the sampling policy of newly loaded kernels
+    void add_kernels(const std::vector<kernel_t>& kernels);
+    void add_kernel(rocprofiler_kernel_id_t kernel_id, std::string_view kernel_name)
+    {
+        add_kernels({kernel_t{kernel_id, kernel_name}});
+    }
+
+    // Returns the sample weight of the dispatch, i.e. the number of dispatches of the kernel the
+    // dispatch represents, or zero if the dispatch is not profiled
+    uint64_t select(rocprofiler_kernel_id_t kernel_id, rocprofiler_dispatch_id_t dispatch_id)
+    {
+        if(!m_enabled.load(std::memory_order_acquire)) return 1;
+        if(dispatch_id < m_dispatch_begin.load(std::memory_order_relaxed) ||
+           dispatch_id >= m_dispatch_end.load(std::memory_order_relaxed))
+            return 0;
+        if(m_every_dispatch.load(std::memory_order_relaxed)) return 1;
+
+        auto* state = m_kernels.find(kernel_id, nullptr);
+        return (state) ? state->sample(kernel_id) : 0;
+    }
+
+private:
+    static constexpr auto max_dispatch_id = std::numeric_limits<rocprofiler_dispatch_id_t>::max();
+
+    using policy_t = rocprofiler_profile_counting_sampling_policy_t;
+
+    // sampling state of a kernel, shared by the dispatches of the kernel. A kernel has a single
+    // state which is updated in place when its policy changes
+    struct kernel_state
+    {
+        uint64_t sample(rocprofiler_kernel_id_t kernel_id);
+
+        // applies the policy and restarts the dispatch counts. A dispatch sampled concurrently
+        // may use either policy
+        void reset(const rocprofiler_profile_counting_sampling_t& sampling);
+
+        std::atomic<policy_t> policy         = {ROCPROFILER_PROFILE_COUNTING_SAMPLING_NONE};
+        std::atomic<uint64_t> period         = {0};
+        std::atomic<uint64_t> seed           = {0};
+        std::atomic<uint64_t> dispatches     = {0};
+        std::atomic<uint64_t> last_sample    = {0};
+        std::atomic<uint64_t> next_sample_ns = {0};
+    };
+
+    using kernel_name_map_t = std::unordered_map<rocprofiler_kernel_id_t, std::string>;
+    using sampling_map_t =
+        std::unordered_map<rocprofiler_kernel_id_t, rocprofiler_profile_counting_sampling_t>;
+    using kernel_state_map_t =
+        common::container::read_mostly_map<rocprofiler_kernel_id_t, kernel_state*>;
+    using kernel_state_ptr_map_t =
+        std::unordered_map<rocprofiler_kernel_id_t, std::unique_ptr<kernel_state>>;
+
+    void register_load_callback();
+    void rebuild();
+    bool resolve(rocprofiler_kernel_id_t kernel_id, const std::string& kernel_name) const;
+    rocprofiler_profile_counting_sampling_t get_sampling(rocprofiler_kernel_id_t kernel_id) const;
+    kernel_state* get_state(rocprofiler_kernel_id_t kernel_id, bool restart);
+
+    std::mutex                                   m_mutex              = {};
+    std::once_flag                               m_load_callback      = {};
+    bool                                         m_all_kernels        = true;
+    std::unordered_set<rocprofiler_kernel_id_t>  m_kernel_ids         = {};
+    rocprofiler_profile_counting_kernel_filter_t m_kernel_filter      = nullptr;
+    void*                                        m_kernel_filter_args = nullptr;
+    sampling_map_t                               m_sampling           = {};
+    kernel_name_map_t                            m_kernel_names       = {};
+    // states are only released with the filter since dispatches may still use the states of
+    // kernels which are no longer targeted
+    kernel_state_ptr_map_t                 m_states         = {};
+    kernel_state_map_t                     m_kernels        = {};
+    std::atomic<bool>                      m_enabled        = {false};
+    std::atomic<bool>                      m_every_dispatch = {true};
+    std::atomic<rocprofiler_dispatch_id_t> m_dispatch_begin = {0};
+    std::atomic<rocprofiler_dispatch_id_t> m_dispatch_end   = {max_dispatch_id};
+};
+}  // namespace counters
+}  // namespace rocprofiler
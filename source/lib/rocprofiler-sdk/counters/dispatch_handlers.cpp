@@ -61,7 +61,8 @@ queue_cb(const context::context*                                         ctx,
     // and maybe adds barrier packets if the state is transitioning from serialized <->
     // unserialized
     auto maybe_add_serialization = [&](auto& gen_pkt) {
-        CHECK_NOTNULL(hsa::get_queue_controller())->serializer().rlock([&](const auto& serializer) {
+        const auto& _serializer = CHECK_NOTNULL(hsa::get_queue_controller())->serializer(queue);
+        _serializer.rlock([&](const auto& serializer) {
             for(auto& s_pkt : serializer.kernel_dispatch(queue))
             {
                 gen_pkt->before_krn_pkt.push_back(s_pkt.ext_amd_aql_pm4);
@@ -77,7 +78,8 @@ queue_cb(const context::context*                                         ctx,
         // to add barrier packets to transition from serialized -> unserialized execution. This
         // transition is coordinated by the serializer.
         maybe_add_serialization(ret_pkt);
-        info->packet_return_map.wlock([&](auto& data) { data.emplace(ret_pkt.get(), nullptr); });
+        info->packet_return_map.wlock(
+            [&](auto& data) { data.emplace(ret_pkt.get(), packet_profile{}); });
         return ret_pkt;
     };
 
@@ -93,6 +95,16 @@ queue_cb(const context::context*                                         ctx,
         return no_instrumentation();
     }
 
+    // Dispatches excluded by the filter of the context, or not selected by the sampling policy
+    // of their kernel, skip the callback of the tool and get no counter packets. They are still
+    // serialized, i.e. a profiled dispatch waits for them to drain from the agent and blocks
+    // them while it runs.
+    auto sample_weight = ctx->counter_collection->filter.select(kernel_id, dispatch_id);
+    if(sample_weight == 0)
+    {
+        return no_instrumentation();
+    }
+
     auto _corr_id_v =
         rocprofiler_correlation_id_t{.internal = 0, .external = context::null_user_data};
     if(const auto* _corr_id = correlation_id)
@@ -110,6 +122,7 @@ queue_cb(const context::context*                                         ctx,
         common::init_public_api_struct(rocprofiler_profile_counting_dispatch_data_t{});
 
     dispatch_data.correlation_id = _corr_id_v;
+    dispatch_data.sample_weight  = sample_weight;
     {
         auto dispatch_info = common::init_public_api_struct(rocprofiler_kernel_dispatch_info_t{});
         dispatch_info.kernel_id            = kernel_id;
@@ -138,7 +151,8 @@ queue_cb(const context::context*                                         ctx,
     CHECK(prof_config);
 
     std::unique_ptr<rocprofiler::hsa::AQLPacket> ret_pkt;
-    auto status = info->get_packet(ret_pkt, queue.get_agent(), prof_config);
+    auto status = info->get_packet(
+        ret_pkt, queue.get_agent(), prof_config, kernel_id, sample_weight, &queue);
     CHECK_EQ(status, ROCPROFILER_STATUS_SUCCESS) << rocprofiler_get_status_string(status);
 
     maybe_add_serialization(ret_pkt);
@@ -172,6 +186,9 @@ completed_cb(const context::context*                       ctx,
     CHECK(info && ctx);
 
     std::shared_ptr<profile_config> prof_config;
+    size_t                          pass          = 0;
+    uint64_t                        sample_weight = 1;
+    packet_ring*                    ring          = nullptr;
     // Get the Profile Config
     std::unique_ptr<rocprofiler::hsa::AQLPacket> pkt = nullptr;
     info->packet_return_map.wlock([&](auto& data) {
@@ -180,7 +197,10 @@ completed_cb(const context::context*                       ctx,
             const auto* profile = rocprofiler::common::get_val(data, aql_pkt.get());
             if(profile)
             {
-                prof_config = *profile;
+                prof_config   = profile->profile;
+                pass          = profile->pass;
+                sample_weight = profile->sample_weight;
+                ring          = profile->ring;
                 data.erase(aql_pkt.get());
                 pkt = std::move(aql_pkt);
                 return;
@@ -190,24 +210,36 @@ completed_cb(const context::context*                       ctx,
 
     if(!pkt) return;
 
-    CHECK_NOTNULL(hsa::get_queue_controller())->serializer().wlock([&](auto& serializer) {
-        serializer.kernel_completion_signal(session.queue);
-    });
+    CHECK_NOTNULL(hsa::get_queue_controller())
+        ->serializer(session.queue)
+        .wlock([&](auto& serializer) { serializer.kernel_completion_signal(session.queue); });
 
     // We have no profile config, nothing to output.
     if(!prof_config) return;
 
-    auto decoded_pkt = EvaluateAST::read_pkt(prof_config->pkt_generator.get(), *pkt);
+    auto decoded_pkt = EvaluateAST::read_pkt(prof_config->pkt_generators.at(pass).get(), *pkt);
+
+    // Re-arm the packet for the next dispatch on the queue. Packets constructed because the ring
+    // was exhausted are destroyed
+    if(ring)
+    {
+        prof_config->packets.wlock([&](auto&) { ring->release(std::move(pkt)); });
+    }
+
+    // The counters of a multi-pass profile are evaluated by the dispatch completing the last
+    // pass of the kernel, the previous dispatches of the kernel do not output records
+    if(prof_config->pkt_generators.size() > 1 &&
+       !merge_kernel_pass(*prof_config,
+                          session.callback_record.dispatch_info.kernel_id,
+                          pass,
+                          decoded_pkt))
+    {
+        return;
+    }
+
     EvaluateAST::read_special_counters(
         *prof_config->agent, prof_config->required_special_counters, decoded_pkt);
 
-    prof_config->packets.wlock([&](auto& pkt_vector) {
-        if(pkt)
-        {
-            pkt_vector.emplace_back(std::move(pkt));
-        }
-    });
-
     common::container::small_vector<rocprofiler_record_counter_t, 128> out;
     rocprofiler::buffer::instance*                                     buf = nullptr;
 
@@ -253,6 +285,8 @@ completed_cb(const context::context*                       ctx,
             _header.num_records    = out.size();
             _header.correlation_id = _corr_id_v;
             _header.dispatch_info  = session.callback_record.dispatch_info;
+            _header.sample_weight  = sample_weight;
+            _header.user_data      = session.user_data;
             buf->emplace(ROCPROFILER_BUFFER_CATEGORY_COUNTERS,
                          ROCPROFILER_COUNTER_RECORD_PROFILE_COUNTING_DISPATCH_HEADER,
                          _header);
@@ -270,6 +304,7 @@ completed_cb(const context::context*                       ctx,
 
             dispatch_data.dispatch_info  = session.callback_record.dispatch_info;
             dispatch_data.correlation_id = _corr_id_v;
+            dispatch_data.sample_weight  = sample_weight;
 
             info->record_callback(dispatch_data,
                                   out.data(),
@@ -23,7 +23,6 @@
 #include "lib/rocprofiler-sdk/counters/evaluate_ast.hpp"
 
 #include <exception>
-#include <numeric>
 #include <optional>
 #include <stdexcept>
 
@@ -53,72 +52,6 @@ get_reduce_op_type_from_string(const std::string& op)
     if(reduce_op_type) type = *reduce_op_type;
     return type;
 }
-
-std::vector<rocprofiler_record_counter_t>*
-perform_reduction(ReduceOperation reduce_op, std::vector<rocprofiler_record_counter_t>* input_array)
-{
-    rocprofiler_record_counter_t result{
-        .id = 0, .counter_value = 0, .dispatch_id = 0, .user_data = {.value = 0}};
-    if(input_array->empty()) return input_array;
-    switch(reduce_op)
-    {
-        case REDUCE_NONE: break;
-        case REDUCE_MIN:
-        {
-            result =
-                *std::min_element(input_array->begin(), input_array->end(), [](auto& a, auto& b) {
-                    return a.counter_value < b.counter_value;
-                });
-            break;
-        }
-        case REDUCE_MAX:
-        {
-            result =
-                *std::max_element(input_array->begin(), input_array->end(), [](auto& a, auto& b) {
-                    return a.counter_value > b.counter_value;
-                });
-            break;
-        }
-        case REDUCE_SUM:
-        {
-            result = std::accumulate(
-                input_array->begin(),
-                input_array->end(),
-                rocprofiler_record_counter_t{
-                    .id = 0, .counter_value = 0, .dispatch_id = 0, .user_data = {.value = 0}},
-                [](auto& a, auto& b) {
-                    return rocprofiler_record_counter_t{
-                        .id            = a.id,
-                        .counter_value = a.counter_value + b.counter_value,
-                        .dispatch_id   = a.dispatch_id,
-                        .user_data     = {.value = 0}};
-                });
-            break;
-        }
-        case REDUCE_AVG:
-        {
-            result = std::accumulate(
-                input_array->begin(),
-                input_array->end(),
-                rocprofiler_record_counter_t{
-                    .id = 0, .counter_value = 0, .dispatch_id = 0, .user_data = {.value = 0}},
-                [](auto& a, auto& b) {
-                    return rocprofiler_record_counter_t{
-                        .id            = a.id,
-                        .counter_value = a.counter_value + b.counter_value,
-                        .dispatch_id   = a.dispatch_id,
-                        .user_data     = {.value = 0}};
-                });
-            result.counter_value /= input_array->size();
-            break;
-        }
-    }
-    input_array->clear();
-    input_array->push_back(result);
-    set_dim_in_rec(input_array->begin()->id, ROCPROFILER_DIMENSION_NONE, 0);
-    return input_array;
-}
-
 }  // namespace
 
 const std::unordered_map<std::string, EvaluateASTMap>&
@@ -205,6 +138,7 @@ EvaluateAST::EvaluateAST(rocprofiler_counter_id_t                       out_id,
 , _reduce_op(get_reduce_op_type_from_string(ast.reduce_op))
 , _agent(std::move(agent))
 , _reduce_dimension_set(ast.reduce_dimension_set)
+, _reduction(_reduce_op, _reduce_dimension_set)
 , _out_id(out_id)
 {
     if(_type == NodeType::REFERENCE_NODE)
@@ -284,11 +218,21 @@ EvaluateAST::set_dimensions()
         break;
         case REDUCE_NODE:
         {
-            // Reduction down to a single instance supported for now.
-            _dimension_types =
-                std::vector<MetricDimension>{{dimension_map().at(ROCPROFILER_DIMENSION_INSTANCE),
-                                              1,
-                                              ROCPROFILER_DIMENSION_INSTANCE}};
+            // The reduced dimensions are removed, reducing every dimension leaves a single
+            // instance
+            for(const auto& dim : _children[0].set_dimensions())
+            {
+                if(_reduce_dimension_set.count(dim.type()) == 0)
+                    _dimension_types.emplace_back(dim);
+            }
+
+            if(_reduce_dimension_set.empty() || _dimension_types.empty())
+            {
+                _dimension_types = std::vector<MetricDimension>{
+                    {dimension_map().at(ROCPROFILER_DIMENSION_INSTANCE),
+                     1,
+                     ROCPROFILER_DIMENSION_INSTANCE}};
+            }
         }
         break;
         case SELECT_NODE:
@@ -462,50 +406,27 @@ EvaluateAST::read_special_counters(
 std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>>
 EvaluateAST::read_pkt(const aql::CounterPacketConstruct* pkt_gen, hsa::AQLPacket& pkt)
 {
-    struct it_data
-    {
-        std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>>* data;
-        const aql::CounterPacketConstruct*                                       pkt_gen;
-        hsa_agent_t                                                              agent;
-    };
-
-    auto agent = CHECK_NOTNULL(rocprofiler::agent::get_agent_cache(
-                                   CHECK_NOTNULL(rocprofiler::agent::get_agent(pkt_gen->agent()))))
-                     ->get_hsa_agent();
     std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>> ret;
-    if(pkt.empty) return ret;
-    it_data aql_data{.data = &ret, .pkt_gen = pkt_gen, .agent = agent};
-    ;
-    hsa_status_t status = hsa_ven_amd_aqlprofile_iterate_data(
-        &pkt.profile,
-        [](hsa_ven_amd_aqlprofile_info_type_t  info_type,
-           hsa_ven_amd_aqlprofile_info_data_t* info_data,
-           void*                               data) {
-            CHECK(data);
-            auto& it = *static_cast<it_data*>(data);
-            if(info_type != HSA_VEN_AMD_AQLPROFILE_INFO_PMC_DATA) return HSA_STATUS_SUCCESS;
-            const auto* metric = it.pkt_gen->event_to_metric(info_data->pmc_data.event);
-            if(!metric) return HSA_STATUS_SUCCESS;
-            auto& vec = it.data->emplace(metric->id(), std::vector<rocprofiler_record_counter_t>{})
-                            .first->second;
-            auto& next_rec = vec.emplace_back();
-            set_counter_in_rec(next_rec.id, {.handle = metric->id()});
-            // Actual dimension info needs to be used here in the future
-            auto aql_status = aql::set_dim_id_from_sample(
-                next_rec.id, it.agent, info_data->pmc_data.event, info_data->sample_id);
-            CHECK_EQ(aql_status, ROCPROFILER_STATUS_SUCCESS)
-                << rocprofiler_get_status_string(aql_status);
-
-            // set_dim_in_rec(next_rec.id, ROCPROFILER_DIMENSION_NONE, vec.size() - 1);
-            // Note: in the near future we need to use hw_counter here instead
-            next_rec.counter_value = info_data->pmc_data.result;
-            return HSA_STATUS_SUCCESS;
-        },
-        &aql_data);
-    CHECK(status == HSA_STATUS_SUCCESS);
+    read_pkt(pkt_gen, pkt, ret);
     return ret;
 }
 
+void
+EvaluateAST::read_pkt(
+    const aql::CounterPacketConstruct*                                       pkt_gen,
+    hsa::AQLPacket&                                                          pkt,
+    std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>>& out_map)
+{
+    if(pkt.empty)
+    {
+        for(auto& itr : out_map)
+            itr.second.clear();
+        return;
+    }
+
+    pkt_gen->decoder().decode(pkt.profile, out_map);
+}
+
 void
 EvaluateAST::set_out_id(std::vector<rocprofiler_record_counter_t>& results) const
 {
@@ -649,7 +570,8 @@ EvaluateAST::evaluate(
             if(_reduce_op == REDUCE_NONE)
                 throw std::runtime_error(fmt::format("Invalid Second argument to reduce(): {}",
                                                      static_cast<int>(_reduce_op)));
-            return perform_reduction(_reduce_op, result);
+            _reduction.reduce(*result);
+            return result;
         }
         // Currently unsupported
         case SELECT_NODE: break;
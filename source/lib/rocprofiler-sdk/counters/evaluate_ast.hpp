@@ -29,6 +29,7 @@
 #include "lib/rocprofiler-sdk/counters/dimensions.hpp"
 #include "lib/rocprofiler-sdk/counters/metrics.hpp"
 #include "lib/rocprofiler-sdk/counters/parser/raw_ast.hpp"
+#include "lib/rocprofiler-sdk/counters/reduction.hpp"
 
 namespace rocprofiler
 {
@@ -52,15 +53,6 @@ enum DimensionTypes
     DIMENSION_LAST          = 1 << 6,
 };
 
-enum ReduceOperation
-{
-    REDUCE_NONE,
-    REDUCE_MIN,
-    REDUCE_MAX,
-    REDUCE_SUM,
-    REDUCE_AVG,
-};
-
 class EvaluateAST
 {
 public:
@@ -137,6 +129,19 @@ public:
         const aql::CounterPacketConstruct* pkt_gen,
         hsa::AQLPacket&                    pkt);
 
+    /**
+     * @brief Same as above but decodes into out_map. The vectors already in out_map are
+     *        cleared (keeping their capacity) so the map can be reused across decodes.
+     *
+     * @param [in] pkt_gen  packet generator used to generate the AQL packet
+     * @param [in] pkt      AQL packet structure to decode
+     * @param [out] out_map map of {metric->id(), vector<records>}
+     */
+    static void read_pkt(
+        const aql::CounterPacketConstruct*                                       pkt_gen,
+        hsa::AQLPacket&                                                          pkt,
+        std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>>& out_map);
+
     /**
      * @brief Insert special counter values, such as constants of the agent (i.e. max waves)
      *        and kernel duration into the output map.
@@ -176,6 +181,7 @@ private:
     std::vector<MetricDimension>                                   _dimension_types{};
     std::vector<rocprofiler_record_counter_t>                      _static_value;
     std::unordered_set<rocprofiler_profile_counter_instance_types> _reduce_dimension_set;
+    DimensionReduction                                             _reduction;
     bool                                                           _expanded{false};
     rocprofiler_counter_id_t                                       _out_id{.handle = 0};
 };
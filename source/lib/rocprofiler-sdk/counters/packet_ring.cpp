@@ -0,0 +1,80 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/packet_ring.hpp"
+#include "lib/common/logging.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rocprofiler
+{
+namespace counters
+{
+packet_ring::packet_ring(size_t capacity, construct_func_t construct, size_t block_slots)
+: m_capacity{std::max<size_t>(capacity, 1)}
+, m_block_slots{std::clamp<size_t>(block_slots, 1, m_capacity)}
+, m_construct{std::move(construct)}
+{
+    m_free.reserve(m_block_slots);
+}
+
+packet_ring::packet_ptr_t
+packet_ring::acquire()
+{
+    if(m_free.empty() && m_slots < m_capacity)
+    {
+        auto _pkts = m_construct(std::min(m_block_slots, m_capacity - m_slots));
+        if(_pkts.empty()) ROCP_ERROR << "Could not construct the counter collection packets";
+
+        m_slots += _pkts.size();
+        for(auto& itr : _pkts)
+            m_free.emplace_back(std::move(itr));
+    }
+
+    if(m_free.empty()) return nullptr;
+
+    auto _pkt = std::move(m_free.back());
+    m_free.pop_back();
+    return _pkt;
+}
+
+void
+packet_ring::release(packet_ptr_t&& pkt)
+{
+    if(!pkt) return;
+
+    // the start/stop/read packets refer to the same buffers, only the counter values of the
+    // previous dispatch need to be cleared
+    auto& _output = pkt->profile.output_buffer;
+    if(_output.ptr) memset(_output.ptr, 0x0, _output.size);
+
+    m_free.emplace_back(std::move(pkt));
+}
+
+size_t
+packet_ring::queue_capacity(uint64_t queue_size)
+{
+    return std::max<size_t>(queue_size / packets_per_dispatch, 1);
+}
+}  // namespace counters
+}  // namespace rocprofiler
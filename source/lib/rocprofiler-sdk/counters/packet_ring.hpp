@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/hsa/aql_packet.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace counters
+{
+/**
+ * Ring of the counter collection packets of one queue for one pass of a profile.
+ *
+ * The packets are constructed in blocks of slots (see hsa::CounterBufferBlock), i.e. the command
+ * and output buffers of a block are allocated and made accessible to the agent once, and are
+ * reused by every later dispatch on the queue. A packet returned by a completed dispatch is
+ * re-armed in place by zeroing its output buffer: its command buffer and start/stop/read packets
+ * are unchanged. The capacity of the ring is derived from the depth of the queue since a queue
+ * cannot hold more profiled dispatches than that.
+ *
+ * Not thread-safe: the rings of a profile are guarded by profile_config::packets.
+ */
+class packet_ring
+{
+public:
+    using packet_ptr_t = std::unique_ptr<hsa::AQLPacket>;
+    // Constructs the armed packets of a block of slots
+    using construct_func_t =
+        std::function<std::vector<std::unique_ptr<hsa::CounterAQLPacket>>(size_t)>;
+
+    static constexpr size_t default_block_slots = 16;
+    // Minimum number of queue slots used by a profiled dispatch: start, kernel, read, stop
+    static constexpr size_t packets_per_dispatch = 4;
+
+    packet_ring(size_t           capacity,
+                construct_func_t construct,
+                size_t           block_slots = default_block_slots);
+
+    /// Returns an armed packet or a nullptr if every slot of the ring is in flight
+    packet_ptr_t acquire();
+
+    /// Re-arms the packet of a completed dispatch and returns it to the ring
+    void release(packet_ptr_t&& pkt);
+
+    size_t capacity() const { return m_capacity; }
+    /// Number of slots which have been constructed
+    size_t slots() const { return m_slots; }
+    /// Number of packets acquired and not released
+    size_t in_flight() const { return m_slots - m_free.size(); }
+
+    /// Capacity of the ring of a queue which holds queue_size packets
+    static size_t queue_capacity(uint64_t queue_size);
+
+private:
+    size_t                    m_capacity    = 0;
+    size_t                    m_block_slots = 0;
+    size_t                    m_slots       = 0;
+    construct_func_t          m_construct   = {};
+    std::vector<packet_ptr_t> m_free        = {};
+};
+}  // namespace counters
+}  // namespace rocprofiler
@@ -136,8 +136,8 @@ struct RawAST
 
     // Reduce operation constructor. Counter is the counter AST
     // to use for the reduce op, op is how to reduce (i.e. SUM,AVG,etc),
-    // dimensions contains the set of dimensions which we want to keep
-    // in the result. Dimensions not specified are all reduced according to op
+    // dimensions contains the set of dimensions which are reduced according
+    // to op and removed from the result. All dimensions are reduced if empty
     RawAST(NodeType t, RawAST* counter, const char* op, LinkedList* dimensions)
     : type(t)
     , reduce_op(CHECK_NOTNULL(op))
@@ -0,0 +1,306 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/reduction.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+
+namespace rocprofiler
+{
+namespace counters
+{
+namespace
+{
+constexpr uint64_t DIM_FIELD_LENGTH = DIM_BIT_LENGTH / ROCPROFILER_DIMENSION_LAST;
+constexpr uint64_t DIM_FIELD_MASK   = MAX_64 >> (64 - DIM_FIELD_LENGTH);
+constexpr uint64_t COUNTER_MASK     = ~(MAX_64 >> COUNTER_BIT_LENGTH);
+
+// Number of independent accumulators of the reductions of contiguous values
+constexpr size_t reduce_lanes = 8;
+
+// Scratch buffers of the reductions (reused by every reduction on a thread)
+struct reduce_buffers
+{
+    std::vector<uint64_t> ids    = {};
+    std::vector<double>   values = {};
+    std::vector<uint32_t> slots  = {};
+    std::vector<double>   accum  = {};
+    std::vector<uint32_t> counts = {};
+    std::vector<uint64_t> keys   = {};
+};
+
+// Number of bits up to the most significant bit set in value
+uint64_t
+bit_width(uint64_t value)
+{
+    uint64_t _bits = 0;
+    for(; value != 0; value >>= 1)
+        ++_bits;
+    return _bits;
+}
+
+reduce_buffers&
+get_reduce_buffers()
+{
+    static thread_local auto _v = reduce_buffers{};
+    return _v;
+}
+
+struct reduce_sum
+{
+    static constexpr double init() { return 0.0; }
+    double                  operator()(double a, double b) const { return a + b; }
+};
+
+struct reduce_min
+{
+    static constexpr double init() { return std::numeric_limits<double>::infinity(); }
+    double                  operator()(double a, double b) const { return (b < a) ? b : a; }
+};
+
+struct reduce_max
+{
+    static constexpr double init() { return -std::numeric_limits<double>::infinity(); }
+    double                  operator()(double a, double b) const { return (b > a) ? b : a; }
+};
+
+// Reduces contiguous values. Each lane accumulates every reduce_lanes-th value so that
+// consecutive operations do not depend on each other and the loop can be vectorized
+template <typename OpT>
+double
+reduce_values(const double* values, size_t size, OpT op)
+{
+    auto   acc = std::array<double, reduce_lanes>{};
+    size_t i   = 0;
+    acc.fill(OpT::init());
+    for(; i + reduce_lanes <= size; i += reduce_lanes)
+    {
+        for(size_t j = 0; j < reduce_lanes; ++j)
+            acc[j] = op(acc[j], values[i + j]);
+    }
+    for(; i < size; ++i)
+        acc[0] = op(acc[0], values[i]);
+    for(size_t j = 1; j < reduce_lanes; ++j)
+        acc[0] = op(acc[0], acc[j]);
+    return acc[0];
+}
+
+// Reduces the values into the accumulator of their slot
+template <typename OpT>
+void
+reduce_slots(reduce_buffers& buf, size_t num_slots, OpT op)
+{
+    const auto  size   = buf.values.size();
+    const auto* values = buf.values.data();
+    const auto* slots  = buf.slots.data();
+
+    buf.accum.assign(num_slots, OpT::init());
+    buf.counts.assign(num_slots, 0);
+
+    auto* accum  = buf.accum.data();
+    auto* counts = buf.counts.data();
+    for(size_t i = 0; i < size; ++i)
+        accum[slots[i]] = op(accum[slots[i]], values[i]);
+    for(size_t i = 0; i < size; ++i)
+        ++counts[slots[i]];
+}
+
+void
+reduce_slots(ReduceOperation op, reduce_buffers& buf, size_t num_slots)
+{
+    switch(op)
+    {
+        case REDUCE_NONE: break;
+        case REDUCE_MIN: reduce_slots(buf, num_slots, reduce_min{}); break;
+        case REDUCE_MAX: reduce_slots(buf, num_slots, reduce_max{}); break;
+        case REDUCE_SUM:
+        case REDUCE_AVG: reduce_slots(buf, num_slots, reduce_sum{}); break;
+    }
+}
+}  // namespace
+
+DimensionReduction::DimensionReduction(ReduceOperation op, const dimension_set_t& reduce_dims)
+: m_op{op}
+{
+    // An empty set reduces every dimension
+    if(reduce_dims.empty()) return;
+
+    for(int i = ROCPROFILER_DIMENSION_NONE + 1; i < ROCPROFILER_DIMENSION_LAST; ++i)
+    {
+        auto dim = static_cast<rocprofiler_profile_counter_instance_types>(i);
+        if(reduce_dims.count(dim) > 0) continue;
+        m_kept.emplace_back(dim);
+        m_shifts.emplace_back((dim - 1) * DIM_FIELD_LENGTH);
+    }
+}
+
+uint64_t
+DimensionReduction::dimension_mask(rocprofiler_profile_counter_instance_types dim)
+{
+    if(dim == ROCPROFILER_DIMENSION_NONE) return MAX_64 >> COUNTER_BIT_LENGTH;
+    return DIM_FIELD_MASK << ((dim - 1) * DIM_FIELD_LENGTH);
+}
+
+void
+DimensionReduction::reduce_all(std::vector<rocprofiler_record_counter_t>& records) const
+{
+    auto& buf = get_reduce_buffers();
+    buf.values.resize(records.size());
+    for(size_t i = 0; i < records.size(); ++i)
+        buf.values[i] = records[i].counter_value;
+
+    const auto* values = buf.values.data();
+    const auto  size   = buf.values.size();
+    double      result = 0.0;
+    switch(m_op)
+    {
+        case REDUCE_NONE: return;
+        case REDUCE_MIN: result = reduce_values(values, size, reduce_min{}); break;
+        case REDUCE_MAX: result = reduce_values(values, size, reduce_max{}); break;
+        case REDUCE_SUM: result = reduce_values(values, size, reduce_sum{}); break;
+        case REDUCE_AVG:
+            result = reduce_values(values, size, reduce_sum{}) / static_cast<double>(size);
+            break;
+    }
+
+    auto _record = rocprofiler_record_counter_t{.id            = records.front().id & COUNTER_MASK,
+                                                .counter_value = result,
+                                                .dispatch_id   = records.front().dispatch_id,
+                                                .user_data     = {.value = 0}};
+    records.assign(1, _record);
+}
+
+void
+DimensionReduction::reduce(std::vector<rocprofiler_record_counter_t>& records) const
+{
+    if(records.empty() || m_op == REDUCE_NONE) return;
+    if(m_kept.empty()) return reduce_all(records);
+
+    auto&       buf  = get_reduce_buffers();
+    const auto  size = records.size();
+    const auto* recs = records.data();
+
+    // Structure-of-arrays copy of the instances
+    uint64_t _ored = 0;
+    buf.ids.resize(size);
+    buf.values.resize(size);
+    for(size_t i = 0; i < size; ++i)
+    {
+        buf.ids[i]    = recs[i].id;
+        buf.values[i] = recs[i].counter_value;
+        _ored |= recs[i].id;
+    }
+
+    // The positions of a dimension are below the next power of two of the bitwise OR of its
+    // positions. The slot of an instance concatenates the bits of these bounds for each kept
+    // dimension present in the instances, i.e. the table below holds the offsets of the
+    // positions in the instance id and in the slot
+    auto     _fields    = std::array<std::pair<uint64_t, uint64_t>, ROCPROFILER_DIMENSION_LAST>{};
+    size_t   _nfields   = 0;
+    uint64_t _slot_bits = 0;
+    for(auto _shift : m_shifts)
+    {
+        auto _bits = bit_width((_ored >> _shift) & DIM_FIELD_MASK);
+        if(_bits == 0) continue;  // position is zero in every instance
+        _fields[_nfields++] = {_shift, _bits};
+        _slot_bits += _bits;
+    }
+
+    const auto* ids = buf.ids.data();
+    buf.keys.clear();
+    buf.slots.assign(size, 0);
+
+    uint64_t num_slots = 0;
+    auto*    slots     = buf.slots.data();
+    // The output buffers are at most a few times larger than the instances, more sparse
+    // instances use the indices of their distinct positions as slots
+    if(_slot_bits < 32 && (uint64_t{1} << _slot_bits) <= 4 * size)
+    {
+        num_slots     = uint64_t{1} << _slot_bits;
+        uint64_t _off = 0;
+        for(size_t f = 0; f < _nfields; ++f)
+        {
+            const auto _shift = _fields[f].first;
+            const auto _mask  = (uint64_t{1} << _fields[f].second) - 1;
+            for(size_t i = 0; i < size; ++i)
+                slots[i] |= static_cast<uint32_t>(((ids[i] >> _shift) & _mask) << _off);
+            _off += _fields[f].second;
+        }
+    }
+    else
+    {
+        uint64_t _keep_mask = 0;
+        for(auto dim : m_kept)
+            _keep_mask |= dimension_mask(dim);
+
+        buf.keys.resize(size);
+        for(size_t i = 0; i < size; ++i)
+            buf.keys[i] = ids[i] & _keep_mask;
+        std::sort(buf.keys.begin(), buf.keys.end());
+        buf.keys.erase(std::unique(buf.keys.begin(), buf.keys.end()), buf.keys.end());
+
+        for(size_t i = 0; i < size; ++i)
+        {
+            slots[i] = std::lower_bound(buf.keys.begin(), buf.keys.end(), ids[i] & _keep_mask) -
+                       buf.keys.begin();
+        }
+        num_slots = buf.keys.size();
+    }
+
+    reduce_slots(m_op, buf, num_slots);
+
+    // Write the slots with at least one instance, in order
+    const auto _counter     = records.front().id & COUNTER_MASK;
+    const auto _dispatch_id = records.front().dispatch_id;
+    size_t     _out         = 0;
+    for(size_t s = 0; s < num_slots; ++s)
+    {
+        if(buf.counts[s] == 0) continue;
+
+        uint64_t _key = 0;
+        if(!buf.keys.empty())
+            _key = buf.keys[s];
+        else
+        {
+            uint64_t _off = 0;
+            for(size_t f = 0; f < _nfields; ++f)
+            {
+                const auto [_shift, _bits] = _fields[f];
+                _key |= ((s >> _off) & ((uint64_t{1} << _bits) - 1)) << _shift;
+                _off += _bits;
+            }
+        }
+
+        auto _value = buf.accum[s];
+        if(m_op == REDUCE_AVG) _value /= buf.counts[s];
+        records[_out++] = {.id            = _counter | _key,
+                           .counter_value = _value,
+                           .dispatch_id   = _dispatch_id,
+                           .user_data     = {.value = 0}};
+    }
+    records.resize(_out);
+}
+}  // namespace counters
+}  // namespace rocprofiler
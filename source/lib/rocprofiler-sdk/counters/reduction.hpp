@@ -0,0 +1,92 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <rocprofiler-sdk/fwd.h>
+
+#include "lib/rocprofiler-sdk/counters/id_decode.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace counters
+{
+enum ReduceOperation
+{
+    REDUCE_NONE,
+    REDUCE_MIN,
+    REDUCE_MAX,
+    REDUCE_SUM,
+    REDUCE_AVG,
+};
+
+using dimension_set_t = std::unordered_set<rocprofiler_profile_counter_instance_types>;
+
+/**
+ * Reduction of the instances of a counter (i.e. reduce(COUNTER, op, [dims...])) over a set of
+ * dimensions, or over every dimension when the set is empty. Instances which only differ in the
+ * reduced dimensions are combined into one output record.
+ *
+ * The bit offsets of the kept dimensions in the instance id are computed once by the
+ * constructor. A reduction copies the instance ids and values of the records into
+ * structure-of-arrays buffers, computes the output slot of every record from its id with the
+ * offsets (i.e. without decoding the position of each dimension) and then reduces the arrays
+ * with branch-free loops which the compiler can vectorize.
+ */
+class DimensionReduction
+{
+public:
+    DimensionReduction() = default;
+    DimensionReduction(ReduceOperation op, const dimension_set_t& reduce_dims);
+
+    /**
+     * @brief Reduces the records in place. The output records are ordered by the positions of
+     *        the kept dimensions (the first kept dimension varying fastest) and the positions
+     *        of the reduced dimensions are zero in their instance ids.
+     *
+     * @param [in,out] records instances of a single counter
+     */
+    void reduce(std::vector<rocprofiler_record_counter_t>& records) const;
+
+    ReduceOperation                                                op() const { return m_op; }
+    const std::vector<rocprofiler_profile_counter_instance_types>& kept_dimensions() const
+    {
+        return m_kept;
+    }
+
+    // Bits of the instance id holding the position of dim
+    static uint64_t dimension_mask(rocprofiler_profile_counter_instance_types dim);
+
+private:
+    void reduce_all(std::vector<rocprofiler_record_counter_t>& records) const;
+
+    ReduceOperation                                         m_op     = REDUCE_NONE;
+    std::vector<rocprofiler_profile_counter_instance_types> m_kept   = {};
+    std::vector<uint64_t>                                   m_shifts = {};  // of kept dims
+};
+}  // namespace counters
+}  // namespace rocprofiler
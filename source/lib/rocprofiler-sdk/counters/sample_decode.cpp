@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/sample_decode.hpp"
+#include "lib/common/container/small_vector.hpp"
+#include "lib/common/logging.hpp"
+
+namespace rocprofiler
+{
+namespace counters
+{
+namespace
+{
+bool
+same_event(const hsa_ven_amd_aqlprofile_event_t& lhs, const hsa_ven_amd_aqlprofile_event_t& rhs)
+{
+    return lhs.block_name == rhs.block_name && lhs.block_index == rhs.block_index &&
+           lhs.counter_id == rhs.counter_id;
+}
+}  // namespace
+
+SampleDecoder::SampleDecoder(const counter_events_t& counters,
+                             iterate_data_func_t     iterate_data,
+                             instance_id_func_t      instance_id)
+: m_iterate_data{iterate_data}
+, m_instance_id{std::move(instance_id)}
+{
+    for(const auto& [counter_id, events] : counters)
+    {
+        for(const auto& event : events)
+            m_events.emplace_back(event_layout{.event = event, .slot = m_counters.size()});
+        m_counters.emplace_back(counter_id);
+    }
+    m_samples.assign(m_counters.size(), 0);
+}
+
+size_t
+SampleDecoder::find_event(const hsa_ven_amd_aqlprofile_event_t& event, size_t hint) const
+{
+    // aqlprofile reports the samples of an event together and the events in the order of the
+    // profile, i.e. the event is almost always the previous one or the next one
+    for(size_t i = hint; i < hint + 2 && i < m_events.size(); ++i)
+        if(same_event(m_events[i].event, event)) return i;
+
+    for(size_t i = 0; i < m_events.size(); ++i)
+        if(same_event(m_events[i].event, event)) return i;
+
+    return m_events.size();
+}
+
+void
+SampleDecoder::init_layout(const hsa_ven_amd_aqlprofile_profile_t& profile) const
+{
+    struct layout_data
+    {
+        const SampleDecoder* decoder = nullptr;
+        size_t               cursor  = 0;
+    };
+
+    auto _data   = layout_data{.decoder = this};
+    auto _status = m_iterate_data(
+        &profile,
+        [](hsa_ven_amd_aqlprofile_info_type_t  info_type,
+           hsa_ven_amd_aqlprofile_info_data_t* info_data,
+           void*                               data) {
+            if(info_type != HSA_VEN_AMD_AQLPROFILE_INFO_PMC_DATA) return HSA_STATUS_SUCCESS;
+
+            auto&       _data    = *static_cast<layout_data*>(data);
+            const auto* _decoder = _data.decoder;
+            auto        _idx     = _decoder->find_event(info_data->pmc_data.event, _data.cursor);
+            if(_idx == _decoder->m_events.size()) return HSA_STATUS_SUCCESS;
+            _data.cursor = _idx;
+
+            auto& _event  = _decoder->m_events[_idx];
+            auto  _sample = info_data->sample_id;
+            if(_sample >= _event.ids.size()) _event.ids.resize(_sample + 1, invalid_id);
+            _event.ids[_sample] =
+                _decoder->m_instance_id(_decoder->m_counters[_event.slot], _event.event, _sample);
+            ++_decoder->m_samples[_event.slot];
+            return HSA_STATUS_SUCCESS;
+        },
+        &_data);
+    ROCP_FATAL_IF(_status != HSA_STATUS_SUCCESS) << "failed to iterate the counter samples";
+}
+
+void
+SampleDecoder::decode(const hsa_ven_amd_aqlprofile_profile_t& profile,
+                      decoded_map_t&                          out_map) const
+{
+    using records_t = std::vector<rocprofiler_record_counter_t>;
+
+    struct decode_data
+    {
+        const SampleDecoder*                           decoder = nullptr;
+        decoded_map_t*                                 out_map = nullptr;
+        common::container::small_vector<records_t*, 8> slots   = {};  // records of each slot
+        size_t                                         cursor  = 0;
+    };
+
+    for(auto& itr : out_map)
+        itr.second.clear();
+
+    std::call_once(m_layout_once, [this, &profile]() { init_layout(profile); });
+
+    auto _data = decode_data{.decoder = this, .out_map = &out_map};
+    _data.slots.resize(m_counters.size(), nullptr);
+
+    auto _status = m_iterate_data(
+        &profile,
+        [](hsa_ven_amd_aqlprofile_info_type_t  info_type,
+           hsa_ven_amd_aqlprofile_info_data_t* info_data,
+           void*                               data) {
+            if(info_type != HSA_VEN_AMD_AQLPROFILE_INFO_PMC_DATA) return HSA_STATUS_SUCCESS;
+
+            auto&       _data    = *static_cast<decode_data*>(data);
+            const auto* _decoder = _data.decoder;
+            auto        _idx     = _decoder->find_event(info_data->pmc_data.event, _data.cursor);
+            if(_idx == _decoder->m_events.size()) return HSA_STATUS_SUCCESS;
+            _data.cursor = _idx;
+
+            const auto& _event   = _decoder->m_events[_idx];
+            auto*&      _records = _data.slots[_event.slot];
+            if(!_records)
+            {
+                _records = &(*_data.out_map)[_decoder->m_counters[_event.slot]];
+                _records->reserve(_decoder->m_samples[_event.slot]);
+            }
+
+            auto _sample = info_data->sample_id;
+            auto _id     = (_sample < _event.ids.size()) ? _event.ids[_sample] : invalid_id;
+            // sample which was not in the first output
+            if(_id == invalid_id)
+                _id = _decoder->m_instance_id(
+                    _decoder->m_counters[_event.slot], _event.event, _sample);
+
+            auto& _rec         = _records->emplace_back();
+            _rec.id            = _id;
+            _rec.counter_value = info_data->pmc_data.result;
+            return HSA_STATUS_SUCCESS;
+        },
+        &_data);
+    ROCP_FATAL_IF(_status != HSA_STATUS_SUCCESS) << "failed to iterate the counter samples";
+}
+}  // namespace counters
+}  // namespace rocprofiler
@@ -0,0 +1,110 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <rocprofiler-sdk/fwd.h>
+
+#include <hsa/hsa.h>
+#include <hsa/hsa_ven_amd_aqlprofile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace counters
+{
+/**
+ * Decodes the samples of the output buffer of the AQL packets of a profile into the records of
+ * its counters.
+ *
+ * The layout of the output is the same for every packet of a profile. The counter (slot) of each
+ * event is known from the profile and the instance id of each sample (i.e. the counter id and
+ * the positions of its dimensions, which aqlprofile reports one coordinate at a time) is
+ * computed once, from the first output decoded. Every later decode is a single pass over the
+ * samples which appends each value with its cached id to the records of its slot, whose vector
+ * is looked up (and sized) once per decode instead of once per sample.
+ */
+class SampleDecoder
+{
+public:
+    using decoded_map_t = std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>>;
+    using iterate_data_func_t = hsa_status_t (*)(const hsa_ven_amd_aqlprofile_profile_t*,
+                                                 hsa_ven_amd_aqlprofile_data_callback_t,
+                                                 void*);
+    // Returns the instance id (counter and dimension positions) of a sample of an event
+    using instance_id_func_t = std::function<rocprofiler_counter_instance_id_t(
+        uint64_t counter_id,
+        const hsa_ven_amd_aqlprofile_event_t&,
+        uint32_t sample_id)>;
+    // Counter id and the events (block instances) of the counter, in the order of the profile
+    using counter_events_t =
+        std::vector<std::pair<uint64_t, std::vector<hsa_ven_amd_aqlprofile_event_t>>>;
+
+    SampleDecoder(const counter_events_t& counters,
+                  iterate_data_func_t     iterate_data,
+                  instance_id_func_t      instance_id);
+
+    SampleDecoder(const SampleDecoder&) = delete;
+    SampleDecoder& operator=(const SampleDecoder&) = delete;
+
+    /**
+     * @brief Decodes the output of a profile. The vectors already in out_map are cleared
+     *        (keeping their capacity) so the map can be reused across decodes. The vector of a
+     *        counter is reserved for all of its samples the first time it is used.
+     *
+     * @param [in] profile  profile of the packet whose output buffer is decoded
+     * @param [out] out_map map of {counter id, vector<records>}
+     */
+    void decode(const hsa_ven_amd_aqlprofile_profile_t& profile, decoded_map_t& out_map) const;
+
+    // Number of samples of each counter in the output, zero until the first decode
+    const std::vector<size_t>& counter_samples() const { return m_samples; }
+
+private:
+    static constexpr rocprofiler_counter_instance_id_t invalid_id = ~0ULL;
+
+    struct event_layout
+    {
+        hsa_ven_amd_aqlprofile_event_t                 event = {};
+        size_t                                         slot  = 0;   // index of the counter
+        std::vector<rocprofiler_counter_instance_id_t> ids   = {};  // by sample id
+    };
+
+    void   init_layout(const hsa_ven_amd_aqlprofile_profile_t& profile) const;
+    size_t find_event(const hsa_ven_amd_aqlprofile_event_t& event, size_t hint) const;
+
+    iterate_data_func_t               m_iterate_data = nullptr;
+    instance_id_func_t                m_instance_id  = {};
+    std::vector<uint64_t>             m_counters     = {};  // counter id of each slot
+    mutable std::once_flag            m_layout_once  = {};
+    mutable std::vector<event_layout> m_events       = {};  // in the order of the profile
+    mutable std::vector<size_t>       m_samples      = {};  // of each slot
+};
+}  // namespace counters
+}  // namespace rocprofiler
@@ -450,6 +450,10 @@ protected:
 
 TEST_F(agent_profile_test, sync_counters) { test_run(); }
 TEST_F(agent_profile_test, async_counters) { test_run(ROCPROFILER_COUNTER_FLAG_ASYNC); }
+TEST_F(agent_profile_test, async_coalesce_counters)
+{
+    test_run(ROCPROFILER_COUNTER_FLAG_ASYNC_COALESCE);
+}
 TEST_F(agent_profile_test, sync_grbm_verify)
 {
     test_run(ROCPROFILER_COUNTER_FLAG_NONE, {"GRBM_COUNT"}, 50000);
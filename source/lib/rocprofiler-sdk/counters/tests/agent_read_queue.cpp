@@ -0,0 +1,143 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/tests/agent_read_queue_mocks.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+TEST(agent_read_queue, reads_in_order)
+{
+    constexpr size_t depth = 4;
+
+    auto _reader = fake_reader{depth, std::chrono::microseconds{200}};
+
+    // non-blocking submissions fail once every slot is in flight
+    auto _ids = std::vector<uint64_t>{};
+    for(uint64_t i = 0; i < 200; ++i)
+    {
+        auto _id = _reader.queue.submit({.value = i}, false, false);
+        if(_id != 0) _ids.emplace_back(_id);
+    }
+    _reader.queue.sync();
+
+    ASSERT_GE(_ids.size(), depth);
+    EXPECT_LT(_ids.size(), 200);
+    EXPECT_LE(_reader.agent.max_in_flight, depth);
+    ASSERT_EQ(_reader.decoded.size(), _ids.size());
+    for(size_t i = 0; i < _ids.size(); ++i)
+    {
+        // sample ids are sequence numbers and the reads are decoded in the order submitted
+        EXPECT_EQ(_ids.at(i), i + 1);
+        EXPECT_EQ(_reader.decoded.at(i).info.sample_id, i + 1);
+        EXPECT_EQ(_reader.decoded.at(i).sequence, i + 1);
+        EXPECT_EQ(_reader.decoded.at(i).info.num_coalesced, 0);
+    }
+
+    // blocking submissions wait for a slot
+    for(uint64_t i = 0; i < 20; ++i)
+        EXPECT_NE(_reader.queue.submit({.value = i}, false, true), 0);
+    _reader.queue.sync();
+    EXPECT_EQ(_reader.decoded.size(), _ids.size() + 20);
+    EXPECT_EQ(_reader.queue.get_num_reads(), _reader.decoded.size());
+}
+
+TEST(agent_read_queue, coalesced_reads)
+{
+    auto _reader = fake_reader{4, std::chrono::microseconds{0}};
+
+    // the reads are pending while the agent is paused: the requests are coalesced into the last
+    // read rather than queued
+    _reader.agent.pause();
+    auto _first = _reader.queue.submit({.value = 1}, true, false);
+    EXPECT_EQ(_first, 1);
+    for(uint64_t i = 0; i < 10; ++i)
+        EXPECT_EQ(_reader.queue.submit({.value = 2 + i}, true, false), _first);
+
+    // a request which is not coalesced is queued after the pending read
+    auto _second = _reader.queue.submit({.value = 100}, false, false);
+    EXPECT_EQ(_second, 2);
+    EXPECT_EQ(_reader.queue.submit({.value = 101}, true, false), _second);
+    _reader.agent.resume();
+
+    _reader.queue.wait(_second);
+    ASSERT_EQ(_reader.decoded.size(), 2);
+    EXPECT_EQ(_reader.decoded.at(0).info.sample_id, _first);
+    EXPECT_EQ(_reader.decoded.at(0).info.user_data.value, 1);
+    EXPECT_EQ(_reader.decoded.at(0).info.num_coalesced, 10);
+    EXPECT_EQ(_reader.decoded.at(1).info.sample_id, _second);
+    EXPECT_EQ(_reader.decoded.at(1).info.user_data.value, 100);
+    EXPECT_EQ(_reader.decoded.at(1).info.num_coalesced, 1);
+    EXPECT_EQ(_reader.agent.submitted, 2);
+    EXPECT_EQ(_reader.queue.get_num_coalesced(), 11);
+
+    // once the read has completed, a coalescing request submits a new read
+    EXPECT_EQ(_reader.queue.submit({.value = 200}, true, false), 3);
+    _reader.queue.sync();
+    EXPECT_EQ(_reader.agent.submitted, 3);
+}
+
+// Samples several agents with and without coalescing the reads
+TEST(agent_read_queue, concurrent_agents)
+{
+    constexpr size_t num_agents = 8;
+    constexpr auto   read_time  = std::chrono::microseconds{500};
+    constexpr auto   duration   = std::chrono::milliseconds{10};
+
+    // samples every agent from one thread for the duration, waiting for each read (sync) or
+    // coalescing the requests with the pending reads (async)
+    auto _samples = [&](bool async) {
+        auto _readers = std::vector<std::unique_ptr<fake_reader>>{};
+        for(size_t i = 0; i < num_agents; ++i)
+            _readers.emplace_back(std::make_unique<fake_reader>(4, read_time));
+
+        auto _end = std::chrono::steady_clock::now() + duration;
+        while(std::chrono::steady_clock::now() < _end)
+        {
+            for(auto& itr : _readers)
+            {
+                auto _id = itr->queue.submit({.value = 0}, async, true);
+                EXPECT_NE(_id, 0);
+                if(!async) itr->queue.wait(_id);
+            }
+        }
+
+        uint64_t _decoded = 0;
+        for(auto& itr : _readers)
+        {
+            itr->queue.sync();
+            EXPECT_LE(itr->agent.max_in_flight, 1);
+            _decoded += itr->decoded.size();
+        }
+        return _decoded;
+    };
+
+    auto _sync  = _samples(false);
+    auto _async = _samples(true);
+
+    EXPECT_GT(_sync, 0);
+    EXPECT_GT(_async, 0);
+}
@@ -0,0 +1,78 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/tests/agent_read_queue_mocks.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Number of reads of several agents sampled from one thread for 100 ms with and without
+// coalescing the reads
+TEST(agent_read_queue, concurrent_agents_benchmark)
+{
+    constexpr size_t num_agents = 8;
+    constexpr auto   read_time  = std::chrono::microseconds{500};
+    constexpr auto   duration   = std::chrono::milliseconds{100};
+
+    // samples every agent from one thread for the duration, waiting for each read (sync) or
+    // coalescing the requests with the pending reads (async)
+    auto _samples = [&](bool async) {
+        auto _readers = std::vector<std::unique_ptr<fake_reader>>{};
+        for(size_t i = 0; i < num_agents; ++i)
+            _readers.emplace_back(std::make_unique<fake_reader>(4, read_time));
+
+        auto _end = std::chrono::steady_clock::now() + duration;
+        while(std::chrono::steady_clock::now() < _end)
+        {
+            for(auto& itr : _readers)
+            {
+                auto _id = itr->queue.submit({.value = 0}, async, true);
+                EXPECT_NE(_id, 0);
+                if(!async) itr->queue.wait(_id);
+            }
+        }
+
+        uint64_t _decoded = 0;
+        for(auto& itr : _readers)
+        {
+            itr->queue.sync();
+            EXPECT_LE(itr->agent.max_in_flight, 1);
+            _decoded += itr->decoded.size();
+        }
+        return _decoded;
+    };
+
+    auto _sync  = _samples(false);
+    auto _async = _samples(true);
+
+    std::cout << "[agent_read_queue] reads of " << num_agents << " agents in " << duration.count()
+              << " ms :: sync = " << _sync << ", async = " << _async << std::endl;
+
+    EXPECT_GT(_sync, 0);
+    // the agents are read concurrently instead of one round trip at a time
+    EXPECT_GT(_async, 2 * _sync) << "sync = " << _sync << ", async = " << _async;
+}
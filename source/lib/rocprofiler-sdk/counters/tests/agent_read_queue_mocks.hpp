@@ -0,0 +1,225 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/counters/agent_read_queue.hpp"
+
+#include <hsa/hsa.h>
+#include <hsa/hsa_api_trace.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using namespace ::rocprofiler::counters;
+
+// Signals of the mock runtime: the handle is the address of the signal. The async handler of a
+// signal is invoked (once) by the thread which decrements the signal below its condition value
+struct mock_signal
+{
+    std::atomic<hsa_signal_value_t> value   = {0};
+    hsa_signal_value_t              limit   = 0;
+    hsa_amd_signal_handler          handler = nullptr;
+    void*                           arg     = nullptr;
+};
+
+mock_signal*
+get_signal(hsa_signal_t signal)
+{
+    return reinterpret_cast<mock_signal*>(signal.handle);
+}
+
+CoreApiTable&
+get_mock_table()
+{
+    static auto _v = []() {
+        auto val                 = CoreApiTable{};
+        val.hsa_signal_create_fn = [](hsa_signal_value_t initial_value,
+                                      uint32_t,
+                                      const hsa_agent_t*,
+                                      hsa_signal_t* signal) {
+            auto* _signal = new mock_signal{};
+            _signal->value.store(initial_value);
+            signal->handle = reinterpret_cast<uint64_t>(_signal);
+            return HSA_STATUS_SUCCESS;
+        };
+        val.hsa_signal_destroy_fn = [](hsa_signal_t signal) {
+            delete get_signal(signal);
+            return HSA_STATUS_SUCCESS;
+        };
+        val.hsa_signal_store_relaxed_fn = [](hsa_signal_t signal, hsa_signal_value_t value) {
+            get_signal(signal)->value.store(value, std::memory_order_relaxed);
+        };
+        return val;
+    }();
+    return _v;
+}
+
+AmdExtTable&
+get_mock_ext_table()
+{
+    static auto _v = []() {
+        auto val                            = AmdExtTable{};
+        val.hsa_amd_signal_async_handler_fn = [](hsa_signal_t signal,
+                                                 hsa_signal_condition_t,
+                                                 hsa_signal_value_t     value,
+                                                 hsa_amd_signal_handler handler,
+                                                 void*                  arg) {
+            auto* _signal    = get_signal(signal);
+            _signal->limit   = value;
+            _signal->handler = handler;
+            _signal->arg     = arg;
+            return HSA_STATUS_SUCCESS;
+        };
+        return val;
+    }();
+    return _v;
+}
+
+// Executes the reads submitted to an agent in order, each taking read_time. A read writes the
+// sequence number of the read into the read buffer of the slot (in place of the counter data
+// written by aqlprofile), completes the signal of the slot and invokes its async handler.
+struct fake_agent
+{
+    struct read_t
+    {
+        size_t       slot       = 0;
+        uint64_t     sequence   = 0;
+        hsa_signal_t completion = {};
+    };
+
+    fake_agent(size_t depth, std::chrono::microseconds read_time)
+    : buffers(depth, 0)
+    , m_read_time{read_time}
+    , m_thread{&fake_agent::run, this}
+    {}
+
+    ~fake_agent()
+    {
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            m_stop   = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    void submit(size_t slot, hsa_signal_t completion)
+    {
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            m_reads.emplace_back(read_t{slot, ++submitted, completion});
+            max_in_flight = std::max(max_in_flight, m_reads.size());
+        }
+        m_cv.notify_one();
+    }
+
+    // blocks the agent until resume is called
+    void pause()
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        m_paused = true;
+    }
+
+    void resume()
+    {
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            m_paused = false;
+        }
+        m_cv.notify_all();
+    }
+
+    std::vector<uint64_t> buffers       = {};
+    uint64_t              submitted     = 0;
+    size_t                max_in_flight = 0;
+
+private:
+    void run()
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        while(true)
+        {
+            m_cv.wait(_lk, [this]() { return m_stop || (!m_paused && !m_reads.empty()); });
+            if(m_reads.empty()) return;
+
+            auto _read = m_reads.front();
+            m_reads.pop_front();
+            _lk.unlock();
+
+            std::this_thread::sleep_for(m_read_time);
+            buffers.at(_read.slot) = _read.sequence;
+
+            auto* _signal = get_signal(_read.completion);
+            auto  _value  = _signal->value.fetch_sub(1, std::memory_order_release) - 1;
+            if(_signal->handler && _value < _signal->limit)
+            {
+                auto _handler    = _signal->handler;
+                _signal->handler = nullptr;
+                _handler(_value, _signal->arg);
+            }
+            _lk.lock();
+        }
+    }
+
+    std::chrono::microseconds m_read_time = {};
+    std::mutex                m_mutex     = {};
+    std::condition_variable   m_cv        = {};
+    std::deque<read_t>        m_reads     = {};
+    bool                      m_paused    = false;
+    bool                      m_stop      = false;
+    std::thread               m_thread    = {};
+};
+
+struct decoded_t
+{
+    uint64_t                  sequence = 0;  // written by the agent
+    agent_read_queue::read_info info   = {};
+};
+
+// read queue of a fake agent which records the decoded reads
+struct fake_reader
+{
+    fake_reader(size_t depth, std::chrono::microseconds read_time)
+    : agent{depth, read_time}
+    , queue{get_mock_table(),
+            get_mock_ext_table(),
+            depth,
+            [this](size_t slot, hsa_signal_t completion) { agent.submit(slot, completion); },
+            [this](size_t slot, const agent_read_queue::read_info& info) {
+                decoded.emplace_back(decoded_t{agent.buffers.at(slot), info});
+            }}
+    {}
+
+    fake_agent             agent;
+    std::vector<decoded_t> decoded = {};
+    agent_read_queue       queue;
+};
+}  // namespace
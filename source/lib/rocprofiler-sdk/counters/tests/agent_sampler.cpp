@@ -0,0 +1,334 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/agent_sampler.hpp"
+
+#include <gtest/gtest.h>
+#include <hsa/hsa.h>
+#include <hsa/hsa_api_trace.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace rocprofiler::counters;
+
+namespace
+{
+// Signals of the mock runtime, the handle is the address of the value
+std::atomic<hsa_signal_value_t>*
+get_signal(hsa_signal_t signal)
+{
+    return reinterpret_cast<std::atomic<hsa_signal_value_t>*>(signal.handle);
+}
+
+CoreApiTable&
+get_mock_table()
+{
+    static auto _v = []() {
+        auto val                 = CoreApiTable{};
+        val.hsa_signal_create_fn = [](hsa_signal_value_t initial_value,
+                                      uint32_t,
+                                      const hsa_agent_t*,
+                                      hsa_signal_t* signal) {
+            signal->handle =
+                reinterpret_cast<uint64_t>(new std::atomic<hsa_signal_value_t>{initial_value});
+            return HSA_STATUS_SUCCESS;
+        };
+        val.hsa_signal_destroy_fn = [](hsa_signal_t signal) {
+            delete get_signal(signal);
+            return HSA_STATUS_SUCCESS;
+        };
+        val.hsa_signal_store_relaxed_fn = [](hsa_signal_t signal, hsa_signal_value_t value) {
+            get_signal(signal)->store(value, std::memory_order_relaxed);
+        };
+        val.hsa_signal_load_scacquire_fn = [](hsa_signal_t signal) {
+            return get_signal(signal)->load(std::memory_order_acquire);
+        };
+        // only the HSA_SIGNAL_CONDITION_LT 1 condition of the sampler is supported
+        val.hsa_signal_wait_scacquire_fn = [](hsa_signal_t signal,
+                                              hsa_signal_condition_t,
+                                              hsa_signal_value_t,
+                                              uint64_t timeout_hint,
+                                              hsa_wait_state_t) {
+            auto _end = std::chrono::steady_clock::now() + std::chrono::nanoseconds{timeout_hint};
+            auto _val = get_signal(signal)->load(std::memory_order_acquire);
+            while(_val > 0 && std::chrono::steady_clock::now() < _end)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds{50});
+                _val = get_signal(signal)->load(std::memory_order_acquire);
+            }
+            return _val;
+        };
+        return val;
+    }();
+    return _v;
+}
+
+// Executes the reads submitted by the sampler in order, each taking read_time. A read
+// writes the sequence number of the sample into the read buffer of the slot (in place of
+// the counter data written by aqlprofile) and then completes the signal of the slot.
+struct fake_queue
+{
+    struct read_t
+    {
+        size_t       slot       = 0;
+        uint64_t     sequence   = 0;
+        hsa_signal_t completion = {};
+    };
+
+    fake_queue(size_t depth, std::chrono::microseconds read_time)
+    : buffers(depth, 0)
+    , m_read_time{read_time}
+    , m_thread{&fake_queue::run, this}
+    {}
+
+    ~fake_queue()
+    {
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            m_stop   = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+    }
+
+    void submit(size_t slot, hsa_signal_t completion)
+    {
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            m_reads.emplace_back(read_t{slot, submitted++, completion});
+            max_in_flight = std::max(max_in_flight, m_reads.size());
+        }
+        m_cv.notify_one();
+    }
+
+    std::vector<uint64_t> buffers       = {};
+    uint64_t              submitted     = 0;
+    size_t                max_in_flight = 0;
+
+private:
+    void run()
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        while(true)
+        {
+            m_cv.wait(_lk, [this]() { return m_stop || !m_reads.empty(); });
+            if(m_reads.empty()) return;
+
+            auto _read = m_reads.front();
+            _lk.unlock();
+
+            std::this_thread::sleep_for(m_read_time);
+            buffers.at(_read.slot) = _read.sequence;
+
+            _lk.lock();
+            m_reads.pop_front();
+            get_signal(_read.completion)->fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    std::chrono::microseconds m_read_time = {};
+    std::mutex                m_mutex     = {};
+    std::condition_variable   m_cv        = {};
+    std::deque<read_t>        m_reads     = {};
+    bool                      m_stop      = false;
+    std::thread               m_thread    = {};
+};
+
+struct decoded_t
+{
+    uint64_t sequence  = 0;
+    uint64_t timestamp = 0;
+};
+
+void
+run_sampler(std::chrono::microseconds interval,
+            std::chrono::microseconds read_time,
+            std::chrono::milliseconds duration,
+            size_t                    depth,
+            std::vector<decoded_t>&   decoded,
+            uint64_t&                 dropped)
+{
+    auto _queue   = fake_queue{depth, read_time};
+    auto _sampler = agent_sampler{
+        get_mock_table(),
+        interval,
+        depth,
+        [&_queue](size_t slot, hsa_signal_t completion) { _queue.submit(slot, completion); },
+        [&_queue, &decoded](size_t slot, uint64_t timestamp) {
+            decoded.emplace_back(decoded_t{_queue.buffers.at(slot), timestamp});
+        }};
+
+    _sampler.start();
+    std::this_thread::sleep_for(duration);
+    _sampler.stop();
+
+    // every submitted sample has been decoded
+    EXPECT_EQ(_queue.submitted, decoded.size());
+    EXPECT_EQ(_sampler.get_num_samples(), decoded.size());
+    EXPECT_LE(_queue.max_in_flight, depth);
+    dropped = _sampler.get_num_dropped();
+}
+}  // namespace
+
+TEST(agent_sampler, periodic_samples_in_order)
+{
+    auto _decoded = std::vector<decoded_t>{};
+    auto _dropped = uint64_t{0};
+    run_sampler(std::chrono::microseconds{1000},
+                std::chrono::microseconds{10},
+                std::chrono::milliseconds{200},
+                4,
+                _decoded,
+                _dropped);
+
+    ASSERT_GT(_decoded.size(), 10);
+    for(size_t i = 0; i < _decoded.size(); ++i)
+    {
+        EXPECT_EQ(_decoded.at(i).sequence, i);
+        if(i > 0)
+        {
+            EXPECT_GT(_decoded.at(i).timestamp, _decoded.at(i - 1).timestamp);
+        }
+    }
+
+    // samples are taken at the interval, not back-to-back
+    EXPECT_LE(_decoded.size(), 200 + 1);
+}
+
+TEST(agent_sampler, slow_reads_are_pipelined)
+{
+    constexpr size_t depth = 4;
+
+    // each read takes longer than the interval: the sampler keeps depth samples in flight
+    // and drops the ticks for which no slot is available
+    auto _decoded = std::vector<decoded_t>{};
+    auto _dropped = uint64_t{0};
+    run_sampler(std::chrono::microseconds{100},
+                std::chrono::microseconds{2000},
+                std::chrono::milliseconds{100},
+                depth,
+                _decoded,
+                _dropped);
+
+    ASSERT_GT(_decoded.size(), depth);
+    EXPECT_GT(_dropped, 0);
+    for(size_t i = 0; i < _decoded.size(); ++i)
+        EXPECT_EQ(_decoded.at(i).sequence, i);
+}
+
+TEST(agent_sampler, stop_with_hung_reads)
+{
+    constexpr size_t depth = 4;
+
+    // the reads never complete, e.g. the agent hangs: stop gives up on the samples in flight
+    // after the drain timeout instead of waiting forever
+    auto _signals = std::vector<hsa_signal_t>{};
+    auto _sampler = agent_sampler{
+        get_mock_table(),
+        std::chrono::microseconds{500},
+        depth,
+        [&_signals](size_t, hsa_signal_t completion) { _signals.emplace_back(completion); },
+        [](size_t, uint64_t) { ADD_FAILURE() << "a read which never completed was decoded"; }};
+
+    _sampler.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+
+    auto _beg = std::chrono::steady_clock::now();
+    _sampler.stop();
+    auto _elapsed = std::chrono::steady_clock::now() - _beg;
+
+    EXPECT_EQ(_signals.size(), depth);
+    EXPECT_EQ(_sampler.get_num_samples(), 0);
+    EXPECT_GE(_sampler.get_num_dropped(), depth);
+    EXPECT_GE(_elapsed, agent_sampler::drain_timeout);
+    EXPECT_LT(_elapsed, 5 * agent_sampler::drain_timeout);
+
+    // the agent eventually completes the reads, their data is not decoded
+    for(auto itr : _signals)
+        get_signal(itr)->fetch_sub(1, std::memory_order_release);
+}
+
+TEST(agent_sampler, late_reads_keep_their_slots)
+{
+    constexpr size_t depth = 4;
+
+    // the reads of the first run complete after the drain timeout, i.e. the agent may still
+    // write the read buffers of their slots: the slots are not reused until the reads complete
+    auto _complete      = std::atomic<bool>{false};
+    auto _pending       = std::array<std::atomic<bool>, depth>{};
+    auto _num_reused    = std::atomic<size_t>{0};
+    auto _num_submitted = std::atomic<size_t>{0};
+    auto _late          = std::vector<std::pair<size_t, hsa_signal_t>>{};
+    auto _decoded       = std::vector<size_t>{};
+    auto _sampler       = agent_sampler{
+        get_mock_table(),
+        std::chrono::microseconds{500},
+        depth,
+        [&](size_t slot, hsa_signal_t completion) {
+            if(_pending.at(slot).load()) ++_num_reused;
+            if(_num_submitted++ < depth) _late.emplace_back(slot, completion);
+            if(_complete) get_signal(completion)->fetch_sub(1, std::memory_order_release);
+        },
+        [&_decoded](size_t slot, uint64_t) { _decoded.emplace_back(slot); }};
+
+    _sampler.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    _sampler.stop();
+
+    ASSERT_EQ(_late.size(), depth);
+    EXPECT_TRUE(_decoded.empty());
+    for(auto itr : _late)
+        _pending.at(itr.first).store(true);
+
+    // every slot is in use until the late reads complete
+    _sampler.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    EXPECT_EQ(_num_submitted.load(), depth);
+
+    _complete = true;
+    for(auto itr : _late)
+    {
+        _pending.at(itr.first).store(false);
+        get_signal(itr.second)->fetch_sub(1, std::memory_order_release);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    auto _beg = std::chrono::steady_clock::now();
+    _sampler.stop();
+    auto _elapsed = std::chrono::steady_clock::now() - _beg;
+
+    // only the samples of the second run are decoded
+    EXPECT_EQ(_num_reused.load(), 0);
+    EXPECT_GT(_decoded.size(), 0);
+    EXPECT_EQ(_decoded.size(), _num_submitted.load() - depth);
+    EXPECT_EQ(_sampler.get_num_samples(), _decoded.size());
+    EXPECT_LT(_elapsed, agent_sampler::drain_timeout);
+}
@@ -270,7 +270,7 @@ TEST(core, check_packet_generation)
              * Check that a packet generator was created and there is an AST with constructed
              * dimensions
              */
-            EXPECT_TRUE(profile->pkt_generator) << "No packet generator created";
+            EXPECT_FALSE(profile->pkt_generators.empty()) << "No packet generator created";
             EXPECT_EQ(profile->asts.size(), 1);
             EXPECT_FALSE(profile->asts.at(0).dimension_types().empty());
 
@@ -288,6 +288,15 @@ TEST(core, check_packet_generation)
                 EXPECT_TRUE(ptr) << "Could not find pkt";
             });
 
+            /**
+             * Check that the packet ring of the queue is released with the queue
+             */
+            profile->packets.rlock(
+                [](const auto& queue_rings) { EXPECT_EQ(queue_rings.count(0), 1); });
+            counters::remove_queue(0);
+            profile->packets.rlock(
+                [](const auto& queue_rings) { EXPECT_TRUE(queue_rings.empty()); });
+
             /**
              * Check that required hardware counters match
              */
@@ -0,0 +1,381 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/dispatch_filter.hpp"
+
+#include <gtest/gtest.h>
+#include <rocprofiler-sdk/dispatch_profile.h>
+#include <rocprofiler-sdk/fwd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace rocprofiler::counters;
+
+namespace
+{
+// kernel ids of the mock kernels, above the ids of the kernels loaded by the other tests
+constexpr rocprofiler_kernel_id_t kernel_id_base = (1ULL << 40);
+
+rocprofiler_profile_counting_dispatch_filter_t
+make_filter()
+{
+    auto filter = rocprofiler_profile_counting_dispatch_filter_t{};
+    filter.size = sizeof(rocprofiler_profile_counting_dispatch_filter_t);
+    return filter;
+}
+
+rocprofiler_profile_counting_sampling_t
+make_sampling(rocprofiler_kernel_id_t                         kernel_id,
+              rocprofiler_profile_counting_sampling_policy_t policy,
+              uint64_t                                        period,
+              uint64_t                                        seed = 0)
+{
+    auto sampling      = rocprofiler_profile_counting_sampling_t{};
+    sampling.size      = sizeof(rocprofiler_profile_counting_sampling_t);
+    sampling.kernel_id = kernel_id;
+    sampling.policy    = policy;
+    sampling.period    = period;
+    sampling.seed      = seed;
+    return sampling;
+}
+
+// targets the kernels whose name contains the string of filter_args
+int
+name_filter(rocprofiler_kernel_id_t, const char* kernel_name, void* filter_args)
+{
+    const auto* pattern = static_cast<const std::string*>(filter_args);
+    return (std::string_view{kernel_name}.find(*pattern) != std::string_view::npos) ? 1 : 0;
+}
+
+std::string
+kernel_name(size_t idx)
+{
+    return "kernel_" + std::to_string(idx) + "(float*, int)";
+}
+
+struct sample_stats
+{
+    uint64_t              selected = 0;
+    uint64_t              weight   = 0;
+    std::vector<uint64_t> indexes  = {};
+};
+
+// dispatches the kernel num_dispatches times and records the selected dispatches
+sample_stats
+run_dispatches(dispatch_filter* filter, rocprofiler_kernel_id_t kernel_id, uint64_t num_dispatches)
+{
+    auto stats = sample_stats{};
+    for(uint64_t i = 0; i < num_dispatches; ++i)
+    {
+        auto weight = filter->select(kernel_id, i + 1);
+        if(weight == 0) continue;
+        ++stats.selected;
+        stats.weight += weight;
+        stats.indexes.emplace_back(i);
+    }
+    return stats;
+}
+}  // namespace
+
+// the filters register a code object load callback so they are never destroyed
+TEST(dispatch_filter, unconfigured_targets_all)
+{
+    static auto* filter = new dispatch_filter{};
+
+    filter->add_kernel(kernel_id_base + 1, kernel_name(1));
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 1), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 2, 2), 1);
+}
+
+TEST(dispatch_filter, kernel_ids_and_names)
+{
+    static auto* filter = new dispatch_filter{};
+
+    for(size_t i = 0; i < 4; ++i)
+        filter->add_kernel(kernel_id_base + i, kernel_name(i));
+
+    auto pattern               = std::string{"kernel_2("};
+    auto kernel_ids            = std::vector<rocprofiler_kernel_id_t>{kernel_id_base + 0};
+    auto _filter               = make_filter();
+    _filter.kernel_ids         = kernel_ids.data();
+    _filter.kernel_ids_count   = kernel_ids.size();
+    _filter.kernel_filter      = name_filter;
+    _filter.kernel_filter_args = &pattern;
+    ASSERT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_SUCCESS);
+
+    EXPECT_EQ(filter->select(kernel_id_base + 0, 1), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 2), 0);
+    EXPECT_EQ(filter->select(kernel_id_base + 2, 3), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 3, 4), 0);
+
+    // kernels loaded after the filter was configured are resolved when they are added
+    filter->add_kernel(kernel_id_base + 12, "kernel_2(double*, int)");
+    filter->add_kernel(kernel_id_base + 13, kernel_name(13));
+    EXPECT_EQ(filter->select(kernel_id_base + 12, 5), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 13, 6), 0);
+
+    // kernel ids which are not loaded yet are targeted once they are
+    kernel_ids.emplace_back(kernel_id_base + 14);
+    _filter.kernel_ids       = kernel_ids.data();
+    _filter.kernel_ids_count = kernel_ids.size();
+    ASSERT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(filter->select(kernel_id_base + 14, 7), 0);
+    filter->add_kernel(kernel_id_base + 14, kernel_name(14));
+    EXPECT_EQ(filter->select(kernel_id_base + 14, 8), 1);
+
+    // reconfiguring re-resolves the loaded kernels
+    pattern = "kernel_3(";
+    ASSERT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(filter->select(kernel_id_base + 0, 9), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 2, 10), 0);
+    EXPECT_EQ(filter->select(kernel_id_base + 3, 11), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 12, 12), 0);
+}
+
+TEST(dispatch_filter, dispatch_range)
+{
+    static auto* filter = new dispatch_filter{};
+
+    filter->add_kernel(kernel_id_base + 1, kernel_name(1));
+
+    // every kernel, dispatches [10, 20)
+    auto _filter              = make_filter();
+    _filter.dispatch_id_begin = 10;
+    _filter.dispatch_id_end   = 20;
+    ASSERT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_SUCCESS);
+
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 9), 0);
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 10), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 2, 19), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 20), 0);
+
+    // no end
+    _filter.dispatch_id_end = 0;
+    ASSERT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 1000000), 1);
+
+    // invalid arguments leave the filter unchanged
+    _filter.dispatch_id_end = 10;
+    EXPECT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT);
+    _filter.dispatch_id_end  = 0;
+    _filter.kernel_ids_count = 1;
+    EXPECT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 1000000), 1);
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 9), 0);
+}
+
+TEST(dispatch_filter, sampling_stride_and_first)
+{
+    static auto* filter = new dispatch_filter{};
+
+    filter->add_kernel(kernel_id_base + 1, kernel_name(1));
+    filter->add_kernel(kernel_id_base + 2, kernel_name(2));
+
+    // every 4th dispatch by default, the first 3 dispatches of kernel 2
+    ASSERT_EQ(filter->configure(make_sampling(0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_STRIDE, 4)),
+              ROCPROFILER_STATUS_SUCCESS);
+    ASSERT_EQ(filter->configure(make_sampling(
+                  kernel_id_base + 2, ROCPROFILER_PROFILE_COUNTING_SAMPLING_FIRST, 3)),
+              ROCPROFILER_STATUS_SUCCESS);
+
+    auto stride = run_dispatches(filter, kernel_id_base + 1, 100);
+    EXPECT_EQ(stride.selected, 25);
+    EXPECT_EQ(stride.weight, 100);
+    ASSERT_FALSE(stride.indexes.empty());
+    EXPECT_EQ(stride.indexes.front(), 0);
+    EXPECT_EQ(stride.indexes.back(), 96);
+
+    auto first = run_dispatches(filter, kernel_id_base + 2, 100);
+    EXPECT_EQ(first.selected, 3);
+    EXPECT_EQ(first.weight, 3);
+    EXPECT_EQ(first.indexes, (std::vector<uint64_t>{0, 1, 2}));
+
+    // kernels loaded later use the default policy
+    filter->add_kernel(kernel_id_base + 3, kernel_name(3));
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 3, 40).selected, 10);
+
+    // configuring a policy restarts the counts
+    ASSERT_EQ(filter->configure(make_sampling(
+                  kernel_id_base + 2, ROCPROFILER_PROFILE_COUNTING_SAMPLING_NONE, 0)),
+              ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 1, 8).selected, 2);
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 2, 8).selected, 8);
+}
+
+TEST(dispatch_filter, sampling_updates_only_policy_kernels)
+{
+    constexpr size_t num_kernels = 64;
+
+    static auto* filter      = new dispatch_filter{};
+    static auto  num_filters = std::atomic<size_t>{0};
+
+    auto _filter          = make_filter();
+    _filter.kernel_filter = [](rocprofiler_kernel_id_t, const char*, void*) {
+        ++num_filters;
+        return 1;
+    };
+    ASSERT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_SUCCESS);
+
+    for(size_t i = 0; i < num_kernels; ++i)
+        filter->add_kernel(kernel_id_base + i, kernel_name(i));
+    // the kernels which are already loaded by the process are resolved as well
+    const auto num_resolved = num_filters.load();
+    EXPECT_GE(num_resolved, num_kernels);
+
+    ASSERT_EQ(filter->configure(make_sampling(0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_STRIDE, 4)),
+              ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 0, 3).selected, 1);
+
+    // a policy per kernel neither re-runs the kernel filter nor restarts the counts of the
+    // other kernels
+    for(size_t i = 1; i < num_kernels; ++i)
+    {
+        ASSERT_EQ(filter->configure(make_sampling(
+                      kernel_id_base + i, ROCPROFILER_PROFILE_COUNTING_SAMPLING_FIRST, 1)),
+                  ROCPROFILER_STATUS_SUCCESS);
+    }
+    EXPECT_EQ(num_filters.load(), num_resolved);
+
+    // the 4th dispatch of kernel 0 is not sampled, the 5th is
+    EXPECT_EQ(filter->select(kernel_id_base + 0, 4), 0);
+    EXPECT_EQ(filter->select(kernel_id_base + 0, 5), 4);
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 1, 10).selected, 1);
+
+    // the default policy restarts the kernels which do not have a policy of their own
+    ASSERT_EQ(filter->configure(make_sampling(0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_STRIDE, 2)),
+              ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 0, 4).selected, 2);
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 1, 4).selected, 0);
+    EXPECT_EQ(num_filters.load(), num_resolved);
+}
+
+TEST(dispatch_filter, sampling_with_filter)
+{
+    static auto* filter = new dispatch_filter{};
+
+    for(size_t i = 0; i < 4; ++i)
+        filter->add_kernel(kernel_id_base + i, kernel_name(i));
+
+    auto kernel_ids          = std::vector<rocprofiler_kernel_id_t>{kernel_id_base + 1};
+    auto _filter             = make_filter();
+    _filter.kernel_ids       = kernel_ids.data();
+    _filter.kernel_ids_count = kernel_ids.size();
+    ASSERT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_SUCCESS);
+    ASSERT_EQ(filter->configure(make_sampling(0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_STRIDE, 2)),
+              ROCPROFILER_STATUS_SUCCESS);
+
+    // only the targeted kernels are sampled
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 0, 10).selected, 0);
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 1, 10).selected, 5);
+}
+
+TEST(dispatch_filter, sampling_random)
+{
+    constexpr uint64_t num_dispatches = 100000;
+    constexpr uint64_t period         = 8;
+
+    static auto* filter = new dispatch_filter{};
+
+    for(size_t i = 0; i < 3; ++i)
+        filter->add_kernel(kernel_id_base + i, kernel_name(i));
+
+    auto _configure = [](uint64_t seed) {
+        ASSERT_EQ(filter->configure(make_sampling(
+                      0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_RANDOM, period, seed)),
+                  ROCPROFILER_STATUS_SUCCESS);
+    };
+
+    _configure(42);
+    auto first = run_dispatches(filter, kernel_id_base + 1, num_dispatches);
+
+    // about 1 in period dispatches, each representing period dispatches
+    auto expected = num_dispatches / period;
+    EXPECT_GT(first.selected, expected * 9 / 10);
+    EXPECT_LT(first.selected, expected * 11 / 10);
+    EXPECT_EQ(first.weight, first.selected * period);
+
+    // the selected dispatches are spread over the run, not clustered
+    size_t half = 0;
+    for(auto itr : first.indexes)
+        if(itr < num_dispatches / 2) ++half;
+    EXPECT_GT(half, first.selected * 4 / 10);
+    EXPECT_LT(half, first.selected * 6 / 10);
+
+    // the same seed selects the same dispatches, another kernel or seed selects other ones
+    _configure(42);
+    auto second = run_dispatches(filter, kernel_id_base + 1, num_dispatches);
+    EXPECT_EQ(first.indexes, second.indexes);
+
+    _configure(42);
+    EXPECT_NE(first.indexes, run_dispatches(filter, kernel_id_base + 2, num_dispatches).indexes);
+
+    _configure(43);
+    EXPECT_NE(first.indexes, run_dispatches(filter, kernel_id_base + 1, num_dispatches).indexes);
+}
+
+TEST(dispatch_filter, sampling_interval)
+{
+    static auto* filter = new dispatch_filter{};
+
+    filter->add_kernel(kernel_id_base + 1, kernel_name(1));
+
+    // at most one dispatch per 50 msec
+    constexpr uint64_t interval_ns = 50000000;
+    ASSERT_EQ(filter->configure(make_sampling(
+                  0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_INTERVAL, interval_ns)),
+              ROCPROFILER_STATUS_SUCCESS);
+
+    EXPECT_EQ(filter->select(kernel_id_base + 1, 1), 1);
+    auto burst = run_dispatches(filter, kernel_id_base + 1, 999);
+    EXPECT_LE(burst.selected, 1);
+
+    // the next sample represents the dispatches since the previous one
+    std::this_thread::sleep_for(std::chrono::nanoseconds{2 * interval_ns});
+    auto weight = filter->select(kernel_id_base + 1, 1001);
+    EXPECT_GT(weight, 0);
+    EXPECT_EQ(weight + burst.weight, 1000);
+}
+
+TEST(dispatch_filter, sampling_invalid_arguments)
+{
+    static auto* filter = new dispatch_filter{};
+
+    filter->add_kernel(kernel_id_base + 1, kernel_name(1));
+
+    EXPECT_EQ(filter->configure(make_sampling(0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_LAST, 1)),
+              ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(filter->configure(make_sampling(0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_STRIDE, 0)),
+              ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT);
+
+    // invalid policies leave every dispatch profiled
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 1, 10).selected, 10);
+
+    EXPECT_EQ(filter->configure(make_sampling(0, ROCPROFILER_PROFILE_COUNTING_SAMPLING_NONE, 0)),
+              ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(run_dispatches(filter, kernel_id_base + 1, 10).weight, 10);
+}
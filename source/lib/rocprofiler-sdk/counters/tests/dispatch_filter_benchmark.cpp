@@ -0,0 +1,137 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/synchronized.hpp"
+#include "lib/rocprofiler-sdk/counters/dispatch_filter.hpp"
+
+#include <gtest/gtest.h>
+#include <rocprofiler-sdk/dispatch_profile.h>
+#include <rocprofiler-sdk/fwd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+using namespace rocprofiler::counters;
+
+namespace
+{
+// kernel ids of the mock kernels
+constexpr rocprofiler_kernel_id_t kernel_id_base = (1ULL << 40);
+
+rocprofiler_profile_counting_dispatch_filter_t
+make_filter()
+{
+    auto filter = rocprofiler_profile_counting_dispatch_filter_t{};
+    filter.size = sizeof(rocprofiler_profile_counting_dispatch_filter_t);
+    return filter;
+}
+
+// targets the kernels whose name contains the string of filter_args
+int
+name_filter(rocprofiler_kernel_id_t, const char* kernel_name, void* filter_args)
+{
+    const auto* pattern = static_cast<const std::string*>(filter_args);
+    return (std::string_view{kernel_name}.find(*pattern) != std::string_view::npos) ? 1 : 0;
+}
+
+std::string
+kernel_name(size_t idx)
+{
+    return "kernel_" + std::to_string(idx) + "(float*, int)";
+}
+}  // namespace
+
+// Per-dispatch cost of selecting 1 out of 10,000 kernels: in the SDK, with the kernel resolved
+// at load time, versus in the dispatch callback of the tool, which rocprofv3 implements with a
+// read-locked set of the targeted kernels
+TEST(dispatch_filter, benchmark)
+{
+    constexpr size_t num_kernels    = 10000;
+    constexpr size_t num_dispatches = 1000000;
+
+    using targeted_kernels_t = rocprofiler::common::Synchronized<std::unordered_set<uint64_t>>;
+
+    static auto* filter           = new dispatch_filter{};
+    auto         targeted_kernels = targeted_kernels_t{};
+    auto         pattern          = std::string{"kernel_" + std::to_string(num_kernels / 2) + "("};
+
+    targeted_kernels.wlock([](auto& data) { data.emplace(kernel_id_base + num_kernels / 2); });
+
+    auto _filter               = make_filter();
+    _filter.kernel_filter      = name_filter;
+    _filter.kernel_filter_args = &pattern;
+    ASSERT_EQ(filter->configure(_filter), ROCPROFILER_STATUS_SUCCESS);
+
+    for(size_t i = 0; i < num_kernels; ++i)
+        filter->add_kernel(kernel_id_base + i, kernel_name(i));
+
+    using dispatch_callback_t = void (*)(rocprofiler_profile_counting_dispatch_data_t,
+                                         rocprofiler_profile_config_id_t*,
+                                         rocprofiler_user_data_t*,
+                                         void*);
+
+    dispatch_callback_t tool_callback = [](rocprofiler_profile_counting_dispatch_data_t data,
+                                           rocprofiler_profile_config_id_t*             config,
+                                           rocprofiler_user_data_t*,
+                                           void* args) {
+        auto kernel_id = data.dispatch_info.kernel_id;
+        if(static_cast<targeted_kernels_t*>(args)->rlock(
+               [kernel_id](const auto& data_v) { return data_v.count(kernel_id) > 0; }))
+            config->handle = 1;
+    };
+
+    auto _run = [](auto&& _func) {
+        size_t num_targeted = 0;
+        auto   _beg         = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < num_dispatches; ++i)
+        {
+            if(_func(kernel_id_base + (i % num_kernels), i + 1)) ++num_targeted;
+        }
+        auto _end = std::chrono::steady_clock::now();
+        EXPECT_EQ(num_targeted, num_dispatches / num_kernels);
+        return std::chrono::duration<double, std::nano>(_end - _beg).count() / num_dispatches;
+    };
+
+    auto _tool_ns = _run([&](uint64_t kernel_id, uint64_t dispatch_id) {
+        auto config        = rocprofiler_profile_config_id_t{.handle = 0};
+        auto user_data     = rocprofiler_user_data_t{.value = 0};
+        auto dispatch_data = rocprofiler_profile_counting_dispatch_data_t{};
+        dispatch_data.dispatch_info.kernel_id   = kernel_id;
+        dispatch_data.dispatch_info.dispatch_id = dispatch_id;
+        tool_callback(dispatch_data, &config, &user_data, &targeted_kernels);
+        return config.handle != 0;
+    });
+
+    auto _filter_ns = _run([](uint64_t kernel_id, uint64_t dispatch_id) {
+        return filter->select(kernel_id, dispatch_id) > 0;
+    });
+
+    std::cout << "[dispatch_filter] ns/dispatch (1 of " << num_kernels
+              << " kernels targeted) :: tool callback = " << _tool_ns
+              << ", sdk filter = " << _filter_ns << std::endl;
+
+    EXPECT_GT(_filter_ns, 0.0);
+}
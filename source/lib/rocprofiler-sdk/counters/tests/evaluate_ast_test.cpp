@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <map>
 #include <tuple>
 
 #include <fmt/core.h>
@@ -928,6 +929,80 @@ TEST(evaluate_ast, counter_reduction_avg)
     run_reduce_test(metrics, base_counter_data, derived_counters);
 }
 
+TEST(evaluate_ast, counter_reduction_dimensions)
+{
+    using namespace rocprofiler::counters;
+
+    std::unordered_map<std::string, Metric> metrics = {
+        {"MYERS", Metric("gfx9", "MYERS", "a", "a", "a", "", "", 2)},
+        {"MYERS_SE",
+         Metric("gfx9",
+                "MYERS_SE",
+                "a",
+                "a",
+                "a",
+                "reduce(MYERS,sum,[DIMENSION_SHADER_ENGINE])",
+                "",
+                3)},
+        {"MYERS_MAX",
+         Metric("gfx9",
+                "MYERS_MAX",
+                "a",
+                "a",
+                "a",
+                "reduce(MYERS,max,[DIMENSION_XCC,DIMENSION_SHADER_ENGINE])",
+                "",
+                4)},
+    };
+
+    rocprofiler_counter_instance_id_t base_id = 0;
+    set_counter_in_rec(base_id, {.handle = 2});
+    auto base_counter_data = construct_test_data_dim(
+        base_id, {ROCPROFILER_DIMENSION_XCC, ROCPROFILER_DIMENSION_SHADER_ENGINE}, 4);
+
+    // instances which only differ in the reduced dimensions are combined
+    std::map<size_t, double> expected_sum;
+    double                   expected_max = 0;
+    for(const auto& rec : base_counter_data)
+    {
+        expected_sum[rec_to_dim_pos(rec.id, ROCPROFILER_DIMENSION_XCC)] += rec.counter_value;
+        expected_max = std::max(expected_max, rec.counter_value);
+    }
+
+    auto evaluate = [&](const std::string& name) {
+        RawAST* ast = nullptr;
+        auto    buf = yy_scan_string(metrics.at(name).expression().c_str());
+        yyparse(&ast);
+        EXPECT_TRUE(ast) << metrics.at(name).expression();
+        auto eval_ast = EvaluateAST({.handle = metrics.at(name).id()}, metrics, *ast, "gfx9");
+        yy_delete_buffer(buf);
+        delete ast;
+
+        // the reduction is done in place on the decoded records
+        std::unordered_map<uint64_t, std::vector<rocprofiler_record_counter_t>> decoded = {
+            {metrics.at("MYERS").id(), base_counter_data}};
+        std::vector<std::unique_ptr<std::vector<rocprofiler_record_counter_t>>> cache;
+        auto ret = *eval_ast.evaluate(decoded, cache);
+        eval_ast.set_out_id(ret);
+        return ret;
+    };
+
+    auto sum_ret = evaluate("MYERS_SE");
+    ASSERT_EQ(sum_ret.size(), expected_sum.size());
+    for(const auto& v : sum_ret)
+    {
+        auto xcc = rec_to_dim_pos(v.id, ROCPROFILER_DIMENSION_XCC);
+        EXPECT_EQ(rec_to_counter_id(v.id).handle, metrics.at("MYERS_SE").id());
+        EXPECT_EQ(rec_to_dim_pos(v.id, ROCPROFILER_DIMENSION_SHADER_ENGINE), 0);
+        EXPECT_FLOAT_EQ(v.counter_value, expected_sum.at(xcc));
+    }
+
+    auto max_ret = evaluate("MYERS_MAX");
+    ASSERT_EQ(max_ret.size(), 1);
+    EXPECT_EQ(rec_to_dim_pos(max_ret.front().id, ROCPROFILER_DIMENSION_NONE), 0);
+    EXPECT_FLOAT_EQ(max_ret.front().counter_value, expected_max);
+}
+
 TEST(evaluate_ast, evaluate_mixed_counters)
 {
     using namespace rocprofiler::counters;
@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include "lib/rocprofiler-sdk/counters/controller.hpp"
+
+#include <rocprofiler-sdk/fwd.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace rocprofiler;
+
+namespace
+{
+// values read by a pass, one record per counter
+counters::decoded_pkt_t
+make_pass_values(const std::vector<uint64_t>& counter_ids, double value)
+{
+    auto decoded = counters::decoded_pkt_t{};
+    for(auto id : counter_ids)
+    {
+        auto record          = rocprofiler_record_counter_t{};
+        record.id            = id;
+        record.counter_value = value;
+        decoded[id].emplace_back(record);
+    }
+    return decoded;
+}
+}  // namespace
+
+TEST(kernel_passes, round_robin)
+{
+    // multi-pass profile without packet generators, only the number of passes is used
+    counters::profile_config config = {};
+    config.pkt_generators.resize(3);
+
+    // Successive dispatches of a kernel take the passes in turn
+    for(size_t i = 0; i < 7; ++i)
+        EXPECT_EQ(counters::next_kernel_pass(config, 1), i % 3);
+
+    // The passes of each kernel are selected independently
+    EXPECT_EQ(counters::next_kernel_pass(config, 2), 0);
+    EXPECT_EQ(counters::next_kernel_pass(config, 2), 1);
+    EXPECT_EQ(counters::next_kernel_pass(config, 1), 1);
+}
+
+TEST(kernel_passes, merge)
+{
+    counters::profile_config config = {};
+    config.pkt_generators.resize(3);
+
+    // Passes may complete out of order, nothing is reported before the last one
+    auto pass_2 = make_pass_values({20, 21}, 2.0);
+    EXPECT_FALSE(counters::merge_kernel_pass(config, 1, 2, pass_2));
+    auto pass_0 = make_pass_values({0}, 0.0);
+    EXPECT_FALSE(counters::merge_kernel_pass(config, 1, 0, pass_0));
+
+    // A pass of another kernel does not complete the kernel
+    auto other = make_pass_values({10}, 5.0);
+    EXPECT_FALSE(counters::merge_kernel_pass(config, 2, 1, other));
+
+    auto decoded = make_pass_values({10}, 1.0);
+    ASSERT_TRUE(counters::merge_kernel_pass(config, 1, 1, decoded));
+    ASSERT_EQ(decoded.size(), 4);
+    for(auto [id, value] : std::vector<std::pair<uint64_t, double>>{
+            {0, 0.0}, {10, 1.0}, {20, 2.0}, {21, 2.0}})
+    {
+        ASSERT_EQ(decoded.count(id), 1) << "counter " << id;
+        ASSERT_EQ(decoded.at(id).size(), 1);
+        EXPECT_EQ(decoded.at(id).front().counter_value, value) << "counter " << id;
+    }
+
+    // The next set of passes starts over
+    auto next = make_pass_values({0}, 3.0);
+    EXPECT_FALSE(counters::merge_kernel_pass(config, 1, 0, next));
+
+    // Kernel 1 restarted a set of passes, kernel 2 has one pass pending
+    EXPECT_EQ(counters::drop_partial_kernel_passes(config), 2);
+    EXPECT_EQ(counters::drop_partial_kernel_passes(config), 0);
+}
+
+TEST(kernel_passes, drop_partial)
+{
+    counters::profile_config config = {};
+    config.pkt_generators.resize(2);
+
+    EXPECT_EQ(counters::next_kernel_pass(config, 1), 0);
+    auto pass_0 = make_pass_values({0}, 1.0);
+    EXPECT_FALSE(counters::merge_kernel_pass(config, 1, 0, pass_0));
+    EXPECT_EQ(counters::drop_partial_kernel_passes(config), 1);
+
+    // The dropped values are not merged with the next set of passes of the kernel
+    EXPECT_EQ(counters::next_kernel_pass(config, 1), 0);
+    auto pass_1 = make_pass_values({1}, 2.0);
+    EXPECT_FALSE(counters::merge_kernel_pass(config, 1, 1, pass_1));
+    auto decoded = make_pass_values({0}, 3.0);
+    ASSERT_TRUE(counters::merge_kernel_pass(config, 1, 0, decoded));
+    ASSERT_EQ(decoded.size(), 2);
+    EXPECT_EQ(decoded.at(0).front().counter_value, 3.0);
+    EXPECT_EQ(decoded.at(1).front().counter_value, 2.0);
+}
@@ -0,0 +1,280 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include "lib/rocprofiler-sdk/counters/packet_ring.hpp"
+#include "lib/rocprofiler-sdk/hsa/aql_packet.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+using namespace rocprofiler;
+
+namespace
+{
+// counts the calls to the memory pool functions of the mock runtime
+struct mock_pool_counts
+{
+    uint64_t allocated    = 0;
+    uint64_t freed        = 0;
+    uint64_t access       = 0;
+    bool     fail_allocate = false;
+};
+
+mock_pool_counts counts = {};
+
+hsa_status_t
+mock_memory_pool_allocate(hsa_amd_memory_pool_t, size_t size, uint32_t, void** ptr)
+{
+    if(counts.fail_allocate) return HSA_STATUS_ERROR_OUT_OF_RESOURCES;
+
+    *ptr = std::aligned_alloc(hsa::CounterBufferBlock::page_size, size);
+    ++counts.allocated;
+    return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+mock_memory_pool_free(void* ptr)
+{
+    std::free(ptr);
+    ++counts.freed;
+    return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+mock_agents_allow_access(uint32_t, const hsa_agent_t*, const uint32_t*, const void*)
+{
+    ++counts.access;
+    return HSA_STATUS_SUCCESS;
+}
+
+AmdExtTable
+get_mock_table()
+{
+    auto _table                            = AmdExtTable{};
+    _table.hsa_amd_memory_pool_allocate_fn = mock_memory_pool_allocate;
+    _table.hsa_amd_memory_pool_free_fn     = mock_memory_pool_free;
+    _table.hsa_amd_agents_allow_access_fn  = mock_agents_allow_access;
+    return _table;
+}
+
+constexpr size_t command_size = 160;
+constexpr size_t output_size  = 6000;
+
+// constructs the packets of a block of slots, i.e. CounterPacketConstruct::construct_packets
+// without the aqlprofile packets
+counters::packet_ring::construct_func_t
+get_construct_func(const AmdExtTable& table)
+{
+    return [&table](size_t count) {
+        auto _block = std::make_shared<hsa::CounterBufferBlock>(table,
+                                                                hsa_agent_t{.handle = 1},
+                                                                hsa_amd_memory_pool_t{.handle = 2},
+                                                                hsa_amd_memory_pool_t{.handle = 3},
+                                                                command_size,
+                                                                output_size,
+                                                                count);
+
+        auto _pkts = std::vector<std::unique_ptr<hsa::CounterAQLPacket>>{};
+        for(size_t i = 0; i < count; ++i)
+            _pkts.emplace_back(std::make_unique<hsa::CounterAQLPacket>(_block, i));
+        return _pkts;
+    };
+}
+
+bool
+is_zeroed(const hsa::AQLPacket& pkt)
+{
+    const auto* _data = static_cast<const uint8_t*>(pkt.profile.output_buffer.ptr);
+    for(size_t i = 0; i < pkt.profile.output_buffer.size; ++i)
+        if(_data[i] != 0) return false;
+    return true;
+}
+
+// writes the "counters" of a dispatch at both ends of the output buffer
+void
+write_output(hsa::AQLPacket& pkt, uint64_t value)
+{
+    auto* _data = static_cast<uint8_t*>(pkt.profile.output_buffer.ptr);
+    memcpy(_data, &value, sizeof(value));
+    memcpy(_data + pkt.profile.output_buffer.size - sizeof(value), &value, sizeof(value));
+}
+
+uint64_t
+read_output(const hsa::AQLPacket& pkt)
+{
+    const auto* _data  = static_cast<const uint8_t*>(pkt.profile.output_buffer.ptr);
+    uint64_t    _first = 0;
+    uint64_t    _last  = 0;
+    memcpy(&_first, _data, sizeof(_first));
+    memcpy(&_last, _data + pkt.profile.output_buffer.size - sizeof(_last), sizeof(_last));
+    return (_first == _last) ? _first : 0;
+}
+}  // namespace
+
+TEST(packet_ring, buffer_block)
+{
+    counts      = {};
+    auto _table = get_mock_table();
+    {
+        auto _block = hsa::CounterBufferBlock{_table,
+                                              hsa_agent_t{.handle = 1},
+                                              hsa_amd_memory_pool_t{.handle = 2},
+                                              hsa_amd_memory_pool_t{.handle = 3},
+                                              command_size,
+                                              output_size,
+                                              8};
+
+        // one allocation and one access grant per buffer type for every slot of the block
+        EXPECT_EQ(counts.allocated, 2);
+        EXPECT_EQ(counts.access, 2);
+        EXPECT_EQ(_block.slots(), 8);
+        EXPECT_EQ(_block.command_size(), command_size);
+        EXPECT_EQ(_block.output_size(), output_size);
+
+        for(size_t i = 0; i < _block.slots(); ++i)
+        {
+            auto _cmd = reinterpret_cast<uintptr_t>(_block.command_buffer(i));
+            auto _out = reinterpret_cast<uintptr_t>(_block.output_buffer(i));
+            EXPECT_EQ(_cmd % hsa::CounterBufferBlock::page_size, 0);
+            EXPECT_EQ(_out % hsa::CounterBufferBlock::page_size, 0);
+            if(i > 0)
+            {
+                EXPECT_GE(_out - reinterpret_cast<uintptr_t>(_block.output_buffer(i - 1)),
+                          output_size);
+            }
+        }
+    }
+    EXPECT_EQ(counts.freed, 2);
+
+    // the buffers are malloced (and not granted to the agent) if the pool allocation fails
+    counts               = {};
+    counts.fail_allocate = true;
+    {
+        auto _block = std::make_shared<hsa::CounterBufferBlock>(_table,
+                                                                hsa_agent_t{.handle = 1},
+                                                                hsa_amd_memory_pool_t{.handle = 2},
+                                                                hsa_amd_memory_pool_t{.handle = 3},
+                                                                command_size,
+                                                                output_size,
+                                                                4);
+        auto _pkt   = hsa::CounterAQLPacket{_block, 3};
+        EXPECT_EQ(_pkt.profile.output_buffer.ptr, _block->output_buffer(3));
+        EXPECT_EQ(_pkt.profile.output_buffer.size, output_size);
+        EXPECT_TRUE(is_zeroed(_pkt));
+    }
+    EXPECT_EQ(counts.access, 0);
+    EXPECT_EQ(counts.freed, 0);
+}
+
+TEST(packet_ring, exhaustion)
+{
+    counts      = {};
+    auto _table = get_mock_table();
+    auto _ring  = counters::packet_ring{32, get_construct_func(_table), 16};
+
+    EXPECT_EQ(_ring.capacity(), 32);
+    EXPECT_EQ(_ring.slots(), 0);
+
+    auto _pkts = std::vector<counters::packet_ring::packet_ptr_t>{};
+    for(size_t i = 0; i < 32; ++i)
+    {
+        _pkts.emplace_back(_ring.acquire());
+        ASSERT_TRUE(_pkts.back());
+    }
+    EXPECT_EQ(_ring.slots(), 32);
+    EXPECT_EQ(_ring.in_flight(), 32);
+    EXPECT_EQ(counts.allocated, 4);
+
+    // every slot is in flight
+    EXPECT_FALSE(_ring.acquire());
+
+    auto* _released = _pkts.back().get();
+    _ring.release(std::move(_pkts.back()));
+    _pkts.pop_back();
+
+    auto _pkt = _ring.acquire();
+    EXPECT_EQ(_pkt.get(), _released);
+    EXPECT_EQ(counts.allocated, 4);
+
+    _ring.release(std::move(_pkt));
+    for(auto& itr : _pkts)
+        _ring.release(std::move(itr));
+    EXPECT_EQ(_ring.in_flight(), 0);
+
+    EXPECT_EQ(counters::packet_ring::queue_capacity(0), 1);
+    EXPECT_EQ(counters::packet_ring::queue_capacity(1024), 256);
+}
+
+TEST(packet_ring, reuse_across_dispatches)
+{
+    constexpr uint64_t num_dispatches = 1000000;
+    constexpr size_t   max_inflight   = 40;
+    constexpr size_t   queue_size     = 4096;
+
+    counts      = {};
+    auto _table = get_mock_table();
+    {
+        auto _ring = counters::packet_ring{counters::packet_ring::queue_capacity(queue_size),
+                                           get_construct_func(_table)};
+
+        // dispatches are completed in order with at most max_inflight dispatches on the queue
+        auto _inflight = std::deque<counters::packet_ring::packet_ptr_t>{};
+        for(uint64_t i = 0; i < num_dispatches; ++i)
+        {
+            if(_inflight.size() == max_inflight)
+            {
+                auto& _done = _inflight.front();
+                EXPECT_EQ(read_output(*_done), i - max_inflight + 1);
+                _ring.release(std::move(_done));
+                _inflight.pop_front();
+            }
+
+            auto _pkt = _ring.acquire();
+            ASSERT_TRUE(_pkt);
+            // the output of the previous dispatch using the slot was cleared
+            ASSERT_EQ(read_output(*_pkt), 0) << "dispatch " << i;
+            if(i < max_inflight * 4) ASSERT_TRUE(is_zeroed(*_pkt));
+
+            write_output(*_pkt, i + 1);
+            _inflight.emplace_back(std::move(_pkt));
+        }
+
+        // the slots are only constructed for the peak number of dispatches in flight
+        auto _blocks = (max_inflight + counters::packet_ring::default_block_slots - 1) /
+                       counters::packet_ring::default_block_slots;
+        EXPECT_EQ(_ring.slots(), _blocks * counters::packet_ring::default_block_slots);
+        EXPECT_EQ(counts.allocated, 2 * _blocks);
+        EXPECT_EQ(counts.access, 2 * _blocks);
+        EXPECT_EQ(counts.freed, 0);
+
+        for(auto& itr : _inflight)
+            _ring.release(std::move(itr));
+        EXPECT_EQ(_ring.in_flight(), 0);
+    }
+    EXPECT_EQ(counts.freed, counts.allocated);
+}
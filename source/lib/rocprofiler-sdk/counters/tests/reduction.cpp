@@ -0,0 +1,87 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/tests/reduction_records.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(reduction, reduce_all)
+{
+    auto _records = make_records(3, mi300_dims());
+    check_reduction({}, _records);
+
+    // a single output record without dimensions
+    auto _reduced = _records;
+    DimensionReduction{REDUCE_SUM, {}}.reduce(_reduced);
+    ASSERT_EQ(_reduced.size(), 1);
+    EXPECT_EQ(rec_to_counter_id(_reduced.front().id).handle, 3);
+    EXPECT_EQ(rec_to_dim_pos(_reduced.front().id, ROCPROFILER_DIMENSION_NONE), 0);
+
+    // fewer records than the lanes of the kernels
+    check_reduction({}, make_records(3, {{ROCPROFILER_DIMENSION_INSTANCE, 3}}));
+    check_reduction({}, make_records(3, {{ROCPROFILER_DIMENSION_INSTANCE, 1}}));
+
+    // every dimension listed is the same as none
+    check_reduction(dimension_set_t(ALL_DIMENSIONS.begin(), ALL_DIMENSIONS.end()), _records);
+}
+
+TEST(reduction, reduce_dimensions)
+{
+    auto _records = make_records(5, mi300_dims(), 1);
+
+    check_reduction({ROCPROFILER_DIMENSION_XCC}, _records);
+    check_reduction({ROCPROFILER_DIMENSION_INSTANCE}, _records);
+    check_reduction({ROCPROFILER_DIMENSION_SHADER_ENGINE, ROCPROFILER_DIMENSION_CU}, _records);
+    check_reduction({ROCPROFILER_DIMENSION_XCC,
+                     ROCPROFILER_DIMENSION_SHADER_ENGINE,
+                     ROCPROFILER_DIMENSION_CU},
+                    _records);
+    // dimension not present in the records
+    check_reduction({ROCPROFILER_DIMENSION_AID}, _records);
+
+    auto _reduced = _records;
+    DimensionReduction{REDUCE_SUM, {ROCPROFILER_DIMENSION_SHADER_ENGINE, ROCPROFILER_DIMENSION_CU}}
+        .reduce(_reduced);
+    ASSERT_EQ(_reduced.size(), 8 * 32);
+    for(const auto& itr : _reduced)
+    {
+        EXPECT_EQ(rec_to_counter_id(itr.id).handle, 5);
+        EXPECT_EQ(rec_to_dim_pos(itr.id, ROCPROFILER_DIMENSION_SHADER_ENGINE), 0);
+        EXPECT_EQ(rec_to_dim_pos(itr.id, ROCPROFILER_DIMENSION_CU), 0);
+    }
+}
+
+TEST(reduction, sparse_instances)
+{
+    // only the even CUs of the last XCC
+    auto _records = records_t{};
+    for(const auto& itr : make_records(5, mi300_dims(), 2))
+    {
+        if(rec_to_dim_pos(itr.id, ROCPROFILER_DIMENSION_XCC) == 7 &&
+           rec_to_dim_pos(itr.id, ROCPROFILER_DIMENSION_CU) % 2 == 0)
+            _records.emplace_back(itr);
+    }
+
+    check_reduction({ROCPROFILER_DIMENSION_INSTANCE}, _records);
+    check_reduction({ROCPROFILER_DIMENSION_SHADER_ENGINE}, _records);
+    check_reduction({}, _records);
+}
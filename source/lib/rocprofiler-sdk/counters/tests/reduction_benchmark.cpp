@@ -0,0 +1,78 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/tests/reduction_records.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+// Compares the reference and the vectorized reductions
+TEST(reduction, benchmark)
+{
+    constexpr size_t iterations = 200;
+
+    auto _records = make_records(9, mi300_dims(), 3);
+    auto _scratch = records_t{};
+
+    // nanoseconds per record of the reference and the reduction of the records
+    auto _run = [&](ReduceOperation op, const dimension_set_t& reduce_dims) {
+        auto _reduction = DimensionReduction{op, reduce_dims};
+        auto _expected  = reference_reduce(op, reduce_dims, _records);
+
+        auto _beg = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            _scratch = reference_reduce(op, reduce_dims, _records);
+        }
+        auto _mid = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < iterations; ++i)
+        {
+            _scratch = _records;
+            _reduction.reduce(_scratch);
+        }
+        auto _end = std::chrono::steady_clock::now();
+
+        expect_records_eq(_scratch, _expected);
+
+        auto _per_record = [&](auto _duration) {
+            return std::chrono::duration<double, std::nano>(_duration).count() /
+                   (iterations * _records.size());
+        };
+        return std::make_pair(_per_record(_mid - _beg), _per_record(_end - _mid));
+    };
+
+    auto _print = [&](const char* label, std::pair<double, double> result) {
+        std::cout << "[reduction] " << _records.size() << " instances, " << label
+                  << " :: ns/instance reference = " << result.first
+                  << ", vectorized = " << result.second << std::endl;
+    };
+
+    _print("sum over every dimension", _run(REDUCE_SUM, {}));
+    _print("max over every dimension", _run(REDUCE_MAX, {}));
+    _print("sum over SE and CU",
+           _run(REDUCE_SUM, {ROCPROFILER_DIMENSION_SHADER_ENGINE, ROCPROFILER_DIMENSION_CU}));
+    _print("avg over instances", _run(REDUCE_AVG, {ROCPROFILER_DIMENSION_INSTANCE}));
+}
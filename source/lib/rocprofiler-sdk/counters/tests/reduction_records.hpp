@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/counters/id_decode.hpp"
+#include "lib/rocprofiler-sdk/counters/reduction.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using namespace ::rocprofiler::counters;
+
+using dims_t    = std::vector<std::pair<rocprofiler_profile_counter_instance_types, size_t>>;
+using records_t = std::vector<rocprofiler_record_counter_t>;
+
+constexpr auto ALL_DIMENSIONS = {ROCPROFILER_DIMENSION_XCC,
+                                 ROCPROFILER_DIMENSION_AID,
+                                 ROCPROFILER_DIMENSION_SHADER_ENGINE,
+                                 ROCPROFILER_DIMENSION_AGENT,
+                                 ROCPROFILER_DIMENSION_SHADER_ARRAY,
+                                 ROCPROFILER_DIMENSION_CU,
+                                 ROCPROFILER_DIMENSION_INSTANCE};
+
+// Instances of a counter covering every position of the dimensions (the last dimension varying
+// fastest, like the records decoded from an AQL packet). Integer values so that the sums do not
+// depend on the order of the additions.
+records_t
+make_records(uint64_t counter_id, const dims_t& dims, uint64_t seed = 0)
+{
+    auto _rng  = std::mt19937_64{seed};
+    auto _dist = std::uniform_int_distribution<int64_t>{0, 50000};
+    auto _ret  = records_t{};
+    auto _pos  = std::vector<size_t>(dims.size(), 0);
+
+    size_t _size = 1;
+    for(const auto& itr : dims)
+        _size *= itr.second;
+
+    for(size_t i = 0; i < _size; ++i)
+    {
+        auto& _rec = _ret.emplace_back(rocprofiler_record_counter_t{});
+        set_counter_in_rec(_rec.id, {.handle = counter_id});
+        for(size_t d = 0; d < dims.size(); ++d)
+            set_dim_in_rec(_rec.id, dims.at(d).first, _pos.at(d));
+        _rec.counter_value = static_cast<double>(_dist(_rng));
+        _rec.dispatch_id   = 7;
+
+        for(size_t d = dims.size(); d > 0; --d)
+        {
+            if(++_pos.at(d - 1) < dims.at(d - 1).second) break;
+            _pos.at(d - 1) = 0;
+        }
+    }
+    return _ret;
+}
+
+// Scalar reduction which decodes the position of every dimension of every record and combines
+// the records in a map keyed by the positions of the kept dimensions
+records_t
+reference_reduce(ReduceOperation op, const dimension_set_t& reduce_dims, const records_t& records)
+{
+    auto _groups = std::map<uint64_t, std::pair<rocprofiler_record_counter_t, size_t>>{};
+    for(const auto& rec : records)
+    {
+        rocprofiler_counter_instance_id_t _id = 0;
+        set_counter_in_rec(_id, rec_to_counter_id(rec.id));
+        for(auto dim : ALL_DIMENSIONS)
+        {
+            if(!reduce_dims.empty() && reduce_dims.count(dim) == 0)
+                set_dim_in_rec(_id, dim, rec_to_dim_pos(rec.id, dim));
+        }
+
+        auto [_itr, _inserted] = _groups.emplace(_id, std::make_pair(rec, 1));
+        auto& [_group, _count] = _itr->second;
+        _group.id              = _id;
+        if(_inserted) continue;
+
+        ++_count;
+        switch(op)
+        {
+            case REDUCE_NONE: break;
+            case REDUCE_MIN:
+                _group.counter_value = std::min(_group.counter_value, rec.counter_value);
+                break;
+            case REDUCE_MAX:
+                _group.counter_value = std::max(_group.counter_value, rec.counter_value);
+                break;
+            case REDUCE_SUM:
+            case REDUCE_AVG: _group.counter_value += rec.counter_value; break;
+        }
+    }
+
+    auto _ret = records_t{};
+    for(auto& [_, itr] : _groups)
+    {
+        auto& [_group, _count] = itr;
+        if(op == REDUCE_AVG) _group.counter_value /= _count;
+        _ret.emplace_back(_group);
+    }
+    return _ret;
+}
+
+void
+expect_records_eq(const records_t& lhs, const records_t& rhs)
+{
+    ASSERT_EQ(lhs.size(), rhs.size());
+    for(size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(lhs.at(i).id, rhs.at(i).id) << "record " << i;
+        EXPECT_DOUBLE_EQ(lhs.at(i).counter_value, rhs.at(i).counter_value) << "record " << i;
+        EXPECT_EQ(lhs.at(i).dispatch_id, rhs.at(i).dispatch_id) << "record " << i;
+    }
+}
+
+void
+check_reduction(const dimension_set_t& reduce_dims, const records_t& records)
+{
+    for(auto op : {REDUCE_MIN, REDUCE_MAX, REDUCE_SUM, REDUCE_AVG})
+    {
+        auto _reduced = records;
+        DimensionReduction{op, reduce_dims}.reduce(_reduced);
+        expect_records_eq(_reduced, reference_reduce(op, reduce_dims, records));
+    }
+}
+
+// MI300 scale instances: 8 XCCs with 4 SEs of 10 CUs each and 32 instances per CU
+const dims_t&
+mi300_dims()
+{
+    static const auto _v = dims_t{{ROCPROFILER_DIMENSION_XCC, 8},
+                                  {ROCPROFILER_DIMENSION_SHADER_ENGINE, 4},
+                                  {ROCPROFILER_DIMENSION_CU, 10},
+                                  {ROCPROFILER_DIMENSION_INSTANCE, 32}};
+    return _v;
+}
+}  // namespace
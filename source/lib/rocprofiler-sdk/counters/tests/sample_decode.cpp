@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/tests/sample_decode_mocks.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+TEST(sample_decode, decodes_like_per_sample_lookup)
+{
+    auto _counters = make_counter_events({{1, {13, 16}}, {2, {13, 16}}, {3, {7, 4}}, {4, {2, 1}}});
+    auto _decoder  = SampleDecoder{_counters, iterate_synthetic, synthetic_instance_id};
+    auto _expected = per_sample_decoder{_counters};
+
+    size_t _num_samples = 0;
+    auto   _out         = SampleDecoder::decoded_map_t{};
+    auto   _ref         = SampleDecoder::decoded_map_t{};
+    for(uint64_t seed : {100, 200, 300})
+    {
+        auto _output  = make_output(_counters, seed);
+        auto _profile = make_profile(_output);
+        _num_samples  = _output.size();
+
+        num_instance_ids.store(0);
+        _decoder.decode(_profile, _out);
+        // the instance ids are only computed from the first output
+        EXPECT_EQ(num_instance_ids.load(), (seed == 100) ? _num_samples : 0);
+
+        _expected.decode(_profile, _ref);
+        expect_same(_out, _ref);
+    }
+
+    ASSERT_EQ(_decoder.counter_samples().size(), _counters.size());
+    for(size_t i = 0; i < _counters.size(); ++i)
+        EXPECT_EQ(_decoder.counter_samples()[i],
+                  _counters[i].second.size() * NUM_XCC * NUM_SE);
+}
+
+TEST(sample_decode, samples_outside_layout)
+{
+    auto _counters = make_counter_events({{1, {13, 2}}, {2, {7, 2}}});
+    auto _decoder  = SampleDecoder{_counters, iterate_synthetic, synthetic_instance_id};
+    auto _expected = per_sample_decoder{_counters};
+
+    auto _out    = SampleDecoder::decoded_map_t{};
+    auto _ref    = SampleDecoder::decoded_map_t{};
+    auto _output = make_output(_counters, 0);
+    {
+        auto _profile = make_profile(_output);
+        _decoder.decode(_profile, _out);
+    }
+
+    // a sample id which was not in the first output, an event which is not in the profile and
+    // the events in a different order
+    _output.push_back({event_t{7, 1, 2}, NUM_XCC * NUM_SE, 42});
+    _output.push_back({event_t{5, 0, 1}, 0, 43});
+    std::reverse(_output.begin(), _output.end());
+
+    auto _profile = make_profile(_output);
+    num_instance_ids.store(0);
+    _decoder.decode(_profile, _out);
+    EXPECT_EQ(num_instance_ids.load(), 1);
+
+    _expected.decode(_profile, _ref);
+    expect_same(_out, _ref);
+    EXPECT_EQ(_out.at(2).size(), 2 * NUM_XCC * NUM_SE + 1);
+}
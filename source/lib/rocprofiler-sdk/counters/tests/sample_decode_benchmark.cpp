@@ -0,0 +1,71 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/counters/tests/sample_decode_mocks.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+// Compares the per-sample lookup with the cached sample layout
+TEST(sample_decode, benchmark)
+{
+    constexpr size_t num_iterations = 200;
+
+    // eight counters of blocks with 16 instances, e.g. TCC
+    auto _counters = make_counter_events({{1, {13, 16}},
+                                          {2, {13, 16}},
+                                          {3, {13, 16}},
+                                          {4, {13, 16}},
+                                          {5, {14, 16}},
+                                          {6, {14, 16}},
+                                          {7, {14, 16}},
+                                          {8, {14, 16}}});
+    auto _output   = make_output(_counters, 0);
+    auto _profile  = make_profile(_output);
+
+    auto _time = [&](auto&& decoder) {
+        auto _out = SampleDecoder::decoded_map_t{};
+        decoder.decode(_profile, _out);
+
+        auto _beg = std::chrono::steady_clock::now();
+        for(size_t i = 0; i < num_iterations; ++i)
+            decoder.decode(_profile, _out);
+        auto _end = std::chrono::steady_clock::now();
+        return std::make_pair(std::chrono::duration<double, std::micro>(_end - _beg).count() /
+                                  num_iterations,
+                              std::move(_out));
+    };
+
+    auto [_per_sample_us, _ref] = _time(per_sample_decoder{_counters});
+    auto [_layout_us, _out] =
+        _time(SampleDecoder{_counters, iterate_synthetic, synthetic_instance_id});
+
+    std::cout << "[sample_decode] " << _output.size() << " samples, usec/decode :: per sample = "
+              << _per_sample_us << ", layout = " << _layout_us << std::endl;
+
+    expect_same(_out, _ref);
+    EXPECT_GT(_layout_us, 0.0);
+}
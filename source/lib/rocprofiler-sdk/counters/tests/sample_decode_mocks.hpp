@@ -0,0 +1,204 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/counters/id_decode.hpp"
+#include "lib/rocprofiler-sdk/counters/sample_decode.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using namespace ::rocprofiler::counters;
+
+using event_t = hsa_ven_amd_aqlprofile_event_t;
+
+constexpr uint32_t NUM_XCC = 8;
+constexpr uint32_t NUM_SE  = 4;
+
+// sample of the synthetic output buffer of a profile
+struct synthetic_sample
+{
+    event_t  event     = {};
+    uint32_t sample_id = 0;
+    uint64_t result    = 0;
+};
+
+std::atomic<uint64_t> num_instance_ids = {0};
+
+// Stub of hsa_ven_amd_aqlprofile_iterate_data: the output buffer of the profile is an array of
+// synthetic_sample
+hsa_status_t
+iterate_synthetic(const hsa_ven_amd_aqlprofile_profile_t* profile,
+                  hsa_ven_amd_aqlprofile_data_callback_t  callback,
+                  void*                                   data)
+{
+    const auto* _samples = static_cast<const synthetic_sample*>(profile->output_buffer.ptr);
+    auto        _count   = profile->output_buffer.size / sizeof(synthetic_sample);
+    for(size_t i = 0; i < _count; ++i)
+    {
+        auto _info            = hsa_ven_amd_aqlprofile_info_data_t{};
+        _info.sample_id       = _samples[i].sample_id;
+        _info.pmc_data.event  = _samples[i].event;
+        _info.pmc_data.result = _samples[i].result;
+        auto _status          = callback(HSA_VEN_AMD_AQLPROFILE_INFO_PMC_DATA, &_info, data);
+        if(_status != HSA_STATUS_SUCCESS) return _status;
+    }
+    return HSA_STATUS_SUCCESS;
+}
+
+// Emulates aql::set_dim_id_from_sample: aqlprofile reports the coordinates of a sample one at a
+// time with the aqlprofile id of their dimension
+rocprofiler_counter_instance_id_t
+synthetic_instance_id(uint64_t counter_id, const event_t& event, uint32_t sample_id)
+{
+    static const auto aql_dims = std::map<int, rocprofiler_profile_counter_instance_types>{
+        {0, ROCPROFILER_DIMENSION_XCC},
+        {1, ROCPROFILER_DIMENSION_SHADER_ENGINE},
+        {2, ROCPROFILER_DIMENSION_INSTANCE}};
+
+    ++num_instance_ids;
+
+    const auto _coords = {std::make_pair(0, sample_id / NUM_SE),
+                          std::make_pair(1, sample_id % NUM_SE),
+                          std::make_pair(2, event.block_index)};
+
+    rocprofiler_counter_instance_id_t _id = 0;
+    set_counter_in_rec(_id, {.handle = counter_id});
+    for(const auto& [aql_id, coord] : _coords)
+        set_dim_in_rec(_id, aql_dims.at(aql_id), coord);
+    return _id;
+}
+
+// counters of the profile: {counter id, {block name, number of block instances}}
+using profile_counters_t = std::vector<std::pair<uint64_t, std::pair<int, uint32_t>>>;
+
+SampleDecoder::counter_events_t
+make_counter_events(const profile_counters_t& counters)
+{
+    auto _ret = SampleDecoder::counter_events_t{};
+    for(const auto& [counter_id, block] : counters)
+    {
+        auto& _events = _ret.emplace_back(counter_id, std::vector<event_t>{}).second;
+        for(uint32_t i = 0; i < block.second; ++i)
+            _events.push_back(event_t{block.first, i, static_cast<uint32_t>(counter_id)});
+    }
+    return _ret;
+}
+
+// output of the profile: the samples of each event together, in the order of the events
+std::vector<synthetic_sample>
+make_output(const SampleDecoder::counter_events_t& counters, uint64_t seed)
+{
+    auto _ret = std::vector<synthetic_sample>{};
+    for(const auto& [counter_id, events] : counters)
+        for(const auto& event : events)
+            for(uint32_t s = 0; s < NUM_XCC * NUM_SE; ++s)
+                _ret.push_back({event, s, seed + _ret.size()});
+    return _ret;
+}
+
+hsa_ven_amd_aqlprofile_profile_t
+make_profile(std::vector<synthetic_sample>& output)
+{
+    auto _ret               = hsa_ven_amd_aqlprofile_profile_t{};
+    _ret.output_buffer.ptr  = output.data();
+    _ret.output_buffer.size = static_cast<uint32_t>(output.size() * sizeof(synthetic_sample));
+    return _ret;
+}
+
+// Decoding without a layout (i.e. read_pkt before SampleDecoder): a lookup of the counter of the
+// event, of the vector of the counter and the coordinates of the dimensions for every sample
+struct per_sample_decoder
+{
+    per_sample_decoder(const SampleDecoder::counter_events_t& counters)
+    {
+        for(const auto& [counter_id, events] : counters)
+            for(const auto& event : events)
+                event_to_counter.emplace(
+                    std::make_tuple(event.block_name, event.block_index, event.counter_id),
+                    counter_id);
+    }
+
+    void decode(const hsa_ven_amd_aqlprofile_profile_t& profile,
+                SampleDecoder::decoded_map_t&           out_map) const
+    {
+        struct it_data
+        {
+            const per_sample_decoder*     decoder;
+            SampleDecoder::decoded_map_t* out_map;
+        };
+
+        for(auto& itr : out_map)
+            itr.second.clear();
+
+        auto _data = it_data{this, &out_map};
+        iterate_synthetic(
+            &profile,
+            [](hsa_ven_amd_aqlprofile_info_type_t,
+               hsa_ven_amd_aqlprofile_info_data_t* info_data,
+               void*                               data) {
+                auto&       _data  = *static_cast<it_data*>(data);
+                const auto& _event = info_data->pmc_data.event;
+                auto        _itr   = _data.decoder->event_to_counter.find(
+                    std::make_tuple(_event.block_name, _event.block_index, _event.counter_id));
+                if(_itr == _data.decoder->event_to_counter.end()) return HSA_STATUS_SUCCESS;
+
+                auto& _vec = (*_data.out_map)[_itr->second];
+                auto& _rec = _vec.emplace_back();
+                _rec.id    = synthetic_instance_id(_itr->second, _event, info_data->sample_id);
+                _rec.counter_value = info_data->pmc_data.result;
+                return HSA_STATUS_SUCCESS;
+            },
+            &_data);
+    }
+
+    std::map<std::tuple<int, uint32_t, uint32_t>, uint64_t> event_to_counter = {};
+};
+
+void
+expect_same(const SampleDecoder::decoded_map_t& lhs, const SampleDecoder::decoded_map_t& rhs)
+{
+    ASSERT_EQ(lhs.size(), rhs.size());
+    for(const auto& [counter_id, records] : lhs)
+    {
+        ASSERT_EQ(rhs.count(counter_id), 1) << "counter " << counter_id;
+        const auto& _other = rhs.at(counter_id);
+        ASSERT_EQ(records.size(), _other.size()) << "counter " << counter_id;
+        for(size_t i = 0; i < records.size(); ++i)
+        {
+            EXPECT_EQ(records[i].id, _other[i].id) << "counter " << counter_id << " record " << i;
+            EXPECT_EQ(records[i].counter_value, _other[i].counter_value)
+                << "counter " << counter_id << " record " << i;
+        }
+    }
+}
+}  // namespace
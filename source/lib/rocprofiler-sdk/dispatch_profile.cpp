@@ -74,4 +74,36 @@ rocprofiler_configure_callback_dispatch_profile_counting_service(
                                                               record_callback,
                                                               record_callback_args);
 }
+
+/**
+ * @brief Restricts the dispatch profile counting services of a context to the dispatches
+ *        selected by the filter.
+ *
+ * @param [in] context_id context id
+ * @param [in] filter dispatches to profile
+ * @return ::rocprofiler_status_t
+ */
+rocprofiler_status_t ROCPROFILER_API
+rocprofiler_configure_dispatch_profile_counting_filter(
+    rocprofiler_context_id_t                       context_id,
+    rocprofiler_profile_counting_dispatch_filter_t filter)
+{
+    return rocprofiler::counters::configure_dispatch_filter(context_id, filter);
+}
+
+/**
+ * @brief Sets the dispatch sampling policy of a kernel (or the default policy of every kernel)
+ *        for the dispatch profile counting services of a context.
+ *
+ * @param [in] context_id context id
+ * @param [in] sampling sampling policy
+ * @return ::rocprofiler_status_t
+ */
+rocprofiler_status_t ROCPROFILER_API
+rocprofiler_configure_dispatch_profile_counting_sampling(
+    rocprofiler_context_id_t                context_id,
+    rocprofiler_profile_counting_sampling_t sampling)
+{
+    return rocprofiler::counters::configure_dispatch_sampling(context_id, sampling);
+}
 }
@@ -22,6 +22,7 @@
 
 #include "lib/rocprofiler-sdk/hsa/aql_packet.hpp"
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include "lib/common/logging.hpp"
 
@@ -36,8 +37,89 @@ namespace rocprofiler
 {
 namespace hsa
 {
+CounterBufferBlock::CounterBufferBlock(const AmdExtTable&    ext,
+                                       hsa_agent_t           agent,
+                                       hsa_amd_memory_pool_t command_pool,
+                                       hsa_amd_memory_pool_t output_pool,
+                                       size_t                command_size,
+                                       size_t                output_size,
+                                       size_t                slots)
+: m_ext{ext}
+, m_agent{agent}
+, m_slots{slots}
+, m_command{allocate(command_pool, command_size)}
+, m_output{allocate(output_pool, output_size)}
+{
+    memset(m_output.ptr, 0x0, m_output.stride * m_slots);
+}
+
+CounterBufferBlock::~CounterBufferBlock()
+{
+    for(auto* itr : {&m_command, &m_output})
+    {
+        if(!itr->ptr)
+        {
+            // pass, nothing allocated
+        }
+        else if(!itr->malloced)
+        {
+            CHECK_HSA(m_ext.hsa_amd_memory_pool_free_fn(itr->ptr), "freeing memory");
+        }
+        else
+        {
+            ::free(itr->ptr);
+        }
+    }
+}
+
+void*
+CounterBufferBlock::command_buffer(size_t slot) const
+{
+    return static_cast<char*>(m_command.ptr) + (slot * m_command.stride);
+}
+
+void*
+CounterBufferBlock::output_buffer(size_t slot) const
+{
+    return static_cast<char*>(m_output.ptr) + (slot * m_output.stride);
+}
+
+CounterBufferBlock::region
+CounterBufferBlock::allocate(hsa_amd_memory_pool_t pool, size_t size) const
+{
+    auto _region = region{nullptr, size, page_aligned(size), false};
+    auto _total  = _region.stride * m_slots;
+    auto _status = m_ext.hsa_amd_memory_pool_allocate_fn(pool, _total, 0, &_region.ptr);
+    if(_status != HSA_STATUS_SUCCESS || !_region.ptr)
+    {
+        _region.ptr      = ::malloc(_total);
+        _region.malloced = true;
+        if(!_region.ptr) ROCP_FATAL << "Error: could not allocate counter collection buffers";
+    }
+    else
+    {
+        // Memory is accessable by both the GPU and CPU, unlock the buffers of every slot for
+        // sharing.
+        CHECK_HSA(m_ext.hsa_amd_agents_allow_access_fn(1, &m_agent, nullptr, _region.ptr),
+                  "Error: Allowing access to Command Buffer");
+    }
+    return _region;
+}
+
+CounterAQLPacket::CounterAQLPacket(std::shared_ptr<CounterBufferBlock> block, size_t slot)
+: buffer_block{std::move(block)}
+{
+    profile.command_buffer.ptr  = buffer_block->command_buffer(slot);
+    profile.command_buffer.size = static_cast<uint32_t>(buffer_block->command_size());
+    profile.output_buffer.ptr   = buffer_block->output_buffer(slot);
+    profile.output_buffer.size  = static_cast<uint32_t>(buffer_block->output_size());
+}
+
 CounterAQLPacket::~CounterAQLPacket()
 {
+    // the buffers belong to the block
+    if(buffer_block) return;
+
     if(!profile.command_buffer.ptr)
     {
         // pass, nothing malloced
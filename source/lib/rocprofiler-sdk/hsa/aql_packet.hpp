@@ -25,9 +25,13 @@
 #include "lib/common/container/small_vector.hpp"
 #include "lib/rocprofiler-sdk/aql/aql_profile_v2.h"
 
+#include <hsa/hsa_api_trace.h>
 #include <hsa/hsa_ext_amd.h>
 #include <hsa/hsa_ven_amd_aqlprofile.h>
 
+#include <cstddef>
+#include <memory>
+
 namespace rocprofiler
 {
 namespace aql
@@ -83,6 +87,55 @@ public:
     bool isEmpty() const { return empty; }
 };
 
+/**
+ * Command and output buffers of a block of counter collection packets. The buffers of every slot
+ * are carved out of one page aligned allocation per buffer type, which is made accessible to the
+ * agent once, and freed with the block (i.e. with the last packet using one of its slots).
+ */
+class CounterBufferBlock
+{
+public:
+    CounterBufferBlock(const AmdExtTable&    ext,
+                       hsa_agent_t           agent,
+                       hsa_amd_memory_pool_t command_pool,
+                       hsa_amd_memory_pool_t output_pool,
+                       size_t                command_size,
+                       size_t                output_size,
+                       size_t                slots);
+    ~CounterBufferBlock();
+
+    CounterBufferBlock(const CounterBufferBlock&) = delete;
+    CounterBufferBlock(CounterBufferBlock&&)      = delete;
+    CounterBufferBlock& operator=(const CounterBufferBlock&) = delete;
+    CounterBufferBlock& operator=(CounterBufferBlock&&) = delete;
+
+    size_t slots() const { return m_slots; }
+    size_t command_size() const { return m_command.size; }
+    size_t output_size() const { return m_output.size; }
+    void*  command_buffer(size_t slot) const;
+    void*  output_buffer(size_t slot) const;
+
+    static constexpr size_t page_size = 0x1000;
+    static size_t page_aligned(size_t size) { return (size + page_size - 1) & ~(page_size - 1); }
+
+private:
+    struct region
+    {
+        void*  ptr      = nullptr;
+        size_t size     = 0;  // size of the buffer of a slot
+        size_t stride   = 0;  // page aligned distance between the buffers of two slots
+        bool   malloced = false;
+    };
+
+    region allocate(hsa_amd_memory_pool_t pool, size_t size) const;
+
+    const AmdExtTable& m_ext;
+    hsa_agent_t        m_agent   = {.handle = 0};
+    size_t             m_slots   = 0;
+    region             m_command = {};
+    region             m_output  = {};
+};
+
 class CounterAQLPacket : public AQLPacket
 {
     friend class rocprofiler::aql::CounterPacketConstruct;
@@ -91,6 +144,8 @@ class CounterAQLPacket : public AQLPacket
 public:
     CounterAQLPacket(memory_pool_free_func_t func)
     : free_func{func} {};
+    // Packet using the buffers of a slot of the block. The buffers are not freed by the packet
+    CounterAQLPacket(std::shared_ptr<CounterBufferBlock> block, size_t slot);
     ~CounterAQLPacket() override;
 
     void populate_before() override { before_krn_pkt.push_back(start); };
@@ -101,9 +156,10 @@ public:
     };
 
 protected:
-    bool                    command_buf_mallocd    = false;
-    bool                    output_buffer_malloced = false;
-    memory_pool_free_func_t free_func              = nullptr;
+    bool                                command_buf_mallocd    = false;
+    bool                                output_buffer_malloced = false;
+    memory_pool_free_func_t             free_func              = nullptr;
+    std::shared_ptr<CounterBufferBlock> buffer_block           = {};
 };
 
 struct TraceMemoryPool
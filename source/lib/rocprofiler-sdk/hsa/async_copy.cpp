@@ -27,6 +27,7 @@
 #include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/agent.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
+#include "lib/rocprofiler-sdk/hsa/async_copy_tracker.hpp"
 #include "lib/rocprofiler-sdk/hsa/hsa.hpp"
 #include "lib/rocprofiler-sdk/registration.hpp"
 #include "lib/rocprofiler-sdk/tracing/fwd.hpp"
@@ -152,14 +153,14 @@ context_filter(const context::context* ctx)
 constexpr auto null_rocp_agent_id =
     rocprofiler_agent_id_t{.handle = std::numeric_limits<uint64_t>::max()};
 
-struct async_copy_data
+// recycled by the async copy tracker, i.e. the fields are reassigned for every copy
+struct async_copy_data : async_copy_slot
 {
     using timestamp_t     = rocprofiler_timestamp_t;
     using callback_data_t = rocprofiler_callback_tracing_memory_copy_data_t;
     using buffered_data_t = rocprofiler_buffer_tracing_memory_copy_record_t;
 
     hsa_signal_t                        orig_signal    = {};
-    hsa_signal_t                        rocp_signal    = {};
     rocprofiler_thread_id_t             tid            = common::get_tid();
     rocprofiler_agent_id_t              dst_agent      = null_rocp_agent_id;
     rocprofiler_agent_id_t              src_agent      = null_rocp_agent_id;
@@ -207,115 +208,6 @@ async_copy_data::get_buffered_record(const context_t* _ctx,
                                           bytes_copied);
 }
 
-struct active_signals
-{
-    active_signals();
-    ~active_signals()                         = default;
-    active_signals(const active_signals&)     = delete;
-    active_signals(active_signals&&) noexcept = delete;
-    active_signals& operator=(const active_signals&) = delete;
-    active_signals& operator=(active_signals&&) noexcept = delete;
-
-    void create();          // create hsa signal
-    void destroy();         // destroy hsa signal
-    void sync();            // wait for outstanding signal completion callbacks
-    void fetch_add(int v);  // increment hsa signal value
-    void fetch_sub(int v);  // decrement hsa signal value
-
-private:
-    hsa_signal_t         m_signal = {.handle = 0};
-    std::atomic<int64_t> m_count  = 0;
-};
-
-active_signals::active_signals()
-{
-    // only create if not started finalization
-    if(registration::get_fini_status() == 0) create();
-}
-
-void
-active_signals::create()
-{
-    if(m_signal.handle != 0) return;
-
-    // function pointer may be null during unit testing
-    if(get_core_table()->hsa_signal_create_fn)
-    {
-        ROCP_HSA_TABLE_CALL(ERROR,
-                            get_core_table()->hsa_signal_create_fn(0, 0, nullptr, &m_signal));
-    }
-}
-
-void
-active_signals::destroy()
-{
-    if(m_signal.handle == 0) return;
-
-    // function pointer may be null during unit testing
-    if(get_core_table()->hsa_signal_destroy_fn)
-    {
-        ROCP_HSA_TABLE_CALL(ERROR, get_core_table()->hsa_signal_destroy_fn(m_signal));
-        m_signal.handle = 0;
-    }
-}
-
-void
-active_signals::sync()
-{
-    if(m_signal.handle == 0) return;
-
-    // wait a maximum of thirty seconds
-    constexpr auto timeout_sec = std::chrono::seconds{30};
-    constexpr auto timeout =
-        std::chrono::duration_cast<std::chrono::nanoseconds>(timeout_sec).count();
-
-    if(m_count.load() > 0)
-    {
-        auto _cnt_beg      = m_count.load();
-        auto _signal_value = get_core_table()->hsa_signal_wait_scacquire_fn(
-            m_signal, HSA_SIGNAL_CONDITION_LT, 1, timeout, HSA_WAIT_STATE_ACTIVE);
-        auto _cnt_end = m_count.load();
-        if(_signal_value != 0)
-        {
-            ROCP_CI_LOG_IF(WARNING, _cnt_end > 0)
-                << "rocprofiler-sdk timed out after " << timeout_sec.count()
-                << " seconds waiting for " << _cnt_beg
-                << " completion callbacks from HSA for async memory copy tracing. " << _cnt_end
-                << " completion callbacks were not delivered";
-        }
-    }
-}
-
-void
-active_signals::fetch_add(int v)
-{
-    create();
-    if(m_signal.handle == 0) return;
-
-    m_count.fetch_add(1);
-    get_core_table()->hsa_signal_add_screlease_fn(m_signal, v);
-}
-
-void
-active_signals::fetch_sub(int v)
-{
-    if(m_signal.handle == 0) return;
-
-    auto _cnt = m_count.load();
-    ROCP_CI_LOG_IF(WARNING, _cnt == 0) << "active_signals count (currently = 0) was requested to "
-                                          "decrement more times than it was incremented";
-
-    if(_cnt > 0) m_count.fetch_sub(1);
-    get_core_table()->hsa_signal_subtract_screlease_fn(m_signal, v);
-}
-
-active_signals*
-get_active_signals()
-{
-    static auto*& _v = common::static_object<active_signals>::construct();
-    return _v;
-}
-
 template <typename Tp, typename Up>
 constexpr Tp*
 convert_hsa_handle(Up _hsa_object)
@@ -350,16 +242,44 @@ operator*=(hsa_amd_profiling_async_copy_time_t& lhs, uint64_t rhs)
     return lhs;
 }
 
-bool
-async_copy_handler(hsa_signal_value_t signal_value, void* arg)
+// invoked by the HSA async handler of every completed copy, before the copy is queued for the
+// reaper thread
+void
+async_copy_complete(async_copy_slot* slot)
 {
-    // if we have fully finalized, delete the data and return
-    if(registration::get_fini_status() > 0)
+    // if we have fully finalized, return
+    if(registration::get_fini_status() > 0) return;
+
+    auto* _data           = static_cast<async_copy_data*>(slot);
+    auto  signal_value    = _data->signal_value;
+    auto* orig_amd_signal = convert_hsa_handle<amd_signal_t>(_data->orig_signal);
+
+    // Original intercepted signal completion
+    if(orig_amd_signal)
     {
-        auto* _data = static_cast<async_copy_data*>(arg);
-        delete _data;
-        return false;
+        // NOLINTNEXTLINE(performance-no-int-to-ptr)
+        auto* rocp_amd_signal = convert_hsa_handle<amd_signal_t>(_data->rocp_signal);
+
+        std::tie(orig_amd_signal->start_ts, orig_amd_signal->end_ts) =
+            std::tie(rocp_amd_signal->start_ts, rocp_amd_signal->end_ts);
+
+        const hsa_signal_value_t new_value =
+            get_core_table()->hsa_signal_load_relaxed_fn(_data->orig_signal) - 1;
+
+        ROCP_ERROR_IF(signal_value != new_value) << "bad original signal value in " << __FUNCTION__;
+        // Move to ROCP_TRACE when rebasing
+        ROCP_INFO << "Decrementing Signal: " << std::hex << _data->orig_signal.handle << std::dec;
+        get_core_table()->hsa_signal_store_screlease_fn(_data->orig_signal, signal_value);
     }
+}
+
+// invoked by the reaper thread of the async copy tracker for every completed copy. The slot is
+// recycled afterwards
+void
+async_copy_reap(async_copy_slot* slot)
+{
+    // if we have fully finalized, return
+    if(registration::get_fini_status() > 0) return;
 
     static auto sysclock_period = []() -> uint64_t {
         constexpr auto nanosec     = 1000000000UL;
@@ -370,8 +290,8 @@ async_copy_handler(hsa_signal_value_t signal_value, void* arg)
         return (nanosec / sysclock_hz);
     }();
 
-    auto  ts               = common::timestamp_ns();
-    auto* _data            = static_cast<async_copy_data*>(arg);
+    auto* _data            = static_cast<async_copy_data*>(slot);
+    auto  ts               = _data->completion_ts;
     auto  copy_time        = hsa_amd_profiling_async_copy_time_t{};
     auto  copy_time_status = get_amd_ext_table()->hsa_amd_profiling_get_async_copy_time_fn(
         _data->rocp_signal, &copy_time);
@@ -425,35 +345,28 @@ async_copy_handler(hsa_signal_value_t signal_value, void* arg)
         }
     }
 
-    // decrement the active signals
-    if(get_active_signals()) get_active_signals()->fetch_sub(1);
-
-    auto* orig_amd_signal = convert_hsa_handle<amd_signal_t>(_data->orig_signal);
-
-    // Original intercepted signal completion
-    if(orig_amd_signal)
-    {
-        // NOLINTNEXTLINE(performance-no-int-to-ptr)
-        auto* rocp_amd_signal = convert_hsa_handle<amd_signal_t>(_data->rocp_signal);
-
-        std::tie(orig_amd_signal->start_ts, orig_amd_signal->end_ts) =
-            std::tie(rocp_amd_signal->start_ts, rocp_amd_signal->end_ts);
-
-        const hsa_signal_value_t new_value =
-            get_core_table()->hsa_signal_load_relaxed_fn(_data->orig_signal) - 1;
-
-        ROCP_ERROR_IF(signal_value != new_value) << "bad original signal value in " << __FUNCTION__;
-        // Move to ROCP_TRACE when rebasing
-        ROCP_INFO << "Decrementing Signal: " << std::hex << _data->orig_signal.handle << std::dec;
-        get_core_table()->hsa_signal_store_screlease_fn(_data->orig_signal, signal_value);
-    }
+    if(_corr_id) _corr_id->sub_ref_count();
+    _data->correlation_id = nullptr;
+}
 
-    ROCP_HSA_TABLE_CALL(ERROR, get_core_table()->hsa_signal_destroy_fn(_data->rocp_signal));
-    delete _data;
+async_copy_slot*
+create_async_copy_data()
+{
+    return new async_copy_data{};
+}
 
-    if(_corr_id) _corr_id->sub_ref_count();
+void
+destroy_async_copy_data(async_copy_slot* slot)
+{
+    delete static_cast<async_copy_data*>(slot);
+}
 
-    return false;
+async_copy_tracker*
+get_tracker()
+{
+    static auto*& _v = common::static_object<async_copy_tracker>::construct(
+        create_async_copy_data, async_copy_complete, async_copy_reap, destroy_async_copy_data);
+    return _v;
 }
 
 enum async_copy_id
@@ -592,75 +505,53 @@ async_copy_impl(Args... args)
     async_copy_data* _data = nullptr;
 
     {
-        auto tracing_data = tracing::tracing_data{};
+        // reused by the copies of this thread: the tracing data of a recycled slot is swapped in
+        static thread_local auto tracing_data = tracing::tracing_data{};
 
         tracing::populate_contexts(ROCPROFILER_CALLBACK_TRACING_MEMORY_COPY,
                                    ROCPROFILER_BUFFER_TRACING_MEMORY_COPY,
                                    _direction,
-                                   tracing_data);
+                                   tracing_data,
+                                   std::true_type{});
+
+        // recycled slot with a profiling signal which has a value of one
+        auto* _slot = (tracing_data.empty() || !get_tracker()) ? nullptr : get_tracker()->acquire();
+
         // if no contexts are tracing memory copies for this direction, execute as usual
-        if(tracing_data.empty())
+        if(!_slot)
         {
             return invoke(get_next_dispatch<TableIdx, OpIdx>(),
                           std::move(_tied_args),
                           std::make_index_sequence<N>{});
         }
 
-        _data               = new async_copy_data{};
-        _data->tracing_data = std::move(tracing_data);
+        _data = static_cast<async_copy_data*>(_slot);
+        std::swap(_data->tracing_data, tracing_data);
     }
 
     auto& tracing_data = _data->tracing_data;
 
     // at this point, we want to install our own signal handler
-    _data->tid          = common::get_tid();
-    _data->dst_agent    = _dst_agent_id;
-    _data->src_agent    = _src_agent_id;
-    _data->direction    = _direction;
-    _data->bytes_copied = compute_copy_bytes(std::get<copy_size_idx>(_tied_args));
-
-    constexpr auto           completion_signal_idx  = arg_indices<OpIdx>::completion_signal_idx;
-    auto&                    _completion_signal     = std::get<completion_signal_idx>(_tied_args);
-    const hsa_signal_value_t _completion_signal_val = 1;
+    _data->orig_signal    = {};
+    _data->tid            = common::get_tid();
+    _data->dst_agent      = _dst_agent_id;
+    _data->src_agent      = _src_agent_id;
+    _data->direction      = _direction;
+    _data->bytes_copied   = compute_copy_bytes(std::get<copy_size_idx>(_tied_args));
+    _data->start_ts       = 0;
+    _data->correlation_id = nullptr;
+
+    constexpr auto completion_signal_idx = arg_indices<OpIdx>::completion_signal_idx;
+    auto&          _completion_signal    = std::get<completion_signal_idx>(_tied_args);
 
     auto original_value = get_core_table()->hsa_signal_load_scacquire_fn(_completion_signal);
 
+    // the slot is returned to the tracker if the completion handler cannot be registered
+    if(!get_tracker()->track(_data))
     {
-        const uint32_t     num_consumers = 0;
-        const hsa_agent_t* consumers     = nullptr;
-        auto               _status       = get_core_table()->hsa_signal_create_fn(
-            _completion_signal_val, num_consumers, consumers, &_data->rocp_signal);
-
-        if(_status != HSA_STATUS_SUCCESS)
-        {
-            ROCP_ERROR << "hsa_signal_create returned non-zero error code " << _status;
-
-            delete _data;
-            return invoke(get_next_dispatch<TableIdx, OpIdx>(),
-                          std::move(_tied_args),
-                          std::make_index_sequence<N>{});
-        }
-    }
-
-    {
-        auto _status = get_amd_ext_table()->hsa_amd_signal_async_handler_fn(_data->rocp_signal,
-                                                                            HSA_SIGNAL_CONDITION_LT,
-                                                                            _completion_signal_val,
-                                                                            async_copy_handler,
-                                                                            _data);
-
-        if(_status != HSA_STATUS_SUCCESS)
-        {
-            ROCP_ERROR << "hsa_amd_signal_async_handler returned non-zero error code " << _status;
-
-            ROCP_HSA_TABLE_CALL(ERROR, get_core_table()->hsa_signal_destroy_fn(_data->rocp_signal))
-                << ":: failed to destroy signal after async handler failed";
-
-            delete _data;
-            return invoke(get_next_dispatch<TableIdx, OpIdx>(),
-                          std::move(_tied_args),
-                          std::make_index_sequence<N>{});
-        }
+        return invoke(get_next_dispatch<TableIdx, OpIdx>(),
+                      std::move(_tied_args),
+                      std::make_index_sequence<N>{});
     }
 
     _data->correlation_id                 = context::get_latest_correlation_id();
@@ -714,8 +605,6 @@ async_copy_impl(Args... args)
               << ": " << original_value << " | Replacement Signal: " << std::hex
               << _completion_signal.handle << std::dec << ": 1";
 
-    CHECK_NOTNULL(get_active_signals())->fetch_add(1);
-
     return invoke(
         get_next_dispatch<TableIdx, OpIdx>(), std::move(_tied_args), std::make_index_sequence<N>{});
 }
@@ -855,10 +744,20 @@ async_copy_init(hsa_api_table_t* _orig, uint64_t _tbl_instance)
 void
 async_copy_fini()
 {
-    if(!async_copy::get_active_signals()) return;
+    auto* _tracker = async_copy::get_tracker();
+    if(!_tracker) return;
+
+    // wait a maximum of thirty seconds
+    constexpr auto timeout_sec = std::chrono::seconds{30};
+
+    auto _cnt_beg = _tracker->active();
+    auto _cnt_end = _tracker->sync(timeout_sec);
+    ROCP_CI_LOG_IF(WARNING, _cnt_end > 0)
+        << "rocprofiler-sdk timed out after " << timeout_sec.count() << " seconds waiting for "
+        << _cnt_beg << " completion callbacks from HSA for async memory copy tracing. " << _cnt_end
+        << " completion callbacks were not delivered";
 
-    async_copy::get_active_signals()->sync();
-    async_copy::get_active_signals()->destroy();
+    _tracker->stop();
 }
 }  // namespace hsa
 }  // namespace rocprofiler
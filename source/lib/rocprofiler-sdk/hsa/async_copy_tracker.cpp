@@ -0,0 +1,270 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/hsa/async_copy_tracker.hpp"
+#include "lib/common/logging.hpp"
+#include "lib/common/utility.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
+
+namespace rocprofiler
+{
+namespace hsa
+{
+async_copy_tracker::async_copy_tracker(create_func_t   create_func,
+                                       complete_func_t complete_func,
+                                       reap_func_t     reap_func,
+                                       destroy_func_t  destroy_func,
+                                       size_t          max_free_slots)
+: m_create_func{create_func}
+, m_complete_func{complete_func}
+, m_reap_func{reap_func}
+, m_destroy_func{destroy_func}
+, m_max_free_slots{max_free_slots}
+{}
+
+async_copy_tracker::~async_copy_tracker() { stop(); }
+
+async_copy_slot*
+async_copy_tracker::acquire()
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        if(!m_free.empty())
+        {
+            auto* _slot = m_free.back();
+            m_free.pop_back();
+            _lk.unlock();
+
+            // the profiling signal was decremented by the previous copy
+            get_core_table()->hsa_signal_store_relaxed_fn(_slot->rocp_signal, 1);
+            return _slot;
+        }
+    }
+
+    auto* _slot   = m_create_func();
+    auto  _status = get_core_table()->hsa_signal_create_fn(1, 0, nullptr, &_slot->rocp_signal);
+    if(_status != HSA_STATUS_SUCCESS)
+    {
+        ROCP_ERROR << "hsa_signal_create returned non-zero error code " << _status;
+        m_destroy_func(_slot);
+        return nullptr;
+    }
+
+    return _slot;
+}
+
+void
+async_copy_tracker::release(async_copy_slot* slot)
+{
+    auto _slots = std::vector<async_copy_slot*>{slot};
+    recycle(_slots);
+}
+
+bool
+async_copy_tracker::track(async_copy_slot* slot)
+{
+    bool _start = false;
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        ++m_active;
+        if(!m_started && !m_stop)
+        {
+            m_started = true;
+            m_running = true;
+            _start    = true;
+        }
+    }
+
+    // completions queued before the thread starts are reaped once it does
+    if(_start) start();
+
+    slot->tracker = this;
+    auto _status  = get_amd_ext_table()->hsa_amd_signal_async_handler_fn(
+        slot->rocp_signal, HSA_SIGNAL_CONDITION_LT, 1, completion_handler, slot);
+
+    if(_status != HSA_STATUS_SUCCESS)
+    {
+        ROCP_ERROR << "hsa_amd_signal_async_handler returned non-zero error code " << _status;
+
+        // decrements the number of active copies since the tracker of the slot is set
+        release(slot);
+        return false;
+    }
+
+    return true;
+}
+
+size_t
+async_copy_tracker::sync(std::chrono::nanoseconds timeout)
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    m_reaped_cv.wait_for(_lk, timeout, [this]() { return m_active == 0; });
+    return m_active;
+}
+
+void
+async_copy_tracker::stop()
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        m_stop   = true;
+    }
+    m_pending_cv.notify_all();
+
+    // the reaper processes the queued completions before it exits
+    if(m_thread.joinable()) m_thread.join();
+
+    auto _free = std::vector<async_copy_slot*>{};
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        std::swap(_free, m_free);
+    }
+
+    for(auto* itr : _free)
+    {
+        get_core_table()->hsa_signal_destroy_fn(itr->rocp_signal);
+        m_destroy_func(itr);
+    }
+}
+
+size_t
+async_copy_tracker::active() const
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    return m_active;
+}
+
+size_t
+async_copy_tracker::free_slots() const
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    return m_free.size();
+}
+
+bool
+async_copy_tracker::completion_handler(hsa_signal_value_t signal_value, void* arg)
+{
+    auto* _slot          = static_cast<async_copy_slot*>(arg);
+    auto& _tracker       = *_slot->tracker;
+    _slot->signal_value  = signal_value;
+    _slot->completion_ts = common::timestamp_ns();
+
+    // the application does not wait for the reaper
+    _tracker.m_complete_func(_slot);
+
+    auto _lk = std::unique_lock<std::mutex>{_tracker.m_mutex};
+    if(!_tracker.m_running)
+    {
+        // the reaper has exited
+        _lk.unlock();
+        auto _slots = std::vector<async_copy_slot*>{_slot};
+        _tracker.m_reap_func(_slot);
+        _tracker.recycle(_slots);
+        return false;
+    }
+
+    _tracker.m_pending.emplace_back(_slot);
+    // the reaper checks for pending completions before it waits again
+    if(_tracker.m_waiting)
+    {
+        _lk.unlock();
+        _tracker.m_pending_cv.notify_one();
+    }
+
+    return false;
+}
+
+void
+async_copy_tracker::start()
+{
+    internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+    m_thread = std::thread{&async_copy_tracker::run, this};
+    internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+}
+
+void
+async_copy_tracker::run()
+{
+    auto _batch = std::vector<async_copy_slot*>{};
+    while(true)
+    {
+        {
+            auto _lk  = std::unique_lock<std::mutex>{m_mutex};
+            m_waiting = true;
+            m_pending_cv.wait(_lk, [this]() { return m_stop || !m_pending.empty(); });
+            m_waiting = false;
+
+            if(m_pending.empty())
+            {
+                m_running = false;
+                return;
+            }
+            std::swap(_batch, m_pending);
+        }
+
+        for(auto* itr : _batch)
+            m_reap_func(itr);
+
+        recycle(_batch);
+        _batch.clear();
+    }
+}
+
+void
+async_copy_tracker::recycle(std::vector<async_copy_slot*>& slots)
+{
+    auto   _destroy = std::vector<async_copy_slot*>{};
+    size_t _reaped  = 0;
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        for(auto* itr : slots)
+        {
+            if(itr->tracker)
+            {
+                ++_reaped;
+                itr->tracker = nullptr;
+            }
+
+            if(!m_stop && m_free.size() < m_max_free_slots)
+                m_free.emplace_back(itr);
+            else
+                _destroy.emplace_back(itr);
+        }
+    }
+
+    for(auto* itr : _destroy)
+    {
+        get_core_table()->hsa_signal_destroy_fn(itr->rocp_signal);
+        m_destroy_func(itr);
+    }
+
+    // the copies are only reaped once their slots are recycled, i.e. sync() does not return while
+    // the slots are being destroyed
+    if(_reaped > 0)
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        m_active -= _reaped;
+        m_reaped_cv.notify_all();
+    }
+}
+}  // namespace hsa
+}  // namespace rocprofiler
@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/hsa/hsa.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace hsa
+{
+class async_copy_tracker;
+
+/**
+ * Base of the data tracking a traced async copy. The profiling signal replacing the completion
+ * signal of the copy is created once and reused by every copy tracked with the slot
+ */
+struct async_copy_slot
+{
+    hsa_signal_t        rocp_signal   = {.handle = 0};
+    hsa_signal_value_t  signal_value  = 0;  // value of the profiling signal on completion
+    uint64_t            completion_ts = 0;  // timestamp of the completion handler
+    async_copy_tracker* tracker       = nullptr;
+};
+
+/**
+ * Recycles the slots tracking traced async copies and reaps their completions in batches.
+ *
+ * The HSA async signal handler of a copy records the completion, completes the copy for the
+ * application via the complete function (e.g. forwards the original completion signal) and queues
+ * the slot. A dedicated reaper thread, created by the first tracked copy, processes all the queued
+ * completions each time it wakes up, i.e. under load many copies are reaped per wakeup, and then
+ * returns the slots (with their profiling signal) to a free list for the next copies. Slots are
+ * only destroyed when the free list holds more than max_free_slots.
+ */
+class async_copy_tracker
+{
+public:
+    using create_func_t   = async_copy_slot* (*) ();
+    using complete_func_t = void (*)(async_copy_slot*);
+    using reap_func_t     = void (*)(async_copy_slot*);
+    using destroy_func_t  = void (*)(async_copy_slot*);
+
+    async_copy_tracker(create_func_t   create_func,
+                       complete_func_t complete_func,
+                       reap_func_t     reap_func,
+                       destroy_func_t  destroy_func,
+                       size_t          max_free_slots = 4096);
+    ~async_copy_tracker();
+
+    async_copy_tracker(const async_copy_tracker&)     = delete;
+    async_copy_tracker(async_copy_tracker&&) noexcept = delete;
+    async_copy_tracker& operator=(const async_copy_tracker&) = delete;
+    async_copy_tracker& operator=(async_copy_tracker&&) noexcept = delete;
+
+    /// Returns a slot whose profiling signal has a value of one or a nullptr if the profiling
+    /// signal could not be created
+    async_copy_slot* acquire();
+
+    /// Returns a slot which has not been tracked, e.g. because the copy was not submitted
+    void release(async_copy_slot* slot);
+
+    /// Registers the completion handler of the profiling signal. The slot is released if the
+    /// registration fails
+    bool track(async_copy_slot* slot);
+
+    /// Blocks until every tracked copy has been reaped or the timeout expires. Returns the number
+    /// of copies which have not been reaped
+    size_t sync(std::chrono::nanoseconds timeout);
+
+    /// Reaps the remaining completions, joins the reaper thread and destroys the free slots
+    void stop();
+
+    /// Number of tracked copies which have not been reaped
+    size_t active() const;
+
+    /// Number of slots in the free list
+    size_t free_slots() const;
+
+private:
+    static bool completion_handler(hsa_signal_value_t signal_value, void* arg);
+
+    void start();
+    void run();
+    void recycle(std::vector<async_copy_slot*>& slots);
+
+    create_func_t                 m_create_func    = nullptr;
+    complete_func_t               m_complete_func  = nullptr;
+    reap_func_t                   m_reap_func      = nullptr;
+    destroy_func_t                m_destroy_func   = nullptr;
+    size_t                        m_max_free_slots = 0;
+    mutable std::mutex            m_mutex          = {};
+    std::condition_variable       m_pending_cv     = {};
+    std::condition_variable       m_reaped_cv      = {};
+    std::vector<async_copy_slot*> m_free           = {};
+    std::vector<async_copy_slot*> m_pending        = {};
+    size_t                        m_active         = 0;
+    bool                          m_waiting        = false;
+    bool                          m_started        = false;
+    bool                          m_running        = false;
+    bool                          m_stop           = false;
+    std::thread                   m_thread         = {};
+};
+}  // namespace hsa
+}  // namespace rocprofiler
@@ -46,12 +46,15 @@ hsa_barrier::~hsa_barrier()
 }
 
 void
-hsa_barrier::set_barrier(const queue_map_t& q)
+hsa_barrier::set_barrier(const queue_map_t& q, std::optional<rocprofiler_agent_id_t> agent_id)
 {
     _core_api.hsa_signal_store_screlease_fn(_barrier_signal, 1);
     _queue_waiting.wlock([&](auto& queue_waiting) {
         for(const auto& [_, queue] : q)
         {
+            if(agent_id && queue->get_agent().get_rocp_agent()->id.handle != agent_id->handle)
+                continue;
+
             queue->lock_queue([ptr = queue.get(), &queue_waiting]() {
                 if(ptr->active_async_packets() > 0)
                 {
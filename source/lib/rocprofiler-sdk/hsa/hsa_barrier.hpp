@@ -48,7 +48,9 @@ public:
     hsa_barrier(std::function<void()>&& finished, CoreApiTable core_api);
     ~hsa_barrier();
 
-    void set_barrier(const queue_map_t& q);
+    // Waits for the active kernels of the queues, only the queues of the agent if provided
+    void set_barrier(const queue_map_t&                    q,
+                     std::optional<rocprofiler_agent_id_t> agent_id = std::nullopt);
 
     std::optional<rocprofiler_packet> enqueue_packet(const Queue* queue);
     bool                              register_completion(const Queue* queue);
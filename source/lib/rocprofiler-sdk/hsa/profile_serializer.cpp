@@ -36,7 +36,7 @@ profiler_serializer_ready_signal_handler(hsa_signal_value_t /* signal_value */,
     auto*       hsa_queue = static_cast<hsa_queue_t*>(data);
     const auto* queue     = CHECK_NOTNULL(get_queue_controller())->get_queue(*hsa_queue);
     CHECK(queue);
-    CHECK_NOTNULL(get_queue_controller())->serializer().wlock([&](auto& serializer) {
+    CHECK_NOTNULL(get_queue_controller())->serializer(*queue).wlock([&](auto& serializer) {
         serializer.queue_ready(hsa_queue, *queue);
     });
     return true;
@@ -60,6 +60,16 @@ clear_complete_barriers(std::deque<profiler_serializer::barrier_with_state>& bar
 
 }  // namespace
 
+void
+profiler_serializer::init(rocprofiler_agent_id_t agent_id,
+                          const CoreApiTable&    core_api,
+                          Status                 status)
+{
+    _agent_id          = agent_id;
+    _core_api          = core_api;
+    _serializer_status = status;
+}
+
 void
 profiler_serializer::add_queue(hsa_queue_t** hsa_queues, const Queue& queue)
 {
@@ -103,19 +113,13 @@ profiler_serializer::kernel_completion_signal(const Queue& completed)
 
     CHECK(_dispatch_queue);
     _dispatch_queue = nullptr;
-    CHECK_NOTNULL(get_queue_controller())
-        ->get_core_table()
-        .hsa_signal_store_screlease_fn(completed.block_signal, 1);
-    CHECK_NOTNULL(get_queue_controller())
-        ->get_core_table()
-        .hsa_signal_store_screlease_fn(completed.ready_signal, 0);
+    _core_api.hsa_signal_store_screlease_fn(completed.block_signal, 1);
+    _core_api.hsa_signal_store_screlease_fn(completed.ready_signal, 0);
     if(!_dispatch_ready.empty())
     {
         const auto* queue = _dispatch_ready.front();
-        _dispatch_ready.erase(_dispatch_ready.begin());
-        CHECK_NOTNULL(get_queue_controller())
-            ->get_core_table()
-            .hsa_signal_store_screlease_fn(queue->block_signal, 0);
+        _dispatch_ready.pop_front();
+        _core_api.hsa_signal_store_screlease_fn(queue->block_signal, 0);
         _dispatch_queue = queue;
     }
 }
@@ -133,9 +137,7 @@ profiler_serializer::queue_ready(hsa_queue_t* hsa_queue, const Queue& queue)
             CHECK_NOTNULL(get_queue_controller())
                 ->set_queue_state(queue_state::done_destroy, hsa_queue);
             ROCP_TRACE << "Destroying ready signal...";
-            CHECK_NOTNULL(get_queue_controller())
-                ->get_core_table()
-                .hsa_signal_destroy_fn(queue.ready_signal);
+            _core_api.hsa_signal_destroy_fn(queue.ready_signal);
             ROCP_TRACE << "Notifying queue condition variable...";
             queue.cv_ready_signal.notify_one();
             return;
@@ -143,15 +145,11 @@ profiler_serializer::queue_ready(hsa_queue_t* hsa_queue, const Queue& queue)
     }
 
     ROCP_TRACE << "setting queue ready signal to 1...";
-    CHECK_NOTNULL(get_queue_controller())
-        ->get_core_table()
-        .hsa_signal_store_screlease_fn(queue.ready_signal, 1);
+    _core_api.hsa_signal_store_screlease_fn(queue.ready_signal, 1);
 
     if(_dispatch_queue == nullptr)
     {
-        CHECK_NOTNULL(get_queue_controller())
-            ->get_core_table()
-            .hsa_signal_store_screlease_fn(queue.block_signal, 0);
+        _core_api.hsa_signal_store_screlease_fn(queue.block_signal, 0);
         _dispatch_queue = &queue;
     }
     else
@@ -233,9 +231,7 @@ profiler_serializer::destroy_queue(hsa_queue_t* id, const Queue& queue)
             }),
         _dispatch_ready.end());
     CHECK_NOTNULL(get_queue_controller())->set_queue_state(queue_state::to_destroy, id);
-    CHECK_NOTNULL(get_queue_controller())
-        ->get_core_table()
-        .hsa_signal_store_screlease_fn(queue.ready_signal, 0);
+    _core_api.hsa_signal_store_screlease_fn(queue.ready_signal, 0);
 
     ROCP_INFO << "queue destroyed";
 }
@@ -253,11 +249,9 @@ profiler_serializer::enable(const queue_map_t& queues)
 
     clear_complete_barriers(_barrier);
 
-    _barrier.emplace_back(Status::DISABLED,
-                          std::make_unique<hsa_barrier>(
-                              [] {}, CHECK_NOTNULL(get_queue_controller())->get_core_table()));
+    _barrier.emplace_back(Status::DISABLED, std::make_unique<hsa_barrier>([] {}, _core_api));
     _serializer_status = Status::ENABLED;
-    _barrier.back().barrier->set_barrier(queues);
+    _barrier.back().barrier->set_barrier(queues, _agent_id);
 
     ROCP_INFO << "Profiler serialization enabled";
 }
@@ -275,14 +269,56 @@ profiler_serializer::disable(const queue_map_t& queues)
 
     clear_complete_barriers(_barrier);
 
-    _barrier.emplace_back(Status::ENABLED,
-                          std::make_unique<hsa_barrier>(
-                              [] {}, CHECK_NOTNULL(get_queue_controller())->get_core_table()));
+    _barrier.emplace_back(Status::ENABLED, std::make_unique<hsa_barrier>([] {}, _core_api));
     _serializer_status = Status::DISABLED;
-    _barrier.back().barrier->set_barrier(queues);
+    _barrier.back().barrier->set_barrier(queues, _agent_id);
 
     ROCP_INFO << "Profiler serialization disabled";
 }
 
+void
+agent_serializers::add_agent(const AgentCache& agent, const CoreApiTable& core_api)
+{
+    auto _lk    = std::lock_guard<std::mutex>{_mutex};
+    auto _id    = agent.get_rocp_agent()->id;
+    auto _entry = std::make_unique<serializer_t>();
+    _entry->wlock([&](auto& serializer) { serializer.init(_id, core_api, _status); });
+    _serializers.emplace(_id.handle, std::move(_entry));
+}
+
+agent_serializers::serializer_t&
+agent_serializers::get(const Queue& queue)
+{
+    auto itr = _serializers.find(queue.get_agent().get_rocp_agent()->id.handle);
+    CHECK(itr != _serializers.end()) << "no serializer for agent " << queue.get_agent().name();
+    return *itr->second;
+}
+
+const agent_serializers::serializer_t&
+agent_serializers::get(const Queue& queue) const
+{
+    auto itr = _serializers.find(queue.get_agent().get_rocp_agent()->id.handle);
+    CHECK(itr != _serializers.end()) << "no serializer for agent " << queue.get_agent().name();
+    return *itr->second;
+}
+
+void
+agent_serializers::enable(const queue_map_t& queues)
+{
+    auto _lk = std::lock_guard<std::mutex>{_mutex};
+    _status  = profiler_serializer::Status::ENABLED;
+    for(auto& [_, itr] : _serializers)
+        itr->wlock([&](auto& serializer) { serializer.enable(queues); });
+}
+
+void
+agent_serializers::disable(const queue_map_t& queues)
+{
+    auto _lk = std::lock_guard<std::mutex>{_mutex};
+    _status  = profiler_serializer::Status::DISABLED;
+    for(auto& [_, itr] : _serializers)
+        itr->wlock([&](auto& serializer) { serializer.disable(queues); });
+}
+
 }  // namespace hsa
 }  // namespace rocprofiler
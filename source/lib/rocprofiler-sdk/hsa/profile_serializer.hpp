@@ -25,28 +25,34 @@
 #include <rocprofiler-sdk/rocprofiler.h>
 
 #include "lib/common/container/small_vector.hpp"
+#include "lib/common/synchronized.hpp"
+#include "lib/rocprofiler-sdk/hsa/agent_cache.hpp"
 #include "lib/rocprofiler-sdk/hsa/hsa_barrier.hpp"
 #include "lib/rocprofiler-sdk/hsa/queue.hpp"
 
+#include <atomic>
 #include <deque>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace rocprofiler
 {
 namespace hsa
 {
-/*This is a profiler serializer. It should be instantiated
-only once for the profiler. The following is the
-description of each field.
+/*This is a profiler serializer. It is instantiated once
+per agent (see agent_serializers) and only serializes the
+kernels dispatched to the queues of that agent. The following
+is the description of each field.
 1. _dispatch_queue - The queue to which the currently dispatched kernel
         belongs to.
         At any given time, in serialization only one kernel
-        can be executing.
+        can be executing on the agent.
 2. _dispatch_ready- It is a software data structure which holds
-        the queues which have a kernel ready to be dispatched.
-        This stores the queues in FIFO order.
-3. serializer_mutex - The mutex is used for thread synchronization
-        while accessing the singleton instance of this structure.
+        the queues of the agent which have a kernel ready to be
+        dispatched. This stores the queues in FIFO order.
+3. _barrier - The barriers transitioning the queues of the agent
+        between serialized and unserialized execution.
 Currently, in case of profiling kernels are serialized by default.
 */
 class profiler_serializer
@@ -69,15 +75,19 @@ public:
     };
 
     using queue_map_t = std::unordered_map<hsa_queue_t*, std::unique_ptr<Queue>>;
+
+    // Sets the agent whose queues are serialized and the initial state of the serializer
+    void init(rocprofiler_agent_id_t agent_id, const CoreApiTable& core_api, Status status);
+
     void kernel_completion_signal(const Queue&);
     // Signal a kernel dispatch is taking place, generates packets needed to be
     // inserted to support kernel dispatch
     common::container::small_vector<hsa::rocprofiler_packet, 3> kernel_dispatch(const Queue&) const;
 
     void queue_ready(hsa_queue_t* hsa_queue, const Queue& queue);
-    // Enable the serializer
+    // Enable the serializer, only the queues of the agent are considered
     void enable(const queue_map_t& queues);
-    // Disable the serializer
+    // Disable the serializer, only the queues of the agent are considered
     void disable(const queue_map_t& queues);
 
     void destroy_queue(hsa_queue_t* id, const Queue& queue);
@@ -85,11 +95,44 @@ public:
     static void add_queue(hsa_queue_t** hsa_queues, const Queue& queue);
 
 private:
+    rocprofiler_agent_id_t         _agent_id{.handle = 0};
+    CoreApiTable                   _core_api{};
     const Queue*                   _dispatch_queue{nullptr};
     std::deque<const Queue*>       _dispatch_ready;
     std::atomic<Status>            _serializer_status{Status::DISABLED};
     std::deque<barrier_with_state> _barrier;
 };
 
+/*Holds the profiler serializer of every agent. Kernels dispatched
+to different agents are never serialized against each other, i.e.
+completions on one agent only lock the serializer of that agent.
+The agents are added when the queue controller is initialized,
+before any queue is created, and are never removed. Thus, looking
+up the serializer of a queue does not require a lock. The state of
+the last enable/disable is kept for the agents added afterwards.
+*/
+class agent_serializers
+{
+public:
+    using serializer_t = common::Synchronized<profiler_serializer>;
+    using queue_map_t  = profiler_serializer::queue_map_t;
+
+    void add_agent(const AgentCache& agent, const CoreApiTable& core_api);
+
+    // Serializer of the agent of the queue
+    serializer_t&       get(const Queue& queue);
+    const serializer_t& get(const Queue& queue) const;
+
+    void enable(const queue_map_t& queues);
+    void disable(const queue_map_t& queues);
+
+private:
+    using serializer_map_t = std::unordered_map<uint64_t, std::unique_ptr<serializer_t>>;
+
+    std::mutex                               _mutex{};
+    serializer_map_t                         _serializers{};
+    std::atomic<profiler_serializer::Status> _status{profiler_serializer::Status::DISABLED};
+};
+
 }  // namespace hsa
 }  // namespace rocprofiler
@@ -176,6 +176,8 @@ bit_extract(Integral x, int first, int last)
     return (x >> first) & bit_mask<Integral>(0, last - first);
 }
 
+}  // namespace
+
 /**
  * @brief This function is a queue write interceptor. It intercepts the
  * packet write function. Creates an instance of packet class with the raw
@@ -371,11 +373,13 @@ WriteInterceptor(const void* packets,
             CreateBarrierPacket(nullptr, nullptr, transformed_packets);
         }
 
+        bool pc_sampling_marker = false;
 #if ROCPROFILER_SDK_HSA_PC_SAMPLING > 0
-        if(pc_sampling::is_pc_sample_service_configured(queue.get_agent().get_rocp_agent()->id))
+        if(pc_sampling::is_pc_sample_marker_required(queue.get_agent().get_rocp_agent()->id))
         {
             transformed_packets.emplace_back(pc_sampling::hsa::generate_marker_packet_for_kernel(
                 corr_id, tracing_data_v.external_correlation_ids));
+            pc_sampling_marker = true;
         }
 #endif
 
@@ -429,16 +433,17 @@ WriteInterceptor(const void* packets,
         // signal completes.
         queue.signal_async_handler(
             interrupt_signal,
-            new Queue::queue_info_session_t{.queue            = queue,
-                                            .inst_pkt         = std::move(inst_pkt),
-                                            .interrupt_signal = interrupt_signal,
-                                            .tid              = thr_id,
-                                            .enqueue_ts       = common::timestamp_ns(),
-                                            .user_data        = user_data,
-                                            .correlation_id   = corr_id,
-                                            .kernel_pkt       = kernel_pkt,
-                                            .callback_record  = callback_record,
-                                            .tracing_data     = tracing_data_v});
+            new Queue::queue_info_session_t{.queue              = queue,
+                                            .inst_pkt           = std::move(inst_pkt),
+                                            .interrupt_signal   = interrupt_signal,
+                                            .tid                = thr_id,
+                                            .enqueue_ts         = common::timestamp_ns(),
+                                            .user_data          = user_data,
+                                            .correlation_id     = corr_id,
+                                            .kernel_pkt         = kernel_pkt,
+                                            .callback_record    = callback_record,
+                                            .tracing_data       = tracing_data_v,
+                                            .pc_sampling_marker = pc_sampling_marker});
 
         {
             auto tracer_data = callback_record;
@@ -456,10 +461,10 @@ WriteInterceptor(const void* packets,
 
     writer(transformed_packets.data(), transformed_packets.size());
 }
-}  // namespace
 
-Queue::Queue(const AgentCache& agent, CoreApiTable table)
-: _core_api(table)
+Queue::Queue(const AgentCache& agent, CoreApiTable core_api, AmdExtTable ext_api)
+: _core_api(core_api)
+, _ext_api(ext_api)
 , _agent(agent)
 {
     _core_api.hsa_signal_create_fn(0, 0, nullptr, &_active_kernels);
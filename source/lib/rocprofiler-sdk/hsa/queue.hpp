@@ -90,7 +90,7 @@ public:
                                               inst_pkt_t&)>;
     using callback_map_t = std::unordered_map<ClientID, std::pair<queue_cb_t, completed_cb_t>>;
 
-    Queue(const AgentCache& agent, CoreApiTable table);
+    Queue(const AgentCache& agent, CoreApiTable core_api, AmdExtTable ext_api = {});
     Queue(const AgentCache&  agent,
           uint32_t           size,
           hsa_queue_type32_t type,
@@ -156,6 +156,14 @@ private:
     hsa_signal_t                                      _active_kernels = {.handle = 0};
 };
 
+// Rewrites the packets written to an intercepted queue, @p data is the Queue of the packets
+void
+WriteInterceptor(const void*                           packets,
+                 uint64_t                              pkt_count,
+                 uint64_t                              user_pkt_index,
+                 void*                                 data,
+                 hsa_amd_queue_intercept_packet_writer writer);
+
 inline rocprofiler_queue_id_t
 Queue::get_id() const
 {
@@ -24,7 +24,9 @@
 #include "lib/common/static_object.hpp"
 #include "lib/rocprofiler-sdk/agent.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
+#include "lib/rocprofiler-sdk/counters/controller.hpp"
 #include "lib/rocprofiler-sdk/hsa/agent_cache.hpp"
+#include "lib/rocprofiler-sdk/hsa/scratch_memory.hpp"
 #include "lib/rocprofiler-sdk/registration.hpp"
 
 #include <rocprofiler-sdk/fwd.h>
@@ -62,8 +64,7 @@ create_queue(hsa_agent_t        agent,
                                                      controller->get_ext_table(),
                                                      queue);
 
-            controller->serializer().wlock(
-                [&](auto& serializer) { serializer.add_queue(queue, *new_queue); });
+            profiler_serializer::add_queue(queue, *new_queue);
             controller->add_queue(*queue, std::move(new_queue));
 
             return HSA_STATUS_SUCCESS;
@@ -147,6 +148,8 @@ QueueController::add_queue(hsa_queue_t* id, std::unique_ptr<Queue> queue)
         pre_initialize_fn(queue->get_agent(), get_core_table(), get_ext_table());
 
     CHECK(queue);
+    scratch_memory::add_queue_agent(queue->get_id().handle,
+                                    queue->get_agent().get_rocp_agent()->id);
     _callback_cache.wlock([&](auto& callbacks) {
         _queues.wlock([&](auto& map) {
             const auto agent_id = queue->get_agent().get_rocp_agent()->id.handle;
@@ -180,7 +183,10 @@ QueueController::destroy_queue(hsa_queue_t* id)
 
     ROCP_INFO << "destroying queue...";
 
+    scratch_memory::remove_queue_agent(queue->get_id().handle);
     queue->sync();
+    // the counter collection packets of the completed dispatches have returned to their rings
+    counters::remove_queue(queue->get_id().handle);
     if(queue->block_signal.handle != 0) get_core_table().hsa_signal_destroy_fn(queue->block_signal);
     _queues.wlock([&](auto& map) { map.erase(id); });
 
@@ -251,6 +257,9 @@ QueueController::init(CoreApiTable& core_table, AmdExtTable& ext_table)
         }
     }
 
+    for(const auto& [_, agent_info] : get_supported_agents())
+        _profiler_serializers.add_agent(agent_info, _core_table);
+
     auto enable_intercepter = false;
     for(const auto& itr : context::get_registered_contexts())
     {
@@ -315,8 +324,7 @@ QueueController::disable_serialization()
 {
     _queues.rlock([](const queue_map_t& _queues_v) {
         if(get_queue_controller())
-            get_queue_controller()->serializer().wlock(
-                [&](auto& serializer) { serializer.disable(_queues_v); });
+            get_queue_controller()->_profiler_serializers.disable(_queues_v);
     });
 }
 
@@ -325,8 +333,7 @@ QueueController::enable_serialization()
 {
     _queues.rlock([](const queue_map_t& _queues_v) {
         if(get_queue_controller())
-            get_queue_controller()->serializer().wlock(
-                [&](auto& serializer) { serializer.enable(_queues_v); });
+            get_queue_controller()->_profiler_serializers.enable(_queues_v);
     });
 }
 
@@ -80,7 +80,12 @@ public:
 
     void iterate_callbacks(const callback_iterator_cb_t&) const;
 
-    common::Synchronized<hsa::profiler_serializer>& serializer() { return _profiler_serializer; }
+    // Serializer of the agent of the queue. Kernels are only serialized with the kernels
+    // dispatched to the same agent
+    agent_serializers::serializer_t& serializer(const Queue& queue)
+    {
+        return _profiler_serializers.get(queue);
+    }
 
     /**
      * Disable serialization for QueueController, has no effect if counter collection
@@ -105,12 +110,12 @@ private:
     using agent_cache_map_t = std::unordered_map<uint32_t, AgentCache>;
     using resource_alloc_t  = void(const AgentCache&, const CoreApiTable&, const AmdExtTable&);
 
-    CoreApiTable                                   _core_table       = {};
-    AmdExtTable                                    _ext_table        = {};
-    common::Synchronized<queue_map_t>              _queues           = {};
-    common::Synchronized<client_id_map_t>          _callback_cache   = {};
-    agent_cache_map_t                              _supported_agents = {};
-    common::Synchronized<hsa::profiler_serializer> _profiler_serializer;
+    CoreApiTable                          _core_table       = {};
+    AmdExtTable                           _ext_table        = {};
+    common::Synchronized<queue_map_t>     _queues           = {};
+    common::Synchronized<client_id_map_t> _callback_cache   = {};
+    agent_cache_map_t                     _supported_agents = {};
+    hsa::agent_serializers                _profiler_serializers;
 
     std::vector<std::function<resource_alloc_t>> pre_initialize;
     std::vector<std::function<resource_alloc_t>> pre_deinitialize;
@@ -53,15 +53,16 @@ struct queue_info_session
     using context_array_t        = common::container::small_vector<const context_t*>;
 
     Queue&                   queue;
-    inst_pkt_t               inst_pkt         = {};
-    hsa_signal_t             interrupt_signal = {};
-    rocprofiler_thread_id_t  tid              = common::get_tid();
-    rocprofiler_timestamp_t  enqueue_ts       = 0;
-    rocprofiler_user_data_t  user_data        = {.value = 0};
-    context::correlation_id* correlation_id   = nullptr;
-    rocprofiler_packet       kernel_pkt       = {};
-    callback_record_t        callback_record  = {};
-    tracing::tracing_data    tracing_data     = {};
+    inst_pkt_t               inst_pkt           = {};
+    hsa_signal_t             interrupt_signal   = {};
+    rocprofiler_thread_id_t  tid                = common::get_tid();
+    rocprofiler_timestamp_t  enqueue_ts         = 0;
+    rocprofiler_user_data_t  user_data          = {.value = 0};
+    context::correlation_id* correlation_id     = nullptr;
+    rocprofiler_packet       kernel_pkt         = {};
+    callback_record_t        callback_record    = {};
+    tracing::tracing_data    tracing_data       = {};
+    bool                     pc_sampling_marker = false;
 };
 }  // namespace hsa
 }  // namespace rocprofiler
@@ -22,6 +22,8 @@
 
 #include "lib/rocprofiler-sdk/hsa/scratch_memory.hpp"
 #include "lib/common/defines.hpp"
+#include "lib/common/static_object.hpp"
+#include "lib/common/synchronized.hpp"
 #include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
 #include "lib/rocprofiler-sdk/hsa/defines.hpp"
@@ -43,8 +45,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 HSA_API_TABLE_LOOKUP_DEFINITION(ROCPROFILER_HSA_TABLE_ID_AmdTool, ::ToolsApiTable, amd_tool)
@@ -375,6 +379,59 @@ get_flags(hsa_amd_tool_event_t event)
     return static_cast<rocprofiler_scratch_alloc_flag_t>(event.scratch_alloc_start->flags);
 }
 
+using queue_agent_map_t = std::unordered_map<uint64_t, rocprofiler_agent_id_t>;
+
+auto*
+get_queue_agents()
+{
+    static auto*& _v = common::static_object<common::Synchronized<queue_agent_map_t>>::construct();
+    return _v;
+}
+
+rocprofiler_agent_id_t
+get_agent_id(const hsa_queue_t* hsa_queue)
+{
+    // queue ids are never reused so the last queue of the thread is remembered across events.
+    // Bursts of scratch events are typically reported for the same queue
+    static thread_local auto last_queue = std::pair<uint64_t, rocprofiler_agent_id_t>{
+        std::numeric_limits<uint64_t>::max(), rocprofiler_agent_id_t{static_cast<uint64_t>(-1)}};
+
+    if(last_queue.first == hsa_queue->id) return last_queue.second;
+
+    auto _agent_id   = rocprofiler_agent_id_t{static_cast<uint64_t>(-1)};
+    bool found_agent = false;
+
+    if(auto* _queue_agents = get_queue_agents())
+    {
+        _queue_agents->rlock([&](const queue_agent_map_t& _data) {
+            if(auto itr = _data.find(hsa_queue->id); itr != _data.end())
+            {
+                _agent_id   = itr->second;
+                found_agent = true;
+            }
+        });
+    }
+
+    // fallback for queues which were not registered by the queue controller
+    if(!found_agent && rocprofiler::hsa::get_queue_controller())
+    {
+        rocprofiler::hsa::get_queue_controller()->iterate_queues(
+            [&](const rocprofiler::hsa::Queue* queue_ptr) {
+                if(queue_ptr->intercept_queue()->id == hsa_queue->id)
+                {
+                    _agent_id   = queue_ptr->get_agent().get_rocp_agent()->id;
+                    found_agent = true;
+                }
+            });
+    }
+
+    ROCP_FATAL_IF(!found_agent) << fmt::format(
+        "Scratch memory tracing: Could not find a valid agent for queue id {}", hsa_queue->id);
+
+    last_queue = {hsa_queue->id, _agent_id};
+    return _agent_id;
+}
+
 /*
 Template instantiation per start/stop pairs to track event data through thread local storage
 */
@@ -393,15 +450,19 @@ get_tls_pair(rocprofiler_callback_phase_t phase)
         "Invalid event pair OpIdx");
 
     using callback_data_t = rocprofiler_callback_tracing_scratch_memory_data_t;
-    using buffered_data_t = rocprofiler_buffer_tracing_scratch_memory_record_t;
 
+    // The start of the event is recorded in this preallocated slot and the buffer record is
+    // only built (and emplaced once) at the end of the event
     struct tls_data
     {
         callback_data_t callback_data = common::init_public_api_struct(callback_data_t{});
-        buffered_data_t buffered_data = common::init_public_api_struct(buffered_data_t{});
         tracing::callback_context_data_vec_t   callback_contexts = {};
         tracing::buffered_context_data_vec_t   buffered_contexts = {};
         tracing::external_correlation_id_map_t external_corr_ids = {};
+        rocprofiler_agent_id_t                 agent_id          = {};
+        rocprofiler_queue_id_t                 queue_id          = {};
+        uint64_t                               internal_corr_id  = 0;
+        rocprofiler_timestamp_t                start_timestamp   = 0;
     };
 
     static thread_local auto tls  = tls_data{};
@@ -452,35 +513,25 @@ impl(Args... args)
 
     if(tls.callback_contexts.empty() && tls.buffered_contexts.empty()) return HSA_STATUS_SUCCESS;
 
-    const auto thr_id           = common::get_tid();
-    auto*      corr_id          = context::get_latest_correlation_id();
-    auto       internal_corr_id = (corr_id) ? corr_id->internal : 0;
-
-    [[maybe_unused]] const auto get_agent_id =
-        [](const hsa_queue_t* hsa_queue) -> rocprofiler_agent_id_t {
-        rocprofiler_agent_id_t _agent_id{static_cast<uint64_t>(-1)};
-        bool                   found_agent{false};
-
-        rocprofiler::hsa::get_queue_controller()->iterate_queues(
-            [&](const rocprofiler::hsa::Queue* queue_ptr) {
-                if(queue_ptr->intercept_queue()->id == hsa_queue->id)
-                {
-                    _agent_id   = queue_ptr->get_agent().get_rocp_agent()->id;
-                    found_agent = true;
-                }
-            });
-
-        ROCP_FATAL_IF(!found_agent) << fmt::format(
-            "Scratch memory tracing: Could not find a valid agent for queue id {}", hsa_queue->id);
-        return _agent_id;
-    };
+    const auto thr_id = common::get_tid();
 
     if constexpr(OpPhase == ROCPROFILER_CALLBACK_PHASE_ENTER)
     {
+        auto* corr_id        = context::get_latest_correlation_id();
+        tls.internal_corr_id = (corr_id) ? corr_id->internal : 0;
+        tls.agent_id         = get_agent_id(event_data.scratch_alloc_start->queue);
+        tls.queue_id         = {event_data.scratch_alloc_start->queue->id};
+
+        tracing::populate_external_correlation_ids(tls.external_corr_ids,
+                                                   thr_id,
+                                                   external_corr_id_domain_idx,
+                                                   OpIdx,
+                                                   tls.internal_corr_id);
+
         if(!tls.callback_contexts.empty())
         {
-            tls.callback_data.agent_id  = get_agent_id(event_data.scratch_alloc_start->queue);
-            tls.callback_data.queue_id  = {event_data.scratch_alloc_start->queue->id};
+            tls.callback_data.agent_id  = tls.agent_id;
+            tls.callback_data.queue_id  = tls.queue_id;
             tls.callback_data.args_kind = event_data.none->kind;
             tls.callback_data.flags     = get_flags(event_data);
 
@@ -490,15 +541,9 @@ impl(Args... args)
                     event_data.scratch_alloc_start->dispatch_id;
             }
 
-            tracing::populate_external_correlation_ids(tls.external_corr_ids,
-                                                       thr_id,
-                                                       external_corr_id_domain_idx,
-                                                       OpIdx,
-                                                       internal_corr_id);
-
             tracing::execute_phase_enter_callbacks(tls.callback_contexts,
                                                    thr_id,
-                                                   internal_corr_id,
+                                                   tls.internal_corr_id,
                                                    tls.external_corr_ids,
                                                    ROCPROFILER_CALLBACK_TRACING_SCRATCH_MEMORY,
                                                    OpIdx,
@@ -509,23 +554,12 @@ impl(Args... args)
                 tls.external_corr_ids, thr_id, external_corr_id_domain_idx);
         }
 
-        if(!tls.buffered_contexts.empty())
-        {
-            tls.buffered_data.kind            = ROCPROFILER_BUFFER_TRACING_SCRATCH_MEMORY;
-            tls.buffered_data.operation       = OpIdx;
-            tls.buffered_data.agent_id        = get_agent_id(event_data.scratch_alloc_start->queue);
-            tls.buffered_data.queue_id        = {event_data.scratch_alloc_start->queue->id};
-            tls.buffered_data.thread_id       = thr_id;
-            tls.buffered_data.start_timestamp = common::timestamp_ns();
-        }
+        if(!tls.buffered_contexts.empty()) tls.start_timestamp = common::timestamp_ns();
     }
     else if constexpr(OpPhase == ROCPROFILER_CALLBACK_PHASE_EXIT)
     {
-        if(!tls.buffered_contexts.empty())
-        {
-            tls.buffered_data.flags         = get_flags(event_data);
-            tls.buffered_data.end_timestamp = common::timestamp_ns();
-        }
+        const auto end_timestamp =
+            (tls.buffered_contexts.empty()) ? rocprofiler_timestamp_t{0} : common::timestamp_ns();
 
         if(!tls.callback_contexts.empty())
         {
@@ -548,10 +582,17 @@ impl(Args... args)
 
         if(!tls.buffered_contexts.empty())
         {
-            auto _buffered_data = tls.buffered_data;
+            using buffered_data_t = rocprofiler_buffer_tracing_scratch_memory_record_t;
+
+            auto _buffered_data            = common::init_public_api_struct(buffered_data_t{});
+            _buffered_data.agent_id        = tls.agent_id;
+            _buffered_data.queue_id        = tls.queue_id;
+            _buffered_data.flags           = get_flags(event_data);
+            _buffered_data.start_timestamp = tls.start_timestamp;
+            _buffered_data.end_timestamp   = end_timestamp;
             tracing::execute_buffer_record_emplace(tls.buffered_contexts,
                                                    thr_id,
-                                                   internal_corr_id,
+                                                   tls.internal_corr_id,
                                                    tls.external_corr_ids,
                                                    ROCPROFILER_BUFFER_TRACING_SCRATCH_MEMORY,
                                                    OpIdx,
@@ -642,6 +683,20 @@ update_table(hsa_amd_tool_table_t* _orig, uint64_t _tbl_instance)
     }
 }
 
+void
+add_queue_agent(uint64_t queue_id, rocprofiler_agent_id_t agent_id)
+{
+    if(auto* _queue_agents = get_queue_agents())
+        _queue_agents->wlock([&](queue_agent_map_t& _data) { _data[queue_id] = agent_id; });
+}
+
+void
+remove_queue_agent(uint64_t queue_id)
+{
+    if(auto* _queue_agents = get_queue_agents())
+        _queue_agents->wlock([&](queue_agent_map_t& _data) { _data.erase(queue_id); });
+}
+
 const char*
 name_by_id(uint32_t id)
 {
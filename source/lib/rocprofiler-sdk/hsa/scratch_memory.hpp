@@ -52,6 +52,14 @@ copy_table(hsa_amd_tool_table_t* _orig, uint64_t lib_instance);
 
 void
 update_table(hsa_amd_tool_table_t* _orig, uint64_t lib_instance);
+
+// The queue controller registers the agent of every intercepted queue so that the agent of a
+// scratch memory event is found without iterating over all the queues
+void
+add_queue_agent(uint64_t queue_id, rocprofiler_agent_id_t agent_id);
+
+void
+remove_queue_agent(uint64_t queue_id);
 }  // namespace scratch_memory
 }  // namespace hsa
 }  // namespace rocprofiler
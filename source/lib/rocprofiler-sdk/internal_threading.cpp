@@ -25,6 +25,7 @@
 #include <rocprofiler-sdk/rocprofiler.h>
 
 #include "lib/common/container/stable_vector.hpp"
+#include "lib/common/environment.hpp"
 #include "lib/common/static_object.hpp"
 #include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/allocator.hpp"
@@ -35,11 +36,13 @@
 
 #include <pthread.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <mutex>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace rocprofiler
@@ -48,7 +51,7 @@ namespace internal_threading
 {
 namespace
 {
-using task_group_vec_t     = std::vector<task_group_t*>;
+using executor_vec_t       = std::vector<FlushExecutor*>;
 using thread_pool_config_t = PTL::ThreadPool::Config;
 
 auto affinity_functor(intmax_t)
@@ -72,6 +75,9 @@ get_thread_pool_config()
                                 .initializer  = []() {},
                                 .finalizer    = []() {}};
 }
+
+// task group executing the task on the current thread (if any)
+thread_local const TaskGroup* this_task_group = nullptr;
 }  // namespace
 
 TaskGroup::TaskGroup()
@@ -88,22 +94,68 @@ TaskGroup::~TaskGroup()
 void
 TaskGroup::exec(std::function<void()>&& _func)
 {
+    auto _task = [this, _func = std::move(_func)]() {
+        const auto* _prev = std::exchange(this_task_group, this);
+        _func();
+        this_task_group = _prev;
+    };
+
+    // bound the number of retained task handles: the oldest tasks are (almost always) complete
+    // so waiting on them is cheap and prevents unbounded growth when wait() is never invoked
+    auto _oldest = task_vec_t{};
+    {
+        auto lk = std::unique_lock<std::mutex>{m_mutex};
+        m_tasks.emplace_back(parent_type::async(std::move(_task)));
+        // a task of this group waiting on the oldest tasks could wait on itself
+        if(this_task_group == this || m_tasks.size() <= max_pending_tasks) return;
+        _oldest.assign(m_tasks.begin(), m_tasks.end() - max_pending_tasks);
+    }
+
+    for(auto& itr : _oldest)
+        itr->wait();
+
     auto lk = std::unique_lock<std::mutex>{m_mutex};
-    m_tasks.emplace_back(parent_type::async(std::move(_func)));
+    release(_oldest);
+    while(m_completed_tasks.size() > max_pending_tasks)
+        m_completed_tasks.pop_front();
 }
 
 void
 TaskGroup::wait()
 {
-    auto lk = std::unique_lock<std::mutex>{m_mutex};
-    for(auto& itr : m_tasks)
+    auto _tasks = task_vec_t{};
+    {
+        auto lk = std::unique_lock<std::mutex>{m_mutex};
+        // a task of this group would wait on itself
+        if(this_task_group == this) return;
+        _tasks.assign(m_tasks.begin(), m_tasks.end());
+    }
+
+    // the tasks are waited on without the lock so that they (and other threads) can submit
+    // tasks to the group meanwhile. Tasks submitted meanwhile are not waited on
+    for(auto& itr : _tasks)
         itr->wait();
+
+    auto lk = std::unique_lock<std::mutex>{m_mutex};
     // we hold the handles for the completed tasks to prevent a rare (but possible) data race on the
-    // destruction of the shared_ptr
+    // destruction of the shared_ptr. They are destroyed by the next wait or the destruction of
+    // the task group
     m_completed_tasks.clear();
-    // makes m_tasks empty but delays the destruction of the shared_ptrs until the next wait or the
-    // destruction of the task group
-    std::swap(m_tasks, m_completed_tasks);
+    release(_tasks);
+}
+
+// moves the handles of the completed tasks from the pending to the completed tasks. The tasks
+// are the oldest pending tasks unless another thread released them meanwhile. Expects the lock
+// to be held
+void
+TaskGroup::release(const task_vec_t& _tasks)
+{
+    for(const auto& itr : _tasks)
+    {
+        if(m_tasks.empty() || m_tasks.front() != itr) continue;
+        m_completed_tasks.emplace_back(std::move(m_tasks.front()));
+        m_tasks.pop_front();
+    }
 }
 
 void
@@ -112,6 +164,126 @@ TaskGroup::join()
     wait();
 }
 
+namespace
+{
+// executor owning the current thread (if it is a worker thread)
+thread_local const FlushExecutor* this_flush_executor = nullptr;
+}  // namespace
+
+FlushExecutor::FlushExecutor(size_t num_workers, size_t queue_size)
+: m_queue(std::max<size_t>(queue_size, 1))
+{
+    num_workers = std::max<size_t>(num_workers, 1);
+    m_workers.reserve(num_workers);
+    for(size_t i = 0; i < num_workers; ++i)
+    {
+        notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+        m_workers.emplace_back(&FlushExecutor::run, this);
+        notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+    }
+}
+
+FlushExecutor::~FlushExecutor() { join(); }
+
+void
+FlushExecutor::submit(task _task)
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    while(m_count == m_queue.size())
+    {
+        // a worker submitting into a full queue would wait on itself
+        if(this_flush_executor == this)
+            execute(_lk);
+        else
+            m_available.wait(_lk);
+    }
+
+    m_queue.at((m_head + m_count) % m_queue.size()) = _task;
+    ++m_count;
+    m_pending.notify_one();
+    // a worker waiting inside a task may be the only thread able to execute the new task
+    if(m_helpers > 0) m_completed.notify_all();
+}
+
+void
+FlushExecutor::wait_until(const std::function<bool()>& _pred)
+{
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    while(!_pred())
+    {
+        if(this_flush_executor != this)
+        {
+            m_completed.wait(_lk);
+        }
+        else if(m_count > 0)
+        {
+            execute(_lk);
+        }
+        else
+        {
+            ++m_helpers;
+            m_completed.wait(_lk);
+            --m_helpers;
+        }
+    }
+}
+
+void
+FlushExecutor::wait()
+{
+    wait_until([this]() { return m_count == 0 && m_active == 0; });
+}
+
+void
+FlushExecutor::join()
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        if(m_stop) return;
+        m_stop = true;
+        m_pending.notify_all();
+    }
+
+    // workers drain the queue before exiting
+    for(auto& itr : m_workers)
+    {
+        if(itr.joinable()) itr.join();
+    }
+}
+
+// pops the task at the head of the queue and executes it without holding the lock.
+// Expects the lock to be held and the queue to be non-empty
+void
+FlushExecutor::execute(std::unique_lock<std::mutex>& _lk)
+{
+    auto _task = m_queue.at(m_head);
+    m_head     = (m_head + 1) % m_queue.size();
+    --m_count;
+    ++m_active;
+    m_available.notify_one();
+
+    _lk.unlock();
+    _task.func(_task.arg0, _task.arg1);
+    _lk.lock();
+
+    --m_active;
+    m_completed.notify_all();
+}
+
+void
+FlushExecutor::run()
+{
+    this_flush_executor = this;
+
+    auto _lk = std::unique_lock<std::mutex>{m_mutex};
+    while(true)
+    {
+        m_pending.wait(_lk, [this]() { return m_stop || m_count > 0; });
+        if(m_count == 0 && m_stop) break;
+        execute(_lk);
+    }
+}
+
 namespace
 {
 template <rocprofiler_runtime_library_t... Idx>
@@ -212,24 +384,34 @@ execute_creation_notifiers(rocprofiler_runtime_library_t libs,
     (execute(get_creation_notifier<Idx>()), ...);
 }
 
+// executor of each callback thread, indexed by the handle of the callback thread
 auto*&
-get_task_groups()
+get_flush_executors()
 {
-    static auto* _v = new task_group_vec_t{};
+    static auto* _v = new executor_vec_t{};
     return _v;
 }
 
+// the default callback thread (handle 0) may use several workers, a callback thread created by
+// the tool has a single worker, i.e. its buffers are delivered on the same thread
+FlushExecutor*
+create_flush_executor(bool is_default)
+{
+    auto _num_workers =
+        (is_default) ? common::get_env<size_t>("ROCPROFILER_BUFFER_FLUSH_THREADS", 1) : 1;
+    auto _queue_size = common::get_env<size_t>("ROCPROFILER_BUFFER_FLUSH_QUEUE_SIZE", 256);
+    return new FlushExecutor{_num_workers, _queue_size};
+}
+
 void
 create_forked_callback_threads()
 {
-    if(get_task_groups())
+    // worker threads do not exist in the forked process so the executors from the parent
+    // process (and their possibly locked mutexes) are intentionally leaked
+    if(get_flush_executors())
     {
-        for(auto& itr : *get_task_groups())
-        {
-            notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
-            itr = new task_group_t{};
-            notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
-        }
+        for(size_t i = 0; i < get_flush_executors()->size(); ++i)
+            get_flush_executors()->at(i) = create_flush_executor(i == 0);
     }
 }
 }  // namespace
@@ -240,10 +422,10 @@ initialize()
 {
     static auto _once = std::once_flag{};
     std::call_once(_once, []() {
-        // Note: create_callback_thread() must occur before atexit
+        // Note: the flush executor must be created before atexit
         // registration or else the static objects it is pointing to
         // will be destroyed before finalize is invoked.
-        create_callback_thread();
+        CHECK_NOTNULL(get_flush_executors())->emplace_back(create_flush_executor(true));
         ::atexit(&registration::finalize);
         // ensure the callback threads are created on the forked process
         ::pthread_atfork(nullptr, nullptr, create_forked_callback_threads);
@@ -253,17 +435,15 @@ initialize()
 void
 finalize()
 {
-    // PLT::ThreadPool::f_thread_ids() is not destruction order safe
-    // if it does become safe, these two calls could be removed.
-    if(get_task_groups())
+    if(get_flush_executors())
     {
-        for(auto& itr : *get_task_groups())
+        for(auto& itr : *get_flush_executors())
             itr->join();
-        for(auto& itr : *get_task_groups())
+        for(auto& itr : *get_flush_executors())
             delete itr;
-        get_task_groups()->clear();
-        delete get_task_groups();
-        get_task_groups() = nullptr;
+        get_flush_executors()->clear();
+        delete get_flush_executors();
+        get_flush_executors() = nullptr;
     }
 }
 
@@ -282,27 +462,21 @@ notify_post_internal_thread_create(rocprofiler_runtime_library_t libs)
 rocprofiler_callback_thread_t
 create_callback_thread()
 {
-    // notify that rocprofiler library is about to create an inernal thread
-    notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
-
     // this will be index after emplace_back
-    auto idx = CHECK_NOTNULL(get_task_groups())->size();
-
-    // construct the task group to use the newly created thread pool
-    get_task_groups()->emplace_back(new task_group_t{});
+    auto idx = CHECK_NOTNULL(get_flush_executors())->size();
 
-    // notify that rocprofiler library finished creating an internal thread
-    notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+    // the executor notifies the creation of its internal thread
+    get_flush_executors()->emplace_back(create_flush_executor(false));
 
     return rocprofiler_callback_thread_t{idx};
 }
 
-// returns the task group for the given callback thread identifier
-task_group_t*
-get_task_group(rocprofiler_callback_thread_t cb_tid)
+// returns the executor for the given callback thread identifier
+FlushExecutor*
+get_flush_executor(rocprofiler_callback_thread_t cb_tid)
 {
-    if(!get_task_groups() || get_task_groups()->empty()) return nullptr;
-    return get_task_groups()->at(cb_tid.handle);
+    if(!get_flush_executors() || cb_tid.handle >= get_flush_executors()->size()) return nullptr;
+    return get_flush_executors()->at(cb_tid.handle);
 }
 }  // namespace internal_threading
 }  // namespace rocprofiler
@@ -348,10 +522,7 @@ rocprofiler_assign_callback_thread(rocprofiler_buffer_id_t       buffer_id,
     if(rocprofiler::registration::get_init_status() > 0)
         return ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED;
 
-    if(!rocprofiler::internal_threading::get_task_groups())
-        return ROCPROFILER_STATUS_ERROR_THREAD_NOT_FOUND;
-
-    if(cb_thread_id.handle >= rocprofiler::internal_threading::get_task_groups()->size())
+    if(!rocprofiler::internal_threading::get_flush_executor(cb_thread_id))
         return ROCPROFILER_STATUS_ERROR_THREAD_NOT_FOUND;
 
     auto* buff_v = rocprofiler::buffer::get_buffer(buffer_id);
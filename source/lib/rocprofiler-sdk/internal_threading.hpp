@@ -32,11 +32,13 @@
 #include <PTL/TaskManager.hh>
 #include <PTL/ThreadPool.hh>
 
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace rocprofiler
@@ -63,6 +65,13 @@ public:
     void join();
 
 private:
+    using task_vec_t = std::vector<std::shared_ptr<task_type>>;
+
+    void release(const task_vec_t&);
+
+    // maximum number of task handles retained before the oldest are waited on and released
+    static constexpr size_t max_pending_tasks = 64;
+
     std::mutex                             m_mutex           = {};
     thread_pool_t*                         m_pool            = nullptr;
     std::deque<std::shared_ptr<task_type>> m_tasks           = {};
@@ -71,6 +80,76 @@ private:
 
 using task_group_t = TaskGroup;
 
+/**
+ * FlushExecutor delivers the buffer flushes of a callback thread. The executor of the default
+ * callback thread, which serves every buffer not assigned to a callback thread via
+ * rocprofiler_assign_callback_thread, owns a configurable number of worker threads
+ * (ROCPROFILER_BUFFER_FLUSH_THREADS, default 1 to preserve the documented behavior that buffered
+ * results are delivered on the same thread by default). The executor of a callback thread created
+ * by the tool owns a single worker thread. The workers pull from a single bounded ring of tasks
+ * (ROCPROFILER_BUFFER_FLUSH_QUEUE_SIZE). A task is a function pointer plus two integer arguments
+ * so no heap allocation is needed per flush.
+ *
+ * Per-buffer ordering is provided by the buffer instance: a buffer cannot submit a new flush
+ * until the previous flush released the syncer flag, i.e. each buffer has at most one task in
+ * the executor at any time. Thus, submit only blocks when more buffers than queue slots are
+ * flushing at the same time.
+ */
+class FlushExecutor
+{
+public:
+    using task_func_t = void (*)(uint64_t, uint64_t);
+
+    struct task
+    {
+        task_func_t func = nullptr;
+        uint64_t    arg0 = 0;
+        uint64_t    arg1 = 0;
+    };
+
+    FlushExecutor(size_t num_workers, size_t queue_size);
+    ~FlushExecutor();
+
+    FlushExecutor(const FlushExecutor&)     = delete;
+    FlushExecutor(FlushExecutor&&) noexcept = delete;
+    FlushExecutor& operator=(const FlushExecutor&) = delete;
+    FlushExecutor& operator=(FlushExecutor&&) noexcept = delete;
+
+    // enqueues the task. Blocks while the queue is full
+    void submit(task);
+
+    // blocks until the predicate returns true. The predicate is re-evaluated every time a task
+    // completes. When invoked from a worker thread (e.g. a buffer callback which overflows
+    // another lossless buffer), queued tasks are executed inline instead of deadlocking and the
+    // predicate is also re-evaluated every time a task is submitted
+    void wait_until(const std::function<bool()>& _pred);
+
+    // blocks until all submitted tasks have completed
+    void wait();
+
+    // completes all the tasks and joins the worker threads
+    void join();
+
+    size_t num_workers() const { return m_workers.size(); }
+    size_t queue_size() const { return m_queue.size(); }
+
+private:
+    void run();
+    void execute(std::unique_lock<std::mutex>&);
+
+    std::mutex               m_mutex     = {};
+    std::condition_variable  m_pending   = {};
+    std::condition_variable  m_available = {};
+    std::condition_variable  m_completed = {};
+    std::vector<task>        m_queue     = {};
+    size_t                   m_head      = 0;
+    size_t                   m_count     = 0;
+    size_t                   m_active    = 0;
+    size_t                   m_helpers   = 0;
+    bool                     m_stop      = false;
+    std::vector<std::thread> m_workers   = {};
+};
+
 void notify_pre_internal_thread_create(rocprofiler_runtime_library_t);
 void notify_post_internal_thread_create(rocprofiler_runtime_library_t);
 
@@ -86,7 +165,9 @@ finalize();
 rocprofiler_callback_thread_t
 create_callback_thread();
 
-// returns the task group for the given callback thread identifier
-task_group_t* get_task_group(rocprofiler_callback_thread_t);
+// returns the executor which services the given callback thread identifier (nullptr if the
+// callback thread does not exist)
+FlushExecutor*
+get_flush_executor(rocprofiler_callback_thread_t);
 }  // namespace internal_threading
 }  // namespace rocprofiler
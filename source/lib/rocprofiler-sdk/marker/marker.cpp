@@ -23,6 +23,7 @@
 #include "lib/rocprofiler-sdk/marker/marker.hpp"
 #include "lib/common/defines.hpp"
 #include "lib/common/static_object.hpp"
+#include "lib/common/string_table.hpp"
 #include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/buffer.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
@@ -87,6 +88,34 @@ get_table_impl()
 template <size_t TableIdx>
 auto*
 get_table();
+
+common::string_table*
+get_message_table()
+{
+    static auto*& _v = common::static_object<common::string_table>::construct();
+    return _v;
+}
+
+// interns the message (or name) argument of the marker API so that buffered records only store a
+// compact identifier. Messages are usually repeated so, after the first call, this is a
+// lock-free lookup without any allocation
+template <typename Tp, typename... Args>
+rocprofiler_marker_message_id_t
+get_message_id([[maybe_unused]] Tp _message, Args...)
+{
+    if constexpr(std::is_same<Tp, const char*>::value)
+    {
+        auto* _table = get_message_table();
+        if(_message && _table) return _table->intern_id(_message);
+    }
+    return 0;
+}
+
+rocprofiler_marker_message_id_t
+get_message_id()
+{
+    return 0;
+}
 }  // namespace
 
 template <size_t TableIdx, size_t OpIdx>
@@ -201,6 +230,7 @@ roctx_api_impl<TableIdx, OpIdx>::functor(Args... args)
     // record the start timestamp as close to the function call as possible
     if(!buffered_contexts.empty())
     {
+        buffer_record.message_id      = get_message_id(args...);
         buffer_record.start_timestamp = common::timestamp_ns();
     }
 
@@ -548,3 +578,18 @@ INSTANTIATE_MARKER_TABLE_FUNC(roctx_name_api_table_t, ROCPROFILER_MARKER_TABLE_I
 #undef INSTANTIATE_MARKER_TABLE_FUNC
 }  // namespace marker
 }  // namespace rocprofiler
+
+extern "C" {
+rocprofiler_status_t
+rocprofiler_query_marker_message(rocprofiler_marker_message_id_t message_id, const char** message)
+{
+    auto* _table = rocprofiler::marker::get_message_table();
+    if(!_table) return ROCPROFILER_STATUS_ERROR_FINALIZED;
+
+    auto _message = _table->lookup(message_id);
+    if(!_message.data()) return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    *message = _message.data();
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+}
@@ -24,26 +24,6 @@
 
 #include "lib/common/logging.hpp"
 
-#define KFD_EVENT_PARSE_EVENTS(X, HANDLER)                                                         \
-    do                                                                                             \
-    {                                                                                              \
-        const auto find_newline = [&](auto b) { return std::find(b, X.cend(), '\n'); };            \
-                                                                                                   \
-        const auto* cursor = X.cbegin();                                                           \
-                                                                                                   \
-        for(const auto* pos = find_newline(cursor); pos != X.cend(); pos = find_newline(cursor))   \
-        {                                                                                          \
-            size_t char_count = pos - cursor;                                                      \
-            assert(char_count > 0);                                                                \
-            std::string_view event_str{cursor, char_count};                                        \
-                                                                                                   \
-            ROCP_INFO << fmt::format("KFD event: [{}]", event_str);                                \
-            HANDLER(event_str);                                                                    \
-                                                                                                   \
-            cursor = pos + 1;                                                                      \
-        }                                                                                          \
-    } while(0)
-
 #define APPEND_UVM_EVENT(X)          ROCPROFILER_UVM_EVENT_##X
 #define APPEND_1(X)                  APPEND_UVM_EVENT(X)
 #define CONCAT(X, Y)                 X##Y
@@ -43,6 +43,7 @@
 
 #include <sys/poll.h>
 #include <unistd.h>
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cerrno>
@@ -59,6 +60,7 @@
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <fcntl.h>
 #include <poll.h>
@@ -166,70 +168,72 @@ to_string(EnumT val,
 }
 
 template <size_t>
-page_migration_record_t parse_uvm_event(std::string_view)
+bool
+parse_uvm_event(std::string_view, page_migration_record_t&)
 {
     ROCP_FATAL_IF(false) << uvm_event_info<ROCPROFILER_UVM_EVENT_NONE>::format_str;
-    return {};
+    return false;
 }
 
 template <>
-page_migration_record_t
-parse_uvm_event<ROCPROFILER_UVM_EVENT_PAGE_FAULT_START>(std::string_view str)
-{
-    page_migration_record_t rec{};
-    auto&                   e = rec.page_fault;
-    uint32_t                kind{};
-
-    char fault;
-    std::sscanf(str.data(),
-                uvm_event_info<ROCPROFILER_UVM_EVENT_PAGE_FAULT_START>::format_str.data(),
-                &kind,
-                &rec.start_timestamp,
-                &rec.pid,
-                &e.address,
-                &e.node_id,
-                &fault);
+bool
+parse_uvm_event<ROCPROFILER_UVM_EVENT_PAGE_FAULT_START>(std::string_view         str,
+                                                        page_migration_record_t& rec)
+{
+    auto&    e    = rec.page_fault;
+    uint32_t kind = {};
+    char     fault{};
+
+    auto _cursor = smi_cursor{str};
+    _cursor.hex(kind)
+        .dec(rec.start_timestamp)
+        .skip('-')
+        .dec(rec.pid)
+        .skip('@')
+        .hex(e.address)
+        .skip('(')
+        .hex(e.node_id)
+        .skip(')')
+        .chr(fault);
 
     e.read_fault = (fault == 'R');
     e.address    = page_to_bytes(e.address);
 
-    ROCP_INFO << fmt::format("Page fault start [ ts: {} pid: {} addr: 0x{:X} node: {} ] \n",
-                             rec.start_timestamp,
-                             rec.pid,
-                             e.address,
-                             e.node_id);
+    ROCP_TRACE << fmt::format("Page fault start [ ts: {} pid: {} addr: 0x{:X} node: {} ] \n",
+                              rec.start_timestamp,
+                              rec.pid,
+                              e.address,
+                              e.node_id);
 
-    return rec;
+    return static_cast<bool>(_cursor);
 }
 
 template <>
-page_migration_record_t
-parse_uvm_event<ROCPROFILER_UVM_EVENT_PAGE_FAULT_END>(std::string_view str)
-{
-    page_migration_record_t rec{};
-    auto&                   e = rec.page_fault;
-    uint32_t                kind{};
-
-    char migrated;
-    std::sscanf(str.data(),
-                uvm_event_info<ROCPROFILER_UVM_EVENT_PAGE_FAULT_END>::format_str.data(),
-                &kind,
-                &rec.end_timestamp,
-                &rec.pid,
-                &e.address,
-                &e.node_id,
-                &migrated);
+bool
+parse_uvm_event<ROCPROFILER_UVM_EVENT_PAGE_FAULT_END>(std::string_view         str,
+                                                      page_migration_record_t& rec)
+{
+    auto&    e    = rec.page_fault;
+    uint32_t kind = {};
+    char     migrated{};
+
+    auto _cursor = smi_cursor{str};
+    _cursor.hex(kind)
+        .dec(rec.end_timestamp)
+        .skip('-')
+        .dec(rec.pid)
+        .skip('@')
+        .hex(e.address)
+        .skip('(')
+        .hex(e.node_id)
+        .skip(')')
+        .chr(migrated);
 
     // M or U -> migrated / unmigrated?
-    if(migrated == 'M')
-        e.migrated = true;
-    else if(migrated == 'U')
-        e.migrated = false;
-    // else
-    // throw std::runtime_error("Invalid SVM memory migrate type");
-    e.address = page_to_bytes(e.address);
-
-    ROCP_INFO << fmt::format(
+    e.migrated = (migrated == 'M');
+    e.address  = page_to_bytes(e.address);
+
+    ROCP_TRACE << fmt::format(
         "Page fault end [ ts: {} pid: {} addr: 0x{:X} node: {} migrated: {} ] \n",
         rec.end_timestamp,
         rec.pid,
@@ -237,37 +241,43 @@ parse_uvm_event<ROCPROFILER_UVM_EVENT_PAGE_FAULT_END>(std::string_view str)
         e.node_id,
         migrated);
 
-    return rec;
+    return static_cast<bool>(_cursor);
 }
 
 template <>
-page_migration_record_t
-parse_uvm_event<ROCPROFILER_UVM_EVENT_MIGRATE_START>(std::string_view str)
-{
-    page_migration_record_t rec{};
-    auto&                   e = rec.page_migrate;
-    uint32_t                kind{};
-    uint32_t                trigger{};
-
-    std::sscanf(str.data(),
-                uvm_event_info<ROCPROFILER_UVM_EVENT_MIGRATE_START>::format_str.data(),
-                &kind,
-                &rec.start_timestamp,
-                &rec.pid,
-                &e.start_addr,
-                &e.end_addr,
-                &e.from_node,
-                &e.to_node,
-                &e.prefetch_node,
-                &e.preferred_node,
-                &trigger);
+bool
+parse_uvm_event<ROCPROFILER_UVM_EVENT_MIGRATE_START>(std::string_view         str,
+                                                     page_migration_record_t& rec)
+{
+    auto&    e       = rec.page_migrate;
+    uint32_t kind    = {};
+    int32_t  trigger = {};
+
+    auto _cursor = smi_cursor{str};
+    _cursor.hex(kind)
+        .dec(rec.start_timestamp)
+        .skip('-')
+        .dec(rec.pid)
+        .skip('@')
+        .hex(e.start_addr)
+        .skip('(')
+        .hex(e.end_addr)
+        .skip(')')
+        .hex(e.from_node)
+        .skip('-')
+        .skip('>')
+        .hex(e.to_node)
+        .hex(e.prefetch_node)
+        .skip(':')
+        .hex(e.preferred_node)
+        .dec(trigger);
 
     e.end_addr += e.start_addr;
     e.trigger    = static_cast<migrate_trigger_t>(trigger);
     e.start_addr = page_to_bytes(e.start_addr);
     e.end_addr   = page_to_bytes(e.end_addr) - 1;
 
-    ROCP_INFO << fmt::format(
+    ROCP_TRACE << fmt::format(
         "Page migrate start [ ts: {} pid: {} addr s: 0x{:X} addr "
         "e: 0x{:X} size: {}B from node: {} to node: {} prefetch node: {} preferred node: {} "
         "trigger: {} ] \n",
@@ -282,119 +292,116 @@ parse_uvm_event<ROCPROFILER_UVM_EVENT_MIGRATE_START>(std::string_view str)
         e.preferred_node,
         to_string(e.trigger));
 
-    return rec;
+    return static_cast<bool>(_cursor);
 }
 
 template <>
-page_migration_record_t
-parse_uvm_event<ROCPROFILER_UVM_EVENT_MIGRATE_END>(std::string_view str)
-{
-    page_migration_record_t rec{};
-    auto&                   e = rec.page_migrate;
-    uint32_t                kind{};
-    uint32_t                trigger{};
-
-    std::sscanf(str.data(),
-                uvm_event_info<ROCPROFILER_UVM_EVENT_MIGRATE_END>::format_str.data(),
-                &kind,
-                &rec.end_timestamp,
-                &rec.pid,
-                &e.start_addr,
-                &e.end_addr,
-                &e.from_node,
-                &e.to_node,
-                &trigger);
+bool
+parse_uvm_event<ROCPROFILER_UVM_EVENT_MIGRATE_END>(std::string_view         str,
+                                                   page_migration_record_t& rec)
+{
+    auto&    e       = rec.page_migrate;
+    uint32_t kind    = {};
+    int32_t  trigger = {};
+
+    auto _cursor = smi_cursor{str};
+    _cursor.hex(kind)
+        .dec(rec.end_timestamp)
+        .skip('-')
+        .dec(rec.pid)
+        .skip('@')
+        .hex(e.start_addr)
+        .skip('(')
+        .hex(e.end_addr)
+        .skip(')')
+        .hex(e.from_node)
+        .skip('-')
+        .skip('>')
+        .hex(e.to_node)
+        .dec(trigger);
 
     e.end_addr += e.start_addr;
     e.trigger    = static_cast<migrate_trigger_t>(trigger);
     e.start_addr = page_to_bytes(e.start_addr);
     e.end_addr   = page_to_bytes(e.end_addr) - 1;
 
-    ROCP_INFO << fmt::format("Page migrate end [ ts: {} pid: {} addr s: 0x{:X} addr e: "
-                             "0x{:X} from node: {} to node: {} trigger: {} ] \n",
-                             rec.end_timestamp,
-                             rec.pid,
-                             e.start_addr,
-                             e.end_addr,
-                             e.from_node,
-                             e.to_node,
-                             to_string(e.trigger));
-
-    return rec;
+    ROCP_TRACE << fmt::format("Page migrate end [ ts: {} pid: {} addr s: 0x{:X} addr e: "
+                              "0x{:X} from node: {} to node: {} trigger: {} ] \n",
+                              rec.end_timestamp,
+                              rec.pid,
+                              e.start_addr,
+                              e.end_addr,
+                              e.from_node,
+                              e.to_node,
+                              to_string(e.trigger));
+
+    return static_cast<bool>(_cursor);
 }
 
 template <>
-page_migration_record_t
-parse_uvm_event<ROCPROFILER_UVM_EVENT_QUEUE_EVICTION>(std::string_view str)
-{
-    page_migration_record_t rec{};
-    auto&                   e = rec.queue_suspend;
-    uint32_t                kind{};
-    uint32_t                trigger{};
-
-    std::sscanf(str.data(),
-                uvm_event_info<ROCPROFILER_UVM_EVENT_QUEUE_EVICTION>::format_str.data(),
-                &kind,
-                &rec.start_timestamp,
-                &rec.pid,
-                &e.node_id,
-                &trigger);
+bool
+parse_uvm_event<ROCPROFILER_UVM_EVENT_QUEUE_EVICTION>(std::string_view         str,
+                                                      page_migration_record_t& rec)
+{
+    auto&    e       = rec.queue_suspend;
+    uint32_t kind    = {};
+    int32_t  trigger = {};
+
+    auto _cursor = smi_cursor{str};
+    _cursor.hex(kind).dec(rec.start_timestamp).skip('-').dec(rec.pid).hex(e.node_id).dec(trigger);
 
     rec.queue_suspend.trigger = static_cast<qsuspend_trigger_t>(trigger);
 
-    ROCP_INFO << fmt::format("Queue evict [ ts: {} pid: {} node: {} trigger: {} ] \n",
-                             rec.start_timestamp,
-                             rec.pid,
-                             e.node_id,
-                             to_string(e.trigger));
+    ROCP_TRACE << fmt::format("Queue evict [ ts: {} pid: {} node: {} trigger: {} ] \n",
+                              rec.start_timestamp,
+                              rec.pid,
+                              e.node_id,
+                              to_string(e.trigger));
 
-    return rec;
+    return static_cast<bool>(_cursor);
 }
 
 template <>
-page_migration_record_t
-parse_uvm_event<ROCPROFILER_UVM_EVENT_QUEUE_RESTORE>(std::string_view str)
-{
-    page_migration_record_t rec{};
-    auto&                   e = rec.queue_suspend;
-    uint32_t                kind{};
-
-    std::sscanf(str.data(),
-                uvm_event_info<ROCPROFILER_UVM_EVENT_QUEUE_RESTORE>::format_str.data(),
-                &kind,
-                &rec.end_timestamp,
-                &rec.pid,
-                &e.node_id);
-    // check if we have a valid char at the end. -1 has \0
-    if(str[str.size() - 2] == 'R')
-        e.rescheduled = true;
-    else
-        e.rescheduled = false;
+bool
+parse_uvm_event<ROCPROFILER_UVM_EVENT_QUEUE_RESTORE>(std::string_view         str,
+                                                     page_migration_record_t& rec)
+{
+    auto&    e    = rec.queue_suspend;
+    uint32_t kind = {};
 
-    ROCP_INFO << fmt::format(
+    auto _cursor = smi_cursor{str};
+    _cursor.hex(kind).dec(rec.end_timestamp).skip('-').dec(rec.pid).hex(e.node_id);
+
+    // the queue restore is followed by 'R' if the queue was rescheduled
+    e.rescheduled = (_cursor.peek() == 'R');
+
+    ROCP_TRACE << fmt::format(
         "Queue restore [ ts: {} pid: {} node: {} ] \n", rec.end_timestamp, rec.pid, e.node_id);
 
-    return rec;
+    return static_cast<bool>(_cursor);
 }
 
 template <>
-page_migration_record_t
-parse_uvm_event<ROCPROFILER_UVM_EVENT_UNMAP_FROM_GPU>(std::string_view str)
-{
-    page_migration_record_t rec{};
-    auto&                   e = rec.unmap_from_gpu;
-    uint32_t                kind{};
-    uint32_t                trigger{};
-
-    std::sscanf(str.data(),
-                uvm_event_info<ROCPROFILER_UVM_EVENT_UNMAP_FROM_GPU>::format_str.data(),
-                &kind,
-                &rec.start_timestamp,
-                &rec.pid,
-                &e.start_addr,
-                &e.end_addr,
-                &e.node_id,
-                &trigger);
+bool
+parse_uvm_event<ROCPROFILER_UVM_EVENT_UNMAP_FROM_GPU>(std::string_view         str,
+                                                      page_migration_record_t& rec)
+{
+    auto&    e       = rec.unmap_from_gpu;
+    uint32_t kind    = {};
+    int32_t  trigger = {};
+
+    auto _cursor = smi_cursor{str};
+    _cursor.hex(kind)
+        .dec(rec.start_timestamp)
+        .skip('-')
+        .dec(rec.pid)
+        .skip('@')
+        .hex(e.start_addr)
+        .skip('(')
+        .hex(e.end_addr)
+        .skip(')')
+        .hex(e.node_id)
+        .dec(trigger);
 
     e.end_addr += e.start_addr;
     rec.end_timestamp          = rec.start_timestamp;
@@ -402,36 +409,38 @@ parse_uvm_event<ROCPROFILER_UVM_EVENT_UNMAP_FROM_GPU>(std::string_view str)
     e.start_addr               = page_to_bytes(e.start_addr);
     e.end_addr                 = page_to_bytes(e.end_addr);
 
-    ROCP_INFO << fmt::format("Unmap from GPU [ ts: {} pid: {} start addr: 0x{:X} end addr: 0x{:X}  "
-                             "node: {} trigger {} ] \n",
-                             rec.start_timestamp,
-                             rec.pid,
-                             e.start_addr,
-                             e.end_addr,
-                             e.node_id,
-                             to_string(e.trigger));
+    ROCP_TRACE << fmt::format(
+        "Unmap from GPU [ ts: {} pid: {} start addr: 0x{:X} end addr: 0x{:X}  "
+        "node: {} trigger {} ] \n",
+        rec.start_timestamp,
+        rec.pid,
+        e.start_addr,
+        e.end_addr,
+        e.node_id,
+        to_string(e.trigger));
 
-    return rec;
+    return static_cast<bool>(_cursor);
 }
 
 template <size_t OpInx, size_t... OpInxs>
-page_migration_record_t
-parse_uvm_event(uvm_event_id_t   event_id,
-                std::string_view strn,
+bool
+parse_uvm_event(uvm_event_id_t           event_id,
+                std::string_view         strn,
+                page_migration_record_t& rec,
                 std::index_sequence<OpInx, OpInxs...>)
 {
     if(OpInx == static_cast<uint32_t>(event_id))
     {
-        auto rec      = parse_uvm_event<OpInx>(strn);
+        rec           = page_migration_record_t{};
         rec.size      = sizeof(page_migration_record_t);
         rec.kind      = ROCPROFILER_BUFFER_TRACING_PAGE_MIGRATION;
         rec.operation = to_rocprof_op(OpInx);
-        return rec;
+        return parse_uvm_event<OpInx>(strn, rec);
     }
     else if constexpr(sizeof...(OpInxs) > 0)
-        return parse_uvm_event(event_id, strn, std::index_sequence<OpInxs...>{});
+        return parse_uvm_event(event_id, strn, rec, std::index_sequence<OpInxs...>{});
     else
-        return page_migration_record_t{};
+        return false;
 }
 
 /* -----------------------------------------------------------------------------------*/
@@ -517,7 +526,8 @@ get_key<ROCPROFILER_PAGE_MIGRATION_QUEUE_SUSPEND>(
 /* -----------------------------------------------------------------------------------*/
 
 template <>
-page_migration_record_t parse_uvm_event<0>(std::string_view)
+bool
+parse_uvm_event<0>(std::string_view, page_migration_record_t&)
 {
     throw std::runtime_error("None Op for parsing UVM events should not happen");
 }
@@ -658,26 +668,135 @@ populate_contexts(int operation_idx, std::vector<buffered_context_data>& buffere
     }
 }
 
+/**
+ * Pairs the start record of an event with its end record. Open addressing with a fixed capacity,
+ * allocated on first use: a burst of start events without an end event cannot grow the memory of
+ * the polling thread. Start events which do not fit are dropped, i.e. their end event is reported
+ * without the data of the start event
+ */
+class event_table
+{
+public:
+    static constexpr size_t capacity = 4096;
+    static constexpr size_t max_size = (capacity * 3) / 4;
+
+    bool insert(uint64_t key, const page_migration_record_t& record);
+    bool extract(uint64_t key, page_migration_record_t& record);
+    void erase_before(uint64_t timestamp);
+
+private:
+    struct entry
+    {
+        uint64_t                key    = 0;
+        bool                    used   = false;
+        page_migration_record_t record = {};
+    };
+
+    static size_t next(size_t idx) { return (idx + 1) & (capacity - 1); }
+    static size_t home(uint64_t key);
+    void          erase(size_t idx);
+
+    size_t             m_size    = 0;
+    std::vector<entry> m_entries = {};
+};
+
+static_assert((event_table::capacity & (event_table::capacity - 1)) == 0,
+              "event table capacity must be a power of two");
+
+size_t
+event_table::home(uint64_t key)
+{
+    // keys are page addresses or (node, pid) pairs: mix the bits so that the low bits differ
+    key ^= (key >> 33);
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= (key >> 33);
+    return key & (capacity - 1);
+}
+
+bool
+event_table::insert(uint64_t key, const page_migration_record_t& record)
+{
+    if(m_entries.empty()) m_entries.resize(capacity);
+
+    // the table is never full so the probe sequence always ends at an unused entry
+    for(auto idx = home(key);; idx = next(idx))
+    {
+        auto& _entry = m_entries[idx];
+        if(!_entry.used)
+        {
+            if(m_size >= max_size) return false;
+            _entry = entry{key, true, record};
+            ++m_size;
+            return true;
+        }
+        else if(_entry.key == key)
+        {
+            _entry.record = record;
+            return true;
+        }
+    }
+}
+
+bool
+event_table::extract(uint64_t key, page_migration_record_t& record)
+{
+    if(m_size == 0) return false;
+
+    for(auto idx = home(key); m_entries[idx].used; idx = next(idx))
+    {
+        if(m_entries[idx].key == key)
+        {
+            record = m_entries[idx].record;
+            erase(idx);
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+event_table::erase_before(uint64_t timestamp)
+{
+    for(size_t idx = 0; idx < m_entries.size() && m_size > 0;)
+    {
+        // erasing shifts the next entry of the probe sequence into idx
+        if(m_entries[idx].used && m_entries[idx].record.start_timestamp < timestamp)
+            erase(idx);
+        else
+            ++idx;
+    }
+}
+
 void
-remove_events(events_cache_t& events, size_t timestamp)
+event_table::erase(size_t idx)
 {
-    for(auto map : events)
+    // backward shift deletion: the following entries of the probe sequence are moved into the
+    // hole unless their home is (cyclically) after the hole, so no tombstones are needed
+    auto hole = idx;
+    for(auto itr = next(hole); m_entries[itr].used; itr = next(itr))
     {
-        for(auto i = map.begin(); i != map.end(); ++i)
+        auto _home    = home(m_entries[itr].key);
+        bool _movable = (hole < itr) ? (_home <= hole || _home > itr)
+                                     : (_home <= hole && _home > itr);
+        if(_movable)
         {
-            if(i->second.start_timestamp < timestamp) map.erase(i);
+            m_entries[hole] = m_entries[itr];
+            hole            = itr;
         }
     }
+    m_entries[hole].used = false;
+    --m_size;
 }
 
 bool
-report_event(uvm_event_id_t                                      event_id,
-             rocprofiler_buffer_tracing_page_migration_record_t& end_record)
+report_event(uvm_event_id_t event_id, page_migration_record_t& end_record)
 {
     using rocprofiler_page_migr_seq = std::make_index_sequence<ROCPROFILER_PAGE_MIGRATION_LAST>;
+    using events_cache_t            = std::array<event_table, ROCPROFILER_PAGE_MIGRATION_LAST>;
+
     static thread_local events_cache_t EVENTS_CACHE{};
 
-    auto& events_map = EVENTS_CACHE[to_rocprof_op(event_id)];
+    auto& events_table = EVENTS_CACHE[to_rocprof_op(event_id)];
 
     switch(static_cast<uint32_t>(event_id))
     {
@@ -685,9 +804,9 @@ report_event(uvm_event_id_t                                      event_id,
         case ROCPROFILER_UVM_EVENT_PAGE_FAULT_START: [[fallthrough]];
         case ROCPROFILER_UVM_EVENT_QUEUE_EVICTION:
         {
-            // insert into map
-            auto key        = get_key(event_id, end_record, rocprofiler_page_migr_seq{});
-            events_map[key] = end_record;
+            auto key = get_key(event_id, end_record, rocprofiler_page_migr_seq{});
+            if(!events_table.insert(key, end_record))
+                ROCP_TRACE << "Page migration event table is full, dropping start event";
             return false;
         }
         // End events. Pair up and report
@@ -699,16 +818,18 @@ report_event(uvm_event_id_t                                      event_id,
         case ROCPROFILER_UVM_EVENT_PAGE_FAULT_END: [[fallthrough]];
         case ROCPROFILER_UVM_EVENT_QUEUE_RESTORE:
         {
-            auto key = get_key(event_id, end_record, rocprofiler_page_migr_seq{});
-            if(auto start_rec = events_map.find(key); start_rec != events_map.end())
+            auto key       = get_key(event_id, end_record, rocprofiler_page_migr_seq{});
+            auto start_rec = page_migration_record_t{};
+            if(events_table.extract(key, start_rec))
             {
-                update_end(event_id, start_rec->second, end_record);
+                update_end(event_id, start_rec, end_record);
             }
             else
             {
                 // we got an end record and can't find the start record
-                // drop everything in the map before this timestamp
-                remove_events(EVENTS_CACHE, end_record.end_timestamp);
+                // drop everything in the tables before this timestamp
+                for(auto& itr : EVENTS_CACHE)
+                    itr.erase_before(end_record.end_timestamp);
             }
             return true;
         }
@@ -719,18 +840,28 @@ report_event(uvm_event_id_t                                      event_id,
 void
 handle_reporting(std::string_view event_data)
 {
-    uint32_t kfd_event_id;
-    std::sscanf(event_data.data(), "%x ", &kfd_event_id);
-    std::vector<buffered_context_data> buffered_contexts{};
+    ROCP_TRACE << "KFD event: [" << event_data << "]";
+
+    uint32_t kfd_event_id = 0;
+    if(!smi_cursor{event_data}.hex(kfd_event_id)) return;
 
     auto uvm_event_op = kfd_to_uvm_op(static_cast<kfd_event_id_t>(kfd_event_id));
 
-    populate_contexts(uvm_event_op, buffered_contexts);
+    // reused for every event, the contexts are re-populated without allocating
+    static thread_local auto buffered_contexts = std::vector<buffered_context_data>{};
+    populate_contexts(to_rocprof_op(uvm_event_op), buffered_contexts);
     if(buffered_contexts.empty()) return;
 
     // Parse and process the event
-    auto record = parse_uvm_event(
-        uvm_event_op, event_data, std::make_index_sequence<ROCPROFILER_UVM_EVENT_LAST>{});
+    auto record = page_migration_record_t{};
+    if(!parse_uvm_event(uvm_event_op,
+                        event_data,
+                        record,
+                        std::make_index_sequence<ROCPROFILER_UVM_EVENT_LAST>{}))
+    {
+        ROCP_TRACE << "Malformed KFD event: [" << event_data << "]";
+        return;
+    }
 
     // pair up start and end and only then insert it into the buffer
     if(report_event(uvm_event_op, record))
@@ -785,6 +916,23 @@ ioctl(int kfd_fd, T& args)
     return exit_code;
 }
 
+// reads the available SMI events of the file descriptor and handles every complete event line.
+// Returns the number of bytes read
+ssize_t
+read_events(fd_t fd, std::string& scratch_buffer, smi_line_reader& reader, uint64_t& num_events)
+{
+    auto status_size = ::read(fd, scratch_buffer.data(), scratch_buffer.size());
+    if(status_size > 0)
+    {
+        reader(std::string_view{scratch_buffer.data(), static_cast<size_t>(status_size)},
+               [&num_events](std::string_view event_str) {
+                   ++num_events;
+                   handle_reporting(event_str);
+               });
+    }
+    return status_size;
+}
+
 struct kfd_device_fd
 {
     fd_t fd{-1};
@@ -976,6 +1124,11 @@ poll_events(small_vector<pollfd> file_handles, bool non_blocking)
     std::string      scratch_buffer(PREALLOCATE_ELEMENT_COUNT, '\0');
     auto&            exitfd      = file_handles[1];
     const auto       timeout_val = non_blocking == true ? 0 : -1;
+    uint64_t         num_events  = 0;
+
+    // each GPU has its own stream of events, i.e. a line split across two reads of a GPU is
+    // completed by the next read of the same GPU
+    auto line_readers = std::vector<smi_line_reader>(file_handles.size());
 
     // Wait or spin on events.
     //  0 -> return immediately even if no events
@@ -1003,7 +1156,7 @@ poll_events(small_vector<pollfd> file_handles, bool non_blocking)
 
         if((exitfd.revents & POLLIN) != 0)
         {
-            ROCP_INFO << "Terminating background thread\n";
+            ROCP_INFO << fmt::format("Terminating background thread ({} events)\n", num_events);
             return;
         }
 
@@ -1015,17 +1168,7 @@ poll_events(small_vector<pollfd> file_handles, bool non_blocking)
 
             // We have data to read, perhaps multiple events
             if((fd.revents & POLLIN) != 0)
-            {
-                size_t status_size = read(fd.fd, scratch_buffer.data(), scratch_buffer.size());
-
-                // ROCP_INFO << fmt::format(
-                //     "status_size: {} size {}\n", status_size, scratch_buffer.size());
-                std::string_view event_strings{scratch_buffer.data(), status_size};
-
-                // ROCP_INFO << fmt::format("Raw KFD string [({})]\n",
-                // event_strings.data());
-                KFD_EVENT_PARSE_EVENTS(event_strings, handle_reporting);
-            }
+                read_events(fd.fd, scratch_buffer, line_readers[i], num_events);
             fd.revents = 0;
         }
     }
@@ -1123,6 +1266,29 @@ finalize()
     }
 }
 
+uint64_t
+replay(std::string_view filename, size_t read_size)
+{
+    auto fd = ::open(std::string{filename}.c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd == -1)
+    {
+        ROCP_ERROR << fmt::format("Could not open KFD SMI event file '{}'", filename);
+        return 0;
+    }
+
+    auto     scratch_buffer = std::string(std::max<size_t>(read_size, 1), '\0');
+    auto     reader         = smi_line_reader{};
+    uint64_t num_events     = 0;
+    ssize_t  status_size    = 0;
+    do
+    {
+        status_size = kfd::read_events(fd, scratch_buffer, reader, num_events);
+    } while(status_size > 0);
+
+    close(fd);
+    return num_events;
+}
+
 const char*
 name_by_id(uint32_t id)
 {
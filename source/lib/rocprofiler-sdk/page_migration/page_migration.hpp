@@ -26,6 +26,11 @@
 
 #include <rocprofiler-sdk/rocprofiler.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
 namespace rocprofiler
 {
 namespace page_migration
@@ -41,5 +46,11 @@ init();
 
 void
 finalize();
+
+/// Handles a recorded stream of KFD SMI events, i.e. the data read from the SMI event file
+/// descriptor of a GPU, as if it was read by the polling thread. The file is read in blocks of
+/// read_size bytes. Returns the number of events
+uint64_t
+replay(std::string_view filename, size_t read_size = 1024 * 128);
 }  // namespace page_migration
 }  // namespace rocprofiler
@@ -27,8 +27,12 @@
 #include <rocprofiler-sdk/buffer_tracing.h>
 #include <rocprofiler-sdk/fwd.h>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <cstdint>
-#include <unordered_map>
+#include <string>
+#include <string_view>
 #include <utility>
 
 namespace rocprofiler
@@ -172,10 +176,6 @@ using rocprof_buffer_op_t = rocprofiler_page_migration_operation_t;
 
 using node_fd_t = int;
 
-using event_map_t =
-    std::unordered_map<uint64_t, rocprofiler_buffer_tracing_page_migration_record_t>;
-using events_cache_t = std::array<event_map_t, ROCPROFILER_PAGE_MIGRATION_LAST>;
-
 template <size_t... Ints>
 constexpr size_t to_kfd_bitmask(std::index_sequence<Ints...>)
 {
@@ -214,5 +214,123 @@ is_rocprof_uvm_map(size_t uvm_event)
     return _is_rocprof_uvm_map<RocprofOpIdx>(
         uvm_event, std::make_index_sequence<ROCPROFILER_UVM_EVENT_LAST>{});
 }
+
+/**
+ * Tokenizer for a KFD SMI event line, e.g. "7 1234567 -42 @7f001(1) W". The fields are parsed in
+ * place, i.e. without copying the line and without sscanf. Leading spaces are skipped before every
+ * field. A field which does not match the grammar invalidates the cursor and the following fields
+ * are not parsed
+ */
+struct smi_cursor
+{
+    explicit smi_cursor(std::string_view line)
+    : pos{line.data()}
+    , end{line.data() + line.size()}
+    {}
+
+    template <typename Tp>
+    smi_cursor& hex(Tp& value)
+    {
+        return parse(value, 16);
+    }
+
+    template <typename Tp>
+    smi_cursor& dec(Tp& value)
+    {
+        return parse(value, 10);
+    }
+
+    /// matches a literal character, e.g. the '@' preceding an address
+    smi_cursor& skip(char value)
+    {
+        skip_spaces();
+        if(valid && pos != end && *pos == value)
+            ++pos;
+        else
+            valid = false;
+        return *this;
+    }
+
+    smi_cursor& chr(char& value)
+    {
+        skip_spaces();
+        if(valid && pos != end)
+            value = *pos++;
+        else
+            valid = false;
+        return *this;
+    }
+
+    /// next non-space character or '\0' at the end of the line
+    char peek()
+    {
+        skip_spaces();
+        return (valid && pos != end) ? *pos : '\0';
+    }
+
+    explicit operator bool() const { return valid; }
+
+private:
+    template <typename Tp>
+    smi_cursor& parse(Tp& value, int base)
+    {
+        skip_spaces();
+        if(!valid) return *this;
+
+        auto _result = std::from_chars(pos, end, value, base);
+        if(_result.ec != std::errc{})
+            valid = false;
+        else
+            pos = _result.ptr;
+        return *this;
+    }
+
+    void skip_spaces()
+    {
+        while(pos != end && *pos == ' ')
+            ++pos;
+    }
+
+    const char* pos   = nullptr;
+    const char* end   = nullptr;
+    bool        valid = true;
+};
+
+/**
+ * Splits the data read from an SMI event file descriptor into event lines. A read may end in the
+ * middle of an event: the incomplete line is kept and completed by the next read. Only such split
+ * lines are copied, every other line is passed to the handler in place
+ */
+struct smi_line_reader
+{
+    template <typename FuncT>
+    void operator()(std::string_view data, FuncT&& handler)
+    {
+        if(!pending.empty())
+        {
+            auto _nl = data.find('\n');
+            if(_nl == std::string_view::npos)
+            {
+                pending.append(data);
+                return;
+            }
+
+            pending.append(data.substr(0, _nl));
+            handler(std::string_view{pending});
+            pending.clear();
+            data.remove_prefix(_nl + 1);
+        }
+
+        for(auto _nl = data.find('\n'); _nl != std::string_view::npos; _nl = data.find('\n'))
+        {
+            if(_nl > 0) handler(data.substr(0, _nl));
+            data.remove_prefix(_nl + 1);
+        }
+
+        pending.assign(data);
+    }
+
+    std::string pending = {};
+};
 }  // namespace page_migration
 }  // namespace rocprofiler
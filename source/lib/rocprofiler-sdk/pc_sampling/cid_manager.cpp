@@ -23,18 +23,114 @@
 #include "lib/rocprofiler-sdk/pc_sampling/cid_manager.hpp"
 
 #include <algorithm>
+#include <limits>
+#include <utility>
 
 namespace rocprofiler
 {
 namespace pc_sampling
 {
+namespace
+{
+uint64_t
+get_next_manager_id()
+{
+    static auto _id = std::atomic<uint64_t>{0};
+    return ++_id;
+}
+}  // namespace
+
+PCSCIDManager::completion_list::completion_list()
+: head{new chunk{}}
+, tail{head}
+{}
+
+PCSCIDManager::completion_list::~completion_list()
+{
+    while(head)
+    {
+        auto* next = head->next.load(std::memory_order_acquire);
+        delete head;
+        head = next;
+    }
+}
+
 void
-PCSCIDManager::cid_async_activity_completed(context::correlation_id* cid)
+PCSCIDManager::completion_list::push(completed_cid_t entry)
+{
+    auto idx = tail->size.load(std::memory_order_relaxed);
+    if(idx == chunk::capacity)
+    {
+        // the consumer releases the full chunk once it observes the next chunk, so the producer
+        // must not access the full chunk after publishing the next one
+        auto* next = new chunk{};
+        tail->next.store(next, std::memory_order_release);
+        tail = next;
+        idx  = 0;
+    }
+
+    tail->entries[idx] = entry;
+    // publish the entry to the consumer
+    tail->size.store(idx + 1, std::memory_order_release);
+}
+
+void
+PCSCIDManager::completion_list::consume(uint64_t                               max_epoch,
+                                        std::vector<context::correlation_id*>& out)
 {
-    // Hold the lock while updating the state of PCSCIDManager
+    while(true)
+    {
+        auto size = head->size.load(std::memory_order_acquire);
+        // the epochs of a single thread are non-decreasing so stop at the first entry which
+        // cannot be retired yet
+        for(; read < size; ++read)
+        {
+            const auto& itr = head->entries[read];
+            if(itr.epoch > max_epoch) return;
+            out.emplace_back(itr.cid);
+        }
+
+        if(read < chunk::capacity) return;
+
+        auto* next = head->next.load(std::memory_order_acquire);
+        if(!next) return;
+
+        delete head;
+        head = next;
+        read = 0;
+    }
+}
+
+PCSCIDManager::PCSCIDManager(PCSamplingParserContext* parser)
+: manager_id{get_next_manager_id()}
+, pcs_parser(parser)
+{}
+
+PCSCIDManager::completion_list*
+PCSCIDManager::get_completion_list()
+{
+    // the lists are looked up via the unique id of the manager (instead of its address) because
+    // the entries of the thread-local map outlive the manager
+    static thread_local auto _lists = std::vector<std::pair<uint64_t, completion_list*>>{};
+
+    for(const auto& itr : _lists)
+        if(itr.first == manager_id) return itr.second;
+
+    // first kernel completion on this thread: register a new list
     std::unique_lock<std::mutex> lock(m);
-    // The kernel of the `cid` completed, so add cid to `q1`.
-    q1.emplace_back(cid);
+    auto* list = completion_lists.emplace_back(std::make_unique<completion_list>()).get();
+    _lists.emplace_back(manager_id, list);
+    return list;
+}
+
+void
+PCSCIDManager::cid_async_activity_completed(context::correlation_id* cid)
+{
+    // The kernel of the `cid` completed, so append it to the list of this thread along with the
+    // current epoch. No lock is required: the list has a single producer.
+    // Note: reading the epoch after the kernel completed is conservative. If a flush starts
+    // between the completion and the read, the CID is just retired one flush later.
+    get_completion_list()->push({cid, epoch.load(std::memory_order_acquire)});
 }
 
 void
@@ -42,24 +138,21 @@ PCSCIDManager::manage_cids_implicit(const pc_samples_copy_fn_t& pc_samples_copy_
 {
     std::vector<context::correlation_id*> q3;
     {
-        // To manipulate the contents of q1 and q2 and change the state of PCSCIDManager,
-        // acquire the lock.
+        // Consuming the completion lists requires the lock.
         std::unique_lock<std::mutex> lock(m);
-        // Move all CIDs from q2 to the q3 local for this function.
-        // Note: two buffer flushes happened since kernels of q3's CIDs completed.
-        q3 = std::move(q2);
-        // Move all CIDs from q1 to q2.
-        // Note: exactly one buffer flush occured since kernels of q2's CIDs completed.
-        q2 = std::move(q1);
-
-        // We move CIDs from one queue to another to reflect that an implicit ROCr's buffer flush
-        // occured. move from q1 to q2 reflects the first buffer flush since kernels of q1's CIDs
-        // completed move from q2 to local q3 reflects the second buffer flush since kernels of q2's
-        // CIDs completed.
-
-        // Empty the q1 to indicate that there are no CIDs with the following property:
-        // no buffer flush occured since the kernel of CID is marked completed.
-        q1.clear();
+
+        // Advance the epoch to reflect that an implicit ROCr's buffer flush occured.
+        // This is the first buffer flush since the kernels of the CIDs completed in `_epoch`
+        // and the second buffer flush since the kernels of the CIDs completed in an earlier
+        // epoch.
+        auto _epoch = epoch.fetch_add(1, std::memory_order_acq_rel);
+
+        // Collect all CIDs which have seen two buffer flushes into q3 local for this function.
+        if(_epoch > 0)
+        {
+            for(auto& itr : completion_lists)
+                itr->consume(_epoch - 1, q3);
+        }
 
         // The code that follows does not change the state of the PCSCIDManager, so release the lock
         // implicitly.
@@ -81,21 +174,15 @@ PCSCIDManager::manage_cids_implicit(const pc_samples_copy_fn_t& pc_samples_copy_
 void
 PCSCIDManager::manage_cids_explicit(const pc_samples_copy_fn_t& pc_samples_explicit_flush_fn)
 {
-    std::vector<context::correlation_id*> q1_copy;
-    std::vector<context::correlation_id*> q2_copy;
+    std::vector<context::correlation_id*> q_copy;
     {
-        // To manipulate the contents of q1 and q2 and change the state of PCSCIDManager,
-        // acquire the lock.
+        // Consuming the completion lists requires the lock.
         std::unique_lock<std::mutex> lock(m);
 
-        // Move all CIDs from q1 and q2 to local q1_copy and q2_copy, respectively
-        q1_copy = std::move(q1);
-        q2_copy = std::move(q2);
-
-        // Drop CIDs from q1 and q2, because the following explicit flush
-        // will deliver corresponding samples.
-        q1.clear();
-        q2.clear();
+        // Collect all CIDs whose kernels completed so far regardless of their epoch, because the
+        // following explicit flush will deliver corresponding samples.
+        for(auto& itr : completion_lists)
+            itr->consume(std::numeric_limits<uint64_t>::max(), q_copy);
 
         // The code that follows does not change the state of the PCSCIDManager, so release the lock
         // implicitly.
@@ -104,17 +191,16 @@ PCSCIDManager::manage_cids_explicit(const pc_samples_copy_fn_t& pc_samples_expli
     // Call the passed lambda function to initiate an explicit flush of ROCr buffer by leveraging
     // the `hsa_ven_amd_pcs_flush flush`. The latter function guarantees delivery of all samples
     // generated (sequenced) before the call to the `hsa_ven_amd_pcs_flush`.
-    // Thus, all samples corresponding to CIDs of `q1_copy` and `q2_copy` will be copied
+    // Thus, all samples corresponding to CIDs of `q_copy` will be copied
     // from the ROCr's buffer to the SDK's buffer,
-    // meaning CIDs of `q1_copy` and `q2_copy` will not be used anymore by the PC sampling service.
+    // meaning CIDs of `q_copy` will not be used anymore by the PC sampling service.
     pc_samples_explicit_flush_fn();
 
-    // The PC sampling service will not use q1_copy's and q2_copy's CIDs anymore, so it decrements
+    // The PC sampling service will not use q_copy's CIDs anymore, so it decrements
     // their CIDs. Eventually, CIDs retirement service will report retirement of these CIDs to the
-    // client tool. Note: both `q1_copy` and `q2_copy` are local to the function, so there is no
+    // client tool. Note: `q_copy` is local to the function, so there is no
     // need for inter-thread synchronization.
-    retire_cids_of(q1_copy);
-    retire_cids_of(q2_copy);
+    retire_cids_of(q_copy);
 }
 
 /**
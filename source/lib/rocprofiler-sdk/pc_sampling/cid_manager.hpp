@@ -25,7 +25,12 @@
 #include "lib/rocprofiler-sdk/context/correlation_id.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -75,14 +80,59 @@ namespace pc_sampling
  */
 class PCSCIDManager
 {
-    /// A lock that must be hold while updating the state of PCSCIDManager.
+    /// A completed correlation ID and the flush epoch observed when its kernel completed.
+    struct completed_cid_t
+    {
+        context::correlation_id* cid   = nullptr;
+        uint64_t                 epoch = 0;
+    };
+
+    /// Append-only list of completed correlation IDs of a single thread invoking
+    /// `cid_async_activity_completed` (single producer). The list is consumed by the sample path
+    /// while holding @p m (single consumer), which releases the chunks it has fully consumed.
+    struct completion_list
+    {
+        struct chunk
+        {
+            static constexpr size_t capacity = 256;
+
+            std::array<completed_cid_t, capacity> entries = {};
+            std::atomic<size_t>                   size    = 0;
+            std::atomic<chunk*>                   next    = nullptr;
+        };
+
+        completion_list();
+        ~completion_list();
+
+        completion_list(const completion_list&) = delete;
+        completion_list& operator=(const completion_list&) = delete;
+
+        /// Called by the owning thread only. Never blocks.
+        void push(completed_cid_t entry);
+
+        /// Called while holding @p m. Moves the entries to @p out in completion order, stopping at
+        /// the first entry completed in an epoch later than @p max_epoch.
+        void consume(uint64_t max_epoch, std::vector<context::correlation_id*>& out);
+
+        chunk* head = nullptr;  ///< oldest chunk, owned by the consumer
+        size_t read = 0;        ///< number of consumed entries of head
+        chunk* tail = nullptr;  ///< newest chunk, owned by the producer
+    };
+
+    /// Returns the completion list of the calling thread, registering it on the first call.
+    completion_list* get_completion_list();
+
+    /// Serializes the consumers of the completion lists and the registration of new lists.
+    /// Never acquired while a kernel completion is being recorded for a registered thread.
     std::mutex m;
-    /// Correlation IDs with the following property: no ROCr's buffer flush happened
-    /// since a corresponding kernel completed
-    std::vector<context::correlation_id*> q1;
-    /// Correlation IDs with the following property: exactly one ROCr's buffer flush occured
-    /// since a corresponding kernel completed
-    std::vector<context::correlation_id*> q2;
+    /// Number of implicit ROCr's buffer flushes (i.e. `data_ready_callback` invocations) that
+    /// started so far. A CID whose kernel completed in epoch E can be retired by the flush which
+    /// advances the epoch from E + 1, i.e. the second flush started after the kernel completed.
+    std::atomic<uint64_t> epoch = 0;
+    /// Completion lists of all the threads which have completed a kernel.
+    std::vector<std::unique_ptr<completion_list>> completion_lists;
+    /// Unique identifier used to find the completion list of the calling thread.
+    const uint64_t manager_id;
     /// A pointer to the PC sampling parser to be notified when the CID is retired.
     PCSamplingParserContext* pcs_parser = nullptr;
 
@@ -90,9 +140,7 @@ class PCSCIDManager
     void retire_cids_of(std::vector<context::correlation_id*>& q);
 
 public:
-    PCSCIDManager(PCSamplingParserContext* parser)
-    : pcs_parser(parser)
-    {}
+    PCSCIDManager(PCSamplingParserContext* parser);
 
     /// Called by the `kernel_completion_callback` to mark the kernel matching @p cid completed.
     void cid_async_activity_completed(context::correlation_id* cid);
@@ -51,6 +51,10 @@ namespace hsa
 {
 namespace
 {
+static_assert(utils::get_hsa_pcs_buffer_size() / sizeof(perf_sample_hosttrap_v1_t) ==
+                  PCSamplingParserContext::max_samples_per_notification,
+              "the parser splits batches based on the number of samples in the ROCr buffer");
+
 const PCSAgentSession*
 get_pcs_session_of(hsa_agent_t hsa_agent)
 {
@@ -115,27 +119,6 @@ amd_intercept_marker_handler_callback(const struct amd_aql_intercept_marker_s* p
     parser->newDispatch(dispatch_pkt);
 }
 
-/**
- * Callback called by HSA interceptor when the kernel has completed.
- */
-void
-kernel_completion_cb(const rocprofiler_agent_t* rocp_agent,
-                     rocprofiler::hsa::rocprofiler_packet& /*kernel_pkt*/,
-                     const rocprofiler::hsa::Queue::queue_info_session_t& session)
-{
-    // No internal correlation IDs, meaning there is no need to call CID manager.
-    if(!session.correlation_id) return;
-
-    // Check if the PC sampling service is configured on this agent.
-    if(!is_pc_sample_service_configured(rocp_agent->id)) return;
-
-    auto* service = get_configured_pc_sampling_service().load();
-    assert(service);
-    auto* agent_session = service->agent_sessions.at(rocp_agent->id).get();
-    // Mark the correlation ID as completed
-    agent_session->cid_manager->cid_async_activity_completed(session.correlation_id);
-}
-
 void
 data_ready_callback(void*                                client_callback_data,
                     size_t                               data_size,
@@ -153,12 +136,12 @@ data_ready_callback(void*                                client_callback_data,
     // process of retiring correlation IDs.
     agent_session->cid_manager->manage_cids_implicit([&]() {
         size_t samples_num = data_size / sizeof(packet_union_t);
-        // allocate a temporary buffer for copying PC samples
-        // TODO: think about how to optimize this (e.g., introduce a buffer pool)
-        auto buff = std::make_unique<packet_union_t[]>(samples_num);
+        // reuse a staging buffer for copying PC samples. The buffer returns to the pool when
+        // it goes out of scope, i.e., after the samples are parsed into the SDK's buffer
+        auto buff = agent_session->staging_pool->acquire(samples_num);
 
         // copy all the data
-        data_copy_callback(hsa_callback_data, data_size, buff.get());
+        data_copy_callback(hsa_callback_data, data_size, buff.data());
 
         upcoming_samples_t upc;
         // rocp_agent handle uniquely identifies the device
@@ -173,7 +156,7 @@ data_ready_callback(void*                                client_callback_data,
 
         auto gfx_major         = ((agent_session->agent->gfx_target_version / 10000) % 100);
         auto pcs_parser_status = agent_session->parser->parse(
-            upc, reinterpret_cast<const generic_sample_t*>(buff.get()), gfx_major, cv, false);
+            upc, reinterpret_cast<const generic_sample_t*>(buff.data()), gfx_major, cv, false);
 
         if(pcs_parser_status != PCSAMPLE_STATUS_SUCCESS)
         {
@@ -183,12 +166,35 @@ data_ready_callback(void*                                client_callback_data,
 }
 }  // namespace
 
+/**
+ * Callback called by HSA interceptor when the kernel has completed.
+ */
+void
+kernel_completion_cb(const rocprofiler_agent_t* rocp_agent,
+                     rocprofiler::hsa::rocprofiler_packet& /*kernel_pkt*/,
+                     const rocprofiler::hsa::Queue::queue_info_session_t& session)
+{
+    // No internal correlation IDs, meaning there is no need to call CID manager.
+    if(!session.correlation_id) return;
+
+    // No marker packet has been injected for the kernel (e.g. PC sampling is not configured on
+    // this agent or the kernel has been dispatched while the service was stopped), so the
+    // correlation ID has not been registered with the parser and the CID manager.
+    if(!session.pc_sampling_marker) return;
+
+    auto* service = get_configured_pc_sampling_service().load();
+    assert(service);
+    auto* agent_session = service->agent_sessions.at(rocp_agent->id).get();
+    // Mark the correlation ID as completed
+    agent_session->cid_manager->cid_async_activity_completed(session.correlation_id);
+}
+
 rocprofiler::hsa::rocprofiler_packet
 generate_marker_packet_for_kernel(
     context::correlation_id*                      correlation_id,
     const tracing::external_correlation_id_map_t& external_correlation_ids)
 {
-    // This function executes for each kernel dispatched to the agent on which
+    // By default, this function executes for each kernel dispatched to the agent on which
     // the PC sampling service is configured.
     // By doing this, we allow the following scenario to happen:
     // A tool configures PC sampling on an agent and offloads some kernels on that agent.
@@ -197,7 +203,9 @@ generate_marker_packet_for_kernel(
     // at the moment of dispatching kernels, the configured PC sampling service is aware of all
     // kernels dispatched on the agent and can recreate their correlation IDs.
     // The disadvantage of this approach is that it introduces overhead when PC sampling
-    // service is inactive/stopped.
+    // service is inactive/stopped. With ROCPROFILER_PC_SAMPLING_MARKERS_WHILE_ACTIVE,
+    // this function executes only while the service is active
+    // (see `is_pc_sample_marker_required`).
     amd_aql_intercept_marker_t marker_pkt;
     marker_pkt.header   = HSA_PACKET_TYPE_VENDOR_SPECIFIC;
     marker_pkt.format   = AMD_AQL_FORMAT_INTERCEPT_MARKER;
@@ -209,11 +217,10 @@ generate_marker_packet_for_kernel(
         // Use the internal correlation ID generated by the tracing service.
         marker_pkt.user_data[0] = correlation_id->internal;
 
-        // Find a context that holds PC sampling service.
-        auto contexts = context::get_registered_contexts(
-            [](const auto* ctx) { return ctx->pc_sampler != nullptr; });
-        assert(contexts.size() == 1);
-        const auto* pcs_context = contexts.at(0);
+        // The context that holds PC sampling service.
+        const auto* service = get_configured_pc_sampling_service().load();
+        assert(service && service->ctx);
+        const auto* pcs_context = service->ctx;
 
         // Get an external correlation that corresponds to the context
         // enclosing PC sampling service.
@@ -299,6 +306,12 @@ pc_sampling_service_finish_configuration(context::pc_sampling_service* service)
         // Consequently, no PC samples will be delivered for this device.
         if(!agent_session->hsa_agent.has_value()) continue;
 
+        // The staging buffers must exist before ROCr starts delivering samples
+        agent_session->staging_pool = std::make_unique<PCSStagingPool>(
+            pc_sampling::utils::get_pcs_staging_buffer_samples(
+                agent_session->agent, agent_session->unit, agent_session->interval),
+            pc_sampling::utils::get_pcs_staging_buffer_count());
+
         // Create PC sampling session on the ROCr level.
         // ROCr reuses IOCTL session with `agent_session->ioctl_pcs_id`.
         hsa_status_t status = pc_sampling_table_->hsa_ven_amd_pcs_create_from_id_fn(
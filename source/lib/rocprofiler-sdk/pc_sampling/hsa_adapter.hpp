@@ -44,6 +44,12 @@ generate_marker_packet_for_kernel(
     context::correlation_id*                      correlation_id,
     const tracing::external_correlation_id_map_t& external_correlation_ids);
 
+/// Marks the correlation ID of a kernel completed, if a marker was injected for the kernel
+void
+kernel_completion_cb(const rocprofiler_agent_t*                           rocp_agent,
+                     rocprofiler::hsa::rocprofiler_packet&                kernel_pkt,
+                     const rocprofiler::hsa::Queue::queue_info_session_t& session);
+
 void
 pc_sampling_service_start(context::pc_sampling_service* service);
 
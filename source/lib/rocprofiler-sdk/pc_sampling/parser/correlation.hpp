@@ -31,6 +31,7 @@
 #include <iostream>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 template <>
@@ -94,11 +95,20 @@ namespace Parser
 /**
  * Coordinates DispatchMap and DoorBellMap to reconstruct the original correlation_id
  * from the correlation_id seen by the trap handler.
+ *
+ * The mapping is stored in an open-addressed (linear probing) table keyed by the device and the
+ * correlation_id seen by the trap handler. Entries are removed via backward-shift deletion so the
+ * table never accumulates tombstones, and lookups never throw: find() returns a nullptr for
+ * samples whose dispatch is unknown. find() is const and does not modify any state, so any
+ * number of threads may look up correlation ids concurrently as long as no dispatch is added or
+ * forgotten at the same time.
  */
 class CorrelationMap
 {
 public:
-    CorrelationMap() = default;
+    CorrelationMap()
+    : slots(min_capacity)
+    {}
 
     /**
      * Checks wether a dispatch pkt will generate a collision.
@@ -107,7 +117,7 @@ public:
     bool checkDispatch(const dispatch_pkt_id_t& pkt) const
     {
         auto trap = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
-        return dispatch_to_correlation.find({trap, pkt.device}) != dispatch_to_correlation.end();
+        return find(pkt.device, trap) != nullptr;
     }
 
     /**
@@ -115,9 +125,12 @@ public:
      */
     void newDispatch(const dispatch_pkt_id_t& pkt)
     {
-        cache_dev_id = ~0ul;
         auto trap_id = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
-        dispatch_to_correlation[{trap_id, pkt.device}] = pkt.correlation_id;
+        if(2 * (count + 1) > slots.size()) rehash(2 * slots.size());
+
+        auto idx = probe(pkt.device, trap_id);
+        if(!slots[idx].occupied) ++count;
+        slots[idx] = {trap_id.raw, pkt.device.handle, pkt.correlation_id, true};
     }
 
     /**
@@ -125,27 +138,42 @@ public:
      */
     void forget(const dispatch_pkt_id_t& pkt)
     {
-        cache_dev_id = ~0ul;
         auto trap_id = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
-        dispatch_to_correlation.erase({trap_id, pkt.device});
+        auto idx     = probe(pkt.device, trap_id);
+        if(!slots[idx].occupied) return;
+
+        // backward-shift deletion: move subsequent entries of the probe sequence into the hole
+        const auto mask = slots.size() - 1;
+        for(auto next = (idx + 1) & mask; slots[next].occupied; next = (next + 1) & mask)
+        {
+            auto home = hash(slots[next].dev, slots[next].trap) & mask;
+            // the entry can fill the hole if its home slot is not cyclically within (idx, next]
+            if(((next - home) & mask) >= ((next - idx) & mask))
+            {
+                slots[idx] = slots[next];
+                idx        = next;
+            }
+        }
+        slots[idx] = slot_t{};
+        --count;
     }
 
     /**
      * Given a device dev, doorbell and and wrapped dispatch_id,
-     * @returns the correlation_id set by dispatch_pkt_id_t
+     * @returns the correlation_id set by dispatch_pkt_id_t or nullptr if the dispatch is unknown
      */
-    rocprofiler_correlation_id_t get(device_handle dev, trap_correlation_id_t correlation_in)
+    const rocprofiler_correlation_id_t* find(device_handle         dev,
+                                             trap_correlation_id_t correlation_in) const
     {
-#ifndef _PARSER_CORRELATION_DISABLE_CACHE
-        if(dev.handle == cache_dev_id && correlation_in == cache_correlation_id_in)
-            return cache_correlation_id_out;
-#endif
-        cache_correlation_id_out = dispatch_to_correlation.at({correlation_in, dev});
-        cache_dev_id             = dev.handle;
-        cache_correlation_id_in  = correlation_in;
-        return cache_correlation_id_out;
+        const auto& itr = slots[probe(dev, correlation_in)];
+        return (itr.occupied) ? &itr.correlation_id : nullptr;
     }
 
+    /**
+     * @returns the number of dispatches currently mapped
+     */
+    size_t size() const { return count; }
+
     /**
      * Returns the correlation_id as seen by the trap handler, consisting of a
      * - wrapped dispatch_pkt
@@ -167,14 +195,47 @@ public:
     }
 
 private:
-    std::unordered_map<DispatchPkt, rocprofiler_correlation_id_t> dispatch_to_correlation{};
-
-    // Making get() const and these cache variables mutable causes performance to be unstable
-    trap_correlation_id_t        cache_correlation_id_in{.raw = ~0ul};  // Invalid value in cache
-    rocprofiler_correlation_id_t cache_correlation_id_out{
-        .internal = ~0ul,
-        .external = rocprofiler_user_data_t{.value = ~0ul}};
-    uint64_t cache_dev_id = ~0ul;  // Invalid device Id in cache
+    static constexpr size_t min_capacity = 256;  // must be a power of 2
+
+    struct slot_t
+    {
+        uint64_t                     trap           = 0;
+        uint64_t                     dev            = 0;
+        rocprofiler_correlation_id_t correlation_id = {};
+        bool                         occupied       = false;
+    };
+
+    static size_t hash(uint64_t dev, uint64_t trap)
+    {
+        // fibonacci hashing spreads the consecutive dispatch indexes of a queue
+        return ((trap ^ (dev << 35)) * 0x9E3779B97F4A7C15ul) >> 16;
+    }
+
+    // returns the slot holding the key or the empty slot where the key would be inserted
+    size_t probe(device_handle dev, trap_correlation_id_t trap) const
+    {
+        const auto mask = slots.size() - 1;
+        for(auto i = hash(dev.handle, trap.raw) & mask;; i = (i + 1) & mask)
+        {
+            const auto& itr = slots[i];
+            if(!itr.occupied || (itr.trap == trap.raw && itr.dev == dev.handle)) return i;
+        }
+    }
+
+    void rehash(size_t capacity)
+    {
+        auto old = std::vector<slot_t>(capacity);
+        std::swap(old, slots);
+        for(const auto& itr : old)
+        {
+            if(!itr.occupied) continue;
+            auto dev = device_handle{static_cast<uint32_t>(itr.dev)};
+            slots[probe(dev, trap_correlation_id_t{.raw = itr.trap})] = itr;
+        }
+    }
+
+    std::vector<slot_t> slots = {};
+    size_t              count = 0;
 };
 }  // namespace Parser
 
@@ -183,24 +244,42 @@ inline pcsample_status_t
 add_upcoming_samples(const device_handle               device,
                      const generic_sample_t*           buffer,
                      const size_t                      available_samples,
-                     Parser::CorrelationMap*           corr_map,
+                     const Parser::CorrelationMap*     corr_map,
                      rocprofiler_pc_sampling_record_t* samples)
 {
+    constexpr auto correlation_id_none =
+        rocprofiler_correlation_id_t{.internal = ROCPROFILER_CORRELATION_ID_VALUE_NONE,
+                                     .external = rocprofiler_user_data_t{
+                                         .value = ROCPROFILER_CORRELATION_ID_VALUE_NONE}};
+
+    // consecutive samples usually belong to the same dispatch. The cache is local to this call
+    // so that multiple threads can decode disjoint ranges of samples at the same time
+    uint64_t                            cache_correlation_id_in = ~0ul;  // Invalid value in cache
+    const rocprofiler_correlation_id_t* cache_correlation_id    = nullptr;
+
     pcsample_status_t status = PCSAMPLE_STATUS_SUCCESS;
     for(uint64_t p = 0; p < available_samples; p++)
     {
         const auto* snap = reinterpret_cast<const perf_sample_snapshot_v1*>(buffer + p);
         samples[p]       = copySample<bHostTrap, GFXIP>((const void*) (buffer + p));
         samples[p].size  = sizeof(rocprofiler_pc_sampling_record_t);
-        try
+
+#ifndef _PARSER_CORRELATION_DISABLE_CACHE
+        if(snap->correlation_id != cache_correlation_id_in)
+#endif
         {
             Parser::trap_correlation_id_t trap{.raw = snap->correlation_id};
-            samples[p].correlation_id = corr_map->get(device, trap);
-        } catch(std::exception& e)
+            cache_correlation_id    = corr_map->find(device, trap);
+            cache_correlation_id_in = trap.raw;
+        }
+
+        if(cache_correlation_id)
+        {
+            samples[p].correlation_id = *cache_correlation_id;
+        }
+        else
         {
-            samples[p].correlation_id = {.internal = ROCPROFILER_CORRELATION_ID_VALUE_NONE,
-                                         .external = rocprofiler_user_data_t{
-                                             .value = ROCPROFILER_CORRELATION_ID_VALUE_NONE}};
+            samples[p].correlation_id = correlation_id_none;
             status                    = PCSAMPLE_STATUS_PARSER_ERROR;
         }
     }
@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/pc_sampling/parser/parser_workers.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
+
+#include <algorithm>
+
+ParserWorkerPool::ParserWorkerPool(size_t num_threads)
+: m_num_threads{std::max<size_t>(num_threads, 1)}
+{}
+
+ParserWorkerPool::~ParserWorkerPool()
+{
+    {
+        auto lk = std::unique_lock<std::mutex>{m_mutex};
+        m_stop  = true;
+    }
+    m_start.notify_all();
+
+    for(auto& itr : m_threads)
+        itr.join();
+}
+
+void
+ParserWorkerPool::start()
+{
+    namespace internal_threading = ::rocprofiler::internal_threading;
+
+    m_threads.reserve(m_num_threads - 1);
+    for(size_t i = 1; i < m_num_threads; ++i)
+    {
+        internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+        m_threads.emplace_back(&ParserWorkerPool::work, this);
+        internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+    }
+}
+
+void
+ParserWorkerPool::run(size_t num_tasks, const task_func_t& func)
+{
+    if(num_tasks == 0) return;
+
+    if(num_tasks == 1 || m_num_threads == 1)
+    {
+        for(size_t i = 0; i < num_tasks; ++i)
+            func(i);
+        return;
+    }
+
+    // only one batch of tasks is executed by the pool at any time
+    auto run_lk = std::unique_lock<std::mutex>{m_run_mutex};
+    if(m_threads.empty()) start();
+
+    {
+        auto lk     = std::unique_lock<std::mutex>{m_mutex};
+        m_func      = &func;
+        m_num_tasks = num_tasks;
+        m_active    = m_threads.size();
+        m_next_task.store(0, std::memory_order_relaxed);
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    execute();
+
+    auto lk = std::unique_lock<std::mutex>{m_mutex};
+    m_done.wait(lk, [this]() { return m_active == 0; });
+    m_func = nullptr;
+}
+
+void
+ParserWorkerPool::execute()
+{
+    for(auto i = m_next_task.fetch_add(1); i < m_num_tasks; i = m_next_task.fetch_add(1))
+        (*m_func)(i);
+}
+
+void
+ParserWorkerPool::work()
+{
+    uint64_t generation = 0;
+    while(true)
+    {
+        {
+            auto lk = std::unique_lock<std::mutex>{m_mutex};
+            m_start.wait(lk, [this, generation]() { return m_stop || m_generation != generation; });
+            if(m_stop) return;
+            generation = m_generation;
+        }
+
+        execute();
+
+        {
+            auto lk = std::unique_lock<std::mutex>{m_mutex};
+            --m_active;
+        }
+        m_done.notify_one();
+    }
+}
@@ -0,0 +1,78 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fork-join pool used by PCSamplingParserContext to decode large batches of samples on
+ * multiple threads.
+ *
+ * run() splits the work into tasks which are executed by the calling thread together with the
+ * worker threads and only returns once all tasks completed, i.e. the samples are decoded in place
+ * before the caller proceeds. The worker threads are created on the first call to run() which
+ * needs them, so a parser which only ever sees small batches never creates any threads.
+ */
+class ParserWorkerPool
+{
+public:
+    using task_func_t = std::function<void(size_t)>;
+
+    /// @p num_threads is the total number of threads decoding samples, including the caller
+    explicit ParserWorkerPool(size_t num_threads);
+    ~ParserWorkerPool();
+
+    ParserWorkerPool(const ParserWorkerPool&) = delete;
+    ParserWorkerPool& operator=(const ParserWorkerPool&) = delete;
+
+    /// Invokes @p func for every task index in [0, @p num_tasks) and waits for them to complete
+    void run(size_t num_tasks, const task_func_t& func);
+
+    /// Number of threads decoding samples, including the caller
+    size_t size() const { return m_num_threads; }
+
+private:
+    void start();
+    void work();
+    void execute();
+
+    size_t                   m_num_threads = 1;
+    std::mutex               m_run_mutex   = {};
+    std::mutex               m_mutex       = {};
+    std::condition_variable  m_start       = {};
+    std::condition_variable  m_done        = {};
+    const task_func_t*       m_func        = nullptr;
+    size_t                   m_num_tasks   = 0;
+    std::atomic<size_t>      m_next_task   = 0;
+    size_t                   m_active      = 0;
+    uint64_t                 m_generation  = 0;
+    bool                     m_stop        = false;
+    std::vector<std::thread> m_threads     = {};
+};
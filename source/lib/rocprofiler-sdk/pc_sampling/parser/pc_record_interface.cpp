@@ -21,15 +21,22 @@
 // SOFTWARE.
 
 #include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
+#include "lib/common/environment.hpp"
 
-uint64_t
-PCSamplingParserContext::alloc(rocprofiler_pc_sampling_record_t** buffer, uint64_t size)
+#include <algorithm>
+#include <thread>
+
+size_t
+PCSamplingParserContext::get_default_num_threads()
 {
-    std::unique_lock<std::shared_mutex> lock(mut);
-    assert(buffer != nullptr);
-    data.emplace_back(std::make_unique<PCSamplingData>(size));
-    *buffer = data.back()->samples.data();
-    return size;
+    // a full ROCr buffer is never split across more threads, extra threads would stay idle. The
+    // worker threads are only started by the first batch large enough to be split
+    constexpr size_t max_useful_threads = max_samples_per_notification / min_samples_per_thread;
+
+    auto hw_threads  = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    auto num_threads = ::rocprofiler::common::get_env("ROCPROFILER_PC_SAMPLING_PARSER_THREADS",
+                                                      std::min(max_useful_threads, hw_threads));
+    return std::max<size_t>(num_threads, 1);
 }
 
 pcsample_status_t
@@ -98,11 +105,8 @@ PCSamplingParserContext::shouldFlipRocrBuffer(const dispatch_pkt_id_t& pkt) cons
     return corr_map->checkDispatch(pkt);
 }
 
-void
-PCSamplingParserContext::generate_upcoming_pc_record(
-    uint64_t                                agent_id_handle,
-    const rocprofiler_pc_sampling_record_t* samples,
-    size_t                                  num_samples)
+rocprofiler::buffer::instance*
+PCSamplingParserContext::get_agent_buffer(uint64_t agent_id_handle) const
 {
     auto buff_id = _agent_buffers.at(rocprofiler_agent_id_t{agent_id_handle});
     rocprofiler::buffer::instance* buff = rocprofiler::buffer::get_buffer(buff_id);
@@ -110,8 +114,5 @@ PCSamplingParserContext::generate_upcoming_pc_record(
     if(!buff)
         throw std::runtime_error(fmt::format("Buffer with id: {} does not exists", buff_id.handle));
 
-    for(size_t i = 0; i < num_samples; i++)
-        buff->emplace(ROCPROFILER_BUFFER_CATEGORY_PC_SAMPLING,
-                      ROCPROFILER_PC_SAMPLING_RECORD_SAMPLE,
-                      samples[i]);
-};
\ No newline at end of file
+    return buff;
+}
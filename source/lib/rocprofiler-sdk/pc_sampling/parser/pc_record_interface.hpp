@@ -25,6 +25,7 @@
 #include "lib/rocprofiler-sdk/buffer.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/correlation.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/parser_types.h"
+#include "lib/rocprofiler-sdk/pc_sampling/parser/parser_workers.hpp"
 
 #include <rocprofiler-sdk/fwd.h>
 #include <rocprofiler-sdk/cxx/hash.hpp>
@@ -32,6 +33,8 @@
 
 #include <fmt/core.h>
 #include <sys/types.h>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <condition_variable>
 #include <cstdint>
@@ -41,28 +44,16 @@
 #include <thread>
 #include <unordered_set>
 
-struct PCSamplingData
-{
-    PCSamplingData(size_t size)
-    : samples(size){};
-    PCSamplingData& operator=(PCSamplingData&) = delete;
-
-    std::vector<rocprofiler_pc_sampling_record_t> samples;
-};
-
 class PCSamplingParserContext
 {
 public:
-    PCSamplingParserContext()
-    : corr_map(std::make_unique<Parser::CorrelationMap>()){};
     /**
-     * @brief Allocates some memory. TODO: Translate to Jonathan's buffer implementation.
-     * @param[out] buffer Pointer where samples are to be written to.
-     * @param[in] size Number of samples requested.
-     * @returns Number of samples actually allocated on *buffer.
+     * @param[in] num_threads Number of threads decoding large batches of samples, including the
+     * thread calling parse(). Defaults to ROCPROFILER_PC_SAMPLING_PARSER_THREADS.
      */
-    uint64_t alloc(rocprofiler_pc_sampling_record_t** buffer, uint64_t size);
-
+    explicit PCSamplingParserContext(size_t num_threads = get_default_num_threads())
+    : corr_map(std::make_unique<Parser::CorrelationMap>())
+    , workers(std::make_unique<ParserWorkerPool>(num_threads)){};
     /**
      * @brief Parses a chunk of samples.
      * Call only finishes when all pc sampling records have been generated on the user buffer.
@@ -122,56 +113,100 @@ public:
         _agent_buffers.erase(agent_id);
     }
 
+    /**
+     * @brief Number of threads used to decode a batch of samples, read from
+     * ROCPROFILER_PC_SAMPLING_PARSER_THREADS. Defaults to the number of threads a full ROCr buffer
+     * is split across, bounded by the hardware threads. One decodes on the thread calling parse().
+     */
+    static size_t get_default_num_threads();
+
+    //! Samples held by the ROCr buffer, i.e. the largest batch delivered per notification. Must
+    //! match pc_sampling::utils::get_hsa_pcs_buffer_size()
+    static constexpr size_t max_samples_per_notification = 1024;
+
+    //! Batches are only split across threads when every thread decodes at least this many
+    //! samples: a full ROCr buffer is split across at most 4 threads
+    static constexpr size_t min_samples_per_thread = max_samples_per_notification / 4;
+
 protected:
     /**
      * @brief Parses the given input data and generates pc sampling records.
-     * Calls generate_upcoming_pc_record().
+     * The records are decoded directly into the space reserved in the buffer of the agent.
      */
     template <typename GFX>
     pcsample_status_t _parse(const upcoming_samples_t& upcoming, const generic_sample_t* data_)
     {
-        // std::shared_lock<std::shared_mutex> lock(mut);
-
         pcsample_status_t status      = PCSAMPLE_STATUS_SUCCESS;
-        uint64_t          pkt_counter = upcoming.num_samples;
         auto              dev         = upcoming.device;
         bool              bIsHostTrap = upcoming.which_sample_type == AMD_HOST_TRAP_V1;
-
-        while(pkt_counter > 0)
-        {
-            rocprofiler_pc_sampling_record_t* samples = nullptr;
-            uint64_t                          memsize = alloc(&samples, pkt_counter);
-
-            if(memsize == 0 || memsize > pkt_counter) return PCSAMPLE_STATUS_CALLBACK_ERROR;
-
-            auto* map = corr_map.get();
-            if(bIsHostTrap)
-                status |= add_upcoming_samples<true, GFX>(dev, data_, memsize, map, samples);
-            else
-                status |= add_upcoming_samples<false, GFX>(dev, data_, memsize, map, samples);
-
-            data_ += memsize;
-            pkt_counter -= memsize;
-            generate_upcoming_pc_record(dev.handle, samples, memsize);
-        }
+        auto*             buff        = get_agent_buffer(dev.handle);
+
+        // Samples not written (i.e. dropped by a lossy buffer) are not decoded
+        buff->emplace_n<rocprofiler_pc_sampling_record_t>(
+            ROCPROFILER_BUFFER_CATEGORY_PC_SAMPLING,
+            ROCPROFILER_PC_SAMPLING_RECORD_SAMPLE,
+            upcoming.num_samples,
+            [&](rocprofiler_pc_sampling_record_t* samples, size_t num) {
+                if(bIsHostTrap)
+                    status |= _decode<true, GFX>(dev, data_, num, samples);
+                else
+                    status |= _decode<false, GFX>(dev, data_, num, samples);
+                data_ += num;
+            });
 
         return status;
     }
 
+    /**
+     * @brief Decodes @p num samples into @p samples. Large batches are split into contiguous
+     * ranges decoded by the worker threads. Every sample is written at the same index it has in
+     * the input so the order of the records (and thus the order per dispatch) is preserved.
+     */
+    template <bool bHostTrap, typename GFX>
+    pcsample_status_t _decode(device_handle                     dev,
+                              const generic_sample_t*           data_,
+                              size_t                            num,
+                              rocprofiler_pc_sampling_record_t* samples)
+    {
+        // dispatches cannot be added or forgotten while their samples are being correlated
+        std::shared_lock<std::shared_mutex> lock(mut);
+
+        const auto* map       = corr_map.get();
+        auto        num_tasks = std::min(workers->size(), num / min_samples_per_thread);
+        if(num_tasks <= 1)
+            return add_upcoming_samples<bHostTrap, GFX>(dev, data_, num, map, samples);
+
+        auto chunk  = (num + num_tasks - 1) / num_tasks;
+        auto status = std::atomic<pcsample_status_t>{PCSAMPLE_STATUS_SUCCESS};
+        workers->run(num_tasks, [&](size_t i) {
+            auto beg = i * chunk;
+            auto end = std::min(num, beg + chunk);
+            if(beg >= end) return;
+
+            auto _status = add_upcoming_samples<bHostTrap, GFX>(
+                dev, data_ + beg, end - beg, map, samples + beg);
+            if(_status != PCSAMPLE_STATUS_SUCCESS) status.fetch_or(_status);
+        });
+
+        return status.load();
+    }
+
     /**
      * @brief Causes forget_corr_id records to be generated from forget_list. Clears forget_list.
      * Calls generate_id_completion_record()
      */
     pcsample_status_t flushForgetList();
-    static void       generate_id_completion_record(const dispatch_pkt_id_t& pkt) { (void) pkt; };
-    void              generate_upcoming_pc_record(uint64_t                                agent_id_handle,
-                                                  const rocprofiler_pc_sampling_record_t* samples,
-                                                  size_t                                  num_samples);
+    static void generate_id_completion_record(const dispatch_pkt_id_t& pkt) { (void) pkt; };
+
+    /**
+     * @brief Returns the buffer registered for the agent. Throws if no buffer is registered.
+     */
+    rocprofiler::buffer::instance* get_agent_buffer(uint64_t agent_id_handle) const;
 
     //! Maps doorbells and dispatch_index to correlation_id
     std::unique_ptr<Parser::CorrelationMap> corr_map;
-    //! Data allocated to store samples. Temporary.
-    std::vector<std::unique_ptr<PCSamplingData>> data;
+    //! Threads decoding large batches of samples
+    std::unique_ptr<ParserWorkerPool> workers;
     //! Dispatches not yet completed.
     // Uses only the internal correlation_id.
     std::unordered_map<uint64_t, dispatch_pkt_id_t> active_dispatches;
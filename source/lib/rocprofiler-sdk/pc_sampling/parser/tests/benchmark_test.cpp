@@ -21,9 +21,17 @@
 // THE SOFTWARE.
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cstddef>
+#include <cstring>
+#include <random>
 
+#include "lib/rocprofiler-sdk/buffer.hpp"
+#include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/tests/mocks.hpp"
+#include "lib/rocprofiler-sdk/pc_sampling/staging_pool.hpp"
+
+#include <rocprofiler-sdk/buffer.h>
 
 #define GFXIP_MAJOR 9
 
@@ -94,3 +102,284 @@ TEST(pcs_parser, benchmark_test)
     EXPECT_EQ(Benchmark(false), true);
     EXPECT_EQ(Benchmark(false), true);
 }
+
+namespace
+{
+void
+adapter_buffer_callback(rocprofiler_context_id_t,
+                        rocprofiler_buffer_id_t,
+                        rocprofiler_record_header_t**,
+                        size_t num_headers,
+                        void*  data,
+                        uint64_t)
+{
+    *static_cast<std::atomic<uint64_t>*>(data) += num_headers;
+}
+
+/**
+ * Feeds a synthetic stream of ROCr data-ready notifications through the path of the HSA adapter:
+ * the samples are copied from the "ROCr buffer" into a staging buffer and then parsed into the
+ * SDK's buffer. Returns the throughput in Msample/s.
+ */
+double
+AdapterBenchmark(int gfxip_major, upcoming_sample_t sample_type, bool use_pool)
+{
+    constexpr size_t   NUM_DISPATCHES    = 64;
+    constexpr size_t   QUEUE_SIZE        = 1024;
+    constexpr size_t   SAMPLES_PER_NOTIF = 1024;
+    constexpr size_t   NUM_NOTIFICATIONS = 2000;
+    constexpr size_t   BUFFER_SIZE       = 4 * 1024 * 1024;
+    constexpr uint32_t AGENT_HANDLE      = 1;
+
+    auto parser = PCSamplingParserContext{};
+    for(size_t d = 0; d < NUM_DISPATCHES; d++)
+    {
+        dispatch_pkt_id_t pkt;
+        ::memset(&pkt, 0, sizeof(pkt));
+        pkt.type                    = AMD_DISPATCH_PKT_ID;
+        pkt.device                  = device_handle{AGENT_HANDLE};
+        pkt.doorbell_id             = (d % MockDoorBell::num_unique_bells) << 3;
+        pkt.queue_size              = QUEUE_SIZE;
+        pkt.write_index             = d;
+        pkt.correlation_id.internal = d + 1;
+        parser.newDispatch(pkt);
+    }
+
+    // the contents of the ROCr buffer delivered by each notification. Waves of a dispatch are
+    // usually sampled consecutively so the samples are generated in short runs per dispatch
+    auto rocr_buffer = std::vector<packet_union_t>(SAMPLES_PER_NOTIF);
+    auto gen         = std::mt19937_64{42};
+    for(size_t i = 0; i < SAMPLES_PER_NOTIF; i++)
+    {
+        size_t d = (i / 16 + gen()) % NUM_DISPATCHES;
+        ::memset(&rocr_buffer[i], 0, sizeof(packet_union_t));
+        rocr_buffer[i].snap.pc                 = 0x1000 + (gen() % 4096) * 4;
+        rocr_buffer[i].snap.exec_mask          = ~0ul;
+        rocr_buffer[i].snap.perf_snapshot_data = gen() & 0xFFFFFF;
+        rocr_buffer[i].snap.correlation_id =
+            Parser::CorrelationMap::trap_correlation_id(
+                (d % MockDoorBell::num_unique_bells) << 3, d, QUEUE_SIZE)
+                .raw;
+    }
+
+    namespace buffer = ::rocprofiler::buffer;
+
+    auto num_records = std::atomic<uint64_t>{0};
+    auto buffer_id   = buffer::allocate_buffer();
+    EXPECT_TRUE(buffer_id) << "failed to allocate buffer";
+    if(!buffer_id) return 0.0;
+
+    auto* buffer_v = buffer::get_buffer(*buffer_id);
+    for(auto& itr : buffer_v->buffers)
+        itr.allocate(BUFFER_SIZE);
+    buffer_v->watermark     = BUFFER_SIZE / 2;
+    buffer_v->policy        = ROCPROFILER_BUFFER_POLICY_LOSSLESS;
+    buffer_v->callback      = adapter_buffer_callback;
+    buffer_v->callback_data = &num_records;
+    parser.register_buffer_for_agent(*buffer_id, rocprofiler_agent_id_t{AGENT_HANDLE});
+
+    auto pool = ::rocprofiler::pc_sampling::PCSStagingPool{SAMPLES_PER_NOTIF, 2};
+
+    upcoming_samples_t upc;
+    ::memset(&upc, 0, sizeof(upc));
+    upc.device            = device_handle{AGENT_HANDLE};
+    upc.which_sample_type = sample_type;
+    upc.num_samples       = SAMPLES_PER_NOTIF;
+
+    // mimics data_copy_callback
+    auto data_size = SAMPLES_PER_NOTIF * sizeof(packet_union_t);
+    auto copy_data = [&rocr_buffer, data_size](packet_union_t* dst) {
+        ::memcpy(dst, rocr_buffer.data(), data_size);
+    };
+
+    std::condition_variable cv;
+    auto                    t0 = std::chrono::steady_clock::now();
+    for(size_t n = 0; n < NUM_NOTIFICATIONS; n++)
+    {
+        if(use_pool)
+        {
+            auto buff = pool.acquire(SAMPLES_PER_NOTIF);
+            copy_data(buff.data());
+            CHECK_PARSER(parser.parse(upc,
+                                      reinterpret_cast<const generic_sample_t*>(buff.data()),
+                                      gfxip_major,
+                                      cv,
+                                      false));
+        }
+        else
+        {
+            auto buff = std::make_unique<packet_union_t[]>(SAMPLES_PER_NOTIF);
+            copy_data(buff.get());
+            CHECK_PARSER(parser.parse(upc,
+                                      reinterpret_cast<const generic_sample_t*>(buff.get()),
+                                      gfxip_major,
+                                      cv,
+                                      false));
+        }
+    }
+    buffer::flush(*buffer_id, true);
+    auto t1 = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(num_records.load(), NUM_NOTIFICATIONS * SAMPLES_PER_NOTIF);
+    EXPECT_EQ(pool.num_allocations(), 1);
+    EXPECT_EQ(rocprofiler_destroy_buffer(*buffer_id), ROCPROFILER_STATUS_SUCCESS);
+
+    return (NUM_NOTIFICATIONS * SAMPLES_PER_NOTIF) /
+           std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+}  // namespace
+
+TEST(pcs_parser, adapter_benchmark)
+{
+    for(int gfxip : {9, 11})
+    {
+        for(auto sample_type : {AMD_HOST_TRAP_V1, AMD_SNAPSHOT_V1})
+        {
+            // warmup
+            AdapterBenchmark(gfxip, sample_type, true);
+
+            auto alloc_rate = AdapterBenchmark(gfxip, sample_type, false);
+            auto pool_rate  = AdapterBenchmark(gfxip, sample_type, true);
+            std::cout << "Benchmark: gfx" << gfxip << " "
+                      << ((sample_type == AMD_HOST_TRAP_V1) ? "host-trap" : "stochastic")
+                      << " adapter path: " << alloc_rate << " Msample/s (allocate per callback), "
+                      << pool_rate << " Msample/s (staging pool)" << std::endl;
+        }
+    }
+}
+
+namespace
+{
+struct scaling_callback_data
+{
+    std::atomic<uint64_t> num_records       = 0;
+    std::atomic<uint64_t> num_out_of_order  = 0;
+    size_t                samples_per_notif = 0;
+    size_t                num_dispatches    = 0;
+};
+
+void
+scaling_buffer_callback(rocprofiler_context_id_t,
+                        rocprofiler_buffer_id_t,
+                        rocprofiler_record_header_t** headers,
+                        size_t                        num_headers,
+                        void*                         data,
+                        uint64_t)
+{
+    auto* cb_data = static_cast<scaling_callback_data*>(data);
+    auto  idx     = cb_data->num_records.load();
+    for(size_t i = 0; i < num_headers; ++i, ++idx)
+    {
+        // records must be delivered in the order of the samples in the ROCr buffer
+        const auto* record = static_cast<rocprofiler_pc_sampling_record_t*>(headers[i]->payload);
+        auto dispatch_idx  = ((idx % cb_data->samples_per_notif) / 16) % cb_data->num_dispatches;
+        if(record->correlation_id.internal != dispatch_idx + 1) ++cb_data->num_out_of_order;
+    }
+    cb_data->num_records += num_headers;
+}
+
+/**
+ * Parses full ROCr buffers of samples (e.g. from long-running kernels) into the SDK's buffer with
+ * the given number of parser threads. Returns the throughput in Msample/s.
+ */
+double
+ThreadScalingBenchmark(int gfxip_major, size_t num_threads)
+{
+    constexpr size_t   NUM_DISPATCHES    = 64;
+    constexpr size_t   QUEUE_SIZE        = 1024;
+    constexpr size_t   SAMPLES_PER_NOTIF = PCSamplingParserContext::max_samples_per_notification;
+    constexpr size_t   NUM_NOTIFICATIONS = 10240;
+    constexpr size_t   BUFFER_SIZE       = 16 * 1024 * 1024;
+    constexpr uint32_t AGENT_HANDLE      = 1;
+
+    auto parser = PCSamplingParserContext{num_threads};
+    for(size_t d = 0; d < NUM_DISPATCHES; d++)
+    {
+        dispatch_pkt_id_t pkt;
+        ::memset(&pkt, 0, sizeof(pkt));
+        pkt.type                    = AMD_DISPATCH_PKT_ID;
+        pkt.device                  = device_handle{AGENT_HANDLE};
+        pkt.doorbell_id             = (d % MockDoorBell::num_unique_bells) << 3;
+        pkt.queue_size              = QUEUE_SIZE;
+        pkt.write_index             = d;
+        pkt.correlation_id.internal = d + 1;
+        parser.newDispatch(pkt);
+    }
+
+    auto rocr_buffer = std::vector<packet_union_t>(SAMPLES_PER_NOTIF);
+    auto gen         = std::mt19937_64{42};
+    for(size_t i = 0; i < SAMPLES_PER_NOTIF; i++)
+    {
+        size_t d = (i / 16) % NUM_DISPATCHES;
+        ::memset(&rocr_buffer[i], 0, sizeof(packet_union_t));
+        rocr_buffer[i].snap.pc                 = 0x1000 + (gen() % 4096) * 4;
+        rocr_buffer[i].snap.exec_mask          = ~0ul;
+        rocr_buffer[i].snap.perf_snapshot_data = gen() & 0xFFFFFF;
+        rocr_buffer[i].snap.correlation_id =
+            Parser::CorrelationMap::trap_correlation_id(
+                (d % MockDoorBell::num_unique_bells) << 3, d, QUEUE_SIZE)
+                .raw;
+    }
+
+    namespace buffer = ::rocprofiler::buffer;
+
+    auto cb_data              = scaling_callback_data{};
+    cb_data.samples_per_notif = SAMPLES_PER_NOTIF;
+    cb_data.num_dispatches    = NUM_DISPATCHES;
+
+    auto buffer_id = buffer::allocate_buffer();
+    EXPECT_TRUE(buffer_id) << "failed to allocate buffer";
+    if(!buffer_id) return 0.0;
+
+    auto* buffer_v = buffer::get_buffer(*buffer_id);
+    for(auto& itr : buffer_v->buffers)
+        itr.allocate(BUFFER_SIZE);
+    buffer_v->watermark     = BUFFER_SIZE / 2;
+    buffer_v->policy        = ROCPROFILER_BUFFER_POLICY_LOSSLESS;
+    buffer_v->callback      = scaling_buffer_callback;
+    buffer_v->callback_data = &cb_data;
+    parser.register_buffer_for_agent(*buffer_id, rocprofiler_agent_id_t{AGENT_HANDLE});
+
+    upcoming_samples_t upc;
+    ::memset(&upc, 0, sizeof(upc));
+    upc.device            = device_handle{AGENT_HANDLE};
+    upc.which_sample_type = AMD_SNAPSHOT_V1;
+    upc.num_samples       = SAMPLES_PER_NOTIF;
+
+    std::condition_variable cv;
+    auto                    t0 = std::chrono::steady_clock::now();
+    for(size_t n = 0; n < NUM_NOTIFICATIONS; n++)
+    {
+        CHECK_PARSER(parser.parse(upc,
+                                  reinterpret_cast<const generic_sample_t*>(rocr_buffer.data()),
+                                  gfxip_major,
+                                  cv,
+                                  false));
+    }
+    buffer::flush(*buffer_id, true);
+    auto t1 = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(cb_data.num_records.load(), NUM_NOTIFICATIONS * SAMPLES_PER_NOTIF);
+    EXPECT_EQ(cb_data.num_out_of_order.load(), 0);
+    EXPECT_EQ(rocprofiler_destroy_buffer(*buffer_id), ROCPROFILER_STATUS_SUCCESS);
+
+    return (NUM_NOTIFICATIONS * SAMPLES_PER_NOTIF) /
+           std::chrono::duration<double, std::micro>(t1 - t0).count();
+}
+}  // namespace
+
+TEST(pcs_parser, thread_scaling_benchmark)
+{
+    for(int gfxip : {9, 11})
+    {
+        // warmup
+        ThreadScalingBenchmark(gfxip, 1);
+
+        for(size_t num_threads : {1, 2, 4, 8, 16})
+        {
+            auto rate = ThreadScalingBenchmark(gfxip, num_threads);
+            std::cout << "Benchmark: gfx" << gfxip << " " << num_threads
+                      << " parser thread(s): " << rate << " Msample/s" << std::endl;
+        }
+    }
+}
@@ -25,6 +25,7 @@
 
 #if ROCPROFILER_SDK_HSA_PC_SAMPLING > 0
 
+#    include "lib/common/environment.hpp"
 #    include "lib/common/logging.hpp"
 #    include "lib/rocprofiler-sdk/pc_sampling/hsa_adapter.hpp"
 #    include "lib/rocprofiler-sdk/pc_sampling/ioctl/ioctl_adapter.hpp"
@@ -164,7 +165,12 @@ configure_pc_sampling_service(context::context*                ctx,
 {
     if(!ctx->pc_sampler)
     {
-        ctx->pc_sampler = std::make_unique<context::pc_sampling_service>();
+        ctx->pc_sampler      = std::make_unique<context::pc_sampling_service>();
+        ctx->pc_sampler->ctx = ctx;
+
+        auto _markers_while_active =
+            common::get_env("ROCPROFILER_PC_SAMPLING_MARKERS_WHILE_ACTIVE", false);
+        ctx->pc_sampler->markers_while_active = _markers_while_active;
     }
 
     if(ctx->pc_sampler->agent_sessions.count(agent->id) > 0)
@@ -234,6 +240,18 @@ is_pc_sample_service_configured(rocprofiler_agent_id_t agent_id)
     return false;
 }
 
+bool
+is_pc_sample_marker_required(rocprofiler_agent_id_t agent_id)
+{
+    auto* service = get_configured_pc_sampling_service().load();
+    if(!service || service->agent_sessions.count(agent_id) == 0) return false;
+
+    // By default, the marker is injected for every kernel dispatched to the agent, so that the
+    // correlation IDs of kernels dispatched before the service starts are known to the parser.
+    // Otherwise, the samples of such kernels are delivered without a correlation ID.
+    return !service->markers_while_active || get_active_pc_sampling_service().load() == service;
+}
+
 rocprofiler_status_t
 flush_internal_agent_buffers(rocprofiler_buffer_id_t buffer_id)
 {
@@ -65,6 +65,11 @@ configure_pc_sampling_service(context::context*                ctx,
 bool
 is_pc_sample_service_configured(rocprofiler_agent_id_t agent_id);
 
+// Returns true if a marker packet correlating the PC samples with the kernel dispatch
+// must be injected for a kernel dispatched to the agent
+bool
+is_pc_sample_marker_required(rocprofiler_agent_id_t agent_id);
+
 rocprofiler_status_t
 flush_internal_agent_buffers(rocprofiler_buffer_id_t buffer_id);
 }  // namespace pc_sampling
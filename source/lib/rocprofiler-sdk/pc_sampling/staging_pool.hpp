@@ -0,0 +1,171 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/pc_sampling/parser/rocr.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace pc_sampling
+{
+/**
+ * @brief Pool of reusable staging buffers the raw PC samples are copied into from the ROCr's
+ * buffer before they are parsed into the SDK's buffer.
+ *
+ * ROCr delivers PC samples via `data_ready_callback` at a high rate, so allocating a staging
+ * buffer for every notification puts a large allocation on the ROCr's callback thread. Instead,
+ * buffers are acquired from the pool and returned to it once the samples are parsed. A buffer
+ * is only reallocated when a notification carries more samples than the buffer can hold.
+ *
+ * PCSStagingPool is a singleton per PCSAgentSession.
+ */
+class PCSStagingPool
+{
+public:
+    /// A staging buffer. Returns itself to the pool when destroyed.
+    class buffer
+    {
+    public:
+        buffer() = default;
+        ~buffer() { release(); }
+
+        buffer(const buffer&) = delete;
+        buffer(buffer&& rhs) noexcept { *this = std::move(rhs); }
+        buffer& operator=(const buffer&) = delete;
+        buffer& operator                 =(buffer&& rhs) noexcept
+        {
+            if(this != &rhs)
+            {
+                release();
+                m_pool     = rhs.m_pool;
+                m_data     = std::move(rhs.m_data);
+                m_capacity = rhs.m_capacity;
+                rhs.m_pool = nullptr;
+            }
+            return *this;
+        }
+
+        packet_union_t* data() const { return m_data.get(); }
+        size_t          capacity() const { return m_capacity; }
+
+    private:
+        friend class PCSStagingPool;
+
+        void release()
+        {
+            if(m_pool && m_data) m_pool->release(std::move(m_data), m_capacity);
+            m_pool = nullptr;
+        }
+
+        PCSStagingPool*                   m_pool     = nullptr;
+        std::unique_ptr<packet_union_t[]> m_data     = {};
+        size_t                            m_capacity = 0;
+    };
+
+    /// @p num_samples is the number of samples each buffer initially holds and @p max_buffers
+    /// is the number of buffers retained for concurrent notifications
+    PCSStagingPool(size_t num_samples, size_t max_buffers)
+    : m_num_samples{std::max<size_t>(num_samples, 1)}
+    , m_max_buffers{std::max<size_t>(max_buffers, 1)}
+    {
+        // reserve one buffer up front so the first notification does not allocate
+        m_free.emplace_back(allocate(m_num_samples), m_num_samples);
+    }
+
+    /// Returns a buffer capable of holding at least @p num_samples samples.
+    buffer acquire(size_t num_samples)
+    {
+        auto _buff   = buffer{};
+        _buff.m_pool = this;
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            if(!m_free.empty())
+            {
+                _buff.m_data     = std::move(m_free.back().first);
+                _buff.m_capacity = m_free.back().second;
+                m_free.pop_back();
+            }
+
+            // buffers are reallocated with the largest number of samples seen so far
+            m_num_samples = std::max(m_num_samples, num_samples);
+            if(_buff.m_capacity < num_samples)
+            {
+                _buff.m_data.reset();
+                _buff.m_capacity = m_num_samples;
+                ++m_num_allocations;
+            }
+        }
+
+        // allocate outside of the lock
+        if(!_buff.m_data) _buff.m_data = allocate(_buff.m_capacity);
+        return _buff;
+    }
+
+    /// Number of samples each buffer holds
+    size_t capacity() const
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        return m_num_samples;
+    }
+
+    /// Number of buffers allocated by the pool
+    size_t num_allocations() const
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        return m_num_allocations;
+    }
+
+private:
+    // the samples are always overwritten by the copy from the ROCr's buffer so the memory is
+    // intentionally left uninitialized (i.e. not std::make_unique)
+    static std::unique_ptr<packet_union_t[]> allocate(size_t _n)
+    {
+        return std::unique_ptr<packet_union_t[]>{new packet_union_t[_n]};
+    }
+
+    void release(std::unique_ptr<packet_union_t[]>&& _data, size_t _capacity)
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        // buffers smaller than the current size would be reallocated on the next acquire
+        if(m_free.size() < m_max_buffers && _capacity >= m_num_samples)
+            m_free.emplace_back(std::move(_data), _capacity);
+    }
+
+    using free_buffer_t = std::pair<std::unique_ptr<packet_union_t[]>, size_t>;
+
+    mutable std::mutex         m_mutex           = {};
+    size_t                     m_num_samples     = 0;
+    size_t                     m_max_buffers     = 0;
+    size_t                     m_num_allocations = 1;
+    std::vector<free_buffer_t> m_free            = {};
+};
+}  // namespace pc_sampling
+}  // namespace rocprofiler
@@ -25,7 +25,12 @@
 #include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
 
 TEST(pc_sampling, cid_manager)
 {
@@ -95,3 +100,95 @@ TEST(pc_sampling, cid_manager)
     EXPECT_EQ(c1.get_ref_count(), 4);
     EXPECT_EQ(c2.get_ref_count(), 3);
 }
+
+TEST(pc_sampling, cid_manager_stress)
+{
+    using correlation_id_t = rocprofiler::context::correlation_id;
+    using cid_manager_t    = rocprofiler::pc_sampling::PCSCIDManager;
+    using pcs_parser_t     = PCSamplingParserContext;
+
+    constexpr size_t   num_dispatch_threads         = 8;
+    constexpr size_t   num_cids_per_dispatch_thread = 20000;
+    constexpr size_t   num_callback_threads         = 2;
+    constexpr uint32_t initial_ref_count            = 2;
+    constexpr uint32_t expected_ref_count           = initial_ref_count - 1;
+
+    auto pcs_parser  = pcs_parser_t();
+    auto cid_manager = cid_manager_t(&pcs_parser);
+
+    // the kernels of these CIDs complete on the dispatching threads
+    auto cids = std::vector<std::unique_ptr<correlation_id_t>>{};
+    cids.reserve(num_dispatch_threads * num_cids_per_dispatch_thread);
+    for(size_t i = 0; i < num_dispatch_threads * num_cids_per_dispatch_thread; ++i)
+        cids.emplace_back(std::make_unique<correlation_id_t>(initial_ref_count, 1, i + 1));
+
+    auto num_completed = std::atomic<size_t>{0};
+    auto num_flushes   = std::atomic<size_t>{0};
+    auto done          = std::atomic<bool>{false};
+    auto num_errors    = std::atomic<size_t>{0};
+
+    // data-ready callbacks which periodically flush implicitly (and sometimes explicitly) while
+    // the kernels complete
+    auto callback_threads = std::vector<std::thread>{};
+    for(size_t t = 0; t < num_callback_threads; ++t)
+    {
+        callback_threads.emplace_back([&, t]() {
+            size_t n = 0;
+            while(!done.load(std::memory_order_relaxed))
+            {
+                auto copy_fn = [&]() {
+                    ++num_flushes;
+                    std::this_thread::yield();
+                };
+
+                if(t == 0 && ++n % 64 == 0)
+                    cid_manager.manage_cids_explicit(copy_fn);
+                else
+                    cid_manager.manage_cids_implicit(copy_fn);
+            }
+        });
+    }
+
+    auto dispatch_threads = std::vector<std::thread>{};
+    for(size_t t = 0; t < num_dispatch_threads; ++t)
+    {
+        dispatch_threads.emplace_back([&, t]() {
+            for(size_t i = 0; i < num_cids_per_dispatch_thread; ++i)
+            {
+                auto& cid = cids.at((t * num_cids_per_dispatch_thread) + i);
+                cid_manager.cid_async_activity_completed(cid.get());
+                ++num_completed;
+                // a CID must never be retired more than once
+                if(cid->get_ref_count() < expected_ref_count) ++num_errors;
+            }
+        });
+    }
+
+    for(auto& itr : dispatch_threads)
+        itr.join();
+
+    done.store(true);
+    for(auto& itr : callback_threads)
+        itr.join();
+
+    EXPECT_EQ(num_completed.load(), cids.size());
+    EXPECT_GT(num_flushes.load(), 0);
+    EXPECT_EQ(num_errors.load(), 0);
+
+    // two more implicit flushes retire everything which completed before them
+    cid_manager.manage_cids_implicit([]() {});
+    cid_manager.manage_cids_implicit([]() {});
+
+    // every CID is retired exactly once
+    size_t num_not_retired = 0;
+    for(const auto& itr : cids)
+    {
+        if(itr->get_ref_count() != expected_ref_count) ++num_not_retired;
+    }
+    EXPECT_EQ(num_not_retired, 0);
+
+    // nothing is left to be retired
+    cid_manager.manage_cids_explicit([]() {});
+    for(const auto& itr : cids)
+        EXPECT_EQ(itr->get_ref_count(), expected_ref_count);
+}
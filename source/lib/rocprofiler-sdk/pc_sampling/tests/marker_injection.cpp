@@ -0,0 +1,224 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/pc_sampling/defines.hpp"
+
+#if ROCPROFILER_SDK_HSA_PC_SAMPLING > 0
+
+#    include "lib/rocprofiler-sdk/context/context.hpp"
+#    include "lib/rocprofiler-sdk/context/correlation_id.hpp"
+#    include "lib/rocprofiler-sdk/hsa/queue.hpp"
+#    include "lib/rocprofiler-sdk/hsa/rocprofiler_packet.hpp"
+#    include "lib/rocprofiler-sdk/pc_sampling/cid_manager.hpp"
+#    include "lib/rocprofiler-sdk/pc_sampling/hsa_adapter.hpp"
+#    include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
+#    include "lib/rocprofiler-sdk/pc_sampling/service.hpp"
+#    include "lib/rocprofiler-sdk/pc_sampling/types.hpp"
+#    include "lib/rocprofiler-sdk/registration.hpp"
+#    include "lib/rocprofiler-sdk/tests/queue_mocks.hpp"
+
+#    include <gtest/gtest.h>
+
+#    include <cstddef>
+#    include <cstdint>
+#    include <memory>
+#    include <vector>
+
+namespace
+{
+using rocprofiler_packet_t = hsa::rocprofiler_packet;
+
+// PC sampling service configured (but stopped) on an agent
+struct mock_service
+{
+    mock_service(const rocprofiler_agent_t* agent, bool markers_while_active)
+    {
+        auto _session         = std::make_unique<pc_sampling::PCSAgentSession>();
+        _session->agent       = agent;
+        _session->method      = ROCPROFILER_PC_SAMPLING_METHOD_HOST_TRAP;
+        _session->unit        = ROCPROFILER_PC_SAMPLING_UNIT_TIME;
+        _session->parser      = std::make_unique<PCSamplingParserContext>();
+        _session->cid_manager =
+            std::make_unique<pc_sampling::PCSCIDManager>(_session->parser.get());
+        session               = _session.get();
+
+        ctx.pc_sampler                       = std::make_unique<context::pc_sampling_service>();
+        ctx.pc_sampler->ctx                  = &ctx;
+        ctx.pc_sampler->markers_while_active = markers_while_active;
+        ctx.pc_sampler->agent_sessions.emplace(agent->id, std::move(_session));
+
+        previous = pc_sampling::get_configured_pc_sampling_service().exchange(ctx.pc_sampler.get());
+    }
+
+    ~mock_service() { pc_sampling::get_configured_pc_sampling_service().store(previous); }
+
+    mock_service(const mock_service&) = delete;
+    mock_service& operator=(const mock_service&) = delete;
+
+    // two implicit flushes retire the correlation ids of the kernels completed before them
+    void flush() const
+    {
+        session->cid_manager->manage_cids_implicit([]() {});
+        session->cid_manager->manage_cids_implicit([]() {});
+    }
+
+    context::context              ctx      = {};
+    pc_sampling::PCSAgentSession* session  = nullptr;
+    context::pc_sampling_service* previous = nullptr;
+};
+
+// queue whose kernel completions are reported to the PC sampling service, as done by
+// pc_sampling_service_finish_configuration for the queues of the runtime
+struct pcs_queue : mock_queue
+{
+    pcs_queue(const hsa::AgentCache& agent, uint64_t id)
+    : mock_queue{agent, id}
+    {
+        register_callback(
+            0,
+            [](const hsa::Queue&,
+               const rocprofiler_packet_t&,
+               rocprofiler_kernel_id_t,
+               rocprofiler_dispatch_id_t,
+               rocprofiler_user_data_t*,
+               const hsa::Queue::queue_info_session_t::external_corr_id_map_t&,
+               const context::correlation_id*) { return nullptr; },
+            [](const hsa::Queue&                       q,
+               rocprofiler_packet_t                    kern_pkt,
+               const hsa::Queue::queue_info_session_t& session,
+               hsa::inst_pkt_t&) {
+                pc_sampling::hsa::kernel_completion_cb(
+                    q.get_agent().get_rocp_agent(), kern_pkt, session);
+            });
+    }
+
+    ~pcs_queue() override { remove_callback(0); }
+};
+
+// packets the write interceptor passed on to the queue of the runtime
+std::vector<rocprofiler_packet_t>&
+get_written_packets()
+{
+    static auto _v = std::vector<rocprofiler_packet_t>{};
+    return _v;
+}
+
+void
+mock_packet_writer(const void* packets, uint64_t pkt_count)
+{
+    const auto* _packets = static_cast<const rocprofiler_packet_t*>(packets);
+    get_written_packets().assign(_packets, _packets + pkt_count);
+}
+
+// writes a kernel dispatch packet to the queue and returns whether a marker was injected
+bool
+dispatch_kernel(hsa::Queue& queue)
+{
+    auto _kernel   = hsa_kernel_dispatch_packet_t{};
+    _kernel.header = HSA_PACKET_TYPE_KERNEL_DISPATCH << HSA_PACKET_HEADER_TYPE;
+
+    auto _packet = rocprofiler_packet_t{_kernel};
+    get_written_packets().clear();
+    hsa::WriteInterceptor(&_packet, 1, 0, &queue, mock_packet_writer);
+
+    const auto& _written = get_written_packets();
+    if(_written.empty()) return false;
+
+    const auto& _marker = _written.front().marker;
+    bool        _ret    = (_marker.header == HSA_PACKET_TYPE_VENDOR_SPECIFIC &&
+                   _marker.format == AMD_AQL_FORMAT_INTERCEPT_MARKER);
+    // the kernel is followed by the barrier signaling its completion
+    EXPECT_EQ(_written.size(), (_ret) ? 3 : 2);
+    return _ret;
+}
+}  // namespace
+
+TEST(pc_sampling, marker_injection)
+{
+    registration::init_logging();
+
+    auto _runtime   = mock_runtime{};
+    auto _pcs_agent = mock_agent{0xC0FFEE};
+    auto _agent     = mock_agent{0xBEEF};
+    auto _pcs_queue = pcs_queue{_pcs_agent.cache, 1};
+    auto _queue     = pcs_queue{_agent.cache, 2};
+
+    // correlation id of the API call enclosing the dispatches, the kernels hold a reference
+    // until they complete and the marker holds a reference until the correlation id is retired
+    auto* _corr = context::correlation_tracing_service::construct(1);
+    ASSERT_NE(_corr, nullptr);
+
+    {
+        auto _service = mock_service{&_pcs_agent.rocp_agent, false};
+
+        // PC sampling is not configured on the agent
+        EXPECT_FALSE(dispatch_kernel(_queue));
+        EXPECT_EQ(_corr->get_ref_count(), 2);
+        EXPECT_EQ(run_signal_handlers(), 1);
+        EXPECT_EQ(_corr->get_ref_count(), 1);
+
+        // by default, the marker is injected while the service is stopped
+        ASSERT_TRUE(dispatch_kernel(_pcs_queue));
+        EXPECT_EQ(get_written_packets().front().marker.user_data[0], _corr->internal);
+        EXPECT_EQ(_corr->get_ref_count(), 3);
+        EXPECT_EQ(run_signal_handlers(), 1);
+        EXPECT_EQ(_corr->get_ref_count(), 2);
+
+        // the kernel completed, i.e. the correlation id is retired by the PC sampling service
+        _service.flush();
+        EXPECT_EQ(_corr->get_ref_count(), 1);
+    }
+
+    {
+        auto _service = mock_service{&_pcs_agent.rocp_agent, true};
+
+        // the marker is only injected while the service is active and the completion of a kernel
+        // without a marker is not reported to the PC sampling service
+        EXPECT_FALSE(dispatch_kernel(_pcs_queue));
+        EXPECT_EQ(_corr->get_ref_count(), 2);
+        EXPECT_EQ(run_signal_handlers(), 1);
+        _service.flush();
+        EXPECT_EQ(_corr->get_ref_count(), 1);
+
+        ASSERT_EQ(pc_sampling::start_service(&_service.ctx), ROCPROFILER_STATUS_SUCCESS);
+        EXPECT_TRUE(dispatch_kernel(_pcs_queue));
+        EXPECT_EQ(_corr->get_ref_count(), 3);
+        ASSERT_EQ(pc_sampling::stop_service(&_service.ctx), ROCPROFILER_STATUS_SUCCESS);
+
+        // the kernel completes after the service stopped, the marker still has to be retired
+        EXPECT_EQ(run_signal_handlers(), 1);
+        EXPECT_EQ(_corr->get_ref_count(), 2);
+        _service.flush();
+        EXPECT_EQ(_corr->get_ref_count(), 1);
+
+        EXPECT_FALSE(dispatch_kernel(_pcs_queue));
+        EXPECT_EQ(run_signal_handlers(), 1);
+        _service.flush();
+        EXPECT_EQ(_corr->get_ref_count(), 1);
+    }
+
+    EXPECT_EQ(_corr->get_kern_count(), 0);
+    context::pop_latest_correlation_id(_corr);
+    _corr->sub_ref_count();
+}
+
+#endif
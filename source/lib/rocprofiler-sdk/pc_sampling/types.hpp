@@ -5,6 +5,7 @@
 #include "lib/rocprofiler-sdk/pc_sampling/cid_manager.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/defines.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
+#include "lib/rocprofiler-sdk/pc_sampling/staging_pool.hpp"
 
 #include <rocprofiler-sdk/agent.h>
 #include <rocprofiler-sdk/fwd.h>
@@ -42,6 +43,8 @@ struct PCSAgentSession
     std::unique_ptr<PCSamplingParserContext> parser = {};
     // Manager responsible for retiring CIDs
     std::unique_ptr<PCSCIDManager> cid_manager = {};
+    // Staging buffers for the samples copied from the ROCr's buffer
+    std::unique_ptr<PCSStagingPool> staging_pool = {};
 };
 
 // TODO static assertions
@@ -30,6 +30,7 @@
 #    include <hsa/hsa_ext_amd.h>
 #    include <hsa/hsa_ven_amd_pc_sampling.h>
 
+#    include <algorithm>
 #    include <stdexcept>
 
 namespace rocprofiler
@@ -68,6 +69,23 @@ get_matching_hsa_pcs_units(rocprofiler_pc_sampling_unit_t unit)
 
     throw std::runtime_error("Illegal pc sampling units\n");
 }
+
+size_t
+get_pcs_staging_buffer_samples(const rocprofiler_agent_t*     agent,
+                               rocprofiler_pc_sampling_unit_t unit,
+                               uint64_t                       interval)
+{
+    constexpr size_t min_samples = 64;
+    constexpr size_t max_samples = get_hsa_pcs_buffer_size() / sizeof(perf_sample_hosttrap_v1_t);
+
+    if(unit != ROCPROFILER_PC_SAMPLING_UNIT_TIME || interval == 0) return max_samples;
+
+    // the interval and the latency are both in microseconds and at most one wave per compute
+    // unit is sampled per interval
+    auto num_intervals = (get_hsa_pcs_latency() / interval) + 1;
+    auto num_samples   = num_intervals * std::max<size_t>(agent->cu_count, 1);
+    return std::clamp<size_t>(num_samples, min_samples, max_samples);
+}
 }  // namespace utils
 }  // namespace pc_sampling
 }  // namespace rocprofiler
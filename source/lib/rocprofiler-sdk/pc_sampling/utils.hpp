@@ -26,6 +26,7 @@
 
 #if ROCPROFILER_SDK_HSA_PC_SAMPLING > 0
 
+#    include <rocprofiler-sdk/agent.h>
 #    include <rocprofiler-sdk/fwd.h>
 #    include <rocprofiler-sdk/pc_sampling.h>
 
@@ -60,6 +61,21 @@ get_hsa_pcs_buffer_size()
     // TODO: Find the minimum size of all buffers and use that.
     return 1024 * sizeof(perf_sample_hosttrap_v1_t);
 }
+
+// initial number of samples held by the staging buffers of an agent. ROCr delivers at most the
+// contents of its buffer per notification but with a time interval, fewer samples are expected to
+// accumulate within the latency window so the staging buffers start smaller
+size_t
+get_pcs_staging_buffer_samples(const rocprofiler_agent_t*     agent,
+                               rocprofiler_pc_sampling_unit_t unit,
+                               uint64_t                       interval);
+
+// number of staging buffers retained per agent
+constexpr size_t
+get_pcs_staging_buffer_count()
+{
+    return 2;
+}
 }  // namespace utils
 }  // namespace pc_sampling
 }  // namespace rocprofiler
@@ -0,0 +1,157 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include "lib/rocprofiler-sdk/tests/async_copy_mocks.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+std::atomic<bool> reaper_blocked = {false};
+
+void
+blocking_reap_copy_data(async_copy_slot* slot)
+{
+    while(reaper_blocked.load())
+        std::this_thread::yield();
+    reap_copy_data(slot);
+}
+}  // namespace
+
+TEST(async_copy, tracker_recycles_slots)
+{
+    auto _tables  = mock_tables{};
+    auto _tracker = async_copy_tracker{
+        create_copy_data, complete_copy_data, reap_copy_data, destroy_copy_data, 16};
+
+    hsa_signal_t _orig = {};
+    mock_signal_create(0, 0, nullptr, &_orig);
+
+    constexpr uint64_t num_copies = 1000;
+    num_reaped.store(0);
+    run_copies(&_tracker, _orig, num_copies);
+
+    EXPECT_EQ(_tracker.sync(std::chrono::seconds{10}), 0);
+    EXPECT_EQ(_tracker.active(), 0);
+    EXPECT_EQ(num_reaped.load(), num_copies);
+    EXPECT_LE(_tracker.free_slots(), 16);
+
+    // one signal for the original completion signal. Every other signal belongs to a slot which is
+    // either in the free list or was destroyed because the free list was full
+    auto _slot_signals = runtime->created.load() - 1;
+    EXPECT_EQ(_slot_signals, _tracker.free_slots() + runtime->destroyed.load());
+    EXPECT_LT(_slot_signals, num_copies);
+
+    _tracker.stop();
+    EXPECT_EQ(_tracker.free_slots(), 0);
+    EXPECT_EQ(runtime->created.load() - 1, runtime->destroyed.load());
+
+    mock_signal_destroy(_orig);
+}
+
+TEST(async_copy, tracker_without_free_list)
+{
+    auto _tables  = mock_tables{};
+    auto _tracker = async_copy_tracker{
+        create_copy_data, complete_copy_data, reap_copy_data, destroy_copy_data, 0};
+
+    hsa_signal_t _orig = {};
+    mock_signal_create(0, 0, nullptr, &_orig);
+
+    constexpr uint64_t num_copies = 1000;
+    num_reaped.store(0);
+    run_copies(&_tracker, _orig, num_copies);
+
+    // a slot and a signal are created and destroyed for every copy
+    EXPECT_EQ(_tracker.sync(std::chrono::seconds{10}), 0);
+    EXPECT_EQ(num_reaped.load(), num_copies);
+    EXPECT_EQ(_tracker.free_slots(), 0);
+    EXPECT_EQ(runtime->created.load() - 1, runtime->destroyed.load());
+
+    _tracker.stop();
+    mock_signal_destroy(_orig);
+}
+
+TEST(async_copy, tracker_reaps_after_stop)
+{
+    auto _tables  = mock_tables{};
+    auto _tracker = async_copy_tracker{
+        create_copy_data, complete_copy_data, reap_copy_data, destroy_copy_data};
+
+    hsa_signal_t _orig = {};
+    mock_signal_create(1, 0, nullptr, &_orig);
+
+    num_reaped.store(0);
+    _tracker.stop();
+
+    // completions of copies tracked after the reaper exited are reaped by the async handler
+    auto* _data        = static_cast<copy_data*>(_tracker.acquire());
+    _data->orig_signal = _orig;
+    ASSERT_TRUE(_tracker.track(_data));
+    mock_submit_copy(_data->rocp_signal);
+
+    EXPECT_EQ(_tracker.sync(std::chrono::seconds{10}), 0);
+    EXPECT_EQ(num_reaped.load(), 1);
+    EXPECT_EQ(get_signal(_orig)->value.load(), 0);
+    EXPECT_EQ(runtime->created.load() - 1, runtime->destroyed.load());
+
+    mock_signal_destroy(_orig);
+}
+
+TEST(async_copy, tracker_completes_before_reap)
+{
+    auto _tables  = mock_tables{};
+    auto _tracker = async_copy_tracker{
+        create_copy_data, complete_copy_data, blocking_reap_copy_data, destroy_copy_data};
+
+    hsa_signal_t _orig = {};
+    mock_signal_create(1, 0, nullptr, &_orig);
+
+    num_reaped.store(0);
+    reaper_blocked.store(true);
+
+    auto* _data        = static_cast<copy_data*>(_tracker.acquire());
+    _data->orig_signal = _orig;
+    ASSERT_TRUE(_tracker.track(_data));
+    mock_submit_copy(_data->rocp_signal);
+
+    // the signal of the application is completed by the async handler while the reaper is busy
+    auto _deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while(get_signal(_orig)->value.load() != 0 && std::chrono::steady_clock::now() < _deadline)
+        std::this_thread::yield();
+
+    EXPECT_EQ(get_signal(_orig)->value.load(), 0);
+    EXPECT_EQ(num_reaped.load(), 0);
+    EXPECT_EQ(_tracker.active(), 1);
+
+    reaper_blocked.store(false);
+    EXPECT_EQ(_tracker.sync(std::chrono::seconds{10}), 0);
+    EXPECT_EQ(num_reaped.load(), 1);
+
+    _tracker.stop();
+    mock_signal_destroy(_orig);
+}
@@ -0,0 +1,71 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include "lib/rocprofiler-sdk/tests/async_copy_mocks.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+/**
+ * Compares the copy rate without tracing and with the tracker with and without a free list
+ */
+TEST(async_copy, tracker_benchmark)
+{
+    constexpr uint64_t num_copies = 100000;
+
+    auto _copies_per_sec = [](async_copy_tracker* tracker) {
+        hsa_signal_t _orig = {};
+        mock_signal_create(0, 0, nullptr, &_orig);
+
+        auto _beg = std::chrono::steady_clock::now();
+        run_copies(tracker, _orig, num_copies);
+        if(tracker) EXPECT_EQ(tracker->sync(std::chrono::seconds{10}), 0);
+        auto _end = std::chrono::steady_clock::now();
+
+        mock_signal_destroy(_orig);
+        return num_copies / std::chrono::duration<double>(_end - _beg).count();
+    };
+
+    auto _tables = mock_tables{};
+
+    auto _disabled = _copies_per_sec(nullptr);
+
+    // no free list: a slot and a signal are created and destroyed for every copy
+    auto _unpooled      = async_copy_tracker{
+        create_copy_data, complete_copy_data, reap_copy_data, destroy_copy_data, 0};
+    auto _unpooled_rate = _copies_per_sec(&_unpooled);
+    _unpooled.stop();
+
+    auto _pooled      = async_copy_tracker{
+        create_copy_data, complete_copy_data, reap_copy_data, destroy_copy_data};
+    auto _pooled_rate = _copies_per_sec(&_pooled);
+    _pooled.stop();
+
+    std::cout << "[async_copy] copies/sec :: tracing disabled = " << _disabled
+              << ", tracing enabled (unpooled) = " << _unpooled_rate
+              << ", tracing enabled (pooled) = " << _pooled_rate << std::endl;
+
+    EXPECT_GT(_pooled_rate, 0.0);
+}
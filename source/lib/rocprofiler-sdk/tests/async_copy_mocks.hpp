@@ -0,0 +1,265 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/hsa/async_copy_tracker.hpp"
+#include "lib/rocprofiler-sdk/hsa/hsa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+using namespace ::rocprofiler;
+using namespace ::rocprofiler::hsa;
+
+// signal of the mock runtime, the handle is the address of the value
+struct mock_signal
+{
+    std::atomic<hsa_signal_value_t> value = {};
+};
+
+struct mock_handler
+{
+    hsa_amd_signal_handler handler = nullptr;
+    void*                  arg     = nullptr;
+};
+
+// completes the submitted copies in order on a separate thread and invokes the async handlers
+// registered for their completion signal, i.e. acts as both the copy engine and the async handler
+// thread of the runtime
+struct mock_runtime
+{
+    std::mutex                                 mutex     = {};
+    std::condition_variable                    cv        = {};
+    std::deque<hsa_signal_t>                   copies    = {};
+    std::unordered_map<uint64_t, mock_handler> handlers  = {};
+    std::atomic<uint64_t>                      created   = {0};
+    std::atomic<uint64_t>                      destroyed = {0};
+    bool                                       stop      = false;
+    std::thread                                engine    = {};
+};
+
+mock_runtime* runtime = nullptr;
+
+mock_signal*
+get_signal(hsa_signal_t signal)
+{
+    return reinterpret_cast<mock_signal*>(signal.handle);
+}
+
+hsa_status_t
+mock_signal_create(hsa_signal_value_t initial_value,
+                   uint32_t,
+                   const hsa_agent_t*,
+                   hsa_signal_t* signal)
+{
+    auto* _signal = new mock_signal{};
+    _signal->value.store(initial_value);
+    signal->handle = reinterpret_cast<uint64_t>(_signal);
+    ++runtime->created;
+    return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+mock_signal_destroy(hsa_signal_t signal)
+{
+    delete get_signal(signal);
+    ++runtime->destroyed;
+    return HSA_STATUS_SUCCESS;
+}
+
+void
+mock_signal_store_relaxed(hsa_signal_t signal, hsa_signal_value_t value)
+{
+    get_signal(signal)->value.store(value, std::memory_order_relaxed);
+}
+
+hsa_status_t
+mock_signal_async_handler(hsa_signal_t signal,
+                          hsa_signal_condition_t,
+                          hsa_signal_value_t,
+                          hsa_amd_signal_handler handler,
+                          void*                  arg)
+{
+    auto _lk = std::unique_lock<std::mutex>{runtime->mutex};
+    runtime->handlers.emplace(signal.handle, mock_handler{handler, arg});
+    return HSA_STATUS_SUCCESS;
+}
+
+void
+mock_submit_copy(hsa_signal_t completion_signal)
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{runtime->mutex};
+        runtime->copies.emplace_back(completion_signal);
+    }
+    runtime->cv.notify_one();
+}
+
+void
+mock_engine()
+{
+    auto _lk = std::unique_lock<std::mutex>{runtime->mutex};
+    while(true)
+    {
+        runtime->cv.wait(_lk, []() { return runtime->stop || !runtime->copies.empty(); });
+        if(runtime->copies.empty()) return;
+
+        auto _signal = runtime->copies.front();
+        runtime->copies.pop_front();
+
+        auto _value   = get_signal(_signal)->value.fetch_sub(1) - 1;
+        auto _handler = runtime->handlers.find(_signal.handle);
+        if(_handler == runtime->handlers.end()) continue;
+
+        auto _info = _handler->second;
+        runtime->handlers.erase(_handler);
+
+        _lk.unlock();
+        _info.handler(_value, _info.arg);
+        _lk.lock();
+    }
+}
+
+// installs the mock runtime in the HSA API tables for the lifetime of the test
+struct mock_tables
+{
+    mock_tables()
+    : core{*get_core_table()}
+    , amd_ext{*get_amd_ext_table()}
+    {
+        runtime = new mock_runtime{};
+
+        get_core_table()->hsa_signal_create_fn              = mock_signal_create;
+        get_core_table()->hsa_signal_destroy_fn             = mock_signal_destroy;
+        get_core_table()->hsa_signal_store_relaxed_fn       = mock_signal_store_relaxed;
+        get_amd_ext_table()->hsa_amd_signal_async_handler_fn = mock_signal_async_handler;
+
+        runtime->engine = std::thread{mock_engine};
+    }
+
+    ~mock_tables()
+    {
+        {
+            auto _lk      = std::unique_lock<std::mutex>{runtime->mutex};
+            runtime->stop = true;
+        }
+        runtime->cv.notify_all();
+        runtime->engine.join();
+
+        delete runtime;
+        runtime = nullptr;
+
+        *get_core_table()    = core;
+        *get_amd_ext_table() = amd_ext;
+    }
+
+    CoreApiTable core    = {};
+    AmdExtTable  amd_ext = {};
+};
+
+// data of a traced copy, the original completion signal is forwarded when the copy completes
+struct copy_data : async_copy_slot
+{
+    hsa_signal_t orig_signal = {.handle = 0};
+};
+
+std::atomic<uint64_t> num_reaped    = {0};
+std::atomic<uint64_t> num_completed = {0};
+
+async_copy_slot*
+create_copy_data()
+{
+    return new copy_data{};
+}
+
+void
+destroy_copy_data(async_copy_slot* slot)
+{
+    delete static_cast<copy_data*>(slot);
+}
+
+void
+complete_copy_data(async_copy_slot* slot)
+{
+    auto* _data = static_cast<copy_data*>(slot);
+    EXPECT_EQ(_data->signal_value, 0);
+    EXPECT_GT(_data->completion_ts, 0);
+
+    get_signal(_data->orig_signal)->value.fetch_sub(1);
+    ++num_completed;
+}
+
+void
+reap_copy_data(async_copy_slot*)
+{
+    ++num_reaped;
+}
+
+// submits num_copies copies, at most max_inflight at a time, and waits for all of them
+void
+run_copies(async_copy_tracker* tracker, hsa_signal_t orig_signal, uint64_t num_copies)
+{
+    constexpr uint64_t max_inflight = 64;
+
+    num_completed.store(0);
+    for(uint64_t i = 0; i < num_copies; ++i)
+    {
+        while(i - num_completed.load(std::memory_order_relaxed) >= max_inflight)
+            std::this_thread::yield();
+
+        mock_signal_store_relaxed(orig_signal, 1);
+        if(!tracker)
+        {
+            mock_submit_copy(orig_signal);
+            // the tracing is disabled: the copy completes the signal of the application
+            num_completed.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        auto* _data        = static_cast<copy_data*>(tracker->acquire());
+        _data->orig_signal = orig_signal;
+        ASSERT_TRUE(tracker->track(_data));
+        mock_submit_copy(_data->rocp_signal);
+    }
+
+    // wait for the copy engine to drain
+    while(true)
+    {
+        auto _lk = std::unique_lock<std::mutex>{runtime->mutex};
+        if(runtime->copies.empty()) break;
+        _lk.unlock();
+        std::this_thread::yield();
+    }
+    while(num_completed.load() < num_copies)
+        std::this_thread::yield();
+}
+}  // namespace
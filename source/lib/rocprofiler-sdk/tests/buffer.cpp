@@ -22,18 +22,25 @@
 
 #include "lib/rocprofiler-sdk/buffer.hpp"
 #include "lib/common/units.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
 
 #include <rocprofiler-sdk/buffer.h>
 #include <rocprofiler-sdk/fwd.h>
+#include <rocprofiler-sdk/internal_threading.h>
 #include <rocprofiler-sdk/registration.h>
 
 #include <gtest/gtest.h>
 
 #include <pthread.h>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <random>
+#include <string>
+#include <thread>
 #include <typeinfo>
+#include <vector>
 
 TEST(rocprofiler_lib, buffer)
 {
@@ -76,3 +83,251 @@ TEST(rocprofiler_lib, buffer)
     auto destroy_status = rocprofiler_destroy_buffer(*buffer_id);
     EXPECT_EQ(destroy_status, ROCPROFILER_STATUS_SUCCESS);
 }
+
+namespace
+{
+struct flush_order_data
+{
+    uint64_t              next_value      = 0;
+    uint64_t              num_records     = 0;
+    uint64_t              num_errors      = 0;
+    std::atomic<uint64_t> num_flushes     = {};
+    std::thread::id       callback_thread = {};
+};
+
+void
+flush_order_callback(rocprofiler_context_id_t,
+                     rocprofiler_buffer_id_t,
+                     rocprofiler_record_header_t** headers,
+                     size_t                        num_headers,
+                     void*                         data,
+                     uint64_t)
+{
+    // each buffer has at most one flush in flight so no synchronization is needed here
+    auto* _data = static_cast<flush_order_data*>(data);
+    for(size_t i = 0; i < num_headers; ++i)
+    {
+        auto _value = *static_cast<uint64_t*>(headers[i]->payload);
+        if(_value != _data->next_value) ++_data->num_errors;
+        _data->next_value = _value + 1;
+        ++_data->num_records;
+    }
+    ++_data->num_flushes;
+    _data->callback_thread = std::this_thread::get_id();
+}
+
+/**
+ * Many buffers assigned to the callback thread are filled concurrently and flushed. Verifies that
+ * per-buffer records are delivered exactly once and in order.
+ */
+std::vector<flush_order_data>
+check_flush_order(rocprofiler_callback_thread_t cb_thread)
+{
+    namespace buffer = ::rocprofiler::buffer;
+
+    constexpr size_t   num_buffers        = 32;
+    constexpr size_t   num_threads        = 8;
+    constexpr uint64_t records_per_buffer = 10000;
+    constexpr size_t   buffer_size        = 16 * 4096;
+    constexpr uint64_t watermark          = 256;
+    static_assert(num_buffers % num_threads == 0, "threads must own the same number of buffers");
+
+    auto _data    = std::vector<flush_order_data>(num_buffers);
+    auto _buffers = std::vector<buffer::instance*>{};
+    for(size_t i = 0; i < num_buffers; ++i)
+    {
+        auto buffer_id = buffer::allocate_buffer();
+        EXPECT_TRUE(buffer_id) << "failed to allocate buffer";
+        if(!buffer_id) return _data;
+
+        auto* buffer_v = buffer::get_buffer(*buffer_id);
+        EXPECT_NE(buffer_v, nullptr);
+        if(!buffer_v) return _data;
+        for(auto& itr : buffer_v->buffers)
+            EXPECT_TRUE(itr.allocate(buffer_size));
+        buffer_v->task_group_id = cb_thread.handle;
+        buffer_v->watermark     = watermark;
+        buffer_v->policy        = ROCPROFILER_BUFFER_POLICY_LOSSLESS;
+        buffer_v->callback      = flush_order_callback;
+        buffer_v->callback_data = &_data.at(i);
+        _buffers.emplace_back(buffer_v);
+    }
+
+    // each thread owns a subset of the buffers so that the values within a buffer are
+    // monotonically increasing
+    auto _threads = std::vector<std::thread>{};
+    for(size_t t = 0; t < num_threads; ++t)
+    {
+        _threads.emplace_back([&_buffers, t]() {
+            for(uint64_t i = 0; i < records_per_buffer; ++i)
+            {
+                for(size_t b = t; b < num_buffers; b += num_threads)
+                    _buffers.at(b)->emplace(1, 1, i);
+            }
+        });
+    }
+
+    for(auto& itr : _threads)
+        itr.join();
+
+    for(auto* itr : _buffers)
+        EXPECT_EQ(buffer::flush(itr->buffer_id, true), ROCPROFILER_STATUS_SUCCESS);
+
+    for(size_t i = 0; i < num_buffers; ++i)
+    {
+        EXPECT_EQ(_data.at(i).num_errors, 0) << "buffer " << i << " records out of order";
+        EXPECT_EQ(_data.at(i).num_records, records_per_buffer) << "buffer " << i;
+        EXPECT_GT(_data.at(i).num_flushes.load(), 0) << "buffer " << i;
+    }
+
+    for(auto* itr : _buffers)
+        EXPECT_EQ(rocprofiler_destroy_buffer(rocprofiler_buffer_id_t{itr->buffer_id}),
+                  ROCPROFILER_STATUS_SUCCESS);
+
+    return _data;
+}
+}  // namespace
+
+TEST(rocprofiler_lib, buffer_flush_executor)
+{
+    check_flush_order(rocprofiler_callback_thread_t{0});
+}
+
+/**
+ * The buffers on the default callback thread are flushed by several workers
+ */
+TEST(rocprofiler_lib, buffer_flush_executor_workers)
+{
+    namespace internal_threading = ::rocprofiler::internal_threading;
+
+    constexpr size_t num_workers = 4;
+
+    // the executor is created with the first buffer, i.e. by an earlier test when all the tests
+    // run in the same process
+    ::setenv("ROCPROFILER_BUFFER_FLUSH_THREADS", std::to_string(num_workers).c_str(), 1);
+    internal_threading::initialize();
+
+    auto* executor = internal_threading::get_flush_executor(rocprofiler_callback_thread_t{0});
+    ASSERT_NE(executor, nullptr);
+    if(executor->num_workers() != num_workers)
+        GTEST_SKIP() << "flush executor was created with " << executor->num_workers()
+                     << " worker(s) by an earlier test";
+
+    check_flush_order(rocprofiler_callback_thread_t{0});
+}
+
+/**
+ * The buffers assigned to a callback thread created by the tool are all delivered on that thread
+ */
+TEST(rocprofiler_lib, buffer_flush_callback_thread)
+{
+    auto cb_thread = rocprofiler_callback_thread_t{};
+    ASSERT_EQ(rocprofiler_create_callback_thread(&cb_thread), ROCPROFILER_STATUS_SUCCESS);
+    ASSERT_GT(cb_thread.handle, 0);
+
+    auto _data = check_flush_order(cb_thread);
+    ASSERT_FALSE(_data.empty());
+    for(const auto& itr : _data)
+        EXPECT_EQ(itr.callback_thread, _data.front().callback_thread);
+    EXPECT_NE(_data.front().callback_thread, std::this_thread::get_id());
+}
+
+namespace
+{
+struct flush_latency_data
+{
+    std::atomic<uint64_t> num_records = {};
+    std::atomic<uint64_t> num_flushes = {};
+};
+
+void
+flush_latency_callback(rocprofiler_context_id_t,
+                       rocprofiler_buffer_id_t,
+                       rocprofiler_record_header_t**,
+                       size_t num_headers,
+                       void*  data,
+                       uint64_t)
+{
+    auto* _data = static_cast<flush_latency_data*>(data);
+    // simulate a slow consumer: the time to drain the records grows with the number of records
+    std::this_thread::sleep_for(num_headers * std::chrono::microseconds{2});
+    _data->num_records += num_headers;
+    ++_data->num_flushes;
+}
+}  // namespace
+
+/**
+ * Records in a buffer which never reaches its watermark are delivered by the flush timer within
+ * the max latency, also after the timer was stopped and restarted, and the adaptive watermark
+ * drops below the configured watermark when the callback cannot drain a full watermark within
+ * the max latency
+ */
+TEST(rocprofiler_lib, buffer_flush_policy)
+{
+    namespace buffer = ::rocprofiler::buffer;
+
+    constexpr uint64_t max_latency = 20 * 1000 * 1000;
+    constexpr size_t   buffer_size = 256 * 4096;
+
+    auto _make_buffer = [](flush_latency_data* _data, bool _adaptive) {
+        auto buffer_id = buffer::allocate_buffer();
+        EXPECT_TRUE(buffer_id) << "failed to allocate buffer";
+
+        auto* buffer_v = buffer::get_buffer(*buffer_id);
+        for(auto& itr : buffer_v->buffers)
+            EXPECT_TRUE(itr.allocate(buffer_size));
+        buffer_v->watermark     = buffer_size / 2;
+        buffer_v->policy        = ROCPROFILER_BUFFER_POLICY_LOSSLESS;
+        buffer_v->callback      = flush_latency_callback;
+        buffer_v->callback_data = _data;
+        buffer::set_flush_policy(buffer_v,
+                                 buffer::flush_policy{.max_latency        = max_latency,
+                                                      .adaptive_watermark = _adaptive});
+        return buffer_v;
+    };
+
+    // low-rate buffer: never reaches the watermark
+    auto _check_timer_flush = [&_make_buffer]() {
+        auto  _data    = flush_latency_data{};
+        auto* buffer_v = _make_buffer(&_data, false);
+
+        for(uint64_t i = 0; i < 10; ++i)
+            buffer_v->emplace(1, 1, i);
+
+        // the timer wakes up every max_latency / 2
+        for(size_t i = 0; i < 200 && _data.num_records.load() < 10; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+
+        EXPECT_EQ(_data.num_records.load(), 10) << "records were not flushed by the timer";
+        EXPECT_EQ(buffer_v->get_watermark(), buffer_v->watermark);
+        EXPECT_EQ(rocprofiler_destroy_buffer(rocprofiler_buffer_id_t{buffer_v->buffer_id}),
+                  ROCPROFILER_STATUS_SUCCESS);
+    };
+
+    _check_timer_flush();
+
+    // the timer stopped by finalize is restarted by the next buffer with a max latency
+    buffer::finalize();
+    _check_timer_flush();
+
+    // high-rate buffer with a slow consumer
+    {
+        auto  _data    = flush_latency_data{};
+        auto* buffer_v = _make_buffer(&_data, true);
+
+        constexpr uint64_t num_records = 200000;
+        for(uint64_t i = 0; i < num_records; ++i)
+            buffer_v->emplace(1, 1, i);
+
+        EXPECT_EQ(buffer::flush(buffer_v->buffer_id, true), ROCPROFILER_STATUS_SUCCESS);
+        EXPECT_EQ(_data.num_records.load(), num_records);
+        EXPECT_GT(buffer_v->get_watermark(), 0);
+        EXPECT_LT(buffer_v->get_watermark(), buffer_v->watermark)
+            << "the watermark was not lowered for a consumer slower than the max latency";
+
+        EXPECT_EQ(rocprofiler_destroy_buffer(rocprofiler_buffer_id_t{buffer_v->buffer_id}),
+                  ROCPROFILER_STATUS_SUCCESS);
+    }
+
+    buffer::finalize();
+}
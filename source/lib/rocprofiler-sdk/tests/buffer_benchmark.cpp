@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/buffer.hpp"
+
+#include <rocprofiler-sdk/buffer.h>
+#include <rocprofiler-sdk/fwd.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct flush_count_data
+{
+    std::atomic<uint64_t> num_records = {};
+    std::atomic<uint64_t> num_flushes = {};
+};
+
+void
+flush_count_callback(rocprofiler_context_id_t,
+                     rocprofiler_buffer_id_t,
+                     rocprofiler_record_header_t**,
+                     size_t num_headers,
+                     void*  data,
+                     uint64_t)
+{
+    auto* _data = static_cast<flush_count_data*>(data);
+    _data->num_records += num_headers;
+    ++_data->num_flushes;
+}
+}  // namespace
+
+/**
+ * Measures the rate at which records emplaced concurrently into many buffers are delivered by
+ * the shared flush executor
+ */
+TEST(rocprofiler_lib, buffer_flush_executor_benchmark)
+{
+    namespace buffer = ::rocprofiler::buffer;
+
+    constexpr size_t   num_buffers        = 32;
+    constexpr size_t   num_threads        = 8;
+    constexpr uint64_t records_per_buffer = 200000;
+    constexpr size_t   buffer_size        = 16 * 4096;
+    constexpr uint64_t watermark          = 256;
+    static_assert(num_buffers % num_threads == 0, "threads must own the same number of buffers");
+
+    auto _data    = std::vector<flush_count_data>(num_buffers);
+    auto _buffers = std::vector<buffer::instance*>{};
+    for(size_t i = 0; i < num_buffers; ++i)
+    {
+        auto buffer_id = buffer::allocate_buffer();
+        ASSERT_TRUE(buffer_id) << "failed to allocate buffer";
+
+        auto* buffer_v = buffer::get_buffer(*buffer_id);
+        ASSERT_NE(buffer_v, nullptr);
+        for(auto& itr : buffer_v->buffers)
+            ASSERT_TRUE(itr.allocate(buffer_size));
+        buffer_v->watermark     = watermark;
+        buffer_v->policy        = ROCPROFILER_BUFFER_POLICY_LOSSLESS;
+        buffer_v->callback      = flush_count_callback;
+        buffer_v->callback_data = &_data.at(i);
+        _buffers.emplace_back(buffer_v);
+    }
+
+    auto _threads = std::vector<std::thread>{};
+    auto _t0      = std::chrono::steady_clock::now();
+    for(size_t t = 0; t < num_threads; ++t)
+    {
+        _threads.emplace_back([&_buffers, t]() {
+            for(uint64_t i = 0; i < records_per_buffer; ++i)
+            {
+                for(size_t b = t; b < num_buffers; b += num_threads)
+                    _buffers.at(b)->emplace(1, 1, i);
+            }
+        });
+    }
+
+    for(auto& itr : _threads)
+        itr.join();
+
+    for(auto* itr : _buffers)
+        EXPECT_EQ(buffer::flush(itr->buffer_id, true), ROCPROFILER_STATUS_SUCCESS);
+    auto _t1 = std::chrono::steady_clock::now();
+
+    uint64_t _num_flushes = 0;
+    for(size_t i = 0; i < num_buffers; ++i)
+    {
+        EXPECT_EQ(_data.at(i).num_records.load(), records_per_buffer) << "buffer " << i;
+        _num_flushes += _data.at(i).num_flushes.load();
+    }
+
+    for(auto* itr : _buffers)
+        EXPECT_EQ(rocprofiler_destroy_buffer(rocprofiler_buffer_id_t{itr->buffer_id}),
+                  ROCPROFILER_STATUS_SUCCESS);
+
+    auto _elapsed = std::chrono::duration<double>(_t1 - _t0).count();
+    auto _total   = num_buffers * records_per_buffer;
+    std::cout << "Benchmark: " << _total << " records in " << num_buffers << " buffers ("
+              << _num_flushes << " flushes) delivered in " << _elapsed << " sec ("
+              << (_total / _elapsed / 1.0e6) << " M records/sec)" << std::endl;
+}
@@ -53,27 +53,99 @@ return_line(const std::string_view line)
 {
     static int        line_no = 0;
     std::stringstream strs{};
-    strs << fmt::format("This is {} Line {}", line_no * 10, line_no);
+    strs << fmt::format("This is {} Line {}", line_no % 5 * 10, line_no % 5);
     EXPECT_EQ(strs.str(), line);
     line_no++;
 }
 
 auto
-parse_lines()
+parse_lines(size_t read_size)
 {
-    KFD_EVENT_PARSE_EVENTS(MULTILINE_STRING, return_line);
+    // the string is split as if it was returned by multiple reads of read_size bytes
+    auto reader = ::rocprofiler::page_migration::smi_line_reader{};
+    for(size_t i = 0; i < MULTILINE_STRING.size(); i += read_size)
+        reader(MULTILINE_STRING.substr(i, read_size), return_line);
+    EXPECT_TRUE(reader.pending.empty());
 }
 
 TEST(page_migration, readlines)
 {
     // Ensure all lines are read
-    parse_lines();
+    parse_lines(MULTILINE_STRING.size());
+    // Ensure lines split across reads are completed by the next read
+    parse_lines(1);
+    parse_lines(7);
 }
 
 TEST(page_migration, parse_kvm_events)
 {
-    // Ensure all lines are read
-    parse_lines();
+    using ::rocprofiler::page_migration::smi_cursor;
+
+    // migrate start: "%x %ld -%d @%lx(%lx) %x->%x %x:%x %d"
+    {
+        uint32_t kind = 0, pid = 0, from = 0, to = 0, prefetch = 0, preferred = 0;
+        uint64_t timestamp = 0, start = 0, pages = 0;
+        int32_t  trigger   = -1;
+
+        auto cursor = smi_cursor{"5 1234567 -42 @7f001(20) 0->2 0:2 1"};
+        cursor.hex(kind)
+            .dec(timestamp)
+            .skip('-')
+            .dec(pid)
+            .skip('@')
+            .hex(start)
+            .skip('(')
+            .hex(pages)
+            .skip(')')
+            .hex(from)
+            .skip('-')
+            .skip('>')
+            .hex(to)
+            .hex(prefetch)
+            .skip(':')
+            .hex(preferred)
+            .dec(trigger);
+
+        EXPECT_TRUE(cursor);
+        EXPECT_EQ(kind, KFD_SMI_EVENT_MIGRATE_START);
+        EXPECT_EQ(timestamp, 1234567);
+        EXPECT_EQ(pid, 42);
+        EXPECT_EQ(start, 0x7f001);
+        EXPECT_EQ(pages, 0x20);
+        EXPECT_EQ(from, 0);
+        EXPECT_EQ(to, 2);
+        EXPECT_EQ(prefetch, 0);
+        EXPECT_EQ(preferred, 2);
+        EXPECT_EQ(trigger, 1);
+    }
+
+    // queue restore: "%x %ld -%d %x" optionally followed by 'R' if the queue was rescheduled
+    {
+        uint32_t kind = 0, pid = 0, node = 0;
+        uint64_t timestamp = 0;
+
+        auto rescheduled = smi_cursor{"a 99 -7 3 R"};
+        rescheduled.hex(kind).dec(timestamp).skip('-').dec(pid).hex(node);
+        EXPECT_TRUE(rescheduled);
+        EXPECT_EQ(kind, KFD_SMI_EVENT_QUEUE_RESTORE);
+        EXPECT_EQ(node, 3);
+        EXPECT_EQ(rescheduled.peek(), 'R');
+
+        auto restored = smi_cursor{"a 99 -7 3"};
+        restored.hex(kind).dec(timestamp).skip('-').dec(pid).hex(node);
+        EXPECT_TRUE(restored);
+        EXPECT_EQ(restored.peek(), '\0');
+    }
+
+    // malformed line
+    {
+        uint32_t kind = 0, pid = 0;
+        uint64_t timestamp = 0;
+
+        auto cursor = smi_cursor{"7 1234567 @7f001"};
+        cursor.hex(kind).dec(timestamp).skip('-').dec(pid);
+        EXPECT_FALSE(cursor);
+    }
 }
 
 TEST(page_migtation, rocprof_kfd_map)
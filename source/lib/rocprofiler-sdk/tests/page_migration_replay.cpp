@@ -0,0 +1,187 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <rocprofiler-sdk/buffer.h>
+#include <rocprofiler-sdk/buffer_tracing.h>
+#include <rocprofiler-sdk/fwd.h>
+#include <rocprofiler-sdk/rocprofiler.h>
+
+#include "lib/common/filesystem.hpp"
+#include "lib/rocprofiler-sdk/context/context.hpp"
+#include "lib/rocprofiler-sdk/context/domain.hpp"
+#include "lib/rocprofiler-sdk/details/kfd_ioctl.h"
+#include "lib/rocprofiler-sdk/page_migration/page_migration.hpp"
+#include "lib/rocprofiler-sdk/registration.hpp"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+using namespace rocprofiler;
+
+namespace
+{
+namespace fs = common::filesystem;
+
+#define EXPECT_ROCP_SUCCESS(...)                                                                   \
+    EXPECT_EQ(ROCPROFILER_STATUS_SUCCESS, (__VA_ARGS__)) << #__VA_ARGS__
+
+using page_migration_record_t = rocprofiler_buffer_tracing_page_migration_record_t;
+
+struct replay_data
+{
+    uint64_t num_records     = 0;
+    uint64_t num_unpaired    = 0;
+    uint64_t num_migrated    = 0;
+    uint64_t num_rescheduled = 0;
+
+    // number of records per operation
+    std::array<uint64_t, ROCPROFILER_PAGE_MIGRATION_LAST> operations = {};
+};
+
+void
+replay_buffer_callback(rocprofiler_context_id_t,
+                       rocprofiler_buffer_id_t,
+                       rocprofiler_record_header_t** headers,
+                       size_t                        num_headers,
+                       void*                         data,
+                       uint64_t)
+{
+    auto* _data = static_cast<replay_data*>(data);
+    for(size_t i = 0; i < num_headers; ++i)
+    {
+        if(headers[i]->category != ROCPROFILER_BUFFER_CATEGORY_TRACING ||
+           headers[i]->kind != ROCPROFILER_BUFFER_TRACING_PAGE_MIGRATION)
+            continue;
+
+        auto* _record = static_cast<page_migration_record_t*>(headers[i]->payload);
+        ++_data->num_records;
+        ++_data->operations.at(_record->operation);
+        if(_record->start_timestamp == 0 || _record->start_timestamp > _record->end_timestamp)
+            ++_data->num_unpaired;
+        if(_record->operation == ROCPROFILER_PAGE_MIGRATION_PAGE_FAULT &&
+           _record->page_fault.migrated)
+            ++_data->num_migrated;
+        if(_record->operation == ROCPROFILER_PAGE_MIGRATION_QUEUE_SUSPEND &&
+           _record->queue_suspend.rescheduled)
+            ++_data->num_rescheduled;
+    }
+}
+
+// writes num_iterations of migrate, page fault, queue eviction and unmap events in the format of
+// the KFD SMI event file descriptor, i.e. 7 events per iteration
+void
+write_smi_events(const std::string& filename, uint64_t num_iterations)
+{
+    constexpr auto migrate_start = static_cast<uint32_t>(KFD_SMI_EVENT_MIGRATE_START);
+    constexpr auto migrate_end   = static_cast<uint32_t>(KFD_SMI_EVENT_MIGRATE_END);
+    constexpr auto fault_start   = static_cast<uint32_t>(KFD_SMI_EVENT_PAGE_FAULT_START);
+    constexpr auto fault_end     = static_cast<uint32_t>(KFD_SMI_EVENT_PAGE_FAULT_END);
+    constexpr auto queue_evict   = static_cast<uint32_t>(KFD_SMI_EVENT_QUEUE_EVICTION);
+    constexpr auto queue_restore = static_cast<uint32_t>(KFD_SMI_EVENT_QUEUE_RESTORE);
+    constexpr auto unmap         = static_cast<uint32_t>(KFD_SMI_EVENT_UNMAP_FROM_GPU);
+
+    auto ofs = std::ofstream{filename};
+    auto ts  = uint64_t{1000};
+    auto pid = getpid();
+    for(uint64_t i = 0; i < num_iterations; ++i)
+    {
+        auto addr     = 0x7f0000 + (i * 0x10);
+        auto migrated = (i % 2 == 0) ? 'M' : 'U';
+        auto resched  = (i % 2 == 0) ? " R" : "";
+
+        ofs << fmt::format(
+            "{:x} {} -{} @{:x}({:x}) 0->1 0:1 0\n", migrate_start, ts++, pid, addr, 0x10);
+        ofs << fmt::format("{:x} {} -{} @{:x}({:x}) 0->1 0\n", migrate_end, ts++, pid, addr, 0x10);
+        ofs << fmt::format("{:x} {} -{} @{:x}(1) W\n", fault_start, ts++, pid, addr);
+        ofs << fmt::format("{:x} {} -{} @{:x}(1) {}\n", fault_end, ts++, pid, addr, migrated);
+        ofs << fmt::format("{:x} {} -{} 1 0\n", queue_evict, ts++, pid);
+        ofs << fmt::format("{:x} {} -{} 1{}\n", queue_restore, ts++, pid, resched);
+        ofs << fmt::format("{:x} {} -{} @{:x}({:x}) 1 0\n", unmap, ts++, pid, addr, 0x10);
+    }
+}
+}  // namespace
+
+/**
+ * Replays a synthetic KFD SMI event stream, i.e. without a GPU, through the page migration event
+ * parser and verifies the paired records delivered to the buffer. The file is read in blocks which
+ * are not a multiple of the line length so events are split across reads
+ */
+TEST(page_migration, replay)
+{
+    constexpr uint64_t num_iterations = 2000;
+    constexpr uint64_t num_events     = 7 * num_iterations;
+
+    registration::init_logging();
+    registration::set_init_status(-1);
+    context::push_client(1);
+
+    auto _data      = replay_data{};
+    auto _context   = rocprofiler_context_id_t{};
+    auto _buffer_id = rocprofiler_buffer_id_t{};
+    EXPECT_ROCP_SUCCESS(rocprofiler_create_context(&_context));
+    EXPECT_ROCP_SUCCESS(rocprofiler_create_buffer(_context,
+                                                  256 * 4096,
+                                                  128 * 4096,
+                                                  ROCPROFILER_BUFFER_POLICY_LOSSLESS,
+                                                  replay_buffer_callback,
+                                                  &_data,
+                                                  &_buffer_id));
+
+    // equivalent of rocprofiler_configure_buffer_tracing_service without opening the KFD
+    auto* _ctx = context::get_mutable_registered_context(_context);
+    ASSERT_NE(_ctx, nullptr);
+    _ctx->buffered_tracer = std::make_unique<context::buffer_tracing_service>();
+    _ctx->buffered_tracer->buffer_data.at(ROCPROFILER_BUFFER_TRACING_PAGE_MIGRATION) = _buffer_id;
+    EXPECT_ROCP_SUCCESS(context::add_domain(_ctx->buffered_tracer->domains,
+                                            ROCPROFILER_BUFFER_TRACING_PAGE_MIGRATION));
+    EXPECT_ROCP_SUCCESS(rocprofiler_start_context(_context));
+
+    auto _filename = (fs::temp_directory_path() /
+                      fmt::format("rocprofiler-smi-replay-{}.txt", getpid()))
+                         .string();
+    write_smi_events(_filename, num_iterations);
+
+    auto _events = page_migration::replay(_filename, 4093);
+    EXPECT_ROCP_SUCCESS(rocprofiler_flush_buffer(_buffer_id));
+
+    EXPECT_EQ(_events, num_events);
+    // start events are only reported with their end event
+    EXPECT_EQ(_data.num_records, 4 * num_iterations);
+    EXPECT_EQ(_data.num_unpaired, 0);
+    EXPECT_EQ(_data.operations[ROCPROFILER_PAGE_MIGRATION_PAGE_MIGRATE], num_iterations);
+    EXPECT_EQ(_data.operations[ROCPROFILER_PAGE_MIGRATION_PAGE_FAULT], num_iterations);
+    EXPECT_EQ(_data.operations[ROCPROFILER_PAGE_MIGRATION_QUEUE_SUSPEND], num_iterations);
+    EXPECT_EQ(_data.operations[ROCPROFILER_PAGE_MIGRATION_UNMAP_FROM_GPU], num_iterations);
+    EXPECT_EQ(_data.num_migrated, num_iterations / 2);
+    EXPECT_EQ(_data.num_rescheduled, num_iterations / 2);
+
+    EXPECT_ROCP_SUCCESS(rocprofiler_stop_context(_context));
+    EXPECT_ROCP_SUCCESS(rocprofiler_destroy_buffer(_buffer_id));
+    fs::remove(_filename);
+}
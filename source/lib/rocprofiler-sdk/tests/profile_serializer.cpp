@@ -0,0 +1,217 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include "lib/rocprofiler-sdk/hsa/agent_cache.hpp"
+#include "lib/rocprofiler-sdk/hsa/hsa_barrier.hpp"
+#include "lib/rocprofiler-sdk/hsa/profile_serializer.hpp"
+#include "lib/rocprofiler-sdk/hsa/queue.hpp"
+#include "lib/rocprofiler-sdk/registration.hpp"
+#include "lib/rocprofiler-sdk/tests/queue_mocks.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace rocprofiler;
+using namespace rocprofiler::hsa;
+
+namespace
+{
+using mock_queue_vec_t = std::vector<mock_queue*>;
+
+profiler_serializer::queue_map_t
+create_queue_map(const std::vector<mock_agent*>& agents,
+                 size_t                          num_queues,
+                 std::vector<mock_queue_vec_t>&  agent_queues)
+{
+    auto ret = profiler_serializer::queue_map_t{};
+    agent_queues.clear();
+    agent_queues.resize(agents.size());
+    for(size_t i = 0; i < agents.size(); ++i)
+    {
+        for(size_t j = 0; j < num_queues; ++j)
+        {
+            auto  _id    = (i * num_queues) + j;
+            auto* _queue = new mock_queue{agents.at(i)->cache, _id};
+            // the map is only keyed by the queue, any unique address will do
+            ret.emplace(reinterpret_cast<hsa_queue_t*>(_id + 1), _queue);
+            agent_queues.at(i).emplace_back(_queue);
+        }
+    }
+    return ret;
+}
+}  // namespace
+
+TEST(profile_serializer, per_agent_ordering)
+{
+    registration::init_logging();
+
+    constexpr size_t num_queues  = 4;
+    constexpr size_t num_kernels = 64;  // per queue
+    constexpr auto   timeout     = std::chrono::seconds{10};
+
+    auto _agent_a = mock_agent{0};
+    auto _agent_b = mock_agent{1};
+    auto _agents  = std::vector<mock_agent*>{&_agent_a, &_agent_b};
+
+    auto _serializers = agent_serializers{};
+    for(auto* itr : _agents)
+        _serializers.add_agent(itr->cache, itr->core);
+
+    auto _agent_queues = std::vector<mock_queue_vec_t>{};
+    auto _queues       = create_queue_map(_agents, num_queues, _agent_queues);
+    _serializers.enable(_queues);
+
+    auto _started  = std::array<std::atomic<size_t>, 2>{};
+    auto _overlap  = std::array<size_t, 2>{};
+    auto _order    = std::array<std::vector<size_t>, 2>{};
+    auto _failures = std::array<size_t, 2>{};
+
+    // acts as the runtime and the GPU of an agent: every queue has one kernel ready at a time
+    // and the ready signal handler of the queue is invoked once the previous kernel completed
+    auto _run_agent = [&](size_t idx) {
+        auto& _queues_v   = _agent_queues.at(idx);
+        auto& _serializer = _serializers.get(*_queues_v.front());
+        auto  _other      = (idx + 1) % 2;
+
+        for(auto* itr : _queues_v)
+            _serializer.wlock([itr](auto& serializer) { serializer.queue_ready(nullptr, *itr); });
+
+        for(size_t i = 0; i < num_queues * num_kernels; ++i)
+        {
+            // exactly one kernel of the agent is dispatched
+            mock_queue* _dispatched     = nullptr;
+            size_t      _num_dispatched = 0;
+            for(size_t j = 0; j < _queues_v.size(); ++j)
+            {
+                if(!_queues_v.at(j)->dispatched()) continue;
+                _dispatched = _queues_v.at(j);
+                _order.at(idx).emplace_back(j);
+                ++_num_dispatched;
+            }
+
+            if(_num_dispatched != 1)
+            {
+                ++_failures.at(idx);
+                break;
+            }
+
+            // the kernel stays active until the kernel of the other agent is active as well
+            _started.at(idx).store(i + 1);
+            auto _end = std::chrono::steady_clock::now() + timeout;
+            while(_started.at(_other).load() <= i && std::chrono::steady_clock::now() < _end)
+                std::this_thread::yield();
+            if(_started.at(_other).load() > i) ++_overlap.at(idx);
+
+            _serializer.wlock(
+                [&](auto& serializer) { serializer.kernel_completion_signal(*_dispatched); });
+
+            if((i / num_queues) + 1 < num_kernels)
+            {
+                _serializer.wlock(
+                    [&](auto& serializer) { serializer.queue_ready(nullptr, *_dispatched); });
+            }
+        }
+    };
+
+    auto _threads = std::vector<std::thread>{};
+    for(size_t i = 0; i < _agents.size(); ++i)
+        _threads.emplace_back(_run_agent, i);
+    for(auto& itr : _threads)
+        itr.join();
+
+    for(size_t i = 0; i < _agents.size(); ++i)
+    {
+        EXPECT_EQ(_failures.at(i), 0) << "agent " << i;
+        // the kernels of an agent are dispatched in the order their queues became ready
+        ASSERT_EQ(_order.at(i).size(), num_queues * num_kernels) << "agent " << i;
+        for(size_t j = 0; j < _order.at(i).size(); ++j)
+        {
+            EXPECT_EQ(_order.at(i).at(j), j % num_queues) << "agent " << i << ", kernel " << j;
+        }
+        // every kernel completed while a kernel of the other agent was active
+        EXPECT_EQ(_overlap.at(i), num_queues * num_kernels) << "agent " << i;
+        for(auto* itr : _agent_queues.at(i))
+            EXPECT_FALSE(itr->dispatched());
+    }
+
+    _serializers.disable(_queues);
+}
+
+TEST(profile_serializer, per_agent_barriers)
+{
+    registration::init_logging();
+
+    auto _agent_a = mock_agent{0};
+    auto _agent_b = mock_agent{1};
+    auto _agents  = std::vector<mock_agent*>{&_agent_a, &_agent_b};
+
+    auto _serializers = agent_serializers{};
+    for(auto* itr : _agents)
+        _serializers.add_agent(itr->cache, itr->core);
+
+    auto _agent_queues = std::vector<mock_queue_vec_t>{};
+    auto _queues       = create_queue_map(_agents, 2, _agent_queues);
+    _serializers.enable(_queues);
+
+    // a serialized kernel is active on agent A only
+    auto* _active      = _agent_queues.at(0).at(0);
+    auto& _serializer  = _serializers.get(*_active);
+    _serializer.wlock([&](auto& serializer) { serializer.queue_ready(nullptr, *_active); });
+    _active->async_started();
+    ASSERT_TRUE(_active->dispatched());
+
+    _serializers.disable(_queues);
+
+    // returns the value of the dependency signal of the barrier packet preceding the next kernel
+    auto _barrier_value = [&](const mock_queue& queue) -> int64_t {
+        auto _pkts = _serializers.get(queue).rlock(
+            [&](const auto& serializer) { return serializer.kernel_dispatch(queue); });
+        // serialization is disabled, i.e. only the transition barrier is inserted
+        EXPECT_EQ(_pkts.size(), 1);
+        if(_pkts.empty()) return -1;
+        return mock_signal_load(_pkts.front().barrier_and.dep_signal[0]);
+    };
+
+    // the queues of agent B do not wait for the kernel of agent A
+    for(auto* itr : _agent_queues.at(1))
+        EXPECT_EQ(_barrier_value(*itr), 0);
+
+    // the queues of agent A wait until the serialized kernel completes
+    for(auto* itr : _agent_queues.at(0))
+        EXPECT_EQ(_barrier_value(*itr), 1);
+
+    _active->async_complete();
+    _serializer.wlock([&](auto& serializer) { serializer.kernel_completion_signal(*_active); });
+    EXPECT_FALSE(_active->dispatched());
+
+    // the barrier of agent A was released by the completion of the kernel
+    auto _pkts = _serializer.rlock(
+        [&](const auto& serializer) { return serializer.kernel_dispatch(*_active); });
+    EXPECT_TRUE(_pkts.empty());
+}
@@ -0,0 +1,266 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/hsa/agent_cache.hpp"
+#include "lib/rocprofiler-sdk/hsa/hsa.hpp"
+#include "lib/rocprofiler-sdk/hsa/queue.hpp"
+
+#include <hsa/hsa.h>
+#include <hsa/hsa_api_trace.h>
+#include <hsa/hsa_ext_amd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+using namespace ::rocprofiler;
+
+// signal of the mock runtime, the handle is the address of the value
+struct mock_signal
+{
+    std::atomic<hsa_signal_value_t> value = {};
+};
+
+inline mock_signal*
+get_signal(hsa_signal_t signal)
+{
+    return reinterpret_cast<mock_signal*>(signal.handle);
+}
+
+inline hsa_status_t
+mock_signal_create(hsa_signal_value_t initial_value,
+                   uint32_t,
+                   const hsa_agent_t*,
+                   hsa_signal_t* signal)
+{
+    auto* _signal = new mock_signal{};
+    _signal->value.store(initial_value);
+    signal->handle = reinterpret_cast<uint64_t>(_signal);
+    return HSA_STATUS_SUCCESS;
+}
+
+inline hsa_status_t
+mock_amd_signal_create(hsa_signal_value_t initial_value,
+                       uint32_t           num_consumers,
+                       const hsa_agent_t* consumers,
+                       uint64_t,
+                       hsa_signal_t* signal)
+{
+    return mock_signal_create(initial_value, num_consumers, consumers, signal);
+}
+
+inline hsa_status_t
+mock_signal_destroy(hsa_signal_t signal)
+{
+    delete get_signal(signal);
+    return HSA_STATUS_SUCCESS;
+}
+
+inline void
+mock_signal_store(hsa_signal_t signal, hsa_signal_value_t value)
+{
+    get_signal(signal)->value.store(value);
+}
+
+inline hsa_signal_value_t
+mock_signal_load(hsa_signal_t signal)
+{
+    return get_signal(signal)->value.load();
+}
+
+inline void
+mock_signal_add(hsa_signal_t signal, hsa_signal_value_t value)
+{
+    get_signal(signal)->value.fetch_add(value);
+}
+
+inline void
+mock_signal_subtract(hsa_signal_t signal, hsa_signal_value_t value)
+{
+    get_signal(signal)->value.fetch_sub(value);
+}
+
+inline hsa_signal_value_t
+mock_signal_wait(hsa_signal_t signal,
+                 hsa_signal_condition_t,
+                 hsa_signal_value_t compare_value,
+                 uint64_t,
+                 hsa_wait_state_t)
+{
+    while(get_signal(signal)->value.load() != compare_value)
+        std::this_thread::yield();
+    return compare_value;
+}
+
+// handler registered for a signal of the mock runtime, see run_signal_handlers
+struct mock_signal_handler
+{
+    hsa_signal_t           signal  = {};
+    hsa_amd_signal_handler handler = nullptr;
+    void*                  arg     = nullptr;
+};
+
+inline std::vector<mock_signal_handler>&
+get_signal_handlers()
+{
+    static auto _v = std::vector<mock_signal_handler>{};
+    return _v;
+}
+
+inline hsa_status_t
+mock_signal_async_handler(hsa_signal_t signal,
+                          hsa_signal_condition_t,
+                          hsa_signal_value_t,
+                          hsa_amd_signal_handler handler,
+                          void*                  arg)
+{
+    get_signal_handlers().emplace_back(mock_signal_handler{signal, handler, arg});
+    return HSA_STATUS_SUCCESS;
+}
+
+// acts as the GPU completing every packet enqueued so far: invokes the registered signal
+// handlers and returns how many were invoked
+inline size_t
+run_signal_handlers()
+{
+    auto _handlers = std::move(get_signal_handlers());
+    get_signal_handlers().clear();
+    for(const auto& itr : _handlers)
+        itr.handler(mock_signal_load(itr.signal), itr.arg);
+    return _handlers.size();
+}
+
+inline hsa_status_t
+mock_system_get_info(hsa_system_info_t attribute, void* value)
+{
+    if(attribute != HSA_SYSTEM_INFO_TIMESTAMP_FREQUENCY) return HSA_STATUS_ERROR_INVALID_ARGUMENT;
+    *static_cast<uint64_t*>(value) = 1000000000UL;
+    return HSA_STATUS_SUCCESS;
+}
+
+inline hsa_status_t
+mock_iterate_memory_pools(hsa_agent_t,
+                          hsa_status_t (*)(hsa_amd_memory_pool_t, void*),
+                          void*)
+{
+    return HSA_STATUS_SUCCESS;
+}
+
+inline CoreApiTable
+get_mock_core_table()
+{
+    auto val                           = CoreApiTable{};
+    val.hsa_system_get_info_fn         = mock_system_get_info;
+    val.hsa_signal_create_fn           = mock_signal_create;
+    val.hsa_signal_destroy_fn          = mock_signal_destroy;
+    val.hsa_signal_store_screlease_fn  = mock_signal_store;
+    val.hsa_signal_load_scacquire_fn   = mock_signal_load;
+    val.hsa_signal_add_relaxed_fn      = mock_signal_add;
+    val.hsa_signal_subtract_relaxed_fn = mock_signal_subtract;
+    val.hsa_signal_wait_relaxed_fn     = mock_signal_wait;
+    return val;
+}
+
+inline AmdExtTable
+get_mock_ext_table()
+{
+    auto val                                  = AmdExtTable{};
+    val.hsa_amd_signal_create_fn              = mock_amd_signal_create;
+    val.hsa_amd_signal_async_handler_fn       = mock_signal_async_handler;
+    val.hsa_amd_agent_iterate_memory_pools_fn = mock_iterate_memory_pools;
+    return val;
+}
+
+// installs the mock runtime as the runtime used by the signal handlers of the queues
+struct mock_runtime
+{
+    mock_runtime()
+    : core{*hsa::get_core_table()}
+    {
+        *hsa::get_core_table() = get_mock_core_table();
+    }
+
+    ~mock_runtime() { *hsa::get_core_table() = core; }
+
+    mock_runtime(const mock_runtime&) = delete;
+    mock_runtime& operator=(const mock_runtime&) = delete;
+
+    CoreApiTable core = {};
+};
+
+// agent without memory pools or profile queue
+struct mock_agent
+{
+    explicit mock_agent(uint64_t id)
+    : rocp_agent{make_agent(id)}
+    , cache{&rocp_agent, hsa_agent_t{.handle = id + 1}, id, hsa_agent_t{}, ext, core}
+    {}
+
+    static rocprofiler_agent_t make_agent(uint64_t id)
+    {
+        auto val      = rocprofiler_agent_t{};
+        val.size      = sizeof(rocprofiler_agent_t);
+        val.id.handle = id;
+        val.type      = ROCPROFILER_AGENT_TYPE_GPU;
+        val.name      = "mock-agent";
+        return val;
+    }
+
+    CoreApiTable        core       = get_mock_core_table();
+    AmdExtTable         ext        = get_mock_ext_table();
+    rocprofiler_agent_t rocp_agent = {};
+    hsa::AgentCache     cache;
+};
+
+// queue of a mock agent, a kernel is dispatched on the queue while its block signal is zero
+class mock_queue : public hsa::Queue
+{
+public:
+    mock_queue(const hsa::AgentCache& agent, uint64_t id)
+    : Queue(agent, get_mock_core_table(), get_mock_ext_table())
+    , _id{id}
+    {
+        mock_signal_create(0, 0, nullptr, &ready_signal);
+        mock_signal_create(1, 0, nullptr, &block_signal);
+    }
+
+    ~mock_queue() override
+    {
+        mock_signal_destroy(ready_signal);
+        mock_signal_destroy(block_signal);
+    }
+
+    rocprofiler_queue_id_t get_id() const override { return {.handle = _id}; }
+
+    bool dispatched() const { return mock_signal_load(block_signal) == 0; }
+
+private:
+    uint64_t _id = 0;
+};
+}  // namespace
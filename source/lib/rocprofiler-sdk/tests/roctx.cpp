@@ -27,6 +27,7 @@
 #include <rocprofiler-sdk/callback_tracing.h>
 #include <rocprofiler-sdk/context.h>
 #include <rocprofiler-sdk/fwd.h>
+#include <rocprofiler-sdk/marker.h>
 #include <rocprofiler-sdk/marker/api_id.h>
 #include <rocprofiler-sdk/registration.h>
 #include <rocprofiler-sdk/rocprofiler.h>
@@ -273,6 +274,28 @@ tool_tracing_buffered(rocprofiler_context_id_t      context,
         EXPECT_GT(record->end_timestamp, 0) << info.str();
         EXPECT_LE(record->start_timestamp, record->end_timestamp) << info.str();
 
+        // functions with a message (or name) argument reference the interned string
+        if(record->kind == ROCPROFILER_BUFFER_TRACING_MARKER_NAME_API ||
+           record->operation == ROCPROFILER_MARKER_CORE_API_ID_roctxMarkA ||
+           record->operation == ROCPROFILER_MARKER_CORE_API_ID_roctxRangePushA ||
+           record->operation == ROCPROFILER_MARKER_CORE_API_ID_roctxRangeStartA)
+        {
+            const char* msg = nullptr;
+            EXPECT_EQ(rocprofiler_query_marker_message(record->message_id, &msg),
+                      ROCPROFILER_STATUS_SUCCESS)
+                << info.str();
+            ASSERT_NE(msg, nullptr) << info.str();
+            if(record->kind == ROCPROFILER_BUFFER_TRACING_MARKER_CORE_API)
+            {
+                EXPECT_EQ(std::string_view{msg}, std::string_view{"run_roctx_functions"})
+                    << info.str();
+            }
+        }
+        else
+        {
+            EXPECT_EQ(record->message_id, 0) << info.str();
+        }
+
         cb_data->client_callback_count++;
         last_corr_id = corr_id;
     }
@@ -0,0 +1,185 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <rocprofiler-sdk-roctx/roctx.h>
+#include <rocprofiler-sdk/buffer.h>
+#include <rocprofiler-sdk/context.h>
+#include <rocprofiler-sdk/fwd.h>
+#include <rocprofiler-sdk/marker.h>
+#include <rocprofiler-sdk/registration.h>
+#include <rocprofiler-sdk/rocprofiler.h>
+
+#include "lib/common/environment.hpp"
+#include "lib/common/units.hpp"
+#include "lib/rocprofiler-sdk/tests/common.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Measures the overhead of buffered roctxMarkA tracing from multiple threads. Messages are interned
+ * once so, regardless of the number of markers, the memory used for the messages is bounded by the
+ * number of unique messages. The number of markers per thread can be increased via the
+ * ROCPROFILER_MARKER_BENCHMARK_COUNT environment variable (e.g. 10000000)
+ */
+TEST(rocprofiler_lib, roctx_buffered_message_benchmark)
+{
+    using init_func_t = int (*)(rocprofiler_client_finalize_t, void*);
+    using fini_func_t = void (*)(void*);
+
+    struct benchmark_data
+    {
+        callback_data                cb_data     = {};
+        uint64_t                     num_records = 0;
+        std::unordered_set<uint64_t> message_ids = {};
+    };
+
+    constexpr size_t num_threads  = 8;
+    constexpr size_t num_messages = 64;
+
+    const auto num_markers =
+        rocprofiler::common::get_env<uint64_t>("ROCPROFILER_MARKER_BENCHMARK_COUNT", 1000000);
+
+    static rocprofiler_buffer_tracing_cb_t tool_buffered =
+        [](rocprofiler_context_id_t,
+           rocprofiler_buffer_id_t,
+           rocprofiler_record_header_t** headers,
+           size_t                        num_headers,
+           void*                         buffer_data,
+           uint64_t) {
+            auto* bm_data = static_cast<benchmark_data*>(buffer_data);
+            for(size_t i = 0; i < num_headers; ++i)
+            {
+                auto* record = static_cast<rocprofiler_buffer_tracing_marker_api_record_t*>(
+                    headers[i]->payload);
+                bm_data->message_ids.emplace(record->message_id);
+                ++bm_data->num_records;
+            }
+        };
+
+    static init_func_t tool_init = [](rocprofiler_client_finalize_t fini_func,
+                                      void*                         client_data) -> int {
+        auto* cb_data = &static_cast<benchmark_data*>(client_data)->cb_data;
+
+        cb_data->client_fini_func = fini_func;
+
+        ROCPROFILER_CALL(rocprofiler_create_context(&cb_data->client_ctx),
+                         "failed to create context");
+
+        ROCPROFILER_CALL(rocprofiler_create_buffer(cb_data->client_ctx,
+                                                   64 * ::rocprofiler::common::units::KiB,
+                                                   48 * ::rocprofiler::common::units::KiB,
+                                                   ROCPROFILER_BUFFER_POLICY_LOSSLESS,
+                                                   tool_buffered,
+                                                   client_data,
+                                                   &cb_data->client_buffer),
+                         "buffer creation failed");
+
+        ROCPROFILER_CALL(
+            rocprofiler_configure_buffer_tracing_service(cb_data->client_ctx,
+                                                         ROCPROFILER_BUFFER_TRACING_MARKER_CORE_API,
+                                                         nullptr,
+                                                         0,
+                                                         cb_data->client_buffer),
+            "buffer tracing service failed to configure");
+
+        ROCPROFILER_CALL(rocprofiler_start_context(cb_data->client_ctx),
+                         "rocprofiler context start failed");
+
+        return 0;
+    };
+
+    static fini_func_t tool_fini = [](void* client_data) -> void {
+        auto* cb_data = &static_cast<benchmark_data*>(client_data)->cb_data;
+        ROCPROFILER_CALL(rocprofiler_flush_buffer(cb_data->client_buffer),
+                         "rocprofiler buffer flush failed");
+    };
+
+    static auto bm_data = benchmark_data{};
+
+    static auto cfg_result =
+        rocprofiler_tool_configure_result_t{sizeof(rocprofiler_tool_configure_result_t),
+                                            tool_init,
+                                            tool_fini,
+                                            static_cast<void*>(&bm_data)};
+
+    static rocprofiler_configure_func_t rocp_init =
+        [](uint32_t, const char*, uint32_t, rocprofiler_client_id_t* client_id)
+        -> rocprofiler_tool_configure_result_t* {
+        bm_data.cb_data.client_id = client_id;
+        bm_data.cb_data.client_id->name =
+            ::testing::UnitTest::GetInstance()->current_test_info()->name();
+        return &cfg_result;
+    };
+
+    EXPECT_EQ(rocprofiler_force_configure(rocp_init), ROCPROFILER_STATUS_SUCCESS);
+
+    auto messages = std::vector<std::string>{};
+    for(size_t i = 0; i < num_messages; ++i)
+        messages.emplace_back("roctx_buffered_message_benchmark::iteration::" + std::to_string(i));
+
+    auto threads = std::vector<std::thread>{};
+    auto t0      = std::chrono::steady_clock::now();
+    for(size_t t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([&messages, num_markers, t]() {
+            for(size_t i = 0; i < num_markers; ++i)
+                roctxMarkA(messages[(i + t) % num_messages].c_str());
+        });
+    }
+    for(auto& itr : threads)
+        itr.join();
+    auto t1 = std::chrono::steady_clock::now();
+
+    ASSERT_NE(bm_data.cb_data.client_id, nullptr);
+    ASSERT_NE(bm_data.cb_data.client_fini_func, nullptr);
+
+    bm_data.cb_data.client_fini_func(*bm_data.cb_data.client_id);
+
+    EXPECT_EQ(bm_data.num_records, num_threads * num_markers);
+    EXPECT_EQ(bm_data.message_ids.size(), num_messages);
+
+    size_t message_bytes = 0;
+    for(auto itr : bm_data.message_ids)
+    {
+        const char* msg = nullptr;
+        ASSERT_EQ(rocprofiler_query_marker_message(itr, &msg), ROCPROFILER_STATUS_SUCCESS);
+        EXPECT_EQ(std::string_view{msg}.find("roctx_buffered_message_benchmark"), 0);
+        message_bytes += std::string_view{msg}.length() + 1;
+    }
+
+    auto elapsed_ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    std::cout << "Benchmark: " << num_threads << " threads x " << num_markers
+              << " buffered roctxMarkA calls in " << (elapsed_ns / 1.0e6) << " ms ("
+              << (elapsed_ns / static_cast<double>(num_markers)) << " ns/marker/thread). "
+              << bm_data.message_ids.size() << " unique messages stored in " << message_bytes
+              << " bytes (" << (bm_data.num_records * (message_bytes / num_messages))
+              << " bytes if copied per call)" << std::endl;
+}
@@ -0,0 +1,94 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <rocprofiler-sdk/buffer.h>
+#include <rocprofiler-sdk/buffer_tracing.h>
+#include <rocprofiler-sdk/fwd.h>
+#include <rocprofiler-sdk/rocprofiler.h>
+
+#include "lib/rocprofiler-sdk/context/context.hpp"
+#include "lib/rocprofiler-sdk/hsa/hsa.hpp"
+#include "lib/rocprofiler-sdk/hsa/scratch_memory.hpp"
+#include "lib/rocprofiler-sdk/registration.hpp"
+#include "lib/rocprofiler-sdk/tests/scratch_memory_mocks.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Drives the scratch memory tool API wrappers with synthetic events, i.e. without a GPU, and
+ * checks the records traced into a buffer
+ */
+TEST(scratch_memory, buffered_tracing)
+{
+    constexpr uint64_t num_events = 1000;
+    constexpr auto     agent_id   = rocprofiler_agent_id_t{.handle = 1234};
+
+    registration::init_logging();
+    registration::set_init_status(-1);
+    context::push_client(1);
+
+    auto _queues     = std::array<hsa_queue_t, 2>{};
+    _queues.at(0).id = 100;
+    _queues.at(1).id = 101;
+    for(const auto& itr : _queues)
+        hsa::scratch_memory::add_queue_agent(itr.id, agent_id);
+
+    auto _data      = scratch_record_data{};
+    _data.agent_id  = agent_id.handle;
+    auto _context   = rocprofiler_context_id_t{};
+    auto _buffer_id = rocprofiler_buffer_id_t{};
+    EXPECT_ROCP_SUCCESS(rocprofiler_create_context(&_context));
+    EXPECT_ROCP_SUCCESS(rocprofiler_create_buffer(_context,
+                                                  64 * 4096,
+                                                  32 * 4096,
+                                                  ROCPROFILER_BUFFER_POLICY_LOSSLESS,
+                                                  scratch_buffer_callback,
+                                                  &_data,
+                                                  &_buffer_id));
+    EXPECT_ROCP_SUCCESS(rocprofiler_configure_buffer_tracing_service(
+        _context, ROCPROFILER_BUFFER_TRACING_SCRATCH_MEMORY, nullptr, 0, _buffer_id));
+    EXPECT_ROCP_SUCCESS(rocprofiler_start_context(_context));
+
+    auto _table = get_noop_tool_table();
+    hsa::scratch_memory::copy_table(&_table, 0);
+    hsa::scratch_memory::update_table(&_table, 0);
+    ASSERT_NE(_table.hsa_amd_tool_scratch_event_alloc_start_fn, scratch_event_noop)
+        << "scratch memory events are not traced";
+
+    // same queue for every event and alternating queues, i.e. the agent of the queue is not
+    // remembered by the thread
+    run_scratch_events(_table, _queues.data(), 1, num_events);
+    run_scratch_events(_table, _queues.data(), 2, num_events);
+
+    // one record per start/end pair of the two traced runs
+    EXPECT_ROCP_SUCCESS(rocprofiler_flush_buffer(_buffer_id));
+    EXPECT_EQ(_data.num_records, 2 * num_events);
+    EXPECT_EQ(_data.num_errors, 0);
+
+    EXPECT_ROCP_SUCCESS(rocprofiler_stop_context(_context));
+    EXPECT_ROCP_SUCCESS(rocprofiler_destroy_buffer(_buffer_id));
+    for(const auto& itr : _queues)
+        hsa::scratch_memory::remove_queue_agent(itr.id);
+}
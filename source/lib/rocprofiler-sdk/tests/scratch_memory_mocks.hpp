@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <rocprofiler-sdk/buffer.h>
+#include <rocprofiler-sdk/buffer_tracing.h>
+#include <rocprofiler-sdk/fwd.h>
+
+#include "lib/rocprofiler-sdk/hsa/hsa.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+
+namespace
+{
+using namespace ::rocprofiler;
+
+#define EXPECT_ROCP_SUCCESS(...)                                                                   \
+    EXPECT_EQ(ROCPROFILER_STATUS_SUCCESS, (__VA_ARGS__)) << #__VA_ARGS__
+
+struct scratch_record_data
+{
+    uint64_t num_records = 0;
+    uint64_t num_errors  = 0;
+    uint64_t agent_id    = 0;
+};
+
+void
+scratch_buffer_callback(rocprofiler_context_id_t,
+                        rocprofiler_buffer_id_t,
+                        rocprofiler_record_header_t** headers,
+                        size_t                        num_headers,
+                        void*                         data,
+                        uint64_t)
+{
+    auto* _data = static_cast<scratch_record_data*>(data);
+    for(size_t i = 0; i < num_headers; ++i)
+    {
+        if(headers[i]->category != ROCPROFILER_BUFFER_CATEGORY_TRACING ||
+           headers[i]->kind != ROCPROFILER_BUFFER_TRACING_SCRATCH_MEMORY)
+            continue;
+
+        auto* _record =
+            static_cast<rocprofiler_buffer_tracing_scratch_memory_record_t*>(headers[i]->payload);
+        if(_record->agent_id.handle != _data->agent_id ||
+           _record->start_timestamp > _record->end_timestamp)
+            ++_data->num_errors;
+        ++_data->num_records;
+    }
+}
+
+// the runtime functions invoked after the events are traced
+hsa_status_t
+scratch_event_noop(hsa_amd_tool_event_t)
+{
+    return HSA_STATUS_SUCCESS;
+}
+
+hsa::hsa_amd_tool_table_t
+get_noop_tool_table()
+{
+    auto _table             = hsa::hsa_amd_tool_table_t{};
+    _table.version.minor_id = sizeof(hsa::hsa_amd_tool_table_t);
+
+    _table.hsa_amd_tool_scratch_event_alloc_start_fn         = scratch_event_noop;
+    _table.hsa_amd_tool_scratch_event_alloc_end_fn           = scratch_event_noop;
+    _table.hsa_amd_tool_scratch_event_free_start_fn          = scratch_event_noop;
+    _table.hsa_amd_tool_scratch_event_free_end_fn            = scratch_event_noop;
+    _table.hsa_amd_tool_scratch_event_async_reclaim_start_fn = scratch_event_noop;
+    _table.hsa_amd_tool_scratch_event_async_reclaim_end_fn   = scratch_event_noop;
+    return _table;
+}
+
+// invokes num_events start/end pairs of scratch allocation events and returns the ns per pair
+double
+run_scratch_events(const hsa::hsa_amd_tool_table_t& table,
+                   const hsa_queue_t*               queues,
+                   size_t                           num_queues,
+                   uint64_t                         num_events)
+{
+    auto _start = hsa_amd_event_scratch_alloc_start_t{};
+    auto _end   = hsa_amd_event_scratch_alloc_end_t{};
+    _start.kind = HSA_AMD_TOOL_EVENT_SCRATCH_ALLOC_START;
+    _end.kind   = HSA_AMD_TOOL_EVENT_SCRATCH_ALLOC_END;
+    _end.size   = 4096;
+
+    auto _start_event                = hsa_amd_tool_event_t{};
+    auto _end_event                  = hsa_amd_tool_event_t{};
+    _start_event.scratch_alloc_start = &_start;
+    _end_event.scratch_alloc_end     = &_end;
+
+    auto _beg = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < num_events; ++i)
+    {
+        _start.queue       = &queues[i % num_queues];
+        _end.queue         = _start.queue;
+        _start.dispatch_id = i;
+        _end.dispatch_id   = i;
+        table.hsa_amd_tool_scratch_event_alloc_start_fn(_start_event);
+        table.hsa_amd_tool_scratch_event_alloc_end_fn(_end_event);
+    }
+    auto _elapsed = std::chrono::steady_clock::now() - _beg;
+
+    return std::chrono::duration<double, std::nano>(_elapsed).count() / num_events;
+}
+}  // namespace
@@ -35,6 +35,7 @@
 #include <hsa/hsa_api_trace.h>
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <mutex>
 #include <stdexcept>
@@ -53,6 +54,12 @@
 
 constexpr size_t ROCPROFILER_QUEUE_SIZE = 64;
 
+namespace
+{
+// maximum time to wait for the CP to consume the packets before the queue is destroyed
+constexpr auto submit_timeout = std::chrono::seconds{1};
+}  // namespace
+
 namespace rocprofiler
 {
 struct cbdata_t
@@ -64,36 +71,6 @@ struct cbdata_t
 
 common::Synchronized<std::optional<int64_t>> client;
 
-bool
-AgentThreadTracer::Submit(hsa_ext_amd_aql_pm4_packet_t* packet)
-{
-    const uint64_t write_idx = add_write_index_relaxed_fn(queue, 1);
-
-    size_t index      = (write_idx % queue->size) * sizeof(hsa_ext_amd_aql_pm4_packet_t);
-    auto*  queue_slot = reinterpret_cast<uint32_t*>(size_t(queue->base_address) + index);  // NOLINT
-
-    const auto* slot_data = reinterpret_cast<const uint32_t*>(packet);
-
-    memcpy(&queue_slot[1], &slot_data[1], sizeof(hsa_ext_amd_aql_pm4_packet_t) - sizeof(uint32_t));
-    auto* header = reinterpret_cast<std::atomic<uint32_t>*>(queue_slot);
-
-    header->store(slot_data[0], std::memory_order_release);
-    signal_store_screlease_fn(queue->doorbell_signal, write_idx);
-
-    int loops = 0;
-    while(load_read_index_relaxed_fn(queue) <= write_idx)
-    {
-        loops++;
-        usleep(1);
-        if(loops > 10000)  // Add loop limit to prevent hang. TODO: Remove once stability proven
-        {
-            ROCP_ERROR << "Codeobj packet submission failed!";
-            return false;
-        }
-    }
-    return true;
-}
-
 AgentThreadTracer::AgentThreadTracer(thread_trace_parameter_pack _params,
                                      const hsa::AgentCache&      cache,
                                      const CoreApiTable&         coreapi,
@@ -117,10 +94,9 @@ AgentThreadTracer::AgentThreadTracer(thread_trace_parameter_pack _params,
         this->queue = nullptr;
     }
 
-    queue_destroy_fn           = coreapi.hsa_queue_destroy_fn;
-    signal_store_screlease_fn  = coreapi.hsa_signal_store_screlease_fn;
-    add_write_index_relaxed_fn = coreapi.hsa_queue_add_write_index_relaxed_fn;
-    load_read_index_relaxed_fn = coreapi.hsa_queue_load_read_index_relaxed_fn;
+    if(this->queue) packet_queue = std::make_unique<ThreadTraceQueue>(this->queue, coreapi, ext);
+
+    queue_destroy_fn = coreapi.hsa_queue_destroy_fn;
 }
 
 AgentThreadTracer::~AgentThreadTracer()
@@ -138,10 +114,18 @@ AgentThreadTracer::~AgentThreadTracer()
         packet->clear();
         packet->populate_after();
 
-        for(auto& after_packet : packet->after_krn_pkt)
-            Submit(&after_packet);
+        packet_queue->submit(packet->after_krn_pkt.data(), packet->after_krn_pkt.size());
     }
 
+    // the packets in flight reference memory owned by the AQL packets
+    if(!packet_queue->wait(submit_timeout))
+    {
+        // If something went wrong, don't delete the packets to avoid CP memory access fault
+        ROCP_ERROR << "Thread trace packet submission failed!";
+        active_resources.packet.release();
+    }
+    packet_queue.reset();
+
     if(queue_destroy_fn) queue_destroy_fn(this->queue);
 }
 
@@ -244,47 +228,42 @@ AgentThreadTracer::post_kernel_call(std::unique_ptr<hsa::AQLPacket>&& aql)
 }
 
 void
-AgentThreadTracer::load_codeobj(code_object_id_t id, uint64_t addr, uint64_t size)
+AgentThreadTracer::update_codeobjs(const std::vector<CodeobjRecord>& records)
 {
     std::unique_lock<std::mutex> lk(trace_resources_mut);
 
     if(auto* pkt = static_cast<hsa::TraceControlAQLPacket*>(cached_resources.get()))
     {
-        pkt->add_codeobj(id, addr, size);
+        for(const auto& record : records)
+        {
+            if(!record.bUnload)
+                pkt->add_codeobj(record.id, record.addr, record.size);
+            else
+                pkt->remove_codeobj(record.id);
+        }
         return;
     }
 
-    remaining_codeobj_record.push_back({id, addr, size, false});
+    remaining_codeobj_record.insert(remaining_codeobj_record.end(), records.begin(), records.end());
 
-    if(!queue) return;
+    if(!packet_queue || records.empty()) return;
 
-    auto packet   = factory->construct_load_marker_packet(id, addr, size);
-    bool bSuccess = Submit(&packet->packet);
-
-    if(!bSuccess)  // If something went wrong, don't delete packet to avoid CP memory access fault
-        packet.release();
-}
-
-void
-AgentThreadTracer::unload_codeobj(code_object_id_t id)
-{
-    std::unique_lock<std::mutex> lk(trace_resources_mut);
-
-    if(auto* pkt = static_cast<hsa::TraceControlAQLPacket*>(cached_resources.get()))
+    // The marker packets reference memory owned by the marker AQL packets. They are released
+    // by the completion callback once the CP has consumed the packets (if something goes
+    // wrong, they are never released to avoid CP memory access fault)
+    auto markers = std::make_shared<std::vector<std::unique_ptr<hsa::CodeobjMarkerAQLPacket>>>();
+    auto packets = std::vector<hsa_ext_amd_aql_pm4_packet_t>{};
+    for(const auto& record : records)
     {
-        pkt->remove_codeobj(id);
-        return;
+        auto& marker = markers->emplace_back(
+            (record.bUnload)
+                ? factory->construct_unload_marker_packet(record.id)
+                : factory->construct_load_marker_packet(record.id, record.addr, record.size));
+        packets.emplace_back(marker->packet);
     }
 
-    remaining_codeobj_record.push_back({id, 0, 0, true});
-
-    if(!queue) return;
-
-    auto packet   = factory->construct_unload_marker_packet(id);
-    bool bSuccess = Submit(&packet->packet);
-
-    if(!bSuccess)  // If something went wrong, don't delete packet to avoid CP memory access fault
-        packet.release();
+    if(!packet_queue->submit(packets.data(), packets.size(), [markers]() { markers->clear(); }))
+        ROCP_ERROR << "Codeobj packet submission failed!";
 }
 
 // TODO: make this a wrapper on HSA load instead of registering
@@ -324,9 +303,16 @@ GlobalThreadTracer::codeobj_tracing_callback(rocprofiler_callback_tracing_record
     if(tracer_it == tracer.agents.end()) return;
 
     if(record.phase == ROCPROFILER_CALLBACK_PHASE_LOAD)
-        tracer_it->second->load_codeobj(rec->code_object_id, rec->load_delta, rec->load_size);
+    {
+        tracer_it->second->update_codeobjs({{rec->code_object_id,
+                                             static_cast<uint64_t>(rec->load_delta),
+                                             rec->load_size,
+                                             false}});
+    }
     else if(record.phase == ROCPROFILER_CALLBACK_PHASE_UNLOAD)
-        tracer_it->second->unload_codeobj(rec->code_object_id);
+    {
+        tracer_it->second->update_codeobjs({{rec->code_object_id, 0, 0, true}});
+    }
 }
 
 void
@@ -346,6 +332,19 @@ GlobalThreadTracer::resource_init(const hsa::AgentCache& cache,
 
     auto new_tracer = std::make_unique<AgentThreadTracer>(this->params, cache, coreapi, ext);
     new_tracer->active_queues.store(1);
+
+    // the code objects reported by the callback before the first queue of the agent was
+    // created are passed to the new tracer at once
+    auto loaded_it = loaded_codeobjs.find(agent);
+    if(loaded_it != loaded_codeobjs.end() && !loaded_it->second.empty())
+    {
+        auto records = std::vector<AgentThreadTracer::CodeobjRecord>{};
+        records.reserve(loaded_it->second.size());
+        for(const auto& [id, range] : loaded_it->second)
+            records.push_back({id, static_cast<uint64_t>(range.addr), range.size, false});
+        new_tracer->update_codeobjs(records);
+    }
+
     agents.emplace(agent, std::move(new_tracer));
 }
 
@@ -25,6 +25,7 @@
 #include <rocprofiler-sdk/cxx/hash.hpp>
 #include <rocprofiler-sdk/cxx/operators.hpp>
 #include "lib/rocprofiler-sdk/hsa/agent_cache.hpp"
+#include "lib/rocprofiler-sdk/thread_trace/att_queue.hpp"
 
 #include <rocprofiler-sdk/amd_detail/thread_trace.h>
 #include <rocprofiler-sdk/intercept_table.h>
@@ -77,6 +78,8 @@ struct ThreadTraceActiveResource
 class AgentThreadTracer
 {
     using code_object_id_t = uint64_t;
+
+public:
     struct CodeobjRecord
     {
         code_object_id_t id;
@@ -85,15 +88,15 @@ class AgentThreadTracer
         bool             bUnload;
     };
 
-public:
     AgentThreadTracer(thread_trace_parameter_pack _params,
                       const hsa::AgentCache&,
                       const CoreApiTable&,
                       const AmdExtTable&);
     virtual ~AgentThreadTracer();
 
-    void load_codeobj(code_object_id_t id, uint64_t addr, uint64_t size);
-    void unload_codeobj(code_object_id_t id);
+    // loads/unloads multiple code objects. While a trace is active, the marker packets are
+    // submitted with a single doorbell
+    void update_codeobjs(const std::vector<CodeobjRecord>& records);
 
     std::unique_ptr<hsa::AQLPacket> pre_kernel_call(rocprofiler_att_control_flags_t control_flags,
                                                     rocprofiler_queue_id_t          queue_id,
@@ -111,14 +114,11 @@ public:
     std::vector<CodeobjRecord>      remaining_codeobj_record;
 
     std::unique_ptr<aql::ThreadTraceAQLPacketFactory> factory;
+    // submits the packets to `queue` without blocking the calling thread
+    std::unique_ptr<ThreadTraceQueue> packet_queue;
 
 private:
-    bool Submit(hsa_ext_amd_aql_pm4_packet_t* packet);
-
-    decltype(hsa_queue_load_read_index_relaxed)* load_read_index_relaxed_fn{nullptr};
-    decltype(hsa_queue_add_write_index_relaxed)* add_write_index_relaxed_fn{nullptr};
-    decltype(hsa_signal_store_screlease)*        signal_store_screlease_fn{nullptr};
-    decltype(hsa_queue_destroy)*                 queue_destroy_fn{nullptr};
+    decltype(hsa_queue_destroy)* queue_destroy_fn{nullptr};
 };  // namespace thread_trace
 
 class GlobalThreadTracer
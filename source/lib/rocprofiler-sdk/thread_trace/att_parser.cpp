@@ -20,13 +20,16 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
-#include <rocprofiler-sdk/amd_detail/thread_trace.h>
-#include <rocprofiler-sdk/rocprofiler.h>
-#include <atomic>
+#include "lib/rocprofiler-sdk/thread_trace/att_parser.hpp"
+#include "lib/common/environment.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
+
+#include <algorithm>
+#include <cassert>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
-#include "lib/rocprofiler-sdk/aql/aql_profile_v2.h"
 
 #define AQLPROFILE_OCCUPANCY_RESOLUTION 8
 
@@ -72,70 +75,229 @@ forward_hsa_error(hsa_status_t error_code)
     return ROCPROFILER_STATUS_ERROR;
 }
 
-struct userdata_callback_table_t
+namespace
+{
+template <typename Tp>
+auto
+make_record(rocprofiler_att_parser_data_type_t type, const Tp& data)
 {
-    rocprofiler_att_parser_trace_callback_t   trace;
-    rocprofiler_att_parser_isa_callback_t     isa;
-    rocprofiler_att_parser_se_data_callback_t se_data;
-    void*                                     user;
+    auto _record = ATTDecoder::record_t{};
+    _record.type = type;
+    if constexpr(std::is_same<Tp, rocprofiler_att_data_type_isa_t>::value)
+        _record.data.isa = data;
+    else
+        _record.data.occupancy = data;
+    return _record;
+}
+}  // namespace
 
-    std::vector<pcinfo_t> kernel_id_map;
+struct ATTDecoder::shader_engine
+{
+    int                   id      = -1;
+    std::vector<uint8_t>  data    = {};
+    std::vector<record_t> records = {};
+    hsa_status_t          status  = HSA_STATUS_SUCCESS;
+    bool                  done    = false;
 };
 
-thread_local int TRACE_DATA_ID{-1};
-thread_local int KERNEL_ADDR_ID{-1};
-thread_local int OCCUPANCY_ID{-1};
+struct ATTDecoder::job
+{
+    rocprofiler_att_parser_se_data_callback_t se_data = nullptr;
+    rocprofiler_att_parser_trace_callback_t   trace   = nullptr;
+    rocprofiler_att_parser_isa_callback_t     isa     = nullptr;
+    void*                                     user    = nullptr;
+
+    // protects the records and the completion of the shader engines
+    std::mutex              mtx = {};
+    std::condition_variable cv  = {};
+    // serializes the user callbacks
+    std::mutex callback_mtx = {};
+    // deque since the workers hold references to the shader engines
+    std::deque<shader_engine> engines = {};
+};
+
+struct ATTDecoder::se_context
+{
+    const ATTDecoder* decoder = nullptr;
+    job*              parent  = nullptr;
+    // nullptr when the decoder library pulls the data from the user callback
+    shader_engine*   engine = nullptr;
+    decoder_state_t* state  = nullptr;
+    // records are buffered in the shader engine instead of being delivered to the user
+    bool buffered = false;
+    bool served   = false;
+    // shader engine of the last data pulled from the user callback
+    int seid = -1;
+};
+
+ATTDecoder::ATTDecoder(decoder_table_t table, size_t num_threads)
+: m_table{table}
+, m_num_threads{num_threads}
+{
+    m_table.iterate_event_list_fn(
+        [](int id, const char* metadata, void* userdata) {
+            auto& _decoder = *static_cast<ATTDecoder*>(userdata);
+            if(std::string_view(metadata).find("occupancy") == 0)
+                _decoder.m_occupancy_id = id;
+            else if(std::string_view(metadata).find("kernel_ids_addr") == 0)
+                _decoder.m_kernel_addr_id = id;
+            else if(std::string_view(metadata).find("tracedata") == 0)
+                _decoder.m_trace_data_id = id;
+        },
+        this);
+}
+
+ATTDecoder::~ATTDecoder()
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        m_stop   = true;
+    }
+    m_pending.notify_all();
+    for(auto& itr : m_threads)
+        itr.join();
+}
+
+size_t
+ATTDecoder::get_default_num_threads()
+{
+    // zero is one thread per shader engine, which copies the data of every shader engine and
+    // invokes the ISA callback on the worker threads. One decodes on the calling thread without
+    // copying the data
+    return ::rocprofiler::common::get_env("ROCPROFILER_ATT_PARSER_THREADS", size_t{0});
+}
 
 void
-iterate_trace_type(int id, const char* metadata, void*)
+ATTDecoder::start(size_t num_threads)
 {
-    if(std::string_view(metadata).find("occupancy") == 0)
-        OCCUPANCY_ID = id;
-    else if(std::string_view(metadata).find("kernel_ids_addr") == 0)
-        KERNEL_ADDR_ID = id;
-    else if(std::string_view(metadata).find("tracedata") == 0)
-        TRACE_DATA_ID = id;
+    m_threads.reserve(num_threads);
+    while(m_threads.size() < num_threads)
+    {
+        internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+        m_threads.emplace_back(&ATTDecoder::work, this);
+        internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+    }
+}
+
+void
+ATTDecoder::work()
+{
+    // the buffers of a worker are reused for every shader engine
+    auto _state = decoder_state_t{};
+
+    while(true)
+    {
+        auto _task = std::pair<job*, shader_engine*>{};
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            m_pending.wait(_lk, [this]() { return m_stop || !m_tasks.empty(); });
+            if(m_tasks.empty()) return;
+            _task = m_tasks.front();
+            m_tasks.pop_front();
+        }
+
+        auto [_job, _engine] = _task;
+        auto _ctx            = se_context{};
+        _ctx.decoder         = this;
+        _ctx.parent          = _job;
+        _ctx.engine          = _engine;
+        _ctx.state           = &_state;
+        _ctx.buffered        = true;
+        decode(_ctx);
+
+        auto _lk = std::unique_lock<std::mutex>{_job->mtx};
+        // release the copy of the trace data as early as possible
+        _engine->data = std::vector<uint8_t>{};
+        _engine->done = true;
+        // notified with the lock held since the job is destroyed once the last shader engine is
+        // done
+        _job->cv.notify_all();
+    }
 }
 
 hsa_status_t
-trace_callback(int trace_type_id,
-               int /* correlation_id */,
-               void*    trace_events,
-               uint64_t trace_size,
-               void*    userdata)
+ATTDecoder::decode(se_context& ctx) const
 {
-    assert(userdata);
-    auto& table = *reinterpret_cast<userdata_callback_table_t*>(userdata);
+    // nothing decoded from a previous trace applies to this one, e.g. the occupancy events
+    // which precede the kernel ids of the trace must not use the kernel ids of another trace
+    ctx.state->kernel_id_map.clear();
+    ctx.state->records.clear();
+
+    auto status = m_table.parse_data_fn(se_data_callback, trace_callback, isa_callback, &ctx);
+    if(ctx.engine) ctx.engine->status = status;
+    return status;
+}
 
-    if(trace_type_id == KERNEL_ADDR_ID)
+uint64_t
+ATTDecoder::se_data_callback(int* seid, uint8_t** buffer, uint64_t* buffer_size, void* userdata)
+{
+    assert(userdata);
+    auto& ctx = *static_cast<se_context*>(userdata);
+    if(!ctx.engine)
     {
-        table.kernel_id_map.resize(trace_size);
-        const auto* events = reinterpret_cast<const pcinfo_t*>(trace_events);
+        // decoding on the calling thread, the kernel ids of the previous shader engine do not
+        // apply to the next one. A shader engine may be returned in multiple chunks
+        auto _size = ctx.parent->se_data(seid, buffer, buffer_size, ctx.parent->user);
+        if(_size != 0 && *seid != ctx.seid)
+        {
+            ctx.state->kernel_id_map.clear();
+            ctx.seid = *seid;
+        }
+        return _size;
+    }
 
-        for(size_t i = 0; i < trace_size; i++)
-            table.kernel_id_map.at(i) = events[i];
+    // the data of the shader engine is returned at once
+    if(ctx.served) return 0;
+    ctx.served   = true;
+    *seid        = ctx.engine->id;
+    *buffer      = ctx.engine->data.data();
+    *buffer_size = ctx.engine->data.size();
+    return *buffer_size;
+}
+
+hsa_status_t
+ATTDecoder::trace_callback(int trace_type_id,
+                           int /* correlation_id */,
+                           void*    trace_events,
+                           uint64_t trace_size,
+                           void*    userdata)
+{
+    assert(userdata);
+    auto&       ctx     = *static_cast<se_context*>(userdata);
+    const auto& decoder = *ctx.decoder;
+    auto&       state   = *ctx.state;
+    auto&       records = state.records;
+
+    records.clear();
+    if(trace_type_id == decoder.m_kernel_addr_id)
+    {
+        const auto* events = static_cast<const pcinfo_t*>(trace_events);
+        state.kernel_id_map.assign(events, events + trace_size);
+        return HSA_STATUS_SUCCESS;
     }
-    else if(trace_type_id == OCCUPANCY_ID)
+    else if(trace_type_id == decoder.m_occupancy_id)
     {
-        const auto* events = reinterpret_cast<const att_occupancy_info_t*>(trace_events);
+        const auto* events = static_cast<const att_occupancy_info_t*>(trace_events);
+        records.reserve(trace_size);
         for(size_t i = 0; i < trace_size; i++)
         {
             rocprofiler_att_data_type_occupancy_t occ{};
             occ.timestamp = events[i].time * AQLPROFILE_OCCUPANCY_RESOLUTION;
             occ.enabled   = events[i].enable;
-            try
+            // Not having a kernel_id_map entry is unexpected, but valid
+            if(events[i].kernel_id < state.kernel_id_map.size())
             {
-                pcinfo_t kernel_id_addr = table.kernel_id_map.at(events[i].kernel_id);
-                occ.marker_id           = kernel_id_addr.marker_id;
-                occ.offset              = kernel_id_addr.addr;
-            } catch(...)
-            {}  // Not having a kernel_id_map entry is unexpected, but valid
-            table.trace(ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY, (void*) &occ, table.user);
+                const auto& kernel_id_addr = state.kernel_id_map[events[i].kernel_id];
+                occ.marker_id              = kernel_id_addr.marker_id;
+                occ.offset                 = kernel_id_addr.addr;
+            }
+            records.emplace_back(make_record(ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY, occ));
         }
     }
-    else if(trace_type_id == TRACE_DATA_ID)
+    else if(trace_type_id == decoder.m_trace_data_id)
     {
-        const auto* events = reinterpret_cast<const att_trace_event_t*>(trace_events);
+        const auto* events = static_cast<const att_trace_event_t*>(trace_events);
+        records.reserve(trace_size);
         for(size_t i = 0; i < trace_size; i++)
         {
             rocprofiler_att_data_type_isa_t isa{};
@@ -143,42 +305,169 @@ trace_callback(int trace_type_id,
             isa.offset    = events[i].pc.addr;
             isa.hitcount  = events[i].hitcount;
             isa.latency   = events[i].latency;
-            table.trace(ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA, (void*) &isa, table.user);
+            records.emplace_back(make_record(ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA, isa));
+        }
+    }
+
+    if(records.empty()) return HSA_STATUS_SUCCESS;
+
+    auto& parent = *ctx.parent;
+    if(!ctx.buffered)
+    {
+        // decoded on the calling thread
+        for(auto& itr : records)
+            parent.trace(itr.type, &itr.data, parent.user);
+    }
+    else
+    {
+        {
+            auto  _lk      = std::unique_lock<std::mutex>{parent.mtx};
+            auto& _records = ctx.engine->records;
+            if(_records.empty())
+                _records.swap(records);
+            else
+                _records.insert(_records.end(), records.begin(), records.end());
         }
+        parent.cv.notify_all();
     }
 
     return HSA_STATUS_SUCCESS;
 }
 
 hsa_status_t
-isa_callback(char* isa,
-             char* /*  source_reference  */,
-             uint64_t* memory_size,
-             uint64_t* isa_size,
-             uint64_t* source_size,
-             uint64_t  marker,
-             uint64_t  offset,
-             void*     userdata)
+ATTDecoder::isa_callback(char* isa,
+                         char* /*  source_reference  */,
+                         uint64_t* memory_size,
+                         uint64_t* isa_size,
+                         uint64_t* source_size,
+                         uint64_t  marker,
+                         uint64_t  offset,
+                         void*     userdata)
 {
     assert(userdata);
     assert(source_size);
-    *source_size                = 0;
-    const auto&          table  = *reinterpret_cast<const userdata_callback_table_t*>(userdata);
-    rocprofiler_status_t status = table.isa(isa, memory_size, isa_size, marker, offset, table.user);
+    *source_size = 0;
+
+    auto& parent = *static_cast<se_context*>(userdata)->parent;
+    auto  _lk    = std::unique_lock<std::mutex>{parent.callback_mtx};
+    auto  status = parent.isa(isa, memory_size, isa_size, marker, offset, parent.user);
 
     if(status != ROCPROFILER_STATUS_SUCCESS)
         return rocprofiler::att_parser::forward_hsa_error(status);
     return HSA_STATUS_SUCCESS;
 }
 
-uint64_t
-se_data_callback(int* seid, uint8_t** buffer, uint64_t* buffer_size, void* userdata)
+rocprofiler_status_t
+ATTDecoder::parse(rocprofiler_att_parser_se_data_callback_t se_data_callback,
+                  rocprofiler_att_parser_trace_callback_t   trace_callback,
+                  rocprofiler_att_parser_isa_callback_t     isa_callback,
+                  void*                                     userdata)
 {
-    assert(userdata);
-    auto& table = *reinterpret_cast<userdata_callback_table_t*>(userdata);
-    return table.se_data(seid, buffer, buffer_size, table.user);
+    static thread_local auto _state = decoder_state_t{};
+
+    auto _job    = job{};
+    _job.se_data = se_data_callback;
+    _job.trace   = trace_callback;
+    _job.isa     = isa_callback;
+    _job.user    = userdata;
+
+    if(m_num_threads == 1)
+    {
+        auto _ctx   = se_context{.decoder = this, .parent = &_job, .state = &_state};
+        auto status = decode(_ctx);
+        if(status != HSA_STATUS_SUCCESS) return forward_hsa_error(status);
+        return ROCPROFILER_STATUS_SUCCESS;
+    }
+
+    // the buffers returned by the user callback are only valid until its next invocation so the
+    // data of every shader engine is copied. Chunks of the same shader engine are concatenated
+    auto _engine_idx = std::unordered_map<int, shader_engine*>{};
+    while(true)
+    {
+        int      _seid   = -1;
+        uint8_t* _buffer = nullptr;
+        uint64_t _size   = 0;
+        if(se_data_callback(&_seid, &_buffer, &_size, userdata) == 0 || _seid < 0) break;
+        if(_buffer == nullptr || _size == 0) break;
+
+        auto& _engine = _engine_idx[_seid];
+        if(!_engine)
+        {
+            _engine     = &_job.engines.emplace_back();
+            _engine->id = _seid;
+        }
+        _engine->data.insert(_engine->data.end(), _buffer, _buffer + _size);
+    }
+
+    if(_job.engines.empty()) return ROCPROFILER_STATUS_SUCCESS;
+
+    if(_job.engines.size() == 1)
+    {
+        // decoded on the calling thread, no need for the worker threads
+        auto _ctx = se_context{.decoder = this,
+                               .parent  = &_job,
+                               .engine  = &_job.engines.front(),
+                               .state   = &_state};
+        decode(_ctx);
+        _job.engines.front().done = true;
+    }
+    else
+    {
+        auto _num_threads = m_num_threads;
+        if(_num_threads == 0)
+        {
+            _num_threads = std::min<size_t>(
+                _job.engines.size(), std::max<size_t>(std::thread::hardware_concurrency(), 1));
+        }
+
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            start(_num_threads);
+            for(auto& itr : _job.engines)
+                m_tasks.emplace_back(&_job, &itr);
+        }
+        m_pending.notify_all();
+    }
+
+    // deliver the records of every shader engine in order while the following shader engines are
+    // being decoded
+    auto status  = HSA_STATUS_SUCCESS;
+    auto records = std::vector<record_t>{};
+    for(auto& itr : _job.engines)
+    {
+        bool _done = false;
+        while(!_done)
+        {
+            {
+                auto _lk = std::unique_lock<std::mutex>{_job.mtx};
+                _job.cv.wait(_lk, [&itr]() { return itr.done || !itr.records.empty(); });
+                records.swap(itr.records);
+                _done = itr.done;
+            }
+
+            auto _lk = std::unique_lock<std::mutex>{_job.callback_mtx};
+            for(auto& ritr : records)
+                trace_callback(ritr.type, &ritr.data, userdata);
+            records.clear();
+        }
+
+        if(status == HSA_STATUS_SUCCESS) status = itr.status;
+    }
+
+    if(status != HSA_STATUS_SUCCESS) return forward_hsa_error(status);
+    return ROCPROFILER_STATUS_SUCCESS;
 }
 
+ATTDecoder&
+get_decoder()
+{
+    // never deleted since the worker threads may be idle at exit
+    static auto* _v = new ATTDecoder{
+        decoder_table_t{.parse_data_fn         = aqlprofile_att_parse_data,
+                        .iterate_event_list_fn = aqlprofile_att_parser_iterate_event_list},
+        ATTDecoder::get_default_num_threads()};
+    return *_v;
+}
 };  // namespace att_parser
 };  // namespace rocprofiler
 
@@ -189,25 +478,7 @@ rocprofiler_att_parse_data(rocprofiler_att_parser_se_data_callback_t user_se_dat
                            rocprofiler_att_parser_isa_callback_t     user_isa_callback,
                            void*                                     userdata)
 {
-    static thread_local bool bInit = []() {
-        aqlprofile_att_parser_iterate_event_list(rocprofiler::att_parser::iterate_trace_type,
-                                                 nullptr);
-        return true;
-    }();
-    (void) bInit;
-
-    rocprofiler::att_parser::userdata_callback_table_t table;
-    table.trace   = user_trace_callback;
-    table.isa     = user_isa_callback;
-    table.se_data = user_se_data_callback;
-    table.user    = userdata;
-
-    hsa_status_t status = aqlprofile_att_parse_data(rocprofiler::att_parser::se_data_callback,
-                                                    rocprofiler::att_parser::trace_callback,
-                                                    rocprofiler::att_parser::isa_callback,
-                                                    (void*) &table);
-
-    if(status != HSA_STATUS_SUCCESS) return rocprofiler::att_parser::forward_hsa_error(status);
-    return ROCPROFILER_STATUS_SUCCESS;
+    return rocprofiler::att_parser::get_decoder().parse(
+        user_se_data_callback, user_trace_callback, user_isa_callback, userdata);
 }
 }
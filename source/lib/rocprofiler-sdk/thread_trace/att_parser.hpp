@@ -0,0 +1,139 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <rocprofiler-sdk/amd_detail/thread_trace.h>
+#include <rocprofiler-sdk/rocprofiler.h>
+
+#include "lib/rocprofiler-sdk/aql/aql_profile_v2.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace att_parser
+{
+struct decoder_table_t
+{
+    decltype(aqlprofile_att_parse_data)*                parse_data_fn         = nullptr;
+    decltype(aqlprofile_att_parser_iterate_event_list)* iterate_event_list_fn = nullptr;
+};
+
+/**
+ * Decodes the thread trace data of multiple shader engines, optionally concurrently.
+ *
+ * Unless a single thread is requested, the data returned by the se_data callback is split per
+ * shader engine and every shader engine is decoded by a separate invocation of the decoder library
+ * on a bounded pool of worker threads. The pool is shared by all the parse() calls and created by
+ * the first call which needs it. By default (zero threads), the pool has one thread per shader
+ * engine, up to the number of hardware threads, and grows when a later call returns more shader
+ * engines. The decoded records are delivered to the trace callback on the calling thread, shader
+ * engine by shader engine in the order they were returned by the se_data callback, while the
+ * following shader engines are still being decoded. The user callbacks are never invoked
+ * concurrently.
+ *
+ * With a single thread, the decoder library is invoked on the calling thread with the user
+ * callbacks, i.e. the shader engine data is not copied.
+ */
+class ATTDecoder
+{
+public:
+    ATTDecoder(decoder_table_t table, size_t num_threads);
+    ~ATTDecoder();
+
+    ATTDecoder(const ATTDecoder&) = delete;
+    ATTDecoder& operator=(const ATTDecoder&) = delete;
+
+    rocprofiler_status_t parse(rocprofiler_att_parser_se_data_callback_t se_data_callback,
+                               rocprofiler_att_parser_trace_callback_t   trace_callback,
+                               rocprofiler_att_parser_isa_callback_t     isa_callback,
+                               void*                                     userdata);
+
+    /// Number of threads decoding shader engines, zero for one thread per shader engine
+    size_t size() const { return m_num_threads; }
+
+    /// ROCPROFILER_ATT_PARSER_THREADS, defaults to zero, i.e. one thread per shader engine
+    static size_t get_default_num_threads();
+
+    struct record_t
+    {
+        rocprofiler_att_parser_data_type_t type;
+        union
+        {
+            rocprofiler_att_data_type_isa_t       isa;
+            rocprofiler_att_data_type_occupancy_t occupancy;
+        } data;
+    };
+
+    // scratch memory of a thread invoking the decoder library. The buffers are reused across
+    // parse() calls but cleared before every shader engine is decoded
+    struct decoder_state_t
+    {
+        std::vector<pcinfo_t> kernel_id_map = {};
+        std::vector<record_t> records       = {};
+    };
+
+private:
+    struct job;
+    struct shader_engine;
+    struct se_context;
+
+    void start(size_t num_threads);
+    void work();
+    hsa_status_t decode(se_context& ctx) const;
+
+    static uint64_t     se_data_callback(int*, uint8_t**, uint64_t*, void*);
+    static hsa_status_t trace_callback(int, int, void*, uint64_t, void*);
+    static hsa_status_t isa_callback(char*,
+                                     char*,
+                                     uint64_t*,
+                                     uint64_t*,
+                                     uint64_t*,
+                                     uint64_t,
+                                     uint64_t,
+                                     void*);
+
+    decoder_table_t                             m_table          = {};
+    size_t                                      m_num_threads    = 1;
+    int                                         m_trace_data_id  = -1;
+    int                                         m_kernel_addr_id = -1;
+    int                                         m_occupancy_id   = -1;
+    std::mutex                                  m_mutex          = {};
+    std::condition_variable                     m_pending        = {};
+    std::deque<std::pair<job*, shader_engine*>> m_tasks          = {};
+    bool                                        m_stop           = false;
+    std::vector<std::thread>                    m_threads        = {};
+};
+
+/// Decoder using the aqlprofile library
+ATTDecoder&
+get_decoder();
+}  // namespace att_parser
+}  // namespace rocprofiler
@@ -0,0 +1,276 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/thread_trace/att_queue.hpp"
+#include "lib/common/logging.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rocprofiler
+{
+struct ThreadTraceQueue::submission
+{
+    std::shared_ptr<state> parent   = {};
+    std::vector<packet_t>  packets  = {};
+    completion_cb_t        callback = {};
+    hsa_signal_t           signal   = {.handle = 0};
+};
+
+struct ThreadTraceQueue::state
+{
+    using submission_ptr_t = std::unique_ptr<submission>;
+
+    // writes as many deferred submissions as fit in the free slots of the queue with a single
+    // doorbell, without waiting for slots. Must be invoked with the mutex locked
+    void flush(const std::shared_ptr<state>& self);
+
+    // invoked by the async handler once the packets of the submission have been consumed
+    void complete(submission* sub);
+
+    hsa_queue_t*                    queue        = nullptr;
+    mutable std::mutex              mtx          = {};
+    mutable std::condition_variable cv           = {};
+    std::deque<submission_ptr_t>    deferred     = {};
+    std::vector<hsa_signal_t>       free_signals = {};
+    size_t                          in_flight    = 0;
+    size_t                          in_callback  = 0;
+    bool                            closed       = false;
+
+    decltype(hsa_queue_load_read_index_relaxed)*  load_read_index_relaxed_fn  = nullptr;
+    decltype(hsa_queue_load_write_index_relaxed)* load_write_index_relaxed_fn = nullptr;
+    decltype(hsa_queue_add_write_index_relaxed)*  add_write_index_relaxed_fn  = nullptr;
+    decltype(hsa_signal_store_screlease)*         signal_store_screlease_fn   = nullptr;
+    decltype(hsa_signal_create)*                  signal_create_fn            = nullptr;
+    decltype(hsa_signal_destroy)*                 signal_destroy_fn           = nullptr;
+    decltype(hsa_amd_signal_async_handler)*       signal_async_handler_fn     = nullptr;
+};
+
+void
+ThreadTraceQueue::state::flush(const std::shared_ptr<state>& self)
+{
+    if(deferred.empty()) return;
+
+    // the packet processor may decrement the completion signal before it advances the read
+    // index, i.e. the slots of the last completed submission may not be free yet. Submissions
+    // which do not fit stay deferred until the next completion, submission or wait
+    const uint64_t num_free =
+        queue->size - (load_write_index_relaxed_fn(queue) - load_read_index_relaxed_fn(queue));
+
+    // the submissions are written in order, so stop at the first one which does not fit
+    size_t num_packets = 0;
+    auto   batch       = std::vector<submission*>{};
+    while(!deferred.empty() && num_packets + deferred.front()->packets.size() <= num_free)
+    {
+        if(free_signals.empty())
+        {
+            auto _signal = hsa_signal_t{.handle = 0};
+            if(signal_create_fn(1, 0, nullptr, &_signal) != HSA_STATUS_SUCCESS)
+            {
+                ROCP_ERROR << "Failed to create thread trace completion signal";
+                break;
+            }
+            free_signals.emplace_back(_signal);
+        }
+
+        auto sub = std::move(deferred.front());
+        deferred.pop_front();
+
+        sub->parent = self;
+        sub->signal = free_signals.back();
+        free_signals.pop_back();
+        signal_store_screlease_fn(sub->signal, 1);
+        sub->packets.back().completion_signal = sub->signal;
+
+        // the handler is registered before the packets are written so that a submission whose
+        // handler cannot be registered is dropped without leaving unwritten slots in the queue
+        auto status = signal_async_handler_fn(
+            sub->signal, HSA_SIGNAL_CONDITION_LT, 1, ThreadTraceQueue::async_handler, sub.get());
+        if(status != HSA_STATUS_SUCCESS)
+        {
+            ROCP_ERROR << "Failed to register thread trace completion handler. Dropping "
+                       << sub->packets.size() << " packets";
+            free_signals.emplace_back(sub->signal);
+            continue;
+        }
+
+        // the async handler takes ownership of the submission
+        ++in_flight;
+        num_packets += sub->packets.size();
+        batch.emplace_back(sub.release());
+    }
+
+    if(batch.empty()) return;
+
+    // reserve the slots. This is the only writer to the queue
+    const uint64_t first_idx = add_write_index_relaxed_fn(queue, num_packets);
+    uint64_t       idx       = first_idx;
+    for(const auto* sub : batch)
+    {
+        for(const auto& packet : sub->packets)
+        {
+            size_t offset     = (idx++ % queue->size) * sizeof(packet_t);
+            auto*  queue_slot = reinterpret_cast<uint32_t*>(  // NOLINT(performance-no-int-to-ptr)
+                reinterpret_cast<uintptr_t>(queue->base_address) + offset);
+            const auto* slot_data = reinterpret_cast<const uint32_t*>(&packet);
+
+            // Overwrite the AQL invalid header (first dword) last.
+            // This prevents the slot from being read until it's fully written.
+            memcpy(&queue_slot[1], &slot_data[1], sizeof(packet_t) - sizeof(uint32_t));
+            reinterpret_cast<std::atomic<uint32_t>*>(queue_slot)
+                ->store(slot_data[0], std::memory_order_release);
+        }
+    }
+
+    // a single doorbell for all the packets
+    signal_store_screlease_fn(queue->doorbell_signal, first_idx + num_packets - 1);
+}
+
+void
+ThreadTraceQueue::state::complete(submission* sub)
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{mtx};
+        --in_flight;
+        ++in_callback;
+
+        if(closed)
+            signal_destroy_fn(sub->signal);
+        else
+        {
+            free_signals.emplace_back(sub->signal);
+            // slots have been freed in the queue
+            flush(sub->parent);
+        }
+    }
+
+    if(sub->callback) sub->callback();
+    // release whatever the callback holds on to before the submission is reported as complete
+    sub->callback = nullptr;
+
+    {
+        auto _lk = std::unique_lock<std::mutex>{mtx};
+        --in_callback;
+    }
+    cv.notify_all();
+}
+
+bool
+ThreadTraceQueue::async_handler(hsa_signal_value_t, void* data)
+{
+    auto* _sub = static_cast<submission*>(data);
+    // keep the state alive until the submission is deleted
+    auto _state = _sub->parent;
+    _state->complete(_sub);
+    delete _sub;
+    return false;
+}
+
+ThreadTraceQueue::ThreadTraceQueue(hsa_queue_t*        queue,
+                                   const CoreApiTable& coreapi,
+                                   const AmdExtTable&  ext)
+: m_state{std::make_shared<state>()}
+{
+    m_state->queue                       = queue;
+    m_state->load_read_index_relaxed_fn  = coreapi.hsa_queue_load_read_index_relaxed_fn;
+    m_state->load_write_index_relaxed_fn = coreapi.hsa_queue_load_write_index_relaxed_fn;
+    m_state->add_write_index_relaxed_fn  = coreapi.hsa_queue_add_write_index_relaxed_fn;
+    m_state->signal_store_screlease_fn   = coreapi.hsa_signal_store_screlease_fn;
+    m_state->signal_create_fn            = coreapi.hsa_signal_create_fn;
+    m_state->signal_destroy_fn           = coreapi.hsa_signal_destroy_fn;
+    m_state->signal_async_handler_fn     = ext.hsa_amd_signal_async_handler_fn;
+}
+
+ThreadTraceQueue::~ThreadTraceQueue()
+{
+    auto _lk = std::unique_lock<std::mutex>{m_state->mtx};
+
+    // the deferred packets have never been written to the queue so they can be safely dropped.
+    // The signals of the submissions still in flight are destroyed when they complete
+    m_state->closed = true;
+    m_state->deferred.clear();
+    for(auto itr : m_state->free_signals)
+        m_state->signal_destroy_fn(itr);
+    m_state->free_signals.clear();
+}
+
+bool
+ThreadTraceQueue::submit(const packet_t* packets, size_t num_packets, completion_cb_t callback)
+{
+    if(num_packets == 0) return false;
+
+    auto _lk = std::unique_lock<std::mutex>{m_state->mtx};
+    if(m_state->closed) return false;
+
+    // submissions larger than the queue are split into chunks. Only the last chunk invokes
+    // the callback, i.e., after all the packets have been consumed
+    const size_t chunk_size = m_state->queue->size;
+    for(size_t i = 0; i < num_packets; i += chunk_size)
+    {
+        auto _sub = std::make_unique<submission>();
+        _sub->packets.assign(packets + i, packets + std::min(num_packets, i + chunk_size));
+        if(i + chunk_size >= num_packets) _sub->callback = std::move(callback);
+        m_state->deferred.emplace_back(std::move(_sub));
+    }
+
+    m_state->flush(m_state);
+    return true;
+}
+
+bool
+ThreadTraceQueue::wait(std::chrono::nanoseconds timeout) const
+{
+    // nothing notifies the waiter when the deferred submissions only wait for the packet
+    // processor to advance the read index, so they are retried at this interval
+    constexpr auto retry_interval = std::chrono::microseconds{100};
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto       _lk      = std::unique_lock<std::mutex>{m_state->mtx};
+    while(true)
+    {
+        m_state->flush(m_state);
+        if(m_state->in_flight == 0 && m_state->in_callback == 0 && m_state->deferred.empty())
+            return true;
+
+        auto _now = std::chrono::steady_clock::now();
+        if(_now >= deadline) return false;
+
+        auto _until = deadline;
+        if(m_state->in_flight == 0 && !m_state->deferred.empty())
+            _until = std::min(deadline, _now + retry_interval);
+        m_state->cv.wait_until(_lk, _until);
+    }
+}
+
+size_t
+ThreadTraceQueue::pending() const
+{
+    auto _lk = std::unique_lock<std::mutex>{m_state->mtx};
+    return m_state->in_flight + m_state->in_callback + m_state->deferred.size();
+}
+}  // namespace rocprofiler
@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <hsa/hsa.h>
+#include <hsa/hsa_api_trace.h>
+#include <hsa/hsa_ext_amd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace rocprofiler
+{
+/**
+ * Submits PM4 packets to the private queue of a thread tracer without waiting for the packet
+ * processor on the calling thread.
+ *
+ * The packets of a submission are written with a single doorbell and the last packet carries
+ * a completion signal. Once the packet processor has consumed the packets, the completion
+ * callback of the submission is invoked from the HSA async signal handler thread, e.g. to
+ * release the memory referenced by code object marker packets. Submissions which do not fit
+ * in the free slots of the queue are deferred and written, in order, when an earlier
+ * submission completes or by the next submit or wait.
+ */
+class ThreadTraceQueue
+{
+public:
+    using packet_t        = hsa_ext_amd_aql_pm4_packet_t;
+    using completion_cb_t = std::function<void()>;
+
+    ThreadTraceQueue(hsa_queue_t* queue, const CoreApiTable& coreapi, const AmdExtTable& ext);
+    ~ThreadTraceQueue();
+
+    ThreadTraceQueue(const ThreadTraceQueue&) = delete;
+    ThreadTraceQueue& operator=(const ThreadTraceQueue&) = delete;
+
+    /// Submits the packets in order with a single doorbell (unless the submission has to be
+    /// split because it is larger than the queue). Returns false if the submission is rejected
+    bool submit(const packet_t* packets, size_t num_packets, completion_cb_t callback = {});
+
+    /// Blocks until all the submissions have completed or the timeout expires. Returns false
+    /// on timeout
+    bool wait(std::chrono::nanoseconds timeout) const;
+
+    /// Number of submissions which have not completed
+    size_t pending() const;
+
+private:
+    struct state;
+    struct submission;
+
+    static bool async_handler(hsa_signal_value_t, void*);
+
+    // shared with the submissions in flight so that a late completion does not access a
+    // destroyed queue
+    std::shared_ptr<state> m_state;
+};
+}  // namespace rocprofiler
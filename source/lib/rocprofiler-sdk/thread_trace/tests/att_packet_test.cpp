@@ -60,6 +60,7 @@ get_ext_table()
         val.hsa_amd_memory_pool_free_fn           = hsa_amd_memory_pool_free;
         val.hsa_amd_agent_memory_pool_get_info_fn = hsa_amd_agent_memory_pool_get_info;
         val.hsa_amd_agents_allow_access_fn        = hsa_amd_agents_allow_access;
+        val.hsa_amd_signal_async_handler_fn       = hsa_amd_signal_async_handler;
         return val;
     }();
     return _v;
@@ -69,15 +70,18 @@ CoreApiTable&
 get_api_table()
 {
     static auto _v = []() {
-        auto val                                 = CoreApiTable{};
-        val.hsa_iterate_agents_fn                = hsa_iterate_agents;
-        val.hsa_agent_get_info_fn                = hsa_agent_get_info;
-        val.hsa_queue_create_fn                  = hsa_queue_create;
-        val.hsa_queue_destroy_fn                 = hsa_queue_destroy;
-        val.hsa_signal_wait_relaxed_fn           = hsa_signal_wait_relaxed;
-        val.hsa_queue_load_read_index_relaxed_fn = hsa_queue_load_read_index_relaxed;
-        val.hsa_queue_add_write_index_relaxed_fn = hsa_queue_add_write_index_relaxed;
-        val.hsa_signal_store_screlease_fn        = hsa_signal_store_screlease;
+        auto val                                  = CoreApiTable{};
+        val.hsa_iterate_agents_fn                 = hsa_iterate_agents;
+        val.hsa_agent_get_info_fn                 = hsa_agent_get_info;
+        val.hsa_queue_create_fn                   = hsa_queue_create;
+        val.hsa_queue_destroy_fn                  = hsa_queue_destroy;
+        val.hsa_signal_wait_relaxed_fn            = hsa_signal_wait_relaxed;
+        val.hsa_queue_load_read_index_relaxed_fn  = hsa_queue_load_read_index_relaxed;
+        val.hsa_queue_load_write_index_relaxed_fn = hsa_queue_load_write_index_relaxed;
+        val.hsa_queue_add_write_index_relaxed_fn  = hsa_queue_add_write_index_relaxed;
+        val.hsa_signal_store_screlease_fn         = hsa_signal_store_screlease;
+        val.hsa_signal_create_fn                  = hsa_signal_create;
+        val.hsa_signal_destroy_fn                 = hsa_signal_destroy;
         return val;
     }();
     return _v;
@@ -134,6 +138,8 @@ TEST(thread_trace, resource_creation)
 
         for(const auto& [_, agent] : agents)
         {
+            // Code object loaded before the first queue of the agent
+            tracer.loaded_codeobjs[agent.get_hsa_agent()][4] = {0x7000, 0x1000};
             // Init twice to simulate two queues
             tracer.resource_init(agent, get_api_table(), get_ext_table());
             tracer.resource_init(agent, get_api_table(), get_ext_table());
@@ -141,9 +147,9 @@ TEST(thread_trace, resource_creation)
 
         for(auto& [_, agenttracer] : tracer.agents)
         {
-            agenttracer->load_codeobj(1, 0x1000, 0x1000);
-            agenttracer->load_codeobj(2, 0x3000, 0x1000);
-            agenttracer->unload_codeobj(1);
+            agenttracer->update_codeobjs({{1, 0x1000, 0x1000, false}});
+            agenttracer->update_codeobjs({{2, 0x3000, 0x1000, false}, {1, 0, 0, true}});
+            agenttracer->update_codeobjs({{3, 0x5000, 0x1000, false}, {2, 0, 0, true}});
         }
 
         for(const auto& [_, agent] : agents)
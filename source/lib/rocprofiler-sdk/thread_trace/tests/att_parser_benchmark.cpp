@@ -0,0 +1,63 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/thread_trace/tests/att_parser_mocks.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+
+/**
+ * Replays synthetic per-SE trace data through the mock decoder with a decoding cost per
+ * instruction and compares the serial and the parallel decoding
+ */
+TEST(thread_trace, parser_benchmark)
+{
+    constexpr size_t num_engines = 8;
+    constexpr size_t num_pcs     = 200000;
+
+    mock_decode_cost = 50;
+
+    auto _tool = mock_tool{};
+    make_engines(_tool, num_engines, num_pcs);
+    for(auto& itr : _tool.engines)
+        itr.second.resize(num_pcs, 0x100);
+
+    auto _run = [&_tool](size_t num_threads) {
+        auto _decoder = decoder_t{mock_table, num_threads};
+        auto _t0      = std::chrono::steady_clock::now();
+        EXPECT_EQ(_tool.parse(_decoder), ROCPROFILER_STATUS_SUCCESS);
+        auto _t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(_t1 - _t0).count();
+    };
+
+    auto _serial_ms   = _run(1);
+    auto _expected    = _tool.records;
+    auto _parallel_ms = _run(4);
+    EXPECT_EQ(_tool.records, _expected);
+
+    std::cout << "Benchmark: decoding " << num_engines << " shader engines x " << num_pcs
+              << " instructions: " << _serial_ms << " ms (1 thread), " << _parallel_ms
+              << " ms (4 threads)" << std::endl;
+}
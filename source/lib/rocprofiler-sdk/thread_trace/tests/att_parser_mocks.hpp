@@ -0,0 +1,246 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "lib/rocprofiler-sdk/thread_trace/att_parser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace
+{
+using decoder_t = ::rocprofiler::att_parser::ATTDecoder;
+
+enum mock_event_id
+{
+    MOCK_TRACE_DATA_ID = 1,
+    MOCK_OCCUPANCY_ID,
+    MOCK_KERNEL_ADDR_ID,
+};
+
+constexpr size_t mock_batch_size = 64;
+// number of iterations emulating the cost of decoding an instruction
+std::atomic<size_t> mock_decode_cost = {0};
+// shader engines at or above this id are traced without a kernel id map
+std::atomic<int> mock_kernel_ids_limit = {std::numeric_limits<int>::max()};
+
+uint64_t
+mock_decode(uint64_t pc)
+{
+    auto _cost = mock_decode_cost.load(std::memory_order_relaxed);
+    for(size_t i = 0; i < _cost; ++i)
+        pc = (pc ^ (pc >> 7)) * 0x9E3779B97F4A7C15ULL;
+    return pc & 0xFFFF;
+}
+
+void
+mock_iterate_event_list(aqlprofile_att_parser_iterate_event_cb_t callback, void* userdata)
+{
+    callback(MOCK_TRACE_DATA_ID, "tracedata;instructions", userdata);
+    callback(MOCK_OCCUPANCY_ID, "occupancy;waves", userdata);
+    callback(MOCK_KERNEL_ADDR_ID, "kernel_ids_addr", userdata);
+}
+
+/**
+ * Mock of the decoder library. The trace data of a shader engine is an array of program counters.
+ * Every batch of program counters is returned as instructions, preceded by the ISA lookup of its
+ * first instruction and followed by a wave start referencing the kernel id map of the shader
+ * engine. The kernel id map is only reported at the start of a shader engine, i.e. not for the
+ * following chunks of the same shader engine
+ */
+hsa_status_t
+mock_parse_data(aqlprofile_att_se_data_callback_t se_data_callback,
+                aqlprofile_att_trace_callback_t   trace_callback,
+                aqlprofile_att_isa_callback_t     isa_callback,
+                void*                             userdata)
+{
+    auto _events    = std::vector<att_trace_event_t>{};
+    int  _last_seid = -1;
+    while(true)
+    {
+        int      _seid   = -1;
+        uint8_t* _buffer = nullptr;
+        uint64_t _size   = 0;
+        if(se_data_callback(&_seid, &_buffer, &_size, userdata) == 0) break;
+
+        bool _new_engine = (_seid != _last_seid);
+        _last_seid       = _seid;
+        if(_new_engine && _seid < mock_kernel_ids_limit)
+        {
+            auto _kernel_ids = pcinfo_t{.addr      = 0x1000 * static_cast<size_t>(_seid),
+                                        .marker_id = static_cast<size_t>(_seid)};
+            trace_callback(MOCK_KERNEL_ADDR_ID, _seid, &_kernel_ids, 1, userdata);
+        }
+
+        const auto* _pcs    = reinterpret_cast<const uint64_t*>(_buffer);
+        size_t      _num_pc = _size / sizeof(uint64_t);
+        for(size_t i = 0; i < _num_pc; i += mock_batch_size)
+        {
+            char     _isa[64]     = {};
+            uint64_t _mem_size    = 0;
+            uint64_t _isa_size    = sizeof(_isa);
+            uint64_t _source_size = 0;
+            auto     _status      = isa_callback(
+                _isa, nullptr, &_mem_size, &_isa_size, &_source_size, _seid, _pcs[i], userdata);
+            if(_status != HSA_STATUS_SUCCESS) return _status;
+
+            _events.clear();
+            for(size_t j = i; j < std::min(_num_pc, i + mock_batch_size); ++j)
+            {
+                auto _event         = att_trace_event_t{};
+                _event.hitcount     = 1;
+                _event.latency      = mock_decode(_pcs[j]);
+                _event.pc.addr      = _pcs[j];
+                _event.pc.marker_id = _seid;
+                _events.emplace_back(_event);
+            }
+            trace_callback(MOCK_TRACE_DATA_ID, _seid, _events.data(), _events.size(), userdata);
+
+            auto _occupancy      = att_occupancy_info_t{};
+            _occupancy.kernel_id = 0;
+            _occupancy.enable    = 1;
+            _occupancy.time      = i;
+            trace_callback(MOCK_OCCUPANCY_ID, _seid, &_occupancy, 1, userdata);
+        }
+    }
+    return HSA_STATUS_SUCCESS;
+}
+
+using record_t = std::tuple<int, uint64_t, uint64_t, uint64_t>;
+
+/**
+ * Tool side of the parser: replays the trace data of the shader engines and records the results.
+ * Also checks that the callbacks are not invoked concurrently
+ */
+struct mock_tool
+{
+    std::vector<std::pair<int, std::vector<uint64_t>>> engines       = {};
+    size_t                                             next_engine   = 0;
+    size_t                                             next_pc       = 0;
+    size_t                                             chunk_size    = 0;  // 0: whole engine
+    std::vector<record_t>                              records       = {};
+    size_t                                             num_isa       = 0;
+    int                                                failing_se    = -1;
+    std::atomic<int>                                   in_callback   = {0};
+    std::atomic<int>                                   max_callbacks = {0};
+
+    void enter()
+    {
+        auto _n = ++in_callback;
+        if(_n > max_callbacks) max_callbacks = _n;
+    }
+
+    void exit() { --in_callback; }
+
+    static uint64_t se_data(int* seid, uint8_t** buffer, uint64_t* buffer_size, void* userdata)
+    {
+        auto& _tool = *static_cast<mock_tool*>(userdata);
+        if(_tool.next_engine == _tool.engines.size()) return 0;
+
+        // the program counters of a shader engine are returned in chunks of chunk_size
+        auto& _engine = _tool.engines.at(_tool.next_engine);
+        auto  _size   = _engine.second.size() - _tool.next_pc;
+        if(_tool.chunk_size > 0) _size = std::min(_size, _tool.chunk_size);
+
+        *seid        = _engine.first;
+        *buffer      = reinterpret_cast<uint8_t*>(_engine.second.data() + _tool.next_pc);
+        *buffer_size = _size * sizeof(uint64_t);
+
+        _tool.next_pc += _size;
+        if(_tool.next_pc == _engine.second.size())
+        {
+            ++_tool.next_engine;
+            _tool.next_pc = 0;
+        }
+        return *buffer_size;
+    }
+
+    static void trace(rocprofiler_att_parser_data_type_t type, void* att_data, void* userdata)
+    {
+        auto& _tool = *static_cast<mock_tool*>(userdata);
+        _tool.enter();
+        if(type == ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA)
+        {
+            const auto& _isa = *static_cast<rocprofiler_att_data_type_isa_t*>(att_data);
+            _tool.records.emplace_back(type, _isa.marker_id, _isa.offset, _isa.latency);
+        }
+        else
+        {
+            const auto& _occ = *static_cast<rocprofiler_att_data_type_occupancy_t*>(att_data);
+            _tool.records.emplace_back(type, _occ.marker_id, _occ.offset, _occ.timestamp);
+        }
+        _tool.exit();
+    }
+
+    static rocprofiler_status_t isa(char*     isa_instruction,
+                                    uint64_t* isa_memory_size,
+                                    uint64_t* isa_size,
+                                    uint64_t  marker_id,
+                                    uint64_t /* offset */,
+                                    void* userdata)
+    {
+        auto& _tool = *static_cast<mock_tool*>(userdata);
+        if(static_cast<int>(marker_id) == _tool.failing_se)
+            return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+        _tool.enter();
+        ++_tool.num_isa;
+        *isa_size        = std::min<uint64_t>(*isa_size, 8);
+        *isa_memory_size = 4;
+        memcpy(isa_instruction, "s_nop 0", *isa_size);
+        _tool.exit();
+        return ROCPROFILER_STATUS_SUCCESS;
+    }
+
+    rocprofiler_status_t parse(decoder_t& decoder)
+    {
+        next_engine = 0;
+        next_pc     = 0;
+        records.clear();
+        num_isa = 0;
+        return decoder.parse(se_data, trace, isa, this);
+    }
+};
+
+/// Shader engines returned out of order, the first ones holding the most data
+void
+make_engines(mock_tool& tool, size_t num_engines, size_t num_pcs)
+{
+    for(size_t i = 0; i < num_engines; ++i)
+    {
+        auto& _engine = tool.engines.emplace_back();
+        _engine.first = static_cast<int>((i * 5) % num_engines);
+        for(size_t j = 0; j < num_pcs / (i + 1); ++j)
+            _engine.second.emplace_back(0x100 + 4 * j);
+    }
+}
+
+constexpr auto mock_table = ::rocprofiler::att_parser::decoder_table_t{
+    .parse_data_fn         = mock_parse_data,
+    .iterate_event_list_fn = mock_iterate_event_list};
+}  // namespace
@@ -0,0 +1,220 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/thread_trace/tests/att_parser_mocks.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+TEST(thread_trace, parser_order)
+{
+    mock_decode_cost = 0;
+
+    auto _serial   = decoder_t{mock_table, 1};
+    auto _parallel = decoder_t{mock_table, 4};
+
+    auto _tool = mock_tool{};
+    make_engines(_tool, 6, 4000);
+    ASSERT_EQ(_tool.parse(_serial), ROCPROFILER_STATUS_SUCCESS);
+    auto _expected     = _tool.records;
+    auto _expected_isa = _tool.num_isa;
+
+    // every record of a shader engine is delivered before the records of the next one
+    ASSERT_FALSE(_expected.empty());
+    size_t _engine = 0;
+    for(const auto& itr : _expected)
+    {
+        while(std::get<1>(itr) != static_cast<uint64_t>(_tool.engines.at(_engine).first))
+            ASSERT_LT(++_engine, _tool.engines.size());
+        if(std::get<0>(itr) == ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY)
+        {
+            // resolved from the kernel id map of the shader engine
+            EXPECT_EQ(std::get<2>(itr), 0x1000 * std::get<1>(itr));
+        }
+    }
+    EXPECT_EQ(_engine, _tool.engines.size() - 1);
+
+    // the worker pool and the decoder state are reused across parse calls
+    for(size_t i = 0; i < 3; ++i)
+    {
+        _tool.max_callbacks = 0;
+        ASSERT_EQ(_tool.parse(_parallel), ROCPROFILER_STATUS_SUCCESS);
+        EXPECT_EQ(_tool.records, _expected);
+        EXPECT_EQ(_tool.num_isa, _expected_isa);
+        EXPECT_EQ(_tool.max_callbacks, 1);
+    }
+
+    // a single shader engine is decoded on the calling thread
+    auto _single = mock_tool{};
+    make_engines(_single, 1, 1000);
+    ASSERT_EQ(_single.parse(_serial), ROCPROFILER_STATUS_SUCCESS);
+    auto _single_expected = _single.records;
+    ASSERT_EQ(_single.parse(_parallel), ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(_single.records, _single_expected);
+
+    // no data
+    auto _empty = mock_tool{};
+    EXPECT_EQ(_empty.parse(_parallel), ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_TRUE(_empty.records.empty());
+}
+
+TEST(thread_trace, parser_error)
+{
+    mock_decode_cost = 0;
+
+    auto _serial   = decoder_t{mock_table, 1};
+    auto _parallel = decoder_t{mock_table, 4};
+
+    auto _tool = mock_tool{};
+    make_engines(_tool, 4, 1000);
+    _tool.failing_se = _tool.engines.at(2).first;
+    EXPECT_EQ(_tool.parse(_serial), ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(_tool.parse(_parallel), ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT);
+
+    // the other shader engines are still delivered
+    for(size_t i = 0; i < _tool.engines.size(); ++i)
+    {
+        auto _id    = static_cast<uint64_t>(_tool.engines.at(i).first);
+        auto _found = std::any_of(_tool.records.begin(), _tool.records.end(), [_id](auto& itr) {
+            return std::get<1>(itr) == _id;
+        });
+        EXPECT_EQ(_found, i != 2) << "shader engine " << _id;
+    }
+}
+
+TEST(thread_trace, parser_state_reset)
+{
+    mock_decode_cost = 0;
+
+    auto _serial   = decoder_t{mock_table, 1};
+    auto _parallel = decoder_t{mock_table, 2};
+
+    auto _traced = mock_tool{};
+    make_engines(_traced, 4, 1000);
+
+    auto _untraced = mock_tool{};
+    make_engines(_untraced, 4, 1000);
+
+    for(auto* itr : {&_serial, &_parallel})
+    {
+        // the kernel id maps of the first parse are not used by the second one
+        mock_kernel_ids_limit = std::numeric_limits<int>::max();
+        ASSERT_EQ(_traced.parse(*itr), ROCPROFILER_STATUS_SUCCESS);
+        mock_kernel_ids_limit = 2;
+        ASSERT_EQ(_untraced.parse(*itr), ROCPROFILER_STATUS_SUCCESS);
+
+        // one occupancy record per batch, shader engine 0 resolves to a zero offset
+        size_t _expected_unresolved = 0;
+        for(const auto& eng : _untraced.engines)
+        {
+            if(eng.first == 0 || eng.first >= mock_kernel_ids_limit)
+                _expected_unresolved += (eng.second.size() + mock_batch_size - 1) / mock_batch_size;
+        }
+
+        size_t _num_unresolved = 0;
+        for(const auto& rec : _untraced.records)
+        {
+            if(std::get<0>(rec) != ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY) continue;
+            if(std::get<1>(rec) == 0 && std::get<2>(rec) == 0)
+                ++_num_unresolved;
+            else
+                EXPECT_EQ(std::get<2>(rec), 0x1000 * std::get<1>(rec));
+        }
+        EXPECT_EQ(_num_unresolved, _expected_unresolved);
+    }
+    mock_kernel_ids_limit = std::numeric_limits<int>::max();
+}
+
+TEST(thread_trace, parser_chunks)
+{
+    mock_decode_cost = 0;
+
+    auto _serial   = decoder_t{mock_table, 1};
+    auto _parallel = decoder_t{mock_table, 4};
+
+    auto _isa_records = [](const std::vector<record_t>& records) {
+        auto _isa = std::vector<record_t>{};
+        for(const auto& itr : records)
+            if(std::get<0>(itr) == ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA) _isa.emplace_back(itr);
+        return _isa;
+    };
+
+    // no shader engine 0, i.e. the occupancy records without a kernel id have a zero marker id
+    auto _make_engines = [](mock_tool& tool) {
+        make_engines(tool, 4, 1000);
+        for(auto& itr : tool.engines)
+            ++itr.first;
+    };
+
+    auto _whole = mock_tool{};
+    _make_engines(_whole);
+    ASSERT_EQ(_whole.parse(_serial), ROCPROFILER_STATUS_SUCCESS);
+    auto _expected = _isa_records(_whole.records);
+
+    auto _chunked = mock_tool{};
+    _make_engines(_chunked);
+    _chunked.chunk_size = 100;
+
+    for(auto* itr : {&_serial, &_parallel})
+    {
+        ASSERT_EQ(_chunked.parse(*itr), ROCPROFILER_STATUS_SUCCESS);
+        EXPECT_EQ(_isa_records(_chunked.records), _expected);
+
+        // the kernel id map reported by the first chunk of a shader engine is used by the
+        // following chunks
+        size_t _num_occupancy = 0;
+        for(const auto& rec : _chunked.records)
+        {
+            if(std::get<0>(rec) != ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY) continue;
+            ++_num_occupancy;
+            EXPECT_NE(std::get<1>(rec), 0);
+            EXPECT_EQ(std::get<2>(rec), 0x1000 * std::get<1>(rec));
+        }
+        EXPECT_GT(_num_occupancy, _chunked.engines.size());
+    }
+}
+
+TEST(thread_trace, parser_default_threads)
+{
+    mock_decode_cost = 0;
+
+    auto _serial  = decoder_t{mock_table, 1};
+    auto _default = decoder_t{mock_table, 0};
+    EXPECT_EQ(_default.size(), 0);
+
+    // the pool is sized by the number of shader engines and grows with later calls
+    for(size_t num_engines : {2, 6, 3})
+    {
+        auto _tool = mock_tool{};
+        make_engines(_tool, num_engines, 2000);
+        ASSERT_EQ(_tool.parse(_serial), ROCPROFILER_STATUS_SUCCESS);
+        auto _expected = _tool.records;
+
+        _tool.max_callbacks = 0;
+        ASSERT_EQ(_tool.parse(_default), ROCPROFILER_STATUS_SUCCESS);
+        EXPECT_EQ(_tool.records, _expected);
+        EXPECT_EQ(_tool.max_callbacks, 1);
+    }
+}
@@ -0,0 +1,497 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/thread_trace/att_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using packet_t = hsa_ext_amd_aql_pm4_packet_t;
+
+struct mock_signal
+{
+    std::atomic<hsa_signal_value_t> value   = {0};
+    hsa_amd_signal_handler          handler = nullptr;
+    void*                           arg     = nullptr;
+};
+
+/**
+ * Single queue processed by a mock packet processor (CP). The CP consumes the packets up to the
+ * last doorbell, decrements their completion signals, and invokes the async signal handlers, i.e.
+ * it also plays the role of the HSA async handler thread. It can be paused to emulate a busy GPU
+ */
+struct mock_cp
+{
+    static constexpr uint32_t queue_size = 16;
+
+    mock_cp()
+    : ring(queue_size)
+    {
+        queue.base_address           = ring.data();
+        queue.size                   = queue_size;
+        queue.doorbell_signal.handle = reinterpret_cast<uint64_t>(&doorbell);
+        thread                       = std::thread{[this]() { run(); }};
+    }
+
+    ~mock_cp()
+    {
+        {
+            auto _lk = std::unique_lock<std::mutex>{mtx};
+            stop     = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+    void set_paused(bool value)
+    {
+        {
+            auto _lk = std::unique_lock<std::mutex>{mtx};
+            paused   = value;
+        }
+        cv.notify_all();
+    }
+
+    void run();
+
+    hsa_queue_t             queue          = {};
+    std::vector<packet_t>   ring           = {};
+    std::atomic<uint64_t>   read_idx       = {0};
+    std::atomic<uint64_t>   write_idx      = {0};
+    mock_signal             doorbell       = {};
+    std::mutex              mtx            = {};
+    std::condition_variable cv             = {};
+    uint64_t                num_doorbells  = 0;
+    bool                    rung           = false;
+    bool                    paused         = false;
+    bool                    stop           = false;
+    bool                    lag_read_index = false;
+    std::vector<uint32_t>   processed      = {};  // sequence numbers of the consumed packets
+    std::thread::id         thread_id      = {};
+    std::thread             thread         = {};
+};
+
+mock_cp*         cp                   = nullptr;
+std::atomic<int> num_handler_failures = {0};  // registrations of async handlers which fail
+
+void
+mock_cp::run()
+{
+    thread_id = std::this_thread::get_id();
+    while(true)
+    {
+        auto _lk = std::unique_lock<std::mutex>{mtx};
+        cv.wait(_lk, [this]() {
+            return stop ||
+                   (!paused && rung && read_idx.load() <= uint64_t(doorbell.value.load()) &&
+                    read_idx.load() < write_idx.load());
+        });
+        if(stop) return;
+
+        auto& _packet = ring.at(read_idx.load() % queue_size);
+        auto  _header = reinterpret_cast<std::atomic<uint32_t>*>(&_packet)->load();
+        EXPECT_NE(_header, 0) << "packet " << read_idx.load() << " consumed before it was written";
+        processed.emplace_back(_packet.pm4_command[1]);
+
+        auto _signal = _packet.completion_signal;
+        reinterpret_cast<std::atomic<uint32_t>*>(&_packet)->store(0);
+        auto _lag = lag_read_index;
+        if(!_lag) ++read_idx;
+        _lk.unlock();
+
+        if(_signal.handle != 0)
+        {
+            auto* _sig   = reinterpret_cast<mock_signal*>(_signal.handle);
+            auto  _value = --_sig->value;
+            if(_value < 1 && _sig->handler)
+            {
+                auto _handler = _sig->handler;
+                _sig->handler = nullptr;
+                if(_handler(_value, _sig->arg)) _sig->handler = _handler;
+            }
+        }
+
+        // the read index is advanced after the completion signal has been decremented
+        if(_lag) ++read_idx;
+    }
+}
+
+uint64_t
+load_read_index_relaxed(const hsa_queue_t*)
+{
+    return cp->read_idx.load();
+}
+
+uint64_t
+load_write_index_relaxed(const hsa_queue_t*)
+{
+    return cp->write_idx.load();
+}
+
+uint64_t
+add_write_index_relaxed(const hsa_queue_t*, uint64_t value)
+{
+    return cp->write_idx.fetch_add(value);
+}
+
+void
+signal_store_screlease(hsa_signal_t signal, hsa_signal_value_t value)
+{
+    auto* _sig = reinterpret_cast<mock_signal*>(signal.handle);
+    if(_sig == &cp->doorbell)
+    {
+        {
+            auto _lk = std::unique_lock<std::mutex>{cp->mtx};
+            cp->doorbell.value.store(value);
+            cp->rung = true;
+            ++cp->num_doorbells;
+        }
+        cp->cv.notify_all();
+    }
+    else
+    {
+        _sig->value.store(value);
+    }
+}
+
+hsa_status_t
+signal_create(hsa_signal_value_t value, uint32_t, const hsa_agent_t*, hsa_signal_t* signal)
+{
+    auto* _sig     = new mock_signal{};
+    _sig->value    = value;
+    signal->handle = reinterpret_cast<uint64_t>(_sig);
+    return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+signal_destroy(hsa_signal_t signal)
+{
+    delete reinterpret_cast<mock_signal*>(signal.handle);
+    return HSA_STATUS_SUCCESS;
+}
+
+hsa_status_t
+signal_async_handler(hsa_signal_t           signal,
+                     hsa_signal_condition_t cond,
+                     hsa_signal_value_t     value,
+                     hsa_amd_signal_handler handler,
+                     void*                  arg)
+{
+    EXPECT_EQ(cond, HSA_SIGNAL_CONDITION_LT);
+    EXPECT_EQ(value, 1);
+
+    if(num_handler_failures.load() > 0)
+    {
+        --num_handler_failures;
+        return HSA_STATUS_ERROR;
+    }
+
+    // the handler is registered before the packets are written, i.e. it cannot have completed
+    auto* _sig = reinterpret_cast<mock_signal*>(signal.handle);
+    EXPECT_EQ(_sig->value.load(), 1);
+    _sig->arg     = arg;
+    _sig->handler = handler;
+    return HSA_STATUS_SUCCESS;
+}
+
+CoreApiTable
+get_core_table()
+{
+    auto val                                  = CoreApiTable{};
+    val.hsa_queue_load_read_index_relaxed_fn  = load_read_index_relaxed;
+    val.hsa_queue_load_write_index_relaxed_fn = load_write_index_relaxed;
+    val.hsa_queue_add_write_index_relaxed_fn  = add_write_index_relaxed;
+    val.hsa_signal_store_screlease_fn         = signal_store_screlease;
+    val.hsa_signal_create_fn                  = signal_create;
+    val.hsa_signal_destroy_fn                 = signal_destroy;
+    return val;
+}
+
+AmdExtTable
+get_ext_table()
+{
+    auto val                            = AmdExtTable{};
+    val.hsa_amd_signal_async_handler_fn = signal_async_handler;
+    return val;
+}
+
+std::vector<packet_t>
+make_packets(uint32_t& seq, size_t num)
+{
+    auto _packets = std::vector<packet_t>(num);
+    for(auto& itr : _packets)
+    {
+        itr        = packet_t{};
+        itr.header = HSA_PACKET_TYPE_VENDOR_SPECIFIC << HSA_PACKET_HEADER_TYPE;
+        // a non-zero first dword so that the mock CP can detect packets which are not written
+        itr.pm4_command[0] = 0xC0DE;
+        itr.pm4_command[1] = seq++;
+    }
+    return _packets;
+}
+
+struct completion_log
+{
+    std::mutex                   mtx     = {};
+    std::vector<size_t>          ids     = {};
+    std::vector<std::thread::id> threads = {};
+
+    auto callback(size_t id)
+    {
+        return [this, id]() {
+            auto _lk = std::unique_lock<std::mutex>{mtx};
+            ids.emplace_back(id);
+            threads.emplace_back(std::this_thread::get_id());
+        };
+    }
+};
+}  // namespace
+
+TEST(thread_trace, queue_submit_order)
+{
+    auto _cp = std::make_unique<mock_cp>();
+    cp       = _cp.get();
+
+    constexpr size_t num_batches     = 10;
+    constexpr size_t packets_per_sub = 5;
+
+    auto _log   = completion_log{};
+    auto _queue = rocprofiler::ThreadTraceQueue{&_cp->queue, get_core_table(), get_ext_table()};
+
+    // the CP is busy: the submissions return without waiting for the CP even though the
+    // submissions do not fit in the queue
+    _cp->set_paused(true);
+
+    uint32_t _seq = 0;
+    for(size_t i = 0; i < num_batches; ++i)
+    {
+        auto _packets = make_packets(_seq, packets_per_sub);
+        EXPECT_TRUE(_queue.submit(_packets.data(), _packets.size(), _log.callback(i)));
+    }
+
+    EXPECT_EQ(_queue.pending(), num_batches);
+    {
+        auto _lk = std::unique_lock<std::mutex>{_cp->mtx};
+        EXPECT_TRUE(_cp->processed.empty());
+        // only the submissions which fit in the queue have been written, one doorbell each
+        EXPECT_EQ(_cp->num_doorbells, mock_cp::queue_size / packets_per_sub);
+        EXPECT_EQ(_cp->write_idx.load(),
+                  (mock_cp::queue_size / packets_per_sub) * packets_per_sub);
+    }
+    {
+        auto _lk = std::unique_lock<std::mutex>{_log.mtx};
+        EXPECT_TRUE(_log.ids.empty());
+    }
+
+    _cp->set_paused(false);
+    ASSERT_TRUE(_queue.wait(std::chrono::seconds{5}));
+    EXPECT_EQ(_queue.pending(), 0);
+
+    {
+        auto _lk = std::unique_lock<std::mutex>{_cp->mtx};
+        ASSERT_EQ(_cp->processed.size(), num_batches * packets_per_sub);
+        for(size_t i = 0; i < _cp->processed.size(); ++i)
+            EXPECT_EQ(_cp->processed.at(i), i);
+        // deferred submissions are coalesced when slots are freed
+        EXPECT_LE(_cp->num_doorbells, num_batches);
+    }
+
+    ASSERT_EQ(_log.ids.size(), num_batches);
+    for(size_t i = 0; i < num_batches; ++i)
+    {
+        EXPECT_EQ(_log.ids.at(i), i);
+        // the callbacks are invoked from the async handler thread
+        EXPECT_EQ(_log.threads.at(i), _cp->thread_id);
+        EXPECT_NE(_log.threads.at(i), std::this_thread::get_id());
+    }
+
+    _cp.reset();
+    cp = nullptr;
+}
+
+TEST(thread_trace, queue_submit_batch)
+{
+    auto _cp = std::make_unique<mock_cp>();
+    cp       = _cp.get();
+
+    auto _log   = completion_log{};
+    auto _queue = rocprofiler::ThreadTraceQueue{&_cp->queue, get_core_table(), get_ext_table()};
+
+    // many marker packets with a single doorbell
+    uint32_t _seq     = 0;
+    auto     _packets = make_packets(_seq, 12);
+    _cp->set_paused(true);
+    EXPECT_TRUE(_queue.submit(_packets.data(), _packets.size(), _log.callback(0)));
+    {
+        auto _lk = std::unique_lock<std::mutex>{_cp->mtx};
+        EXPECT_EQ(_cp->num_doorbells, 1);
+        EXPECT_EQ(_cp->write_idx.load(), 12);
+    }
+    _cp->set_paused(false);
+    ASSERT_TRUE(_queue.wait(std::chrono::seconds{5}));
+
+    // a submission larger than the queue is split but completes once
+    _packets = make_packets(_seq, 3 * mock_cp::queue_size + 1);
+    EXPECT_TRUE(_queue.submit(_packets.data(), _packets.size(), _log.callback(1)));
+    ASSERT_TRUE(_queue.wait(std::chrono::seconds{5}));
+
+    EXPECT_FALSE(_queue.submit(_packets.data(), 0));
+
+    {
+        auto _lk = std::unique_lock<std::mutex>{_cp->mtx};
+        ASSERT_EQ(_cp->processed.size(), _seq);
+        for(size_t i = 0; i < _cp->processed.size(); ++i)
+            EXPECT_EQ(_cp->processed.at(i), i);
+    }
+
+    ASSERT_EQ(_log.ids.size(), 2);
+    EXPECT_EQ(_log.ids.at(0), 0);
+    EXPECT_EQ(_log.ids.at(1), 1);
+
+    _cp.reset();
+    cp = nullptr;
+}
+
+TEST(thread_trace, queue_destroy_in_flight)
+{
+    auto _cp = std::make_unique<mock_cp>();
+    cp       = _cp.get();
+
+    auto _written  = std::make_shared<int>(0);
+    auto _deferred = std::make_shared<int>(0);
+    auto _done     = std::atomic<int>{0};
+
+    {
+        auto _queue =
+            rocprofiler::ThreadTraceQueue{&_cp->queue, get_core_table(), get_ext_table()};
+
+        uint32_t _seq = 0;
+        _cp->set_paused(true);
+
+        auto _packets = make_packets(_seq, mock_cp::queue_size);
+        EXPECT_TRUE(_queue.submit(
+            _packets.data(), _packets.size(), [_written, &_done]() { ++_done; }));
+        _packets = make_packets(_seq, 1);
+        EXPECT_TRUE(_queue.submit(
+            _packets.data(), _packets.size(), [_deferred, &_done]() { ++_done; }));
+        EXPECT_FALSE(_queue.wait(std::chrono::milliseconds{10}));
+    }
+
+    // the deferred submission has never been written: it is dropped with the queue
+    EXPECT_EQ(_deferred.use_count(), 1);
+    EXPECT_EQ(_written.use_count(), 2);
+
+    // the submission in flight still completes after the queue has been destroyed
+    _cp->set_paused(false);
+    for(size_t i = 0; i < 5000 && _written.use_count() > 1; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+    EXPECT_EQ(_written.use_count(), 1);
+    EXPECT_EQ(_done.load(), 1);
+
+    _cp.reset();
+    cp = nullptr;
+}
+
+TEST(thread_trace, queue_read_index_lag)
+{
+    auto _cp = std::make_unique<mock_cp>();
+    cp       = _cp.get();
+
+    auto _log   = completion_log{};
+    auto _queue = rocprofiler::ThreadTraceQueue{&_cp->queue, get_core_table(), get_ext_table()};
+
+    // the completion of a full queue is handled before its slots are free: the next
+    // submission stays deferred instead of blocking the async handler thread
+    _cp->lag_read_index = true;
+    _cp->set_paused(true);
+
+    uint32_t _seq     = 0;
+    auto     _packets = make_packets(_seq, mock_cp::queue_size);
+    EXPECT_TRUE(_queue.submit(_packets.data(), _packets.size(), _log.callback(0)));
+    _packets = make_packets(_seq, mock_cp::queue_size);
+    EXPECT_TRUE(_queue.submit(_packets.data(), _packets.size(), _log.callback(1)));
+
+    _cp->set_paused(false);
+    ASSERT_TRUE(_queue.wait(std::chrono::seconds{5}));
+    EXPECT_EQ(_queue.pending(), 0);
+
+    {
+        auto _lk = std::unique_lock<std::mutex>{_cp->mtx};
+        ASSERT_EQ(_cp->processed.size(), _seq);
+        for(size_t i = 0; i < _cp->processed.size(); ++i)
+            EXPECT_EQ(_cp->processed.at(i), i);
+    }
+    ASSERT_EQ(_log.ids.size(), 2);
+
+    _cp.reset();
+    cp = nullptr;
+}
+
+TEST(thread_trace, queue_handler_failure)
+{
+    auto _cp = std::make_unique<mock_cp>();
+    cp       = _cp.get();
+
+    auto _log     = completion_log{};
+    auto _dropped = std::make_shared<int>(0);
+    auto _queue   = rocprofiler::ThreadTraceQueue{&_cp->queue, get_core_table(), get_ext_table()};
+
+    // the submission whose completion handler cannot be registered is dropped: its packets are
+    // not written and it is not reported as pending
+    num_handler_failures.store(1);
+    uint32_t _seq     = 0;
+    auto     _packets = make_packets(_seq, 4);
+    EXPECT_TRUE(_queue.submit(_packets.data(), _packets.size(), [_dropped]() {}));
+    EXPECT_EQ(_dropped.use_count(), 1);
+
+    auto _first = _seq;
+    _packets    = make_packets(_seq, 4);
+    EXPECT_TRUE(_queue.submit(_packets.data(), _packets.size(), _log.callback(1)));
+
+    ASSERT_TRUE(_queue.wait(std::chrono::seconds{5}));
+    EXPECT_EQ(_queue.pending(), 0);
+    EXPECT_EQ(num_handler_failures.load(), 0);
+
+    {
+        auto _lk = std::unique_lock<std::mutex>{_cp->mtx};
+        EXPECT_EQ(_cp->write_idx.load(), 4);
+        ASSERT_EQ(_cp->processed.size(), 4);
+        for(size_t i = 0; i < _cp->processed.size(); ++i)
+            EXPECT_EQ(_cp->processed.at(i), _first + i);
+    }
+    ASSERT_EQ(_log.ids.size(), 1);
+    EXPECT_EQ(_log.ids.at(0), 1);
+
+    _cp.reset();
+    cp = nullptr;
+}
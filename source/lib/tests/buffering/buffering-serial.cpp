@@ -170,3 +170,36 @@ TEST(buffering, serial)
                                     << _fp_rhs.to_string() << "\n";
     }
 }
+
+TEST(buffering, serial_emplace_n)
+{
+    // this test verifies that records written in place via emplace_n are indistinguishable from
+    // records emplaced individually and that a request larger than the free space is truncated
+    // to the number of records which fit
+
+    // the buffer size is rounded up to a multiple of the page size
+    auto _buffer = record_header_buffer_t{1000 * sizeof(uint64_t)};
+    auto n       = _buffer.capacity() / sizeof(uint64_t);
+
+    uint64_t _next = 0;
+    auto     _fill = [&_next](uint64_t* _data, size_t _num) {
+        for(size_t i = 0; i < _num; ++i)
+            _data[i] = _next++;
+    };
+
+    EXPECT_EQ(_buffer.emplace_n<uint64_t>(1, 2, 300, _fill), 300);
+    auto _v = _next++;
+    EXPECT_TRUE(_buffer.emplace(1, 2, _v));
+    EXPECT_EQ(_buffer.emplace_n<uint64_t>(1, 2, n, _fill), n - 301);
+    EXPECT_EQ(_buffer.emplace_n<uint64_t>(1, 2, n, _fill), 0);
+
+    auto _headers = _buffer.get_record_headers();
+    ASSERT_EQ(_headers.size(), n);
+    for(size_t i = 0; i < _headers.size(); ++i)
+    {
+        ASSERT_TRUE(_headers.at(i)->payload) << "nullptr to payload not expected";
+        EXPECT_EQ(_headers.at(i)->category, 1);
+        EXPECT_EQ(_headers.at(i)->kind, 2);
+        EXPECT_EQ(*static_cast<uint64_t*>(_headers.at(i)->payload), i);
+    }
+}
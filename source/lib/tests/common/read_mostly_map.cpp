@@ -0,0 +1,189 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/container/read_mostly_map.hpp"
+#include "lib/common/synchronized.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+using kernel_object_map_t = ::rocprofiler::common::container::read_mostly_map<uint64_t, uint64_t>;
+
+// mimic code object layout: kernel objects are 64-byte aligned addresses within a load range
+constexpr uint64_t kernel_object_base   = 0x7f0000000000ULL;
+constexpr uint64_t kernels_per_code_obj = 256;
+
+uint64_t
+get_kernel_object(uint64_t code_obj, uint64_t kernel)
+{
+    return kernel_object_base + (((code_obj * kernels_per_code_obj) + kernel) * 64);
+}
+
+uint64_t
+get_kernel_id(uint64_t code_obj, uint64_t kernel)
+{
+    return (code_obj * kernels_per_code_obj) + kernel + 1;
+}
+
+void
+load_code_object(kernel_object_map_t& _map, uint64_t code_obj)
+{
+    _map.modify([code_obj](kernel_object_map_t::map_type& data) {
+        for(uint64_t i = 0; i < kernels_per_code_obj; ++i)
+            data[get_kernel_object(code_obj, i)] = get_kernel_id(code_obj, i);
+    });
+}
+
+void
+unload_code_object(kernel_object_map_t& _map, uint64_t code_obj)
+{
+    _map.modify([code_obj](kernel_object_map_t::map_type& data) {
+        for(uint64_t i = 0; i < kernels_per_code_obj; ++i)
+            data.erase(get_kernel_object(code_obj, i));
+    });
+}
+}  // namespace
+
+TEST(common, read_mostly_map)
+{
+    auto _map = kernel_object_map_t{};
+
+    EXPECT_EQ(_map.size(), 0);
+    EXPECT_EQ(_map.find(get_kernel_object(0, 0)), 0);
+    EXPECT_FALSE(_map.contains(get_kernel_object(0, 0)));
+
+    load_code_object(_map, 0);
+    load_code_object(_map, 1);
+    EXPECT_EQ(_map.size(), 2 * kernels_per_code_obj);
+
+    for(uint64_t i = 0; i < kernels_per_code_obj; ++i)
+    {
+        EXPECT_EQ(_map.find(get_kernel_object(0, i)), get_kernel_id(0, i));
+        EXPECT_EQ(_map.find(get_kernel_object(1, i)), get_kernel_id(1, i));
+        // repeated lookups are served from the thread-local cache
+        EXPECT_EQ(_map.find(get_kernel_object(1, i)), get_kernel_id(1, i));
+    }
+
+    auto _gen = _map.generation();
+    unload_code_object(_map, 0);
+    EXPECT_NE(_map.generation(), _gen);
+    EXPECT_EQ(_map.size(), kernels_per_code_obj);
+
+    // the cached hit for code object 1 must not be returned for the unloaded code object
+    for(uint64_t i = 0; i < kernels_per_code_obj; ++i)
+    {
+        EXPECT_EQ(_map.find(get_kernel_object(0, i)), 0);
+        EXPECT_EQ(_map.find(get_kernel_object(0, i), 42), 42);
+        EXPECT_EQ(_map.find(get_kernel_object(1, i)), get_kernel_id(1, i));
+    }
+
+    // the last-hit cache must be invalidated when a key is remapped
+    auto _kern_obj = get_kernel_object(1, 0);
+    EXPECT_EQ(_map.find(_kern_obj), get_kernel_id(1, 0));
+    _map.emplace(_kern_obj, 12345);
+    EXPECT_EQ(_map.find(_kern_obj), 12345);
+    _map.erase(_kern_obj);
+    EXPECT_EQ(_map.find(_kern_obj), 0);
+
+    _map.clear();
+    EXPECT_EQ(_map.size(), 0);
+}
+
+TEST(common, read_mostly_map_stress)
+{
+    constexpr uint64_t num_readers        = 8;
+    constexpr uint64_t lookups_per_thread = 2000000;
+    constexpr uint64_t num_resident       = 4;
+    constexpr uint64_t num_transient      = 32;
+
+    auto _map = kernel_object_map_t{};
+
+    // resident code objects are never unloaded so every lookup into them must succeed
+    for(uint64_t i = 0; i < num_resident; ++i)
+        load_code_object(_map, i);
+
+    auto _done    = std::atomic<bool>{false};
+    auto _errors  = std::atomic<uint64_t>{0};
+    auto _updates = std::atomic<uint64_t>{0};
+
+    // continuously load and unload transient code objects while readers look up kernel ids
+    auto _writers = std::vector<std::thread>{};
+    for(uint64_t w = 0; w < 2; ++w)
+    {
+        _writers.emplace_back([&, w]() {
+            uint64_t n = 0;
+            while(!_done.load(std::memory_order_relaxed))
+            {
+                auto code_obj = num_resident + (w * num_transient) + (n++ % num_transient);
+                load_code_object(_map, code_obj);
+                unload_code_object(_map, code_obj);
+                _updates += 2;
+            }
+        });
+    }
+
+    auto _readers = std::vector<std::thread>{};
+    for(uint64_t r = 0; r < num_readers; ++r)
+    {
+        _readers.emplace_back([&, r]() {
+            uint64_t _local_errors = 0;
+            for(uint64_t i = 0; i < lookups_per_thread; ++i)
+            {
+                // repeat the same kernel a few times to exercise the last-hit cache
+                auto _idx     = (i / 4) + r;
+                auto code_obj = (_idx % 3 == 0) ? num_resident + (_idx % (2 * num_transient))
+                                                : (_idx % num_resident);
+                auto kernel   = (_idx * 7) % kernels_per_code_obj;
+                auto _id      = _map.find(get_kernel_object(code_obj, kernel));
+
+                if(code_obj < num_resident)
+                {
+                    if(_id != get_kernel_id(code_obj, kernel)) ++_local_errors;
+                }
+                else if(_id != 0 && _id != get_kernel_id(code_obj, kernel))
+                {
+                    // transient kernels may be loaded or unloaded but never map to a wrong id
+                    ++_local_errors;
+                }
+            }
+            _errors += _local_errors;
+        });
+    }
+
+    for(auto& itr : _readers)
+        itr.join();
+
+    _done.store(true);
+    for(auto& itr : _writers)
+        itr.join();
+
+    EXPECT_EQ(_errors.load(), 0);
+    EXPECT_GT(_updates.load(), 0);
+    EXPECT_EQ(_map.size(), num_resident * kernels_per_code_obj);
+}
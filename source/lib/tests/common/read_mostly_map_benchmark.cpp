@@ -0,0 +1,146 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/container/read_mostly_map.hpp"
+#include "lib/common/synchronized.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+using kernel_object_map_t = ::rocprofiler::common::container::read_mostly_map<uint64_t, uint64_t>;
+
+// mimic code object layout: kernel objects are 64-byte aligned addresses within a load range
+constexpr uint64_t kernel_object_base   = 0x7f0000000000ULL;
+constexpr uint64_t kernels_per_code_obj = 256;
+
+uint64_t
+get_kernel_object(uint64_t code_obj, uint64_t kernel)
+{
+    return kernel_object_base + (((code_obj * kernels_per_code_obj) + kernel) * 64);
+}
+
+uint64_t
+get_kernel_id(uint64_t code_obj, uint64_t kernel)
+{
+    return (code_obj * kernels_per_code_obj) + kernel + 1;
+}
+
+void
+load_code_object(kernel_object_map_t& _map, uint64_t code_obj)
+{
+    _map.modify([code_obj](kernel_object_map_t::map_type& data) {
+        for(uint64_t i = 0; i < kernels_per_code_obj; ++i)
+            data[get_kernel_object(code_obj, i)] = get_kernel_id(code_obj, i);
+    });
+}
+}  // namespace
+
+/**
+ * Compares the lookup latency of read_mostly_map against the Synchronized<unordered_map> it
+ * replaced for kernel object -> kernel id lookups while a writer periodically republishes
+ */
+TEST(common, read_mostly_map_benchmark)
+{
+    using synced_map_t =
+        ::rocprofiler::common::Synchronized<std::unordered_map<uint64_t, uint64_t>>;
+
+    constexpr uint64_t num_code_objs = 16;
+    constexpr uint64_t num_lookups   = 4000000;
+    const uint64_t     num_threads   = std::max<uint64_t>(std::thread::hardware_concurrency(), 2);
+
+    auto _rmm    = kernel_object_map_t{};
+    auto _synced = synced_map_t{};
+    for(uint64_t i = 0; i < num_code_objs; ++i)
+    {
+        load_code_object(_rmm, i);
+        _synced.wlock([i](auto& data) {
+            for(uint64_t k = 0; k < kernels_per_code_obj; ++k)
+                data[get_kernel_object(i, k)] = get_kernel_id(i, k);
+        });
+    }
+
+    auto _run = [num_threads](auto&& _lookup, auto&& _update) {
+        auto _done   = std::atomic<bool>{false};
+        auto _writer = std::thread{[&]() {
+            while(!_done.load(std::memory_order_relaxed))
+            {
+                _update();
+                std::this_thread::sleep_for(std::chrono::microseconds{100});
+            }
+        }};
+
+        auto _sum     = std::atomic<uint64_t>{0};
+        auto _threads = std::vector<std::thread>{};
+        auto _t0      = std::chrono::steady_clock::now();
+        for(uint64_t t = 0; t < num_threads; ++t)
+        {
+            _threads.emplace_back([&, t]() {
+                uint64_t _local = 0;
+                for(uint64_t i = 0; i < num_lookups; ++i)
+                {
+                    // consecutive dispatches of the same kernel are common
+                    auto _idx = (i / 8) + t;
+                    _local += _lookup(get_kernel_object(_idx % num_code_objs,
+                                                        (_idx * 13) % kernels_per_code_obj));
+                }
+                _sum += _local;
+            });
+        }
+        for(auto& itr : _threads)
+            itr.join();
+        auto _t1 = std::chrono::steady_clock::now();
+
+        _done.store(true);
+        _writer.join();
+
+        EXPECT_GT(_sum.load(), 0);
+        return std::chrono::duration<double, std::nano>(_t1 - _t0).count() /
+               static_cast<double>(num_lookups);
+    };
+
+    auto _updated = get_kernel_object(num_code_objs, 0);
+    auto _rmm_ns  = _run([&_rmm](uint64_t _kern_obj) { return _rmm.find(_kern_obj); },
+                        [&_rmm, _updated]() { _rmm.emplace(_updated, 1); });
+    auto _sync_ns = _run(
+        [&_synced](uint64_t _kern_obj) {
+            return _synced.rlock([_kern_obj](const auto& data) {
+                auto itr = data.find(_kern_obj);
+                return (itr == data.end()) ? uint64_t{0} : itr->second;
+            });
+        },
+        [&_synced, _updated]() { _synced.wlock([_updated](auto& data) { data[_updated] = 1; }); });
+
+    std::cout << "Benchmark: " << num_threads << " threads x " << num_lookups
+              << " kernel id lookups\n"
+              << "    read_mostly_map     : " << _rmm_ns << " ns/lookup\n"
+              << "    Synchronized<umap>  : " << _sync_ns << " ns/lookup" << std::endl;
+}
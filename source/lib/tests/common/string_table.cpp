@@ -0,0 +1,152 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/string_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// generates Itanium-mangled names resembling templated HIP kernels, e.g.
+//   _ZN7rocprim6detail22block_reduce_kernel_17ILj256ELj42EfN6thrust4plusIfEEEEvPT2_mS7_
+std::vector<std::string>
+generate_kernel_names(size_t _n)
+{
+    const char* namespaces[] = {"7rocprim", "6hipcub", "6thrust", "4Kokkos", "5RAJA"};
+    const char* kernels[]    = {"block_reduce_kernel",
+                             "device_scan_kernel",
+                             "radix_sort_onesweep_kernel",
+                             "parallel_for_functor",
+                             "transform_reduce_kernel"};
+    const char* types[]      = {"f", "d", "i", "j", "N6thrust4plusIfEE", "N6Kokkos4ViewIPdJEEE"};
+
+    auto _names = std::vector<std::string>{};
+    _names.reserve(_n);
+    for(size_t i = 0; i < _n; ++i)
+    {
+        auto _kernel = std::string{kernels[i % 5]} + "_" + std::to_string(i);
+        auto _name   = std::string{"_ZN"} + namespaces[(i / 5) % 5] + "6detail" +
+                     std::to_string(_kernel.length()) + _kernel + "ILj" +
+                     std::to_string(64 << (i % 5)) + "ELj" + std::to_string(i % 97) + "E" +
+                     types[i % 6] + types[(i / 6) % 6] + "EEvPT2_mS7_";
+        _names.emplace_back(std::move(_name));
+    }
+    return _names;
+}
+}  // namespace
+
+TEST(common, string_table)
+{
+    auto _table = ::rocprofiler::common::string_table{};
+
+    auto _missing = _table.find("gfx942");
+    EXPECT_TRUE(_missing.empty());
+    EXPECT_EQ(_missing.data(), nullptr);
+
+    auto _src = std::string{"gfx942"};
+    auto _a   = _table.intern(_src);
+    auto _b   = _table.intern("gfx942");
+    auto _c   = _table.intern("gfx90a");
+
+    // interned strings are not references to the input, are deduplicated, and are
+    // null-terminated so they can be handed out as C strings
+    EXPECT_NE(_a.data(), _src.data());
+    EXPECT_EQ(_a.data(), _b.data());
+    EXPECT_NE(_a.data(), _c.data());
+    EXPECT_EQ(_a, "gfx942");
+    EXPECT_EQ(std::strlen(_a.data()), _a.length());
+    EXPECT_EQ(_table.find("gfx90a").data(), _c.data());
+    EXPECT_EQ(_table.size(), 2);
+
+    // empty and embedded strings are distinct entries
+    auto _empty = _table.intern("");
+    EXPECT_TRUE(_empty.empty());
+    EXPECT_NE(_empty.data(), nullptr);
+    EXPECT_NE(_table.intern("gfx9").data(), _a.data());
+    EXPECT_EQ(_table.size(), 4);
+
+    // strings larger than an arena block are supported
+    auto _large = std::string(1024 * 1024, 'x');
+    auto _lv    = _table.intern(_large);
+    EXPECT_EQ(_lv, _large);
+    EXPECT_EQ(_table.intern(_large).data(), _lv.data());
+
+    _src.clear();
+    EXPECT_EQ(_a, "gfx942");
+
+    // identifiers are non-zero, stable, and resolve to the interned string
+    auto _id = _table.intern_id("gfx942");
+    EXPECT_NE(_id, 0);
+    EXPECT_EQ(_table.intern_id(std::string{"gfx942"}), _id);
+    EXPECT_NE(_table.intern_id("gfx90a"), _id);
+    EXPECT_EQ(_table.lookup(_id).data(), _a.data());
+    EXPECT_EQ(_table.size(), 5);
+
+    auto _new_id = _table.intern_id("gfx1100");
+    EXPECT_EQ(_table.lookup(_new_id), "gfx1100");
+    EXPECT_EQ(_table.find("gfx1100").data(), _table.lookup(_new_id).data());
+
+    // invalid identifiers
+    EXPECT_EQ(_table.lookup(0).data(), nullptr);
+    EXPECT_EQ(_table.lookup(_new_id + (1000 * _table.num_shards)).data(), nullptr);
+}
+
+TEST(common, string_table_concurrent)
+{
+    constexpr size_t num_names   = 50000;
+    constexpr size_t num_threads = 8;
+
+    auto _table = ::rocprofiler::common::string_table{};
+    auto _names = generate_kernel_names(num_names);
+
+    // every thread interns every name (in a different order) and must get the same address
+    auto _results = std::vector<std::vector<const char*>>(num_threads);
+    auto _threads = std::vector<std::thread>{};
+    for(size_t t = 0; t < num_threads; ++t)
+    {
+        _threads.emplace_back([&, t]() {
+            auto& _result = _results.at(t);
+            _result.resize(num_names, nullptr);
+            for(size_t i = 0; i < num_names; ++i)
+            {
+                auto idx     = (i + (t * num_names / num_threads)) % num_names;
+                _result[idx] = _table.intern(_names.at(idx)).data();
+            }
+        });
+    }
+
+    for(auto& itr : _threads)
+        itr.join();
+
+    EXPECT_EQ(_table.size(), num_names);
+    for(size_t i = 0; i < num_names; ++i)
+    {
+        ASSERT_EQ(std::string_view{_results.front().at(i)}, _names.at(i));
+        for(size_t t = 1; t < num_threads; ++t)
+            ASSERT_EQ(_results.at(t).at(i), _results.front().at(i)) << "name: " << _names.at(i);
+    }
+}
@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/string_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+// generates Itanium-mangled names resembling templated HIP kernels, e.g.
+//   _ZN7rocprim6detail22block_reduce_kernel_17ILj256ELj42EfN6thrust4plusIfEEEEvPT2_mS7_
+std::vector<std::string>
+generate_kernel_names(size_t _n)
+{
+    const char* namespaces[] = {"7rocprim", "6hipcub", "6thrust", "4Kokkos", "5RAJA"};
+    const char* kernels[]    = {"block_reduce_kernel",
+                             "device_scan_kernel",
+                             "radix_sort_onesweep_kernel",
+                             "parallel_for_functor",
+                             "transform_reduce_kernel"};
+    const char* types[]      = {"f", "d", "i", "j", "N6thrust4plusIfEE", "N6Kokkos4ViewIPdJEEE"};
+
+    auto _names = std::vector<std::string>{};
+    _names.reserve(_n);
+    for(size_t i = 0; i < _n; ++i)
+    {
+        auto _kernel = std::string{kernels[i % 5]} + "_" + std::to_string(i);
+        auto _name   = std::string{"_ZN"} + namespaces[(i / 5) % 5] + "6detail" +
+                     std::to_string(_kernel.length()) + _kernel + "ILj" +
+                     std::to_string(64 << (i % 5)) + "ELj" + std::to_string(i % 97) + "E" +
+                     types[i % 6] + types[(i / 6) % 6] + "EEvPT2_mS7_";
+        _names.emplace_back(std::move(_name));
+    }
+    return _names;
+}
+}  // namespace
+
+/**
+ * Measures the time to intern 500k realistic mangled kernel names (i.e. code object load time)
+ * and the time to look them up again once interned
+ */
+TEST(common, string_table_benchmark)
+{
+    constexpr size_t num_names = 500000;
+
+    auto _names = generate_kernel_names(num_names);
+    auto _table = ::rocprofiler::common::string_table{};
+
+    auto _t0 = std::chrono::steady_clock::now();
+    for(const auto& itr : _names)
+        _table.intern(itr);
+    auto _t1 = std::chrono::steady_clock::now();
+    for(const auto& itr : _names)
+        EXPECT_FALSE(_table.intern(itr).empty());
+    auto _t2 = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(_table.size(), num_names);
+
+    auto _insert_ms = std::chrono::duration<double, std::milli>(_t1 - _t0).count();
+    auto _lookup_ms = std::chrono::duration<double, std::milli>(_t2 - _t1).count();
+    std::cout << "Benchmark: interned " << num_names << " mangled kernel names in " << _insert_ms
+              << " ms (" << (1.0e6 * _insert_ms / num_names) << " ns/name), re-interned in "
+              << _lookup_ms << " ms (" << (1.0e6 * _lookup_ms / num_names) << " ns/name)"
+              << std::endl;
+}